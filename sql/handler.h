@@ -27,6 +27,7 @@
 #include <sys/types.h>
 #include <time.h>
 #include <algorithm>
+#include <functional>
 #include <random>       // std::mt19937
 #include <string>
 
@@ -3899,6 +3900,64 @@ public:
     return 0;
   }
 
+  /**
+    Callback for each row read by parallel_scan(). It is called
+    concurrently from several threads, but never from two threads with
+    the same thread context at the same time.
+
+    @param thread_ctx  Context of the thread that read the row
+    @param record      The row, in the format of table->record[0]
+
+    @retval false  continue the scan
+    @retval true   stop the scan
+  */
+  typedef std::function<bool(void *thread_ctx, const uchar *record)>
+    Load_cbk;
+
+  /**
+    Prepare a scan of all rows of the table with several threads. The
+    rows are returned in no particular order.
+
+    @param[out]    scan_ctx     Context of the scan, to be passed to
+                                parallel_scan() and parallel_scan_end()
+    @param[in,out] num_threads  Number of threads wanted, 0 for the
+                                engine default. Set to the number of
+                                threads the scan will use.
+
+    @retval 0 for OK
+    @retval HA_ERR_WRONG_COMMAND if the engine does not support it
+    @retval one of the HA_xxx values in case of other errors
+  */
+  virtual int parallel_scan_init(void *&scan_ctx, size_t &num_threads)
+  {
+    scan_ctx= NULL;
+    num_threads= 0;
+    return HA_ERR_WRONG_COMMAND;
+  }
+
+  /**
+    Run a scan prepared by parallel_scan_init().
+
+    @param scan_ctx     Context returned by parallel_scan_init()
+    @param thread_ctxs  Array of num_threads contexts, one per thread,
+                        passed to load_fn
+    @param load_fn      Callback for each row
+
+    @retval 0 for OK, one of the HA_xxx values in case of error.
+  */
+  virtual int parallel_scan(void *scan_ctx MY_ATTRIBUTE((unused)),
+                            void **thread_ctxs MY_ATTRIBUTE((unused)),
+                            Load_cbk load_fn MY_ATTRIBUTE((unused)))
+  { return HA_ERR_WRONG_COMMAND; }
+
+  /**
+    Release the context of a scan prepared by parallel_scan_init().
+
+    @param scan_ctx  Context returned by parallel_scan_init()
+  */
+  virtual void parallel_scan_end(void *scan_ctx MY_ATTRIBUTE((unused)))
+  {}
+
   /**
     Return upper bound of current number of records in the table
     (max. of how many records one will retrieve when doing a full table scan)
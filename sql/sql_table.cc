@@ -12704,6 +12704,187 @@ bool mysql_recreate_table(THD *thd, TABLE_LIST *table_list, bool table_copy)
 }
 
 
+/**
+  Compute the checksum of one row for CHECKSUM TABLE.
+
+  @param t           Table
+  @param fields      Fields of the table, pointing into the row
+  @param null_bytes  Null bytes of the row. The bits that no column
+                     uses are set first, so that they do not count.
+
+  @return checksum of the row
+*/
+
+static ha_checksum checksum_row(TABLE *t, Field **fields, uchar *null_bytes)
+{
+  ha_checksum row_crc= 0;
+  uchar null_mask=256 -  (1 << t->s->last_null_bit_pos);
+
+  if (t->s->null_bytes)
+  {
+    /* fix undefined null bits */
+    null_bytes[t->s->null_bytes-1] |= null_mask;
+    if (!(t->s->db_create_options & HA_OPTION_PACK_RECORD))
+      null_bytes[0] |= 1;
+
+    row_crc= checksum_crc32(row_crc, null_bytes, t->s->null_bytes);
+  }
+
+  for (uint i= 0; i < t->s->fields; i++ )
+  {
+    Field *f= fields[i];
+
+    /*
+      BLOB and VARCHAR have pointers in their field, we must convert
+      to string; GEOMETRY and JSON are implemented on top of BLOB.
+      BIT may store its data among NULL bits, convert as well.
+    */
+    switch (f->type()) {
+      case MYSQL_TYPE_BLOB:
+      case MYSQL_TYPE_VARCHAR:
+      case MYSQL_TYPE_GEOMETRY:
+      case MYSQL_TYPE_JSON:
+      case MYSQL_TYPE_BIT:
+      {
+        String tmp;
+        f->val_str(&tmp);
+        row_crc= checksum_crc32(row_crc, (uchar*) tmp.ptr(),
+                                tmp.length());
+        break;
+      }
+      default:
+        row_crc= checksum_crc32(row_crc, f->ptr, f->pack_length());
+        break;
+    }
+  }
+
+  return row_crc;
+}
+
+
+/** Context of one thread of a parallel CHECKSUM TABLE scan. */
+
+struct Checksum_thread_ctx
+{
+  /** Copies of the fields of the table, pointing into record */
+  Field **fields;
+  /** The row buffer of the thread */
+  const uchar *record;
+  /** Copy of the null bytes of the current row */
+  uchar *null_bytes;
+  /** Sum of the checksums of the rows read by the thread */
+  ha_checksum crc;
+};
+
+
+/**
+  Compute the checksum of a table with a parallel scan. The checksum
+  of a table is the sum of the checksums of its rows, so the threads
+  can add up their rows in any order.
+
+  @param thd        Thread handle
+  @param t          Table, with all columns in the read set
+  @param[in,out]    crc  Checksum, to which the rows are added
+
+  @retval 0                     the checksum was computed
+  @retval HA_ERR_WRONG_COMMAND  the table cannot be scanned in parallel
+  @retval other                 the scan failed
+*/
+
+static int checksum_table_parallel(THD *thd, TABLE *t, ha_checksum *crc)
+{
+  /*
+    The rows are read by threads that have no THD. The server computes
+    generated columns, and converting JSON to text can push warnings.
+  */
+  if (t->has_gcol())
+    return HA_ERR_WRONG_COMMAND;
+
+  for (uint i= 0; i < t->s->fields; i++)
+  {
+    if (t->field[i]->type() == MYSQL_TYPE_JSON)
+      return HA_ERR_WRONG_COMMAND;
+  }
+
+  void *scan_ctx;
+  size_t num_threads= 0;
+
+  int error= t->file->parallel_scan_init(scan_ctx, num_threads);
+  if (error)
+    return error;
+
+  Checksum_thread_ctx *ctxs= static_cast<Checksum_thread_ctx*>(
+    thd->alloc(num_threads * sizeof(Checksum_thread_ctx)));
+  void **thread_ctxs= static_cast<void**>(
+    thd->alloc(num_threads * sizeof(void*)));
+
+  if (!ctxs || !thread_ctxs)
+    error= HA_ERR_OUT_OF_MEM;
+
+  for (size_t i= 0; error == 0 && i < num_threads; i++)
+  {
+    Checksum_thread_ctx *ctx= ctxs + i;
+
+    ctx->fields= static_cast<Field**>(
+      thd->alloc(t->s->fields * sizeof(Field*)));
+    ctx->record= t->record[0];
+    ctx->null_bytes= static_cast<uchar*>(thd->alloc(t->s->null_bytes + 1));
+    ctx->crc= 0;
+    thread_ctxs[i]= ctx;
+
+    if (!ctx->fields || !ctx->null_bytes)
+    {
+      error= HA_ERR_OUT_OF_MEM;
+      break;
+    }
+
+    for (uint j= 0; j < t->s->fields; j++)
+    {
+      if (!(ctx->fields[j]= t->field[j]->clone(thd->mem_root)))
+      {
+        error= HA_ERR_OUT_OF_MEM;
+        break;
+      }
+    }
+  }
+
+  if (!error)
+  {
+    error= t->file->parallel_scan(
+      scan_ctx, thread_ctxs,
+      [thd, t](void *thread_ctx, const uchar *record) -> bool
+      {
+        Checksum_thread_ctx *ctx=
+          static_cast<Checksum_thread_ctx*>(thread_ctx);
+
+        /* Each thread reads all of its rows into the same buffer. */
+        if (record != ctx->record)
+        {
+          for (uint i= 0; i < t->s->fields; i++)
+            ctx->fields[i]->move_field_offset(record - ctx->record);
+          ctx->record= record;
+        }
+
+        memcpy(ctx->null_bytes, record, t->s->null_bytes);
+        ctx->crc+= checksum_row(t, ctx->fields, ctx->null_bytes);
+
+        /* Stop the scan if the statement was killed. */
+        return thd->killed != THD::NOT_KILLED;
+      });
+  }
+
+  t->file->parallel_scan_end(scan_ctx);
+
+  if (error)
+    return error;
+
+  for (size_t i= 0; i < num_threads; i++)
+    *crc+= ctxs[i].crc;
+
+  return 0;
+}
+
+
 bool mysql_checksum_table(THD *thd, TABLE_LIST *tables,
                           HA_CHECK_OPT *check_opt)
 {
@@ -12783,11 +12964,25 @@ bool mysql_checksum_table(THD *thd, TABLE_LIST *tables,
       {
 	/* calculating table's checksum */
 	ha_checksum crc= 0;
-        uchar null_mask=256 -  (1 << t->s->last_null_bit_pos);
 
         t->use_all_columns();
 
-	if (t->file->ha_rnd_init(1))
+        int scan_error= checksum_table_parallel(thd, t, &crc);
+
+        if (thd->killed)
+        {
+          protocol->abort_row();
+          goto err;
+        }
+
+        if (scan_error != HA_ERR_WRONG_COMMAND)
+        {
+          if (scan_error)
+            protocol->store_null();
+          else
+            protocol->store((ulonglong)crc);
+        }
+	else if (t->file->ha_rnd_init(1))
 	  protocol->store_null();
 	else
 	{
@@ -12803,7 +12998,6 @@ bool mysql_checksum_table(THD *thd, TABLE_LIST *tables,
               protocol->abort_row();
               goto err;
             }
-	    ha_checksum row_crc= 0;
             int error= t->file->ha_rnd_next(t->record[0]);
             if (unlikely(error))
             {
@@ -12811,45 +13005,7 @@ bool mysql_checksum_table(THD *thd, TABLE_LIST *tables,
                 continue;
               break;
             }
-	    if (t->s->null_bytes)
-            {
-              /* fix undefined null bits */
-              t->record[0][t->s->null_bytes-1] |= null_mask;
-              if (!(t->s->db_create_options & HA_OPTION_PACK_RECORD))
-                t->record[0][0] |= 1;
-
-	      row_crc= checksum_crc32(row_crc, t->record[0], t->s->null_bytes);
-            }
-
-	    for (uint i= 0; i < t->s->fields; i++ )
-	    {
-	      Field *f= t->field[i];
-
-             /*
-               BLOB and VARCHAR have pointers in their field, we must convert
-               to string; GEOMETRY and JSON are implemented on top of BLOB.
-               BIT may store its data among NULL bits, convert as well.
-             */
-              switch (f->type()) {
-                case MYSQL_TYPE_BLOB:
-                case MYSQL_TYPE_VARCHAR:
-                case MYSQL_TYPE_GEOMETRY:
-                case MYSQL_TYPE_JSON:
-                case MYSQL_TYPE_BIT:
-                {
-                  String tmp;
-                  f->val_str(&tmp);
-                  row_crc= checksum_crc32(row_crc, (uchar*) tmp.ptr(),
-                           tmp.length());
-                  break;
-                }
-                default:
-                  row_crc= checksum_crc32(row_crc, f->ptr, f->pack_length());
-                  break;
-	      }
-	    }
-
-	    crc+= row_crc;
+	    crc+= checksum_row(t, t->field, t->record[0]);
 	  }
 	  protocol->store((ulonglong)crc);
           t->file->ha_rnd_end();
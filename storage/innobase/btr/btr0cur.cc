@@ -4368,6 +4368,13 @@ btr_cur_pessimistic_update(
 		ut_ad(page_is_leaf(page));
 		ut_ad(index->is_clustered());
 		ut_ad(flags & BTR_KEEP_POS_FLAG);
+
+		/* Without undo logging, the old versions of the
+		updated LOBs were freed above. */
+		if (!(flags & BTR_NO_UNDO_LOG_FLAG)) {
+			lob::btr_rec_copy_old_field_refs(
+				index, rec, *offsets, big_rec_vec);
+		}
 	}
 
 	/* Do lock checking and undo logging */
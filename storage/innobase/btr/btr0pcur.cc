@@ -27,6 +27,8 @@ Created 2/23/1996 Heikki Tuuri
 
 #include <stddef.h>
 
+#include "buf0rea.h"
+
 #include "my_dbug.h"
 #include "my_inttypes.h"
 #include "rem0cmp.h"
@@ -461,6 +463,132 @@ btr_pcur_move_to_next_page(
 	ut_d(page_check_dir(next_page));
 }
 
+/** Reads ahead the leaf pages that follow the stored position of a
+persistent cursor in ascending order.  The page numbers are taken from the
+node pointers on the level above the leaves, so that the pages are found
+without reading them even when they are not adjacent in the file.  The
+reads are asynchronous.  The read-ahead stops at the first node pointer
+that is greater than end_tuple, because the scan ends before that page.
+NOTE: the caller must not hold any page latches, and this must not be
+called in read-only mode.
+@param[in]	cursor		persistent cursor whose position has been
+stored
+@param[in]	n_pages		maximum number of leaf pages to read ahead
+@param[in]	end_tuple	last key of the scan, or NULL if the scan
+may continue to the end of the index
+@return number of leaf pages that follow the stored position, up to
+n_pages; less than n_pages if the scan reaches the end of the index or
+of the range */
+ulint
+btr_pcur_read_ahead_logical(
+	const btr_pcur_t*	cursor,
+	ulint			n_pages,
+	const dtuple_t*		end_tuple)
+{
+	dict_index_t*	index = cursor->btr_cur.index;
+	ulint		n = 0;
+	mtr_t		mtr;
+
+	ut_ad(cursor->old_stored);
+	ut_ad(!srv_read_only_mode);
+
+	if (cursor->rel_pos != BTR_PCUR_ON
+	    && cursor->rel_pos != BTR_PCUR_BEFORE
+	    && cursor->rel_pos != BTR_PCUR_AFTER) {
+
+		/* The tree is empty. */
+		return(0);
+	}
+
+	mem_heap_t*	heap = mem_heap_create(256);
+	page_no_t*	page_nos = static_cast<page_no_t*>(
+		mem_heap_alloc(heap, n_pages * sizeof(*page_nos)));
+	ulint*		offsets = NULL;
+
+	const dtuple_t*	tuple = dict_index_build_data_tuple(
+		index, cursor->old_rec, cursor->old_n_fields, heap);
+
+	mtr_start(&mtr);
+
+	/* The index S-latch keeps the tree from changing its height while
+	the node pointer pages are read, as in dict_stats_analyze_index(). */
+	mtr_s_lock(dict_index_get_lock(index), &mtr);
+
+	if (btr_height_get(index, &mtr) == 0) {
+
+		/* The root is the only leaf page. */
+		mtr_commit(&mtr);
+		mem_heap_free(heap);
+
+		return(0);
+	}
+
+	btr_cur_t	btr_cur;
+
+	btr_cur.thr = NULL;
+
+	btr_cur_search_to_nth_level(
+		index, 1, tuple, PAGE_CUR_LE,
+		BTR_SEARCH_TREE | BTR_ALREADY_S_LATCHED,
+		&btr_cur, 0, __FILE__, __LINE__, &mtr);
+
+	page_cur_t*	page_cur = btr_cur_get_page_cur(&btr_cur);
+
+	/* The cursor is on the node pointer of the leaf page that holds
+	the stored position.  Collect the child page numbers of the node
+	pointers that follow it. */
+	while (n < n_pages) {
+
+		page_cur_move_to_next(page_cur);
+
+		if (page_cur_is_after_last(page_cur)) {
+			buf_block_t*	block = page_cur_get_block(page_cur);
+			page_no_t	next_page_no = btr_page_get_next(
+				buf_block_get_frame(block), &mtr);
+
+			if (next_page_no == FIL_NULL) {
+				break;
+			}
+
+			block = btr_block_get(
+				page_id_t(block->page.id.space(),
+					  next_page_no),
+				block->page.size, RW_S_LATCH, index, &mtr);
+
+			page_cur_set_before_first(block, page_cur);
+
+			continue;
+		}
+
+		const rec_t*	rec = page_cur_get_rec(page_cur);
+
+		offsets = rec_get_offsets(
+			rec, index, offsets, ULINT_UNDEFINED, &heap);
+
+		/* No key on the child page is smaller than the node
+		pointer.  If the node pointer is past the end of the
+		range, the scan does not reach this page or any of the
+		pages that follow. */
+		if (end_tuple != NULL
+		    && cmp_dtuple_rec(end_tuple, rec, index, offsets) < 0) {
+			break;
+		}
+
+		page_nos[n++] = btr_node_ptr_get_child_page_no(rec, offsets);
+	}
+
+	const space_id_t	space_id = dict_index_get_space(index);
+	const page_size_t	page_size(dict_table_page_size(index->table));
+
+	mtr_commit(&mtr);
+
+	buf_read_ahead_logical(space_id, page_size, page_nos, n);
+
+	mem_heap_free(heap);
+
+	return(n);
+}
+
 /*********************************************************//**
 Moves the persistent cursor backward if it is on the first record of the page.
 Commits mtr. Note that to prevent a possible deadlock, the operation
@@ -33,6 +33,9 @@ Created 2/17/1996 Heikki Tuuri
 #include "btr0sea.h"
 
 #include <sys/types.h>
+#include <atomic>
+#include <deque>
+#include <unordered_set>
 
 #include "btr0btr.h"
 #include "btr0cur.h"
@@ -44,6 +47,8 @@ Created 2/17/1996 Heikki Tuuri
 #include "page0cur.h"
 #include "page0page.h"
 #include "srv0mon.h"
+#include "srv0srv.h"
+#include "srv0start.h"
 #include "sync0sync.h"
 
 /** Is search system enabled.
@@ -53,6 +58,10 @@ bool		btr_search_enabled	= true;
 /** Number of adaptive hash index partition. */
 ulong		btr_ahi_parts		= 8;
 
+/** Whether the adaptive hash index is turned off and on per index by its
+effectiveness, and page hash indexes are built in the background. */
+bool		btr_search_auto		= true;
+
 #ifdef UNIV_SEARCH_PERF_STAT
 /** Number of successful adaptive hash index lookups */
 ulint		btr_search_n_succ	= 0;
@@ -89,6 +98,72 @@ is then built on the page, assuming the global limit has been reached */
 before hash index building is started */
 #define BTR_SEARCH_BUILD_LIMIT		100
 
+/** Number of hash searches of an index, or of analysed searches while its
+hash index is disabled, after which btr_search_tune() judges whether the
+hash index of the index pays off */
+#define BTR_SEARCH_TUNE_WINDOW		1000
+
+/** Number of hash nodes added or removed that cost about as much as one
+failed hash search */
+#define BTR_SEARCH_TUNE_ROW_COST	4
+
+/** The hash index of an index is disabled when the hits are less than this
+percentage of the hits plus the cost of misses and maintenance */
+#define BTR_SEARCH_TUNE_OFF_PCT		25
+
+/** The hash index of an index is enabled again when at least this
+percentage of the searches would have succeeded */
+#define BTR_SEARCH_TUNE_ON_PCT		75
+
+/** Number of consecutive windows that must vote for turning the hash
+index of an index off or on before it is done */
+#define BTR_SEARCH_TUNE_STRIKES		2
+
+/** Maximum number of pages in the build queue of a hash table */
+#define BTR_SEARCH_BUILD_QUEUE_MAX	256
+
+/** A page whose hash index the build thread is to build or drop */
+struct btr_search_build_req_t {
+	dict_index_t*	index;		/*!< index of the page; the request
+					is counted in n_build_pending of its
+					search info, which keeps the index in
+					the dictionary cache */
+	space_id_t	space_id;	/*!< tablespace of the page */
+	page_no_t	page_no;	/*!< page number */
+	ulint		n_fields;	/*!< hash this many full fields */
+	ulint		n_bytes;	/*!< hash this many bytes of the next
+					field */
+	ibool		left_side;	/*!< hash for searches from left side */
+	bool		drop;		/*!< true to drop the hash index of
+					the page instead of building it */
+};
+
+/** Queue of page hash index builds of an adaptive hash index part */
+struct btr_search_build_queue_t {
+	typedef std::deque<btr_search_build_req_t,
+			   ut_allocator<btr_search_build_req_t> > Reqs;
+
+	typedef std::unordered_set<
+		uint64_t, std::hash<uint64_t>, std::equal_to<uint64_t>,
+		ut_allocator<uint64_t> > Pages;
+
+	/** Mutex protecting reqs and pages */
+	ib_mutex_t	mutex;
+
+	/** Requests in arrival order */
+	Reqs		reqs;
+
+	/** Pages that have a request in reqs */
+	Pages		pages;
+};
+
+/** Event that wakes up the hash index build thread */
+static os_event_t	btr_search_build_event;
+
+/** Whether the hash index build thread is running and accepting
+requests; cleared while holding all build queue mutexes */
+static std::atomic<bool>	btr_search_build_running;
+
 /** Compute the hash value of an index identifier.
 @param[in]	space_id	tablespace identifier
 @param[in]	index_id	index identifier
@@ -241,6 +316,23 @@ btr_search_sys_create(ulint hash_size)
 		btr_search_sys->hash_tables[i]->adaptive = TRUE;
 #endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
 	}
+
+	/* Step-3: Allocate the queues of the hash index build thread. */
+	btr_search_sys->build_queues =
+		reinterpret_cast<btr_search_build_queue_t**>(
+			ut_malloc(sizeof(btr_search_build_queue_t*)
+				  * btr_ahi_parts, mem_key_ahi));
+
+	for (ulint i = 0; i < btr_ahi_parts; ++i) {
+
+		btr_search_sys->build_queues[i] =
+			UT_NEW(btr_search_build_queue_t(), mem_key_ahi);
+
+		mutex_create(LATCH_ID_AHI_BUILD_QUEUE,
+			     &btr_search_sys->build_queues[i]->mutex);
+	}
+
+	btr_search_build_event = os_event_create(0);
 }
 
 /** Resize hash index hash table.
@@ -301,6 +393,20 @@ btr_search_sys_free()
 	}
 
 	ut_free(btr_search_sys->hash_tables);
+
+	ut_ad(!btr_search_build_running);
+
+	for (ulint i = 0; i < btr_ahi_parts; ++i) {
+
+		ut_ad(btr_search_sys->build_queues[i]->reqs.empty());
+
+		mutex_free(&btr_search_sys->build_queues[i]->mutex);
+		UT_DELETE(btr_search_sys->build_queues[i]);
+	}
+
+	ut_free(btr_search_sys->build_queues);
+	os_event_destroy(btr_search_build_event);
+
 	ut_free(btr_search_sys);
 	btr_search_sys = NULL;
 
@@ -332,7 +438,17 @@ btr_search_disable_ref_count(
 
 		ut_ad(rw_lock_own(btr_get_search_latch(index), RW_LOCK_X));
 
-		index->search_info->ref_count = 0;
+		btr_search_t*	info = index->search_info;
+
+		info->ref_count = 0;
+
+		/* Start the self-tuning afresh when the adaptive hash
+		index is enabled again. */
+		info->disabled = FALSE;
+		info->tune_hits = 0;
+		info->tune_misses = 0;
+		info->tune_rows = info->n_rows_added + info->n_rows_removed;
+		info->tune_strikes = 0;
 	}
 }
 
@@ -439,10 +555,24 @@ btr_search_info_create(mem_heap_t* heap)
 
 	info->left_side = TRUE;
 
+	info->disabled = FALSE;
+	info->n_switches = 0;
+	info->n_hits = 0;
+	info->n_misses = 0;
+	info->n_rows_added = 0;
+	info->n_rows_removed = 0;
+	info->tune_hits = 0;
+	info->tune_misses = 0;
+	info->tune_rows = 0;
+	info->tune_strikes = 0;
+	info->n_build_pending = 0;
+
 	return(info);
 }
 
 /** Returns the value of ref_count. The value is protected by latch.
+Pages that are queued for the hash index build thread are counted too,
+because the requests refer to the index.
 @param[in]	info		search info
 @param[in]	index		index identifier
 @return ref_count value. */
@@ -451,19 +581,19 @@ btr_search_info_get_ref_count(
 	const btr_search_t*	info,
 	const dict_index_t*	index)
 {
-	ulint ret = 0;
+	ut_ad(info);
+
+	ulint ret = info->n_build_pending;
 
 	if (!btr_search_enabled) {
 		return(ret);
 	}
 
-	ut_ad(info);
-
 	ut_ad(!rw_lock_own(btr_get_search_latch(index), RW_LOCK_S));
 	ut_ad(!rw_lock_own(btr_get_search_latch(index), RW_LOCK_X));
 
 	btr_search_s_lock(index);
-	ret = info->ref_count;
+	ret += info->ref_count;
 	btr_search_s_unlock(index);
 
 	return(ret);
@@ -729,10 +859,330 @@ btr_search_update_hash_ref(
 		ha_insert_for_fold(btr_get_search_table(index), fold,
 				   block, rec);
 
+		index->search_info->n_rows_added++;
 		MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_ADDED);
 	}
 }
 
+/** Check whether the hash index of an index is in use.
+@param[in]	info	search info of the index
+@return true if the hash index is disabled by the self-tuning */
+static inline
+bool
+btr_search_is_disabled(
+	const btr_search_t*	info)
+{
+	return(btr_search_auto && info->disabled);
+}
+
+/** Judge whether the hash index of an index pays off, once a window of
+searches has been observed, and turn it off or on. While it is in use, the
+hits are weighed against the failed hash searches and the hash nodes that
+were added and removed. While it is turned off, the searches are analysed
+as if it were in use, and it is turned on again when most of them would
+have succeeded. The decision must be confirmed by BTR_SEARCH_TUNE_STRIKES
+consecutive windows, so that a short change of the workload does not flip
+the hash index back and forth. NOTE that info is NOT protected by any
+semaphore.
+@param[in,out]	info	search info */
+static
+void
+btr_search_tune(
+	btr_search_t*	info)
+{
+	const ulint	hits = info->tune_hits;
+	const ulint	misses = info->tune_misses;
+
+	if (hits + misses < BTR_SEARCH_TUNE_WINDOW) {
+		return;
+	}
+
+	const ulint	rows = info->n_rows_added + info->n_rows_removed;
+	bool		vote;
+
+	if (info->disabled) {
+		vote = hits * 100 >= (hits + misses) * BTR_SEARCH_TUNE_ON_PCT;
+	} else {
+		const ulint	cost = misses + (rows - info->tune_rows)
+			/ BTR_SEARCH_TUNE_ROW_COST;
+
+		vote = hits * 100 < (hits + cost) * BTR_SEARCH_TUNE_OFF_PCT;
+	}
+
+	/* Pretend that the hash index does not pay off. */
+	DBUG_EXECUTE_IF("btr_search_tune_off", vote = !info->disabled;);
+
+	info->tune_hits = 0;
+	info->tune_misses = 0;
+	info->tune_rows = rows;
+
+	if (!vote) {
+		info->tune_strikes = 0;
+		return;
+	}
+
+	if (++info->tune_strikes < BTR_SEARCH_TUNE_STRIKES) {
+		return;
+	}
+
+	info->tune_strikes = 0;
+	info->disabled = !info->disabled;
+	info->n_switches++;
+
+	if (info->disabled) {
+		MONITOR_INC(MONITOR_ADAPTIVE_HASH_INDEX_OFF);
+	} else {
+		MONITOR_INC(MONITOR_ADAPTIVE_HASH_INDEX_ON);
+	}
+}
+
+/** Get the build queue of the hash table of an index.
+@param[in]	index	index
+@return build queue */
+static
+btr_search_build_queue_t*
+btr_search_get_build_queue(
+	const dict_index_t*	index)
+{
+	ulint	ifold = ut_fold_ulint_pair(static_cast<ulint>(index->id),
+					   static_cast<ulint>(index->space));
+
+	return(btr_search_sys->build_queues[ifold % btr_ahi_parts]);
+}
+
+/** Queue a page for the hash index build thread. A page that is already
+queued is not queued again, and nothing is queued when the queue is full,
+because the searches that recommended the build will recommend it again.
+@param[in]	index	index of the page
+@param[in]	block	index page, s- or x-latched
+@param[in]	drop	true to drop the hash index of the page, false to
+			build it with the parameters recommended in block
+@return false if the build thread is not running and the caller must
+do the work itself */
+static
+bool
+btr_search_build_enqueue(
+	dict_index_t*		index,
+	const buf_block_t*	block,
+	bool			drop)
+{
+	btr_search_build_queue_t*	queue
+		= btr_search_get_build_queue(index);
+	const uint64_t			key
+		= (uint64_t(block->page.id.space()) << 32)
+		| block->page.id.page_no();
+
+	mutex_enter(&queue->mutex);
+
+	if (!btr_search_build_running) {
+		mutex_exit(&queue->mutex);
+		return(false);
+	}
+
+	if (queue->reqs.size() >= BTR_SEARCH_BUILD_QUEUE_MAX
+	    || !queue->pages.insert(key).second) {
+		mutex_exit(&queue->mutex);
+		return(true);
+	}
+
+	btr_search_build_req_t	req = {
+		index, block->page.id.space(), block->page.id.page_no(),
+		block->n_fields, block->n_bytes, block->left_side, drop
+	};
+
+	queue->reqs.push_back(req);
+
+	os_atomic_increment_ulint(&index->search_info->n_build_pending, 1);
+
+	const bool	was_empty = queue->reqs.size() == 1;
+
+	mutex_exit(&queue->mutex);
+
+	MONITOR_INC(MONITOR_ADAPTIVE_HASH_PAGE_QUEUED);
+
+	if (was_empty) {
+		os_event_set(btr_search_build_event);
+	}
+
+	return(true);
+}
+
+/** Build or drop the hash index of a queued page, if the page is still in
+the buffer pool and belongs to the index.
+@param[in]	req	request */
+static
+void
+btr_search_build_page(
+	const btr_search_build_req_t&	req)
+{
+	dict_index_t*	index = req.index;
+
+	/* Do not build the hash index of an index that is being created or
+	dropped, because btr_drop_ahi_for_table() may not see it. */
+	if (btr_search_enabled && !index->disable_ahi
+	    && (req.drop
+		|| (!btr_search_is_disabled(index->search_info)
+		    && index->is_committed()
+		    && !index->table->to_be_dropped))) {
+
+		mtr_t	mtr;
+
+		mtr_start(&mtr);
+
+		buf_block_t*	block = buf_page_get_gen(
+			page_id_t(req.space_id, req.page_no),
+			dict_table_page_size(index->table),
+			RW_S_LATCH, NULL, BUF_PEEK_IF_IN_POOL,
+			__FILE__, __LINE__, &mtr);
+
+		if (block != NULL) {
+			const page_t*	page = buf_block_get_frame(block);
+
+			buf_block_dbg_add_level(
+				block, SYNC_TREE_NODE_FROM_HASH);
+
+			/* The page may have been freed and reused since
+			it was queued. */
+			if (fil_page_index_page_check(page)
+			    && page_is_leaf(page)
+			    && btr_page_get_index_id(page) == index->id) {
+
+				if (req.drop) {
+					btr_search_drop_page_hash_index(block);
+				} else {
+					btr_search_build_page_hash_index(
+						index, block, req.n_fields,
+						req.n_bytes, req.left_side);
+				}
+			}
+		}
+
+		mtr_commit(&mtr);
+	}
+
+	os_atomic_decrement_ulint(&index->search_info->n_build_pending, 1);
+}
+
+/** Take the oldest request from a build queue.
+@param[in,out]	queue	build queue
+@param[out]	req	request
+@return false if the queue is empty */
+static
+bool
+btr_search_build_dequeue(
+	btr_search_build_queue_t*	queue,
+	btr_search_build_req_t*		req)
+{
+	mutex_enter(&queue->mutex);
+
+	if (queue->reqs.empty()) {
+		mutex_exit(&queue->mutex);
+		return(false);
+	}
+
+	*req = queue->reqs.front();
+	queue->reqs.pop_front();
+	queue->pages.erase((uint64_t(req->space_id) << 32) | req->page_no);
+
+	mutex_exit(&queue->mutex);
+
+	return(true);
+}
+
+/** Background thread that builds and drops the hash index of the pages
+that btr_search_info_update_slow() queued. The queues of the hash tables
+are served in turn, so that a busy hash table cannot starve the others. */
+void
+btr_search_build_thread()
+{
+	my_thread_init();
+
+	ut_ad(btr_search_build_running);
+
+	int64_t	sig_count = os_event_reset(btr_search_build_event);
+
+	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+
+		os_event_wait_time_low(btr_search_build_event, 1000000,
+				       sig_count);
+
+		sig_count = os_event_reset(btr_search_build_event);
+
+		/* Leave the requests in the queues. */
+		if (DBUG_EVALUATE_IF("btr_search_build_pause", true, false)) {
+			continue;
+		}
+
+		for (bool found = true;
+		     found && srv_shutdown_state == SRV_SHUTDOWN_NONE;) {
+
+			found = false;
+
+			for (ulint i = 0; i < btr_ahi_parts; ++i) {
+				btr_search_build_req_t	req;
+
+				if (btr_search_build_dequeue(
+					    btr_search_sys->build_queues[i],
+					    &req)) {
+
+					btr_search_build_page(req);
+					found = true;
+				}
+			}
+		}
+	}
+
+	/* Stop accepting requests, and release the indexes of the
+	requests that were not served. */
+	for (ulint i = 0; i < btr_ahi_parts; ++i) {
+		mutex_enter(&btr_search_sys->build_queues[i]->mutex);
+	}
+
+	btr_search_build_running = false;
+
+	for (ulint i = 0; i < btr_ahi_parts; ++i) {
+		mutex_exit(&btr_search_sys->build_queues[i]->mutex);
+	}
+
+	for (ulint i = 0; i < btr_ahi_parts; ++i) {
+		btr_search_build_req_t	req;
+
+		while (btr_search_build_dequeue(
+			       btr_search_sys->build_queues[i], &req)) {
+
+			os_atomic_decrement_ulint(
+				&req.index->search_info->n_build_pending, 1);
+		}
+	}
+
+	my_thread_end();
+}
+
+/** Let the hash index build thread accept requests before it is
+created, so that it is waited for at shutdown even if it has not started
+to run yet. */
+void
+btr_search_build_thread_starting()
+{
+	ut_ad(!btr_search_build_running);
+
+	btr_search_build_running = true;
+}
+
+/** Wake up the hash index build thread. */
+void
+btr_search_build_thread_wakeup()
+{
+	os_event_set(btr_search_build_event);
+}
+
+/** @return true if the hash index build thread is running */
+bool
+btr_search_build_thread_active()
+{
+	return(btr_search_build_running);
+}
+
 /** Updates the search info.
 @param[in,out]	info	search info
 @param[in]	cursor	cursor which was just positioned */
@@ -754,10 +1204,40 @@ btr_search_info_update_slow(
 	We cannot assume the fields are consistent when we return from
 	those functions! */
 
+	const ulint	n_hash_potential = info->n_hash_potential;
+
 	btr_search_info_update_hash(info, cursor);
 
 	build_index = btr_search_update_block_hash_info(info, block, cursor);
 
+	if (btr_search_auto) {
+		if (info->disabled) {
+			/* Count the searches that the hash index would
+			have served. After a failure, the analysis is
+			skipped for BTR_SEARCH_HASH_ANALYSIS searches. */
+			if (n_hash_potential > 0
+			    && info->n_hash_potential > n_hash_potential) {
+				info->tune_hits++;
+			} else {
+				info->tune_misses += BTR_SEARCH_HASH_ANALYSIS;
+			}
+		}
+
+		btr_search_tune(info);
+
+		if (info->disabled) {
+			/* Lazily drop the hash index of the pages that
+			are still being searched. */
+			if (block->index != NULL
+			    && !btr_search_build_enqueue(
+				    cursor->index, block, true)) {
+				btr_search_drop_page_hash_index(block);
+			}
+
+			return;
+		}
+	}
+
 	if (build_index || (cursor->flag == BTR_CUR_HASH_FAIL)) {
 
 		btr_search_check_free_space_in_heap(cursor->index);
@@ -777,7 +1257,9 @@ btr_search_info_update_slow(
 		btr_search_x_unlock(cursor->index);
 	}
 
-	if (build_index) {
+	if (build_index
+	    && (!btr_search_auto
+		|| !btr_search_build_enqueue(cursor->index, block, false))) {
 		/* Note that since we did not protect block->n_fields etc.
 		with any semaphore, the values can be inconsistent. We have
 		to check inside the function call that they make sense. */
@@ -938,6 +1420,9 @@ btr_search_failure(btr_search_t* info, btr_cur_t* cursor)
 {
 	cursor->flag = BTR_CUR_HASH_FAIL;
 
+	info->n_misses++;
+	info->tune_misses++;
+
 #ifdef UNIV_SEARCH_PERF_STAT
 	++info->n_hash_fail;
 
@@ -986,7 +1471,7 @@ btr_search_guess_on_hash(
 	btr_pcur_t	pcur;
 #endif
 
-	if (!btr_search_enabled) {
+	if (!btr_search_enabled || btr_search_is_disabled(info)) {
 		return(FALSE);
 	}
 
@@ -1156,6 +1641,9 @@ btr_search_guess_on_hash(
 #endif
 	info->last_hash_succ = TRUE;
 
+	info->n_hits++;
+	info->tune_hits++;
+
 #ifdef UNIV_SEARCH_PERF_STAT
 	btr_search_n_succ++;
 #endif
@@ -1363,6 +1851,7 @@ next_rec:
 	info = btr_search_get_info(block->index);
 	ut_a(info->ref_count > 0);
 	info->ref_count--;
+	info->n_rows_removed += n_cached;
 
 	block->index = NULL;
 
@@ -1425,6 +1914,38 @@ btr_search_drop_page_hash_when_freed(
 	mtr_commit(&mtr);
 }
 
+/** Remove the queued hash index builds of the pages of an index. A
+request that the hash index build thread is serving stays counted in
+n_build_pending until the thread is done with it.
+@param[in]	index	index */
+void
+btr_search_build_cancel(
+	const dict_index_t*	index)
+{
+	btr_search_build_queue_t*	queue
+		= btr_search_get_build_queue(index);
+
+	mutex_enter(&queue->mutex);
+
+	for (auto it = queue->reqs.begin(); it != queue->reqs.end();) {
+
+		if (it->index != index) {
+			++it;
+			continue;
+		}
+
+		queue->pages.erase(
+			(uint64_t(it->space_id) << 32) | it->page_no);
+
+		os_atomic_decrement_ulint(
+			&index->search_info->n_build_pending, 1);
+
+		it = queue->reqs.erase(it);
+	}
+
+	mutex_exit(&queue->mutex);
+}
+
 /** Drop any adaptive hash index entries for a table.
 @param[in,out]	table	to drop indexes of this table */
 void
@@ -1436,6 +1957,19 @@ btr_drop_ahi_for_table(dict_table_t* table)
 	return;
 	}
 
+	/* Make sure that the hash index build thread does not build the
+	hash index of a page after it has been dropped here. */
+	for (const dict_index_t* index = table->first_index();
+	     index != nullptr; index = index->next()) {
+
+		btr_search_build_cancel(index);
+
+		while (index->search_info->n_build_pending > 0) {
+			/* Sleep for 10ms before trying again. */
+			os_thread_sleep(10000);
+		}
+	}
+
 	const dict_index_t*	indexes[MAX_INDEXES];
 	static constexpr unsigned DROP_BATCH = 1024;
 
@@ -1698,6 +2232,8 @@ btr_search_build_page_hash_index(
 		ha_insert_for_fold(table, folds[i], block, recs[i]);
 	}
 
+	index->search_info->n_rows_added += n_cached;
+
 	MONITOR_INC(MONITOR_ADAPTIVE_HASH_PAGE_ADDED);
 	MONITOR_INC_VALUE(MONITOR_ADAPTIVE_HASH_ROW_ADDED, n_cached);
 exit_func:
@@ -1834,6 +2370,7 @@ btr_search_update_hash_on_delete(btr_cur_t* cursor)
 		ut_a(block->index == index);
 
 		if (ha_search_and_delete_if_found(table, fold, rec)) {
+			index->search_info->n_rows_removed++;
 			MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_REMOVED);
 		} else {
 			MONITOR_INC(
@@ -1897,6 +2434,7 @@ btr_search_update_hash_node_on_insert(btr_cur_t* cursor)
 		if (ha_search_and_update_if_found(
 			table, cursor->fold, rec, block,
 			page_rec_get_next(rec))) {
+			index->search_info->n_rows_added++;
 			MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_UPDATED);
 		}
 
@@ -2072,10 +2610,79 @@ function_exit:
 		mem_heap_free(heap);
 	}
 	if (locked) {
+		index->search_info->n_rows_added++;
 		btr_search_x_unlock(index);
 	}
 }
 
+/** Add the adaptive hash index statistics of the indexes of a table.
+@param[in]	table	table
+@param[in,out]	stats	statistics of the indexes */
+static
+void
+btr_search_get_table_stats(
+	const dict_table_t*		table,
+	btr_search_index_stats_list_t&	stats)
+{
+	for (const dict_index_t* index = table->first_index();
+	     index != NULL;
+	     index = index->next()) {
+
+		const btr_search_t*	info = index->search_info;
+
+		if (info == NULL
+		    || (info->ref_count == 0 && info->n_hits == 0
+			&& info->n_misses == 0 && info->n_rows_added == 0)) {
+			continue;
+		}
+
+		btr_search_index_stats_t	index_stats;
+
+		index_stats.space_id = index->space;
+		index_stats.index_id = index->id;
+		index_stats.table_name = table->name.m_name;
+		index_stats.index_name = index->name;
+		index_stats.enabled = btr_search_enabled
+			&& !btr_search_is_disabled(info);
+		index_stats.n_pages = info->ref_count;
+		index_stats.n_hits = info->n_hits;
+		index_stats.n_misses = info->n_misses;
+		index_stats.n_rows_added = info->n_rows_added;
+		index_stats.n_rows_removed = info->n_rows_removed;
+		index_stats.n_switches = info->n_switches;
+
+		stats.push_back(index_stats);
+	}
+}
+
+/** Get the effectiveness of the adaptive hash index of the cached indexes
+that have used it.
+@param[out]	stats	statistics of the indexes */
+void
+btr_search_get_index_stats(
+	btr_search_index_stats_list_t&	stats)
+{
+	mutex_enter(&dict_sys->mutex);
+
+	for (const dict_table_t* table
+		     = UT_LIST_GET_FIRST(dict_sys->table_LRU);
+	     table != NULL;
+	     table = UT_LIST_GET_NEXT(table_LRU, table)) {
+
+		btr_search_get_table_stats(table, stats);
+	}
+
+	for (const dict_table_t* table
+		     = UT_LIST_GET_FIRST(dict_sys->table_non_LRU);
+	     table != NULL;
+	     table = UT_LIST_GET_NEXT(table_LRU, table)) {
+
+		btr_search_get_table_stats(table, stats);
+	}
+
+	mutex_exit(&dict_sys->mutex);
+}
+
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
 
 /** Validates the search system for given hash table.
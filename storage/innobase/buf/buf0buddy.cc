@@ -651,7 +651,7 @@ buf_buddy_relocate(
 
 	mutex_enter(&buf_pool->zip_free_mutex);
 
-	if (buf_page_can_relocate(bpage)) {
+	if (buf_page_can_relocate(bpage) && buf_page_freeze(bpage)) {
 		/* Relocate the compressed page. */
 		uintmax_t	usec = ut_time_us(NULL);
 
@@ -660,6 +660,8 @@ buf_buddy_relocate(
 		memcpy(dst, src, size);
 		bpage->zip.data = reinterpret_cast<page_zip_t*>(dst);
 
+		buf_page_unfreeze(bpage);
+
 		rw_lock_x_unlock(hash_lock);
 
 		mutex_exit(block_mutex);
@@ -59,6 +59,7 @@ Created 11/5/1995 Heikki Tuuri
 #include <stdarg.h>
 #include <sys/types.h>
 #include <time.h>
+#include <atomic>
 #include <map>
 #include <new>
 #include <sstream>
@@ -715,6 +716,12 @@ buf_page_print(
 		fputs("InnoDB: Page may be a Rollback Segment Array page\n",
 		      stderr);
 		break;
+	case FIL_PAGE_TYPE_LOB_FIRST:
+	case FIL_PAGE_TYPE_LOB_INDEX:
+	case FIL_PAGE_TYPE_LOB_DATA:
+		fputs("InnoDB: Page may be an indexed LOB page\n",
+		      stderr);
+		break;
 	}
 
 	ut_ad(flags & BUF_PAGE_PRINT_NO_CRASH);
@@ -811,7 +818,7 @@ buf_block_init(
 
 	block->page.buf_pool_index = buf_pool_index(buf_pool);
 	block->page.state = BUF_BLOCK_NOT_USED;
-	block->page.buf_fix_count = 0;
+	block->page.buf_fix_count = BUF_PAGE_FIX_FROZEN;
 	block->page.io_fix = BUF_IO_NONE;
 	block->page.flush_observer = NULL;
 
@@ -1318,6 +1325,28 @@ buf_pool_free_instance(
 	buf_pool->allocator.~ut_allocator();
 }
 
+/** Register the memory of all buffer pool chunks with the asynchronous
+i/o system, so that page i/o can use it as fixed buffers with io_uring. */
+static
+void
+buf_pool_register_aio_buffers()
+{
+	os_aio_buffers_t	areas;
+
+	for (ulint i = 0; i < srv_buf_pool_instances; ++i) {
+		const buf_pool_t*	buf_pool = buf_pool_from_array(i);
+		const buf_chunk_t*	chunk = buf_pool->chunks;
+		const buf_chunk_t*	echunk = chunk + buf_pool->n_chunks;
+
+		for (; chunk < echunk; ++chunk) {
+			areas.push_back(std::make_pair(
+				chunk->mem, ulint(chunk->mem_size())));
+		}
+	}
+
+	os_aio_register_buffers(areas);
+}
+
 /********************************************************************//**
 Creates the buffer pool.
 @return DB_SUCCESS if success, DB_ERROR if not enough memory or error */
@@ -1365,6 +1394,8 @@ buf_pool_init(
 	buf_stat_per_index = UT_NEW(buf_stat_per_index_t(),
 				    mem_key_buf_stat_per_index_t);
 
+	buf_pool_register_aio_buffers();
+
 	return(DB_SUCCESS);
 }
 
@@ -1416,9 +1447,14 @@ buf_page_realloc(
 	rw_lock_x_lock(hash_lock);
 	mutex_enter(&block->mutex);
 
-	if (buf_page_can_relocate(&block->page)) {
+	if (buf_page_can_relocate(&block->page)
+	    && buf_page_freeze(&block->page)) {
 		mutex_enter(&new_block->mutex);
 
+		/* Both blocks are frozen, so that the copy of
+		buf_fix_count cannot lose a buffer-fix. */
+		ut_ad(new_block->page.buf_fix_count == BUF_PAGE_FIX_FROZEN);
+
 		memcpy(new_block->frame, block->frame, UNIV_PAGE_SIZE);
 		memcpy(&new_block->page, &block->page, sizeof block->page);
 
@@ -1510,6 +1546,8 @@ buf_page_realloc(
 			new_block->page.id.space(),
 			new_block->page.id.page_no()));
 
+		buf_page_unfreeze(&new_block->page);
+
 		rw_lock_x_unlock(hash_lock);
 		mutex_exit(&block->mutex);
 		mutex_exit(&new_block->mutex);
@@ -1930,6 +1968,47 @@ buf_pool_resize_chunk_make_null(buf_chunk_t** new_chunks)
 }
 #endif /* UNIV_DEBUG */
 
+/** Number of counters of buf_page_hash_get_optimistic() calls in
+progress */
+static const ulint	BUF_PAGE_HASH_OPTIMISTIC_N_GUARDS = 64;
+
+/** A counter of buf_page_hash_get_optimistic() calls in progress.
+buf_pool_resize() waits for all of them to drop to zero before it frees
+any chunk or page_hash. The lookups are spread over the counters by page,
+so that they do not all modify the same cache line. */
+struct buf_page_hash_guard_t {
+	/** number of lookups in progress */
+	std::atomic<ulint>	n_active;
+
+	/** padding to keep the counters on different cache lines */
+	char			pad[CACHE_LINE_SIZE - sizeof(std::atomic<ulint>)];
+};
+
+/** Counters of buf_page_hash_get_optimistic() calls in progress */
+static buf_page_hash_guard_t
+	buf_page_hash_guards[BUF_PAGE_HASH_OPTIMISTIC_N_GUARDS];
+
+/** Wait for the buf_page_hash_get_optimistic() calls that started before
+buf_pool_resizing was set. The calls that start later see the flag and
+fall back to the latched lookup, so the chunks and page_hash can be
+freed afterwards. */
+static
+void
+buf_page_hash_optimistic_wait()
+{
+	ut_ad(buf_pool_resizing);
+
+	/* Pairs with the fence in buf_page_hash_get_optimistic(): either
+	the lookup sees buf_pool_resizing, or we see its counter. */
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	for (auto& guard : buf_page_hash_guards) {
+		while (guard.n_active.load(std::memory_order_acquire) != 0) {
+			os_thread_yield();
+		}
+	}
+}
+
 /** Resize the buffer pool based on srv_buf_pool_size from
 srv_buf_pool_old_size. */
 static
@@ -2128,6 +2207,13 @@ withdraw_retry:
 	/* Indicate critical path */
 	buf_pool_resizing = true;
 
+	/* Chunks and page_hash may be freed from now on. */
+	buf_page_hash_optimistic_wait();
+
+	/* Stop using the chunks as fixed buffers for page i/o before
+	any of them is freed or a new one is allocated. */
+	os_aio_register_buffers(os_aio_buffers_t());
+
 	/* Acquire all buffer pool mutexes and hash table locks */
 	/* TODO: while we certainly lock a lot here, it does not necessarily
 	buy us enough correctness. Exploits the fact that freed pages must
@@ -2403,6 +2489,8 @@ calc_buf_pool_size:
 		os_wmb;
 	}
 
+	buf_pool_register_aio_buffers();
+
 	/* enable AHI if needed */
 	if (btr_search_disabled) {
 		btr_search_enable();
@@ -2529,7 +2617,8 @@ buf_relocate(
 	ut_ad(buf_page_hash_lock_held_x(buf_pool, bpage));
 	ut_ad(mutex_own(buf_page_get_mutex(bpage)));
 	ut_a(buf_page_get_io_fix(bpage) == BUF_IO_NONE);
-	ut_a(bpage->buf_fix_count == 0);
+	ut_a(bpage->buf_fix_count == BUF_PAGE_FIX_FROZEN);
+	ut_ad(dpage->buf_fix_count == BUF_PAGE_FIX_FROZEN);
 	ut_ad(bpage->in_LRU_list);
 	ut_ad(!bpage->in_zip_hash);
 	ut_ad(bpage->in_page_hash);
@@ -2927,6 +3016,8 @@ buf_page_make_young(
 /** Moves a page to the start of the buffer pool LRU list if it is too old.
 This high-level function can be used to prevent an important page from
 slipping out of the buffer pool. The page must be fixed to the buffer pool.
+Unless innodb_lru_access_batch=1, the page is moved later, together with
+other pages that the thread accessed.
 @param[in,out]	bpage	buffer block of a file page */
 static
 void
@@ -2937,7 +3028,11 @@ buf_page_make_young_if_needed(
 	ut_ad(bpage->buf_fix_count > 0);
 	ut_a(buf_page_in_file(bpage));
 
-	if (buf_page_peek_if_too_old(bpage)) {
+	if (!buf_page_peek_if_too_old(bpage)) {
+		/* Nothing to do */
+	} else if (srv_LRU_access_batch > 1) {
+		buf_LRU_make_block_young_deferred(bpage->id);
+	} else {
 		buf_page_make_young(bpage);
 	}
 }
@@ -3368,6 +3463,119 @@ buf_block_is_uncompressed(
 	return(buf_pointer_is_block_field_instance(buf_pool, (void*) block));
 }
 
+/** Maximum number of page_hash chain nodes that
+buf_page_hash_get_optimistic() looks at */
+static const ulint	BUF_PAGE_HASH_OPTIMISTIC_STEPS = 8;
+
+/** Buffer-fixes a page without acquiring the page_hash latch or the
+block mutex. The caller must have made sure that buf_pool_resize()
+cannot free the chunks or page_hash while we look at them.
+@param[in]	buf_pool	buffer pool instance
+@param[in]	page_id		page id
+@param[in]	guess		guessed block or NULL
+@return the buffer-fixed block, or NULL if the caller must look up the
+page while holding the page_hash latch */
+static
+buf_block_t*
+buf_page_hash_get_optimistic_low(
+	buf_pool_t*		buf_pool,
+	const page_id_t&	page_id,
+	buf_block_t*		guess)
+{
+	buf_block_t*	block = NULL;
+
+	if (guess != NULL
+	    && buf_block_is_uncompressed(buf_pool, guess)
+	    && page_id.equals_to(guess->page.id)) {
+
+		block = guess;
+	} else {
+		hash_table_t*	page_hash = buf_pool->page_hash;
+		buf_page_t*	bpage = static_cast<buf_page_t*>(
+			hash_get_nth_cell(
+				page_hash,
+				hash_calc_hash(page_id.fold(), page_hash))
+			->node);
+
+		for (ulint n = 0; bpage != NULL; n++) {
+
+			if (n == BUF_PAGE_HASH_OPTIMISTIC_STEPS
+			    || !buf_block_is_uncompressed(
+				    buf_pool,
+				    reinterpret_cast<buf_block_t*>(bpage))) {
+
+				return(NULL);
+			}
+
+			if (page_id.equals_to(bpage->id)) {
+				block = reinterpret_cast<buf_block_t*>(bpage);
+				break;
+			}
+
+			bpage = bpage->hash;
+		}
+	}
+
+	if (block == NULL
+	    || buf_block_get_state(block) != BUF_BLOCK_FILE_PAGE
+	    || !buf_block_fix_if_not_frozen(&block->page)) {
+
+		return(NULL);
+	}
+
+	/* The block may have been evicted and reused for another page
+	before we buffer-fixed it. */
+	if (buf_block_get_state(block) != BUF_BLOCK_FILE_PAGE
+	    || !page_id.equals_to(block->page.id)) {
+
+		buf_block_unfix(block);
+		return(NULL);
+	}
+
+	return(block);
+}
+
+/** Buffer-fixes a page without acquiring the page_hash latch or the
+block mutex. The lookup can only succeed for an uncompressed page:
+compressed-only page descriptors and watch sentinels may be freed while
+we look at them, but buf_block_t objects only go away in
+buf_pool_resize(), which waits for the lookups in progress before it
+frees any chunk. A block cannot be evicted or relocated while it is
+buffer-fixed, and buf_page_freeze() makes sure that we cannot buffer-fix
+a block that is being removed from page_hash. Whatever the chain looked
+like, the block is validated once it has been buffer-fixed.
+@param[in]	buf_pool	buffer pool instance
+@param[in]	page_id		page id
+@param[in]	guess		guessed block or NULL
+@return the buffer-fixed block, or NULL if the caller must look up the
+page while holding the page_hash latch */
+static
+buf_block_t*
+buf_page_hash_get_optimistic(
+	buf_pool_t*		buf_pool,
+	const page_id_t&	page_id,
+	buf_block_t*		guess)
+{
+	buf_page_hash_guard_t&	guard = buf_page_hash_guards[
+		page_id.fold() % BUF_PAGE_HASH_OPTIMISTIC_N_GUARDS];
+
+	guard.n_active.fetch_add(1, std::memory_order_relaxed);
+
+	/* Pairs with the fence in buf_page_hash_optimistic_wait(). */
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	buf_block_t*	block = NULL;
+
+	if (!buf_pool_resizing && !buf_pool_withdrawing) {
+		block = buf_page_hash_get_optimistic_low(
+			buf_pool, page_id, guess);
+	}
+
+	guard.n_active.fetch_sub(1, std::memory_order_release);
+
+	return(block);
+}
+
 #if defined UNIV_DEBUG || defined UNIV_IBUF_DEBUG
 /********************************************************************//**
 Return true if probe is enabled.
@@ -3488,6 +3696,17 @@ buf_page_get_gen(
 
 	buf_pool->stat.n_page_gets++;
 	hash_lock = buf_page_hash_lock_get(buf_pool, page_id);
+
+	/* The temporary tablespace buffer-fixes pages under the block
+	mutex, see below. */
+	if (!fsp_is_system_temporary(page_id.space())) {
+		block = buf_page_hash_get_optimistic(buf_pool, page_id, guess);
+
+		if (block != NULL) {
+			fix_block = block;
+			goto got_block;
+		}
+	}
 loop:
 	block = guess;
 
@@ -3732,8 +3951,8 @@ got_block:
 
 		fix_block = block;
 
-		if (bpage->buf_fix_count > 0
-		    || buf_page_get_io_fix(bpage) != BUF_IO_NONE) {
+		if (buf_page_get_io_fix(bpage) != BUF_IO_NONE
+		    || !buf_page_freeze(bpage)) {
 
 			mutex_exit(&buf_pool->zip_mutex);
 			/* The block was buffer-fixed or I/O-fixed while
@@ -3761,8 +3980,9 @@ got_block:
 
 		buf_block_init_low(block);
 
-		/* Set after buf_relocate(). */
-		block->page.buf_fix_count = 1;
+		/* Set after buf_relocate(). The block stays frozen
+		until it is I/O-fixed and X-latched below. */
+		block->page.buf_fix_count = BUF_PAGE_FIX_FROZEN + 1;
 
 		block->lock_hash_val = lock_rec_hash(page_id.space(),
 						     page_id.page_no());
@@ -3793,6 +4013,8 @@ got_block:
 		buf_block_set_io_fix(block, BUF_IO_READ);
 		rw_lock_x_lock_inline(&block->lock, 0, file, line);
 
+		buf_page_unfreeze(&block->page);
+
 		UNIV_MEM_INVALID(bpage, sizeof *bpage);
 
 		rw_lock_x_unlock(hash_lock);
@@ -4371,7 +4593,6 @@ buf_page_init_low(
 {
 	bpage->flush_type = BUF_FLUSH_LRU;
 	bpage->io_fix = BUF_IO_NONE;
-	bpage->buf_fix_count = 0;
 	bpage->freed_page_clock = 0;
 	bpage->access_time = 0;
 	bpage->newest_modification = 0;
@@ -4424,6 +4645,10 @@ buf_page_init(
 
 	buf_page_init_low(&block->page);
 
+	/* The caller must call buf_page_unfreeze() once the block is
+	ready to be buffer-fixed by buf_page_hash_get_optimistic(). */
+	ut_ad(block->page.buf_fix_count == BUF_PAGE_FIX_FROZEN);
+
 	/* Insert into the hash table of file pages */
 
 	hash_page = buf_page_hash_get_low(buf_pool, page_id);
@@ -4617,6 +4842,8 @@ buf_page_init_for_read(
 
 		rw_lock_x_lock_gen(&block->lock, BUF_IO_READ);
 
+		buf_page_unfreeze(bpage);
+
 		rw_lock_x_unlock(hash_lock);
 
 		buf_page_mutex_exit(block);
@@ -4636,6 +4863,7 @@ buf_page_init_for_read(
 		UNIV_MEM_DESC(bpage->zip.data, bpage->size.physical());
 
 		buf_page_init_low(bpage);
+		bpage->buf_fix_count = 0;
 
 		bpage->state = BUF_BLOCK_ZIP_PAGE;
 		bpage->id.copy_from(page_id);
@@ -4760,6 +4988,8 @@ buf_page_create(
 
 	buf_page_init(buf_pool, page_id, page_size, block);
 
+	buf_page_unfreeze(&block->page);
+
 	rw_lock_x_unlock(hash_lock);
 
 	/* The block must be put to the LRU list */
@@ -4945,6 +5175,9 @@ buf_page_monitor(
 		break;
 
 	case FIL_PAGE_TYPE_BLOB:
+	case FIL_PAGE_TYPE_LOB_FIRST:
+	case FIL_PAGE_TYPE_LOB_INDEX:
+	case FIL_PAGE_TYPE_LOB_DATA:
 		counter = MONITOR_RW_COUNTER(io_type, MONITOR_BLOB_PAGE);
 		break;
 
@@ -4988,7 +5221,10 @@ buf_read_page_handle_error(
 	mutex_enter(buf_page_get_mutex(bpage));
 
 	ut_ad(buf_page_get_io_fix(bpage) == BUF_IO_READ);
-	ut_ad(bpage->buf_fix_count == 0);
+
+	/* Freeze the block before it stops being I/O-fixed, so that
+	buf_page_hash_get_optimistic() cannot buffer-fix it. */
+	ut_a(buf_page_freeze(bpage));
 
 	/* Set BUF_IO_NONE before we remove the block from LRU list */
 	buf_page_set_io_fix(bpage, BUF_IO_NONE);
@@ -5796,7 +6032,7 @@ buf_get_latched_pages_number_instance(
 				continue;
 			}
 
-			if (block->page.buf_fix_count != 0
+			if (buf_page_get_fix_count(&block->page) != 0
 			    || buf_page_get_io_fix_unlocked(&block->page)
 			    != BUF_IO_NONE) {
 				fixed_pages_number++;
@@ -5815,7 +6051,7 @@ buf_get_latched_pages_number_instance(
 		ut_a(buf_page_get_state(b) == BUF_BLOCK_ZIP_PAGE);
 		ut_a(buf_page_get_io_fix(b) != BUF_IO_WRITE);
 
-		if (b->buf_fix_count != 0
+		if (buf_page_get_fix_count(b) != 0
 		    || buf_page_get_io_fix(b) != BUF_IO_NONE) {
 			fixed_pages_number++;
 		}
@@ -5828,7 +6064,7 @@ buf_get_latched_pages_number_instance(
 
 		switch (buf_page_get_state(b)) {
 		case BUF_BLOCK_ZIP_DIRTY:
-			if (b->buf_fix_count != 0
+			if (buf_page_get_fix_count(b) != 0
 			    || buf_page_get_io_fix(b) != BUF_IO_NONE) {
 				fixed_pages_number++;
 			}
@@ -24,6 +24,7 @@ Created 2011/12/19
 *******************************************************/
 
 #include <sys/types.h>
+#include <unordered_map>
 
 #include "buf0buf.h"
 #include "buf0checksum.h"
@@ -44,6 +45,10 @@ buf_dblwr_t*	buf_dblwr = NULL;
 /** Set to TRUE when the doublewrite buffer is being created */
 ibool	buf_dblwr_being_created = FALSE;
 
+/** Number of pages in a doublewrite file, the same as in the doublewrite
+buffer of the system tablespace */
+#define BUF_DBLWR_SHARD_PAGES	(2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
+
 /****************************************************************//**
 Determines if a page number is located inside the doublewrite buffer.
 @return TRUE if the location is inside the two blocks of the
@@ -113,54 +118,204 @@ buf_dblwr_sync_datafiles()
 	fil_flush_file_spaces(to_int(FIL_TYPE_TABLESPACE));
 }
 
-/****************************************************************//**
-Creates or initialializes the doublewrite buffer at a database start. */
+/** Build the path of a doublewrite file. The files are created in the
+InnoDB data home directory (innodb_data_home_dir), or in the MySQL data
+directory if it is not set.
+@param[in]	i	number of the file
+@return path of the file, to be freed with ut_free() */
+static
+char*
+buf_dblwr_file_name(
+	ulint	i)
+{
+	char		name[OS_FILE_MAX_PATH];
+	const char*	dir = srv_data_home;
+
+	if (strcmp(dir, "") == 0) {
+		dir = fil_path_to_mysql_datadir;
+	}
+
+	snprintf(name, sizeof(name), "%s%c#ib_" ULINTPF "_" ULINTPF ".dblwr",
+		 dir, OS_PATH_SEPARATOR, static_cast<ulint>(UNIV_PAGE_SIZE), i);
+
+	return(mem_strdup(name));
+}
+
+/** Get the doublewrite shard that a buffer pool instance uses for a
+flush type. The LRU and flush_list batches of each instance have their
+own file when there are enough of them. Single page flushes are done
+from the LRU list and use the single page slots of the LRU shard.
+@param[in]	buf_pool	buffer pool instance
+@param[in]	flush_type	flush type
+@return doublewrite shard */
+static
+buf_dblwr_shard_t*
+buf_dblwr_get_shard(
+	const buf_pool_t*	buf_pool,
+	buf_flush_t		flush_type)
+{
+	ulint	i = buf_pool->instance_no * 2;
+
+	if (flush_type != BUF_FLUSH_LIST) {
+		++i;
+	}
+
+	return(&buf_dblwr->shards[i % buf_dblwr->n_shards]);
+}
+
+/** Open or create the file of a doublewrite shard and extend it to its
+full size.
+@param[in,out]	shard	doublewrite shard
+@return true if successful */
+static
+bool
+buf_dblwr_shard_open(
+	buf_dblwr_shard_t*	shard)
+{
+	bool		exists;
+	bool		success;
+	os_file_type_t	type;
+	os_offset_t	size = BUF_DBLWR_SHARD_PAGES * UNIV_PAGE_SIZE;
+
+	if (!os_file_status(shard->name, &exists, &type)) {
+		return(false);
+	}
+
+	shard->file = os_file_create(
+		innodb_data_file_key, shard->name,
+		(exists ? OS_FILE_OPEN : OS_FILE_CREATE)
+		| OS_FILE_ON_ERROR_NO_EXIT,
+		OS_FILE_NORMAL, OS_DATA_FILE, srv_read_only_mode, &success);
+
+	if (!success) {
+		ib::error() << "Cannot open doublewrite file " << shard->name;
+		shard->file.m_file = OS_FILE_CLOSED;
+		return(false);
+	}
+
+	if (!exists || os_file_get_size(shard->file) < size) {
+
+		if (!os_file_set_size(shard->name, shard->file, size,
+				      srv_read_only_mode)) {
+
+			ib::error() << "Cannot set the size of doublewrite"
+				" file " << shard->name << " to " << size
+				<< " bytes";
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/** Free a doublewrite shard.
+@param[in,out]	shard	doublewrite shard */
 static
 void
+buf_dblwr_shard_free(
+	buf_dblwr_shard_t*	shard)
+{
+	ut_ad(shard->s_reserved == 0);
+	ut_ad(shard->b_reserved == 0);
+
+	if (shard->file.m_file != OS_FILE_CLOSED) {
+		os_file_close(shard->file);
+		shard->file.m_file = OS_FILE_CLOSED;
+	}
+
+	os_event_destroy(shard->b_event);
+	os_event_destroy(shard->s_event);
+
+	ut_free(shard->write_buf_unaligned);
+	ut_free(shard->buf_block_arr);
+	ut_free(shard->in_use);
+	ut_free(shard->name);
+
+	mutex_free(&shard->mutex);
+}
+
+/****************************************************************//**
+Creates or initialializes the doublewrite buffer at a database start.
+The doublewrite files are opened, or created if they do not exist, unless
+InnoDB is read-only or the doublewrite buffer is disabled.
+@return true if successful */
+static
+bool
 buf_dblwr_init(
 /*===========*/
 	byte*	doublewrite)	/*!< in: pointer to the doublewrite buf
 				header on trx sys page */
 {
 	ulint	buf_size;
+	ulint	n_shards;
 
 	buf_dblwr = static_cast<buf_dblwr_t*>(
 		ut_zalloc_nokey(sizeof(buf_dblwr_t)));
 
-	/* There are two blocks of same size in the doublewrite
-	buffer. */
-	buf_size = 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
+	/* Each doublewrite file is as large as the two blocks of the
+	doublewrite buffer in the system tablespace. */
+	buf_size = BUF_DBLWR_SHARD_PAGES;
 
 	/* There must be atleast one buffer for single page writes
 	and one buffer for batch writes. */
 	ut_a(srv_doublewrite_batch_size > 0
 	     && srv_doublewrite_batch_size < buf_size);
 
-	mutex_create(LATCH_ID_BUF_DBLWR, &buf_dblwr->mutex);
-
-	buf_dblwr->b_event = os_event_create("dblwr_batch_event");
-	buf_dblwr->s_event = os_event_create("dblwr_single_event");
-	buf_dblwr->first_free = 0;
-	buf_dblwr->s_reserved = 0;
-	buf_dblwr->b_reserved = 0;
-
 	buf_dblwr->block1 = mach_read_from_4(
 		doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK1);
 	buf_dblwr->block2 = mach_read_from_4(
 		doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK2);
 
-	buf_dblwr->in_use = static_cast<bool*>(
-		ut_zalloc_nokey(buf_size * sizeof(bool)));
+	/* By default every buffer pool instance gets one file for
+	flush_list and one for LRU flushing. */
+	n_shards = srv_doublewrite_files;
+
+	if (n_shards == 0 || n_shards > 2 * srv_buf_pool_instances) {
+		n_shards = 2 * srv_buf_pool_instances;
+	}
+
+	buf_dblwr->n_shards = n_shards;
 
-	buf_dblwr->write_buf_unaligned = static_cast<byte*>(
-		ut_malloc_nokey((1 + buf_size) * UNIV_PAGE_SIZE));
+	buf_dblwr->shards = static_cast<buf_dblwr_shard_t*>(
+		ut_zalloc_nokey(n_shards * sizeof(buf_dblwr_shard_t)));
 
-	buf_dblwr->write_buf = static_cast<byte*>(
-		ut_align(buf_dblwr->write_buf_unaligned,
-			 UNIV_PAGE_SIZE));
+	bool	success = true;
 
-	buf_dblwr->buf_block_arr = static_cast<buf_page_t**>(
-		ut_zalloc_nokey(buf_size * sizeof(void*)));
+	for (ulint i = 0; i < n_shards; ++i) {
+		buf_dblwr_shard_t*	shard = &buf_dblwr->shards[i];
+
+		mutex_create(LATCH_ID_BUF_DBLWR, &shard->mutex);
+
+		shard->name = buf_dblwr_file_name(i);
+		shard->file.m_file = OS_FILE_CLOSED;
+
+		shard->b_event = os_event_create("dblwr_batch_event");
+		shard->s_event = os_event_create("dblwr_single_event");
+		shard->first_free = 0;
+		shard->s_reserved = 0;
+		shard->b_reserved = 0;
+
+		shard->in_use = static_cast<bool*>(
+			ut_zalloc_nokey(buf_size * sizeof(bool)));
+
+		shard->write_buf_unaligned = static_cast<byte*>(
+			ut_malloc_nokey((1 + buf_size) * UNIV_PAGE_SIZE));
+
+		shard->write_buf = static_cast<byte*>(
+			ut_align(shard->write_buf_unaligned,
+				 UNIV_PAGE_SIZE));
+
+		shard->buf_block_arr = static_cast<buf_page_t**>(
+			ut_zalloc_nokey(buf_size * sizeof(void*)));
+
+		if (success && !srv_read_only_mode
+		    && srv_use_doublewrite_buf) {
+
+			success = buf_dblwr_shard_open(shard);
+		}
+	}
+
+	return(success);
 }
 
 /****************************************************************//**
@@ -202,11 +357,16 @@ start_again:
 		/* The doublewrite buffer has already been created:
 		just read in some numbers */
 
-		buf_dblwr_init(doublewrite);
+		bool	success = buf_dblwr_init(doublewrite);
 
 		mtr_commit(&mtr);
 		buf_dblwr_being_created = FALSE;
-		return(true);
+
+		if (!success) {
+			buf_dblwr_free();
+		}
+
+		return(success);
 	}
 
 	ib::info() << "Doublewrite buffer not found: creating new";
@@ -341,12 +501,118 @@ start_again:
 	goto start_again;
 }
 
+/** Count the doublewrite files that exist. The files are numbered from 0
+and the numbering has no gaps, but there may be more or fewer of them than
+innodb_doublewrite_files if the setting was changed.
+@return number of doublewrite files */
+static
+ulint
+buf_dblwr_count_files()
+{
+	ulint	n_files;
+
+	for (n_files = 0;; ++n_files) {
+		bool		exists;
+		os_file_type_t	type;
+		char*		name = buf_dblwr_file_name(n_files);
+
+		if (!os_file_status(name, &exists, &type)) {
+			exists = false;
+		}
+
+		ut_free(name);
+
+		if (!exists) {
+			break;
+		}
+	}
+
+	return(n_files);
+}
+
+/** Read the pages of the doublewrite files to memory and add them to the
+pages that crash recovery restores torn pages from.
+@param[in]	n_files	number of doublewrite files
+@param[out]	buf	buffer for n_files * BUF_DBLWR_SHARD_PAGES pages
+@return DB_SUCCESS or error code */
+static
+dberr_t
+buf_dblwr_load_files(
+	ulint	n_files,
+	byte*	buf)
+{
+	IORequest	read_request(IORequest::READ);
+
+	read_request.disable_compression();
+
+	for (ulint i = 0; i < n_files; ++i) {
+		bool		success;
+		char*		name = buf_dblwr_file_name(i);
+		pfs_os_file_t	file;
+
+		file = os_file_create_simple_no_error_handling(
+			innodb_data_file_key, name, OS_FILE_OPEN,
+			OS_FILE_READ_ONLY, true, &success);
+
+		if (!success) {
+			ib::error() << "Cannot open doublewrite file " << name;
+			ut_free(name);
+			return(DB_ERROR);
+		}
+
+		/* A file whose creation was interrupted can be short. */
+		os_offset_t	size = os_file_get_size(file);
+		os_offset_t	max_size = BUF_DBLWR_SHARD_PAGES
+			* UNIV_PAGE_SIZE;
+
+		if (size == static_cast<os_offset_t>(-1)) {
+			size = 0;
+		}
+
+		size = ut_calc_align_down(
+			std::min(size, max_size), UNIV_PAGE_SIZE);
+
+		dberr_t	err = DB_SUCCESS;
+
+		if (size > 0) {
+			err = os_file_read(
+				read_request, file, buf, 0,
+				static_cast<ulint>(size));
+		}
+
+		os_file_close(file);
+
+		if (err != DB_SUCCESS) {
+			ib::error() << "Failed to read doublewrite file "
+				<< name;
+			ut_free(name);
+			return(err);
+		}
+
+		ut_free(name);
+
+		/* Slots that were never written to are all zeroes. */
+		for (byte* page = buf; page < buf + size;
+		     page += UNIV_PAGE_SIZE) {
+
+			if (!buf_page_is_zeroes(page, univ_page_size)) {
+				recv_sys->dblwr.add(page);
+			}
+		}
+
+		buf += max_size;
+	}
+
+	return(DB_SUCCESS);
+}
+
 /**
 At database startup initializes the doublewrite buffer memory structure if
 we already have a doublewrite buffer created in the data files. If we are
 upgrading to an InnoDB version which supports multiple tablespaces, then this
 function performs the necessary update operations. If we are in a crash
-recovery, this function loads the pages from double write buffer into memory.
+recovery, this function loads the pages from double write buffer and from
+the doublewrite files into memory.
 @param[in]	file		File handle
 @param[in]	path		Path name of file
 @return DB_SUCCESS or error code */
@@ -363,6 +629,8 @@ buf_dblwr_init_or_load_pages(
 	byte*		read_buf;
 	byte*		doublewrite;
 	byte*		unaligned_read_buf;
+	byte*		unaligned_buf;
+	ulint		n_files;
 	ibool		reset_space_ids = FALSE;
 	recv_dblwr_t&	recv_dblwr = recv_sys->dblwr;
 
@@ -400,20 +668,28 @@ buf_dblwr_init_or_load_pages(
 	doublewrite = read_buf + TRX_SYS_DOUBLEWRITE;
 
 	if (mach_read_from_4(doublewrite + TRX_SYS_DOUBLEWRITE_MAGIC)
-	    == TRX_SYS_DOUBLEWRITE_MAGIC_N) {
-		/* The doublewrite buffer has been created */
+	    != TRX_SYS_DOUBLEWRITE_MAGIC_N) {
 
-		buf_dblwr_init(doublewrite);
-
-		block1 = buf_dblwr->block1;
-		block2 = buf_dblwr->block2;
-
-		buf = buf_dblwr->write_buf;
-	} else {
 		ut_free(unaligned_read_buf);
 		return(DB_SUCCESS);
 	}
 
+	/* The doublewrite buffer has been created. Read its pages and
+	the pages of the doublewrite files before the files are opened
+	for writing. The pages are kept in memory until
+	buf_dblwr_free_recovery_pages(). */
+
+	block1 = mach_read_from_4(doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK1);
+	block2 = mach_read_from_4(doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK2);
+
+	n_files = srv_read_only_mode ? 0 : buf_dblwr_count_files();
+
+	unaligned_buf = static_cast<byte*>(
+		ut_malloc_nokey((1 + (1 + n_files) * BUF_DBLWR_SHARD_PAGES)
+				* UNIV_PAGE_SIZE));
+
+	buf = static_cast<byte*>(ut_align(unaligned_buf, UNIV_PAGE_SIZE));
+
 	if (mach_read_from_4(doublewrite + TRX_SYS_DOUBLEWRITE_SPACE_ID_STORED)
 	    != TRX_SYS_DOUBLEWRITE_SPACE_ID_STORED_N) {
 
@@ -440,6 +716,7 @@ buf_dblwr_init_or_load_pages(
 			<< "Failed to read the first double write buffer "
 			"extent";
 
+		ut_free(unaligned_buf);
 		ut_free(unaligned_read_buf);
 
 		return(err);
@@ -458,6 +735,7 @@ buf_dblwr_init_or_load_pages(
 			<< "Failed to read the second double write buffer "
 			"extent";
 
+		ut_free(unaligned_buf);
 		ut_free(unaligned_read_buf);
 
 		return(err);
@@ -504,6 +782,7 @@ buf_dblwr_init_or_load_pages(
 					<< "Failed to write to the double write"
 					" buffer";
 
+				ut_free(unaligned_buf);
 				ut_free(unaligned_read_buf);
 
 				return(err);
@@ -521,6 +800,27 @@ buf_dblwr_init_or_load_pages(
 		os_file_flush(file);
 	}
 
+	err = buf_dblwr_load_files(
+		n_files, buf + BUF_DBLWR_SHARD_PAGES * UNIV_PAGE_SIZE);
+
+	if (err == DB_SUCCESS && !buf_dblwr_init(doublewrite)) {
+		err = DB_ERROR;
+	}
+
+	if (err != DB_SUCCESS) {
+		recv_dblwr.pages.clear();
+		ut_free(unaligned_buf);
+		ut_free(unaligned_read_buf);
+
+		if (buf_dblwr != NULL) {
+			buf_dblwr_free();
+		}
+
+		return(err);
+	}
+
+	buf_dblwr->recv_buf_unaligned = unaligned_buf;
+
 	ut_free(unaligned_read_buf);
 
 	return(DB_SUCCESS);
@@ -675,6 +975,18 @@ buf_dblwr_recover_page(
 	ut_free(ptr);
 }
 
+/** Get the key of a page in the doublewrite buffer.
+@param[in]	page	page frame
+@return tablespace id and page number of the page */
+static
+uint64_t
+buf_dblwr_page_key(
+	const byte*	page)
+{
+	return(uint64_t(page_get_space_id(page)) << 32
+	       | page_get_page_no(page));
+}
+
 /** Process and remove the double write buffer pages for all tablespaces. */
 void
 buf_dblwr_process()
@@ -682,6 +994,30 @@ buf_dblwr_process()
 	page_no_t		page_no_dblwr	= 0;
 	recv_dblwr_t&		dblwr	= recv_sys->dblwr;
 
+	ut_ad(dblwr.deferred.empty());
+
+	/* A page can have copies in several doublewrite files. Find the
+	newest copy of each page, so that only that one is restored. */
+	using Newest = std::unordered_map<
+		uint64_t, const byte*, std::hash<uint64_t>,
+		std::equal_to<uint64_t>,
+		ut_allocator<std::pair<const uint64_t, const byte*>>>;
+
+	Newest	newest;
+
+	for (auto page : dblwr.pages) {
+
+		uint64_t	key = buf_dblwr_page_key(page);
+		auto		it = newest.find(key);
+
+		if (it == newest.end()) {
+			newest.insert(Newest::value_type(key, page));
+		} else if (mach_read_from_8(page + FIL_PAGE_LSN)
+			   > mach_read_from_8(it->second + FIL_PAGE_LSN)) {
+			it->second = page;
+		}
+	}
+
 	for (auto i = dblwr.pages.begin();
 	     i != dblwr.pages.end();
 	     ++i, ++page_no_dblwr) {
@@ -690,6 +1026,10 @@ buf_dblwr_process()
 		page_no_t	page_no		= page_get_page_no(page);
 		space_id_t	space_id	= page_get_space_id(page);
 
+		if (newest[buf_dblwr_page_key(page)] != page) {
+			continue;
+		}
+
 		fil_space_t*	space = fil_space_get(space_id);
 
 		if (space == nullptr) {
@@ -707,11 +1047,24 @@ buf_dblwr_process()
 		}
 	}
 
-	dblwr.pages.clear();
+	buf_dblwr_free_recovery_pages();
 
 	fil_flush_file_spaces(to_int(FIL_TYPE_TABLESPACE));
 }
 
+/** Free the pages that were read from the doublewrite buffer and files at
+startup, once crash recovery no longer needs them. */
+void
+buf_dblwr_free_recovery_pages()
+{
+	recv_sys->dblwr.pages.clear();
+
+	if (buf_dblwr != NULL) {
+		ut_free(buf_dblwr->recv_buf_unaligned);
+		buf_dblwr->recv_buf_unaligned = NULL;
+	}
+}
+
 /** Recover pages from the double write buffer for a specific tablespace.
 The pages that were read from the doublewrite buffer are written to the
 tablespace they belong to.
@@ -755,21 +1108,12 @@ buf_dblwr_free(void)
 /*================*/
 {
 	/* Free the double write data structures. */
-	ut_ad(buf_dblwr->s_reserved == 0);
-	ut_ad(buf_dblwr->b_reserved == 0);
-
-	os_event_destroy(buf_dblwr->b_event);
-	os_event_destroy(buf_dblwr->s_event);
-	ut_free(buf_dblwr->write_buf_unaligned);
-	buf_dblwr->write_buf_unaligned = NULL;
-
-	ut_free(buf_dblwr->buf_block_arr);
-	buf_dblwr->buf_block_arr = NULL;
-
-	ut_free(buf_dblwr->in_use);
-	buf_dblwr->in_use = NULL;
+	for (ulint i = 0; i < buf_dblwr->n_shards; ++i) {
+		buf_dblwr_shard_free(&buf_dblwr->shards[i]);
+	}
 
-	mutex_free(&buf_dblwr->mutex);
+	ut_free(buf_dblwr->shards);
+	ut_free(buf_dblwr->recv_buf_unaligned);
 	ut_free(buf_dblwr);
 	buf_dblwr = NULL;
 }
@@ -790,42 +1134,45 @@ buf_dblwr_update(
 
 	ut_ad(!srv_read_only_mode);
 
+	buf_dblwr_shard_t*	shard = buf_dblwr_get_shard(
+		buf_pool_from_bpage(bpage), flush_type);
+
 	switch (flush_type) {
 	case BUF_FLUSH_LIST:
 	case BUF_FLUSH_LRU:
-		mutex_enter(&buf_dblwr->mutex);
+		mutex_enter(&shard->mutex);
 
-		ut_ad(buf_dblwr->batch_running);
-		ut_ad(buf_dblwr->b_reserved > 0);
-		ut_ad(buf_dblwr->b_reserved <= buf_dblwr->first_free);
+		ut_ad(shard->batch_running);
+		ut_ad(shard->b_reserved > 0);
+		ut_ad(shard->b_reserved <= shard->first_free);
 
-		buf_dblwr->b_reserved--;
+		shard->b_reserved--;
 
-		if (buf_dblwr->b_reserved == 0) {
-			mutex_exit(&buf_dblwr->mutex);
+		if (shard->b_reserved == 0) {
+			mutex_exit(&shard->mutex);
 			/* This will finish the batch. Sync data files
 			to the disk. */
 			fil_flush_file_spaces(to_int(FIL_TYPE_TABLESPACE));
-			mutex_enter(&buf_dblwr->mutex);
+			mutex_enter(&shard->mutex);
 
 			/* We can now reuse the doublewrite memory buffer: */
-			buf_dblwr->first_free = 0;
-			buf_dblwr->batch_running = false;
-			os_event_set(buf_dblwr->b_event);
+			shard->first_free = 0;
+			shard->batch_running = false;
+			os_event_set(shard->b_event);
 		}
 
-		mutex_exit(&buf_dblwr->mutex);
+		mutex_exit(&shard->mutex);
 		break;
 	case BUF_FLUSH_SINGLE_PAGE:
 		{
-			const ulint size = 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
+			const ulint size = BUF_DBLWR_SHARD_PAGES;
 			ulint i;
-			mutex_enter(&buf_dblwr->mutex);
+			mutex_enter(&shard->mutex);
 			for (i = srv_doublewrite_batch_size; i < size; ++i) {
-				if (buf_dblwr->buf_block_arr[i] == bpage) {
-					buf_dblwr->s_reserved--;
-					buf_dblwr->buf_block_arr[i] = NULL;
-					buf_dblwr->in_use[i] = false;
+				if (shard->buf_block_arr[i] == bpage) {
+					shard->s_reserved--;
+					shard->buf_block_arr[i] = NULL;
+					shard->in_use[i] = false;
 					break;
 				}
 			}
@@ -834,8 +1181,8 @@ buf_dblwr_update(
 			reserved block. */
 			ut_a(i < size);
 		}
-		os_event_set(buf_dblwr->s_event);
-		mutex_exit(&buf_dblwr->mutex);
+		os_event_set(shard->s_event);
+		mutex_exit(&shard->mutex);
 		break;
 	case BUF_FLUSH_N_TYPES:
 		ut_error;
@@ -935,6 +1282,9 @@ buf_dblwr_check_block(
 	case FIL_PAGE_SDI_BLOB:
 	case FIL_PAGE_SDI_ZBLOB:
 	case FIL_PAGE_TYPE_RSEG_ARRAY:
+	case FIL_PAGE_TYPE_LOB_FIRST:
+	case FIL_PAGE_TYPE_LOB_INDEX:
+	case FIL_PAGE_TYPE_LOB_DATA:
 		/* TODO: validate also non-index pages */
 		return;
 	case FIL_PAGE_TYPE_ALLOCATED:
@@ -953,14 +1303,19 @@ void
 buf_dblwr_write_block_to_datafile(
 /*==============================*/
 	const buf_page_t*	bpage,	/*!< in: page to write */
-	bool			sync)	/*!< in: true if sync IO
+	bool			sync,	/*!< in: true if sync IO
 					is requested */
+	bool			batch)	/*!< in: true if the write is
+					part of a batch that the caller
+					posts with
+					os_aio_simulated_wake_handler_threads()
+					*/
 {
 	ut_a(buf_page_in_file(bpage));
 
 	ulint	type = IORequest::WRITE;
 
-	if (sync) {
+	if (sync || batch) {
 		type |= IORequest::DO_NOT_WAKE;
 	}
 
@@ -991,38 +1346,60 @@ buf_dblwr_write_block_to_datafile(
 	}
 }
 
-/********************************************************************//**
-Flushes possible buffered writes from the doublewrite memory buffer to disk,
-and also wakes up the aio thread if simulated aio is used. It is very
-important to call this function after a batch of writes has been posted,
-and also when we may have to wait for a page latch! Otherwise a deadlock
-of threads can occur. */
+/** Write pages to a doublewrite file and flush the file.
+@param[in]	shard	doublewrite shard
+@param[in]	buf	pages to write
+@param[in]	slot	first slot of the file to write to
+@param[in]	n_pages	number of pages to write */
+static
 void
-buf_dblwr_flush_buffered_writes(void)
-/*=================================*/
+buf_dblwr_write_to_file(
+	const buf_dblwr_shard_t*	shard,
+	const byte*			buf,
+	ulint				slot,
+	ulint				n_pages)
 {
-	byte*		write_buf;
-	ulint		first_free;
-	ulint		len;
+	IORequest	request(IORequest::WRITE);
 
-	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
-		/* Sync the writes to the disk. */
-		buf_dblwr_sync_datafiles();
-		return;
+	request.disable_compression();
+
+	dberr_t	err = os_file_write(
+		request, shard->name, shard->file, buf,
+		static_cast<os_offset_t>(slot) * UNIV_PAGE_SIZE,
+		n_pages * UNIV_PAGE_SIZE);
+
+	if (err != DB_SUCCESS) {
+		ib::fatal() << "Failed to write to the doublewrite file "
+			<< shard->name << ": " << ut_strerr(err);
 	}
 
+	/* Now flush the doublewrite buffer data to disk */
+	os_file_flush(shard->file);
+}
+
+/** Flushes possible buffered writes from the doublewrite memory buffer of
+a shard to disk.
+@param[in,out]	shard	doublewrite shard */
+static
+void
+buf_dblwr_flush_shard(
+	buf_dblwr_shard_t*	shard)
+{
+	byte*		write_buf;
+	ulint		first_free;
+
 	ut_ad(!srv_read_only_mode);
 
 try_again:
-	mutex_enter(&buf_dblwr->mutex);
+	mutex_enter(&shard->mutex);
 
 	/* Write first to doublewrite buffer blocks. We use synchronous
-	aio and thus know that file write has been completed when the
+	i/o and thus know that file write has been completed when the
 	control returns. */
 
-	if (buf_dblwr->first_free == 0) {
+	if (shard->first_free == 0) {
 
-		mutex_exit(&buf_dblwr->mutex);
+		mutex_exit(&shard->mutex);
 
 		/* Wake possible simulated aio thread as there could be
 		system temporary tablespace pages active for flushing.
@@ -1033,39 +1410,39 @@ try_again:
 		return;
 	}
 
-	if (buf_dblwr->batch_running) {
+	if (shard->batch_running) {
 		/* Another thread is running the batch right now. Wait
 		for it to finish. */
-		int64_t	sig_count = os_event_reset(buf_dblwr->b_event);
-		mutex_exit(&buf_dblwr->mutex);
+		int64_t	sig_count = os_event_reset(shard->b_event);
+		mutex_exit(&shard->mutex);
 
-		os_event_wait_low(buf_dblwr->b_event, sig_count);
+		os_event_wait_low(shard->b_event, sig_count);
 		goto try_again;
 	}
 
-	ut_a(!buf_dblwr->batch_running);
-	ut_ad(buf_dblwr->first_free == buf_dblwr->b_reserved);
+	ut_a(!shard->batch_running);
+	ut_ad(shard->first_free == shard->b_reserved);
 
 	/* Disallow anyone else to post to doublewrite buffer or to
 	start another batch of flushing. */
-	buf_dblwr->batch_running = true;
-	first_free = buf_dblwr->first_free;
+	shard->batch_running = true;
+	first_free = shard->first_free;
 
 	/* Now safe to release the mutex. Note that though no other
 	thread is allowed to post to the doublewrite batch flushing
 	but any threads working on single page flushes are allowed
 	to proceed. */
-	mutex_exit(&buf_dblwr->mutex);
+	mutex_exit(&shard->mutex);
 
-	write_buf = buf_dblwr->write_buf;
+	write_buf = shard->write_buf;
 
 	for (ulint len2 = 0, i = 0;
-	     i < buf_dblwr->first_free;
+	     i < first_free;
 	     len2 += UNIV_PAGE_SIZE, i++) {
 
 		const buf_block_t*	block;
 
-		block = (buf_block_t*) buf_dblwr->buf_block_arr[i];
+		block = (buf_block_t*) shard->buf_block_arr[i];
 
 		if (buf_block_get_state(block) != BUF_BLOCK_FILE_PAGE
 		    || block->page.zip.data) {
@@ -1083,107 +1460,110 @@ try_again:
 		buf_dblwr_check_page_lsn(write_buf + len2);
 	}
 
-	/* Write out the first block of the doublewrite buffer */
-	len = ut_min(TRX_SYS_DOUBLEWRITE_BLOCK_SIZE,
-		     buf_dblwr->first_free) * UNIV_PAGE_SIZE;
-
-	fil_io(IORequestWrite, true,
-	       page_id_t(TRX_SYS_SPACE, buf_dblwr->block1), univ_page_size,
-	       0, len, (void*) write_buf, NULL);
-
-	if (buf_dblwr->first_free <= TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
-		/* No unwritten pages in the second block. */
-		goto flush;
-	}
-
-	/* Write out the second block of the doublewrite buffer. */
-	len = (buf_dblwr->first_free - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
-	       * UNIV_PAGE_SIZE;
-
-	write_buf = buf_dblwr->write_buf
-		    + TRX_SYS_DOUBLEWRITE_BLOCK_SIZE * UNIV_PAGE_SIZE;
-
-	fil_io(IORequestWrite, true,
-	       page_id_t(TRX_SYS_SPACE, buf_dblwr->block2), univ_page_size,
-	       0, len, (void*) write_buf, NULL);
+	/* The batch slots are at the start of the file: write them out
+	with one sequential write. */
+	buf_dblwr_write_to_file(shard, write_buf, 0, first_free);
 
-flush:
 	/* increment the doublewrite flushed pages counter */
-	srv_stats.dblwr_pages_written.add(buf_dblwr->first_free);
+	srv_stats.dblwr_pages_written.add(first_free);
 	srv_stats.dblwr_writes.inc();
 
-	/* Now flush the doublewrite buffer data to disk */
-	fil_flush(TRX_SYS_SPACE);
-
 	/* We know that the writes have been flushed to disk now
-	and in recovery we will find them in the doublewrite buffer
-	blocks. Next do the writes to the intended positions. */
+	and in recovery we will find them in the doublewrite file.
+	Next do the writes to the intended positions. */
 
-	/* Up to this point first_free and buf_dblwr->first_free are
-	same because we have set the buf_dblwr->batch_running flag
+	/* Up to this point first_free and shard->first_free are
+	same because we have set the shard->batch_running flag
 	disallowing any other thread to post any request but we
-	can't safely access buf_dblwr->first_free in the loop below.
+	can't safely access shard->first_free in the loop below.
 	This is so because it is possible that after we are done with
 	the last iteration and before we terminate the loop, the batch
 	gets finished in the IO helper thread and another thread posts
-	a new batch setting buf_dblwr->first_free to a higher value.
-	If this happens and we are using buf_dblwr->first_free in the
+	a new batch setting shard->first_free to a higher value.
+	If this happens and we are using shard->first_free in the
 	loop termination condition then we'll end up dispatching
 	the same block twice from two different threads. */
-	ut_ad(first_free == buf_dblwr->first_free);
+	ut_ad(first_free == shard->first_free);
 	for (ulint i = 0; i < first_free; i++) {
 		buf_dblwr_write_block_to_datafile(
-			buf_dblwr->buf_block_arr[i], false);
+			shard->buf_block_arr[i], false, true);
 	}
 
 	/* Wake possible simulated aio thread to actually post the
-	writes to the operating system. We don't flush the files
+	writes to the operating system. With io_uring, this submits
+	the whole batch at once. We don't flush the files
 	at this point. We leave it to the IO helper thread to flush
 	datafiles when the whole batch has been processed. */
 	os_aio_simulated_wake_handler_threads();
 }
 
+/** Flushes possible buffered writes of a buffer pool instance from the
+doublewrite memory buffer to disk, and also wakes up the aio thread if
+simulated aio is used. It is very important to call this function after
+a batch of writes has been posted, and also when we may have to wait for
+a page latch! Otherwise a deadlock of threads can occur.
+@param[in]	buf_pool	buffer pool instance
+@param[in]	flush_type	BUF_FLUSH_LRU or BUF_FLUSH_LIST */
+void
+buf_dblwr_flush_buffered_writes(
+	const buf_pool_t*	buf_pool,
+	buf_flush_t		flush_type)
+{
+	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
+		/* Sync the writes to the disk. */
+		buf_dblwr_sync_datafiles();
+		return;
+	}
+
+	buf_dblwr_flush_shard(buf_dblwr_get_shard(buf_pool, flush_type));
+}
+
 /** Posts a buffer page for writing. If the doublewrite memory buffer
-is full, calls buf_dblwr_flush_buffered_writes and waits for for free
-space to appear.
-@param[in]	bpage	buffer block to write */
+of the shard is full, calls buf_dblwr_flush_buffered_writes and waits
+for free space to appear.
+@param[in]	bpage		buffer block to write
+@param[in]	flush_type	BUF_FLUSH_LRU or BUF_FLUSH_LIST */
 void
 buf_dblwr_add_to_batch(
-	buf_page_t*	bpage)
+	buf_page_t*	bpage,
+	buf_flush_t	flush_type)
 {
 	ut_a(buf_page_in_file(bpage));
 	ut_ad(!mutex_own(&buf_pool_from_bpage(bpage)->LRU_list_mutex));
 
+	buf_dblwr_shard_t*	shard = buf_dblwr_get_shard(
+		buf_pool_from_bpage(bpage), flush_type);
+
 try_again:
-	mutex_enter(&buf_dblwr->mutex);
+	mutex_enter(&shard->mutex);
 
-	ut_a(buf_dblwr->first_free <= srv_doublewrite_batch_size);
+	ut_a(shard->first_free <= srv_doublewrite_batch_size);
 
-	if (buf_dblwr->batch_running) {
+	if (shard->batch_running) {
 
-		/* This not nearly as bad as it looks. There is only
-		page_cleaner thread which does background flushing
-		in batches therefore it is unlikely to be a contention
-		point. The only exception is when a user thread is
-		forced to do a flush batch because of a sync
+		/* This not nearly as bad as it looks. Each shard is
+		used by the page cleaner of one buffer pool instance
+		and one flush type, therefore it is unlikely to be a
+		contention point. The only exception is when a user
+		thread is forced to do a flush batch because of a sync
 		checkpoint. */
-		int64_t	sig_count = os_event_reset(buf_dblwr->b_event);
-		mutex_exit(&buf_dblwr->mutex);
+		int64_t	sig_count = os_event_reset(shard->b_event);
+		mutex_exit(&shard->mutex);
 
-		os_event_wait_low(buf_dblwr->b_event, sig_count);
+		os_event_wait_low(shard->b_event, sig_count);
 		goto try_again;
 	}
 
-	if (buf_dblwr->first_free == srv_doublewrite_batch_size) {
-		mutex_exit(&(buf_dblwr->mutex));
+	if (shard->first_free == srv_doublewrite_batch_size) {
+		mutex_exit(&shard->mutex);
 
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_shard(shard);
 
 		goto try_again;
 	}
 
-	byte*	p = buf_dblwr->write_buf
-		+ univ_page_size.physical() * buf_dblwr->first_free;
+	byte*	p = shard->write_buf
+		+ univ_page_size.physical() * shard->first_free;
 
 	if (bpage->size.is_compressed()) {
 		UNIV_MEM_ASSERT_RW(bpage->zip.data, bpage->size.physical());
@@ -1202,24 +1582,24 @@ try_again:
 		memcpy(p, ((buf_block_t*) bpage)->frame, bpage->size.logical());
 	}
 
-	buf_dblwr->buf_block_arr[buf_dblwr->first_free] = bpage;
+	shard->buf_block_arr[shard->first_free] = bpage;
 
-	buf_dblwr->first_free++;
-	buf_dblwr->b_reserved++;
+	shard->first_free++;
+	shard->b_reserved++;
 
-	ut_ad(!buf_dblwr->batch_running);
-	ut_ad(buf_dblwr->first_free == buf_dblwr->b_reserved);
-	ut_ad(buf_dblwr->b_reserved <= srv_doublewrite_batch_size);
+	ut_ad(!shard->batch_running);
+	ut_ad(shard->first_free == shard->b_reserved);
+	ut_ad(shard->b_reserved <= srv_doublewrite_batch_size);
 
-	if (buf_dblwr->first_free == srv_doublewrite_batch_size) {
-		mutex_exit(&(buf_dblwr->mutex));
+	if (shard->first_free == srv_doublewrite_batch_size) {
+		mutex_exit(&shard->mutex);
 
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_shard(shard);
 
 		return;
 	}
 
-	mutex_exit(&(buf_dblwr->mutex));
+	mutex_exit(&shard->mutex);
 }
 
 /********************************************************************//**
@@ -1238,17 +1618,19 @@ buf_dblwr_write_single_page(
 {
 	ulint		n_slots;
 	page_no_t	size;
-	page_no_t	offset;
 	page_no_t	i;
 
 	ut_a(buf_page_in_file(bpage));
 	ut_a(srv_use_doublewrite_buf);
 	ut_a(buf_dblwr != NULL);
 
+	buf_dblwr_shard_t*	shard = buf_dblwr_get_shard(
+		buf_pool_from_bpage(bpage), BUF_FLUSH_SINGLE_PAGE);
+
 	/* total number of slots available for single page flushes
 	starts from srv_doublewrite_batch_size to the end of the
 	buffer. */
-	size = 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
+	size = BUF_DBLWR_SHARD_PAGES;
 	ut_a(size > srv_doublewrite_batch_size);
 	n_slots = size - srv_doublewrite_batch_size;
 
@@ -1267,87 +1649,66 @@ buf_dblwr_write_single_page(
 	}
 
 retry:
-	mutex_enter(&buf_dblwr->mutex);
-	if (buf_dblwr->s_reserved == n_slots) {
+	mutex_enter(&shard->mutex);
+	if (shard->s_reserved == n_slots) {
 
 		/* All slots are reserved. */
-		int64_t	sig_count = os_event_reset(buf_dblwr->s_event);
-		mutex_exit(&buf_dblwr->mutex);
-		os_event_wait_low(buf_dblwr->s_event, sig_count);
+		int64_t	sig_count = os_event_reset(shard->s_event);
+		mutex_exit(&shard->mutex);
+		os_event_wait_low(shard->s_event, sig_count);
 
 		goto retry;
 	}
 
 	for (i = srv_doublewrite_batch_size; i < size; ++i) {
 
-		if (!buf_dblwr->in_use[i]) {
+		if (!shard->in_use[i]) {
 			break;
 		}
 	}
 
 	/* We are guaranteed to find a slot. */
 	ut_a(i < size);
-	buf_dblwr->in_use[i] = true;
-	buf_dblwr->s_reserved++;
-	buf_dblwr->buf_block_arr[i] = bpage;
+	shard->in_use[i] = true;
+	shard->s_reserved++;
+	shard->buf_block_arr[i] = bpage;
 
 	/* increment the doublewrite flushed pages counter */
 	srv_stats.dblwr_pages_written.inc();
 	srv_stats.dblwr_writes.inc();
 
-	mutex_exit(&buf_dblwr->mutex);
-
-	/* Lets see if we are going to write in the first or second
-	block of the doublewrite buffer. */
-	if (i < TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
-		offset = buf_dblwr->block1 + i;
-	} else {
-		offset = buf_dblwr->block2 + i
-			 - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
-	}
+	mutex_exit(&shard->mutex);
 
 	/* We deal with compressed and uncompressed pages a little
 	differently here. In case of uncompressed pages we can
 	directly write the block to the allocated slot in the
-	doublewrite buffer in the system tablespace and then after
-	syncing the system table space we can proceed to write the page
-	in the datafile.
+	doublewrite file and then after syncing the file we can
+	proceed to write the page in the datafile.
 	In case of compressed page we first do a memcpy of the block
 	to the in-memory buffer of doublewrite before proceeding to
 	write it. This is so because we want to pad the remaining
 	bytes in the doublewrite page with zeros. */
 
 	if (bpage->size.is_compressed()) {
-		memcpy(buf_dblwr->write_buf + univ_page_size.physical() * i,
-		       bpage->zip.data, bpage->size.physical());
+		byte*	p = shard->write_buf + univ_page_size.physical() * i;
+
+		memcpy(p, bpage->zip.data, bpage->size.physical());
 
-		memset(buf_dblwr->write_buf + univ_page_size.physical() * i
-		       + bpage->size.physical(), 0x0,
+		memset(p + bpage->size.physical(), 0x0,
 		       univ_page_size.physical() - bpage->size.physical());
 
-		fil_io(IORequestWrite, true,
-		       page_id_t(TRX_SYS_SPACE, offset), univ_page_size, 0,
-		       univ_page_size.physical(),
-		       (void*) (buf_dblwr->write_buf
-				+ univ_page_size.physical() * i),
-		       NULL);
+		buf_dblwr_write_to_file(shard, p, i, 1);
 	} else {
 		/* It is a regular page. Write it directly to the
-		doublewrite buffer */
-		fil_io(IORequestWrite, true,
-		       page_id_t(TRX_SYS_SPACE, offset), univ_page_size, 0,
-		       univ_page_size.physical(),
-		       (void*) ((buf_block_t*) bpage)->frame,
-		       NULL);
+		doublewrite file */
+		buf_dblwr_write_to_file(
+			shard, ((buf_block_t*) bpage)->frame, i, 1);
 	}
 
-	/* Now flush the doublewrite buffer data to disk */
-	fil_flush(TRX_SYS_SPACE);
-
 	/* We know that the write has been flushed to disk now
-	and during recovery we will find it in the doublewrite buffer
-	blocks. Next do the write to the intended position. */
-	buf_dblwr_write_block_to_datafile(bpage, sync);
+	and during recovery we will find it in the doublewrite
+	file. Next do the write to the intended position. */
+	buf_dblwr_write_block_to_datafile(bpage, sync, false);
 }
 
 /** Constructor
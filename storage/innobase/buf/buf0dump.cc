@@ -27,6 +27,9 @@ Created April 08, 2011 Vasil Dimov
 #include <stdarg.h>
 #include <stdio.h>
 #include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 #include "buf0buf.h"
 #include "buf0dump.h"
@@ -73,6 +76,31 @@ typedef ib_uint64_t	buf_dump_t;
 #define BUF_DUMP_SPACE(a)	static_cast<space_id_t>((a) >> 32)
 #define BUF_DUMP_PAGE(a)	static_cast<page_no_t>((a) & 0xFFFFFFFFUL)
 
+/** Number of priority bands that a buffer pool load is cut into. The
+pages of a band are read before those of the colder bands. */
+static const ulint	BUF_LOAD_N_BANDS = 32;
+
+/** Minimum number of pages in a buffer pool load band */
+static const ulint	BUF_LOAD_MIN_BAND = 1024;
+
+/** Maximum number of pages in a buffer pool load batch. A batch is
+submitted at once; the simulated aio merges up to 64 adjacent pages
+into one read. */
+static const ulint	BUF_LOAD_BATCH = 64;
+
+/** How often the buffer pool load progress is reported, in microseconds */
+static const ulint	BUF_LOAD_PROGRESS_INTERVAL = 100000;
+
+/** Pages [begin, end) of a sorted buffer pool load page list, all in one
+tablespace, that a load thread reads together */
+struct buf_load_batch_t {
+	/** First page */
+	ulint	begin;
+
+	/** End of the pages */
+	ulint	end;
+};
+
 /*****************************************************************//**
 Wakes up the buffer pool dump/load thread and instructs it to start
 a dump. This function is called by MySQL code via buffer_pool_dump_now()
@@ -253,6 +281,20 @@ buf_dump_generate_path(
 	}
 }
 
+/** Free the page lists collected by buf_dump().
+@param[in,out]	dumps	page list of each buffer pool instance, or NULL */
+static
+void
+buf_dump_free(
+	std::vector<buf_dump_t*>&	dumps)
+{
+	for (auto dump : dumps) {
+		ut_free(dump);
+	}
+
+	dumps.clear();
+}
+
 /** Perform a buffer pool dump into the file specified by
 innodb_buffer_pool_filename. If any errors occur then the value of
 innodb_buffer_pool_dump_status will be set accordingly, see buf_dump_status().
@@ -290,7 +332,13 @@ buf_dump(
 	}
 	/* else */
 
-	/* walk through each buffer pool */
+	/* Collect the LRU lists of all the buffer pool instances before
+	writing any of them, so that the pages can be written hottest first
+	across the instances. */
+	std::vector<buf_dump_t*>	dumps(srv_buf_pool_instances);
+	std::vector<ulint>		dumps_n(srv_buf_pool_instances);
+	ulint				max_n = 0;
+
 	for (i = 0; i < srv_buf_pool_instances && !SHOULD_QUIT(); i++) {
 		buf_pool_t*		buf_pool;
 		const buf_page_t*	bpage;
@@ -327,6 +375,7 @@ buf_dump(
 
 		if (dump == NULL) {
 			mutex_exit(&buf_pool->LRU_list_mutex);
+			buf_dump_free(dumps);
 			fclose(f);
 			buf_dump_status(STATUS_ERR,
 					"Cannot allocate " ULINTPF " bytes: %s",
@@ -336,6 +385,8 @@ buf_dump(
 			return;
 		}
 
+		/* The most recently used pages are at the start of the LRU
+		list. */
 		for (bpage = UT_LIST_GET_FIRST(buf_pool->LRU), j = 0;
 		     bpage != NULL && j < n_pages;
 		     bpage = UT_LIST_GET_NEXT(LRU, bpage), j++) {
@@ -350,12 +401,29 @@ buf_dump(
 
 		mutex_exit(&buf_pool->LRU_list_mutex);
 
-		for (j = 0; j < n_pages && !SHOULD_QUIT(); j++) {
+		dumps[i] = dump;
+		dumps_n[i] = n_pages;
+		max_n = std::max(max_n, n_pages);
+	}
+
+	/* Write the pages by their position in the LRU lists, taking one
+	page from each instance in turn. The position of a page in the file
+	is thus its hotness, which buf_load() uses to read the hottest pages
+	first. The format stays compatible with older versions, which sort
+	the whole dump by (space, page) before loading it. */
+	for (ulint j = 0; j < max_n && !SHOULD_QUIT(); j++) {
+
+		for (i = 0; i < srv_buf_pool_instances; i++) {
+
+			if (j >= dumps_n[i]) {
+				continue;
+			}
+
 			ret = fprintf(f, SPACE_ID_PF "," PAGE_NO_PF "\n",
-				      BUF_DUMP_SPACE(dump[j]),
-				      BUF_DUMP_PAGE(dump[j]));
+				      BUF_DUMP_SPACE(dumps[i][j]),
+				      BUF_DUMP_PAGE(dumps[i][j]));
 			if (ret < 0) {
-				ut_free(dump);
+				buf_dump_free(dumps);
 				fclose(f);
 				buf_dump_status(STATUS_ERR,
 						"Cannot write to '%s': %s",
@@ -363,21 +431,19 @@ buf_dump(
 				/* leave tmp_filename to exist */
 				return;
 			}
-
-			if (j % 128 == 0) {
-				buf_dump_status(
-					STATUS_VERBOSE,
-					"Dumping buffer pool"
-					" " ULINTPF "/" ULINTPF ","
-					" page " ULINTPF "/" ULINTPF,
-					i + 1, srv_buf_pool_instances,
-					j + 1, n_pages);
-			}
 		}
 
-		ut_free(dump);
+		if (j % 128 == 0) {
+			buf_dump_status(
+				STATUS_VERBOSE,
+				"Dumping buffer pool(s),"
+				" page " ULINTPF "/" ULINTPF " of each",
+				j + 1, max_n);
+		}
 	}
 
+	buf_dump_free(dumps);
+
 	ret = fclose(f);
 	if (ret != 0) {
 		buf_dump_status(STATUS_ERR,
@@ -422,29 +488,36 @@ normal client queries.
 @param[in,out]	last_check_time		milliseconds since epoch of the last
 					time we did check if throttling is
 					needed, we do the check every
-					srv_io_capacity IO ops.
-@param[in]	last_activity_count	activity count
-@param[in]	n_io			number of IO ops done since buffer
-					pool load has started */
+					io_capacity IO ops.
+@param[in,out]	last_activity_count	activity count
+@param[in,out]	n_io			number of IO ops done since the last
+					check
+@param[in]	io_capacity		maximum number of IO ops per second
+					while there is other activity */
 UNIV_INLINE
 void
 buf_load_throttle_if_needed(
 	ulint*	last_check_time,
 	ulint*	last_activity_count,
-	ulint	n_io)
+	ulint*	n_io,
+	ulint	io_capacity)
 {
-	if (n_io % srv_io_capacity < srv_io_capacity - 1) {
+	if (*n_io < io_capacity) {
 		return;
 	}
 
+	const ulint	n = *n_io;
+
+	*n_io = 0;
+
 	if (*last_check_time == 0 || *last_activity_count == 0) {
 		*last_check_time = ut_time_ms();
 		*last_activity_count = srv_get_activity_count();
 		return;
 	}
 
-	/* srv_io_capacity IO operations have been performed by buffer pool
-	load since the last time we were here. */
+	/* At least io_capacity IO operations have been performed by this
+	buffer pool load thread since the last time we were here. */
 
 	/* If no other activity, then keep going without any delay. */
 	if (srv_get_activity_count() == *last_activity_count) {
@@ -457,36 +530,104 @@ buf_load_throttle_if_needed(
 	ulint	elapsed_time = now - *last_check_time;
 
 	/* Notice that elapsed_time is not the time for the last
-	srv_io_capacity IO operations performed by BP load. It is the
-	time elapsed since the last time we detected that there has been
-	other activity. This has a small and acceptable deficiency, e.g.:
+	n IO operations performed by BP load. It is the time elapsed since
+	the last time we detected that there has been other activity. This
+	has a small and acceptable deficiency, e.g.:
 	1. BP load runs and there is no other activity.
 	2. Other activity occurs, we run N IO operations after that and
-	   enter here (where 0 <= N < srv_io_capacity).
+	   enter here (where 0 <= N < io_capacity).
 	3. last_check_time is very old and we do not sleep at this time, but
 	   only update last_check_time and last_activity_count.
-	4. We run srv_io_capacity more IO operations and call this function
+	4. We run io_capacity more IO operations and call this function
 	   again.
 	5. There has been more other activity and thus we enter here.
 	6. Now last_check_time is recent and we sleep if necessary to prevent
-	   more than srv_io_capacity IO operations per second.
+	   more than io_capacity IO operations per second.
 	The deficiency is that we could have slept at 3., but for this we
 	would have to update last_check_time before the
 	"cur_activity_count == *last_activity_count" check and calling
 	ut_time_ms() that often may turn out to be too expensive. */
 
-	if (elapsed_time < 1000 /* 1 sec (1000 milli secs) */) {
-		os_thread_sleep((1000 - elapsed_time) * 1000 /* micro secs */);
+	/* The IO operations are counted a batch at a time, so n can exceed
+	io_capacity. Sleep long enough for n IO operations. */
+	const ulint	min_time = n * 1000 / io_capacity;
+
+	if (elapsed_time < min_time) {
+		os_thread_sleep((min_time - elapsed_time) * 1000
+				/* micro secs */);
 	}
 
 	*last_check_time = ut_time_ms();
 	*last_activity_count = srv_get_activity_count();
 }
 
+/** Read the pages of buffer pool load batches until all the batches have
+been taken, or the load is aborted or the server shuts down. Each batch
+is read with asynchronous reads that are submitted together.
+@param[in]	dump		page list of the load
+@param[in]	batches		batches of the page list, hottest first
+@param[in,out]	next		index of the next batch to take
+@param[in,out]	n_loaded	number of pages of the batches that have
+				been taken and read
+@param[in]	io_capacity	maximum number of reads per second of this
+				thread while there is other activity */
+static
+void
+buf_load_batches(
+	const buf_dump_t*			dump,
+	const std::vector<buf_load_batch_t>&	batches,
+	std::atomic<ulint>*			next,
+	std::atomic<ulint>*			n_loaded,
+	ulint					io_capacity)
+{
+	ulint	last_check_time = 0;
+	ulint	last_activity_cnt = 0;
+	ulint	n_io = 0;
+
+	for (ulint b = (*next)++; b < batches.size(); b = (*next)++) {
+
+		if (buf_load_abort_flag || SHUTTING_DOWN()) {
+			break;
+		}
+
+		const buf_load_batch_t&	batch = batches[b];
+		const space_id_t	space_id = BUF_DUMP_SPACE(
+			dump[batch.begin]);
+		fil_space_t*		space = fil_space_acquire_silent(
+			space_id);
+
+		if (space != NULL) {
+			const page_size_t	page_size(space->flags);
+
+			for (ulint i = batch.begin; i < batch.end; i++) {
+				buf_read_page_background(
+					page_id_t(space_id,
+						  BUF_DUMP_PAGE(dump[i])),
+					page_size, false);
+			}
+
+			/* The reads were queued with DO_NOT_WAKE: submit
+			the whole batch at once. */
+			os_aio_simulated_wake_handler_threads();
+
+			fil_space_release(space);
+
+			n_io += batch.end - batch.begin;
+		}
+
+		n_loaded->fetch_add(batch.end - batch.begin);
+
+		buf_load_throttle_if_needed(
+			&last_check_time, &last_activity_cnt, &n_io,
+			io_capacity);
+	}
+}
+
 /*****************************************************************//**
 Perform a buffer pool load from the file specified by
 innodb_buffer_pool_filename. If any errors occur then the value of
 innodb_buffer_pool_load_status will be set accordingly, see buf_load_status().
+The pages are read hottest first by innodb_buffer_pool_load_threads threads.
 The dump filename can be specified by (relative to srv_data_home):
 SET GLOBAL innodb_buffer_pool_filename='filename'; */
 static
@@ -630,19 +771,41 @@ buf_load()
 		return;
 	}
 
-	if (!SHUTTING_DOWN()) {
-		std::sort(dump, dump + dump_n);
-	}
+	/* The dump lists the pages hottest first. Cut it into priority
+	bands and sort each band by (space, page), so that the pages of a
+	tablespace are read in order within a band while the hottest bands
+	are still read first. Each band is then cut into batches of pages
+	of one tablespace, which the load threads take in order. */
+	const ulint	band_size = std::max(
+		dump_n / BUF_LOAD_N_BANDS + 1, BUF_LOAD_MIN_BAND);
+
+	std::vector<buf_load_batch_t>	batches;
+
+	for (ulint begin = 0; begin < dump_n && !SHUTTING_DOWN();
+	     begin += band_size) {
+
+		const ulint	end = std::min(begin + band_size, dump_n);
+
+		std::sort(dump + begin, dump + end);
 
-	ulint		last_check_time = 0;
-	ulint		last_activity_cnt = 0;
+		for (i = begin; i < end; ) {
+			const space_id_t	batch_space_id
+				= BUF_DUMP_SPACE(dump[i]);
+			buf_load_batch_t	batch;
 
-	/* Avoid calling the expensive fil_space_acquire_silent() for each
-	page within the same tablespace. dump[] is sorted by (space, page),
-	so all pages from a given tablespace are consecutive. */
-	space_id_t	cur_space_id = BUF_DUMP_SPACE(dump[0]);
-	fil_space_t*	space = fil_space_acquire_silent(cur_space_id);
-	page_size_t	page_size(space ? space->flags : 0);
+			batch.begin = i;
+
+			do {
+				++i;
+			} while (i < end
+				 && i - batch.begin < BUF_LOAD_BATCH
+				 && BUF_DUMP_SPACE(dump[i]) == batch_space_id);
+
+			batch.end = i;
+
+			batches.push_back(batch);
+		}
+	}
 
 #ifdef HAVE_PSI_STAGE_INTERFACE
 	PSI_stage_progress*	pfs_stage_progress
@@ -652,81 +815,88 @@ buf_load()
 	mysql_stage_set_work_estimated(pfs_stage_progress, dump_n);
 	mysql_stage_set_work_completed(pfs_stage_progress, 0);
 
-	for (i = 0; i < dump_n && !SHUTTING_DOWN(); i++) {
+	const ulint	n_threads = std::max<ulint>(
+		std::min<ulint>(srv_buf_load_threads, batches.size()), 1);
 
-		/* space_id for this iteration of the loop */
-		const space_id_t this_space_id = BUF_DUMP_SPACE(dump[i]);
+	/* Share srv_io_capacity between the threads when throttling. */
+	const ulint	io_capacity = std::max<ulint>(
+		srv_io_capacity / n_threads, 1);
 
-		if (this_space_id != cur_space_id) {
-			if (space != NULL) {
-				fil_space_release(space);
-			}
+	std::atomic<ulint>	next(0);
+	std::atomic<ulint>	n_loaded(0);
+	std::atomic<ulint>	n_active(n_threads);
 
-			cur_space_id = this_space_id;
-			space = fil_space_acquire_silent(cur_space_id);
+	auto	load = [&]()
+	{
+		buf_load_batches(dump, batches, &next, &n_loaded, io_capacity);
 
-			if (space != NULL) {
-				const page_size_t	cur_page_size(
-					space->flags);
-				page_size.copy_from(cur_page_size);
-			}
-		}
+		n_active.fetch_sub(1);
+	};
 
-		if (space == NULL) {
-			continue;
-		}
+#ifdef UNIV_PFS_THREAD
+	Runnable	runnable(buf_load_thread_key);
+#else
+	Runnable	runnable(0);
+#endif /* UNIV_PFS_THREAD */
 
-		buf_read_page_background(
-			page_id_t(this_space_id, BUF_DUMP_PAGE(dump[i])),
-			page_size, true);
+	std::vector<std::thread>	threads;
 
-		if (i % 64 == 63) {
-			os_aio_simulated_wake_handler_threads();
-		}
+	for (i = 0; i < n_threads; ++i) {
+		threads.push_back(std::thread(runnable, load));
+	}
 
-		/* Update the progress every 32 MiB, which is every Nth page,
-		where N = 32*1024^2 / page_size. */
-		static const ulint	update_status_every_n_mb = 32;
-		static const ulint	update_status_every_n_pages
-			= update_status_every_n_mb * 1024 * 1024
-			/ page_size.physical();
-
-		if (i % update_status_every_n_pages == 0) {
-			buf_load_status(STATUS_VERBOSE,
-					"Loaded " ULINTPF "/" ULINTPF " pages",
-					i + 1, dump_n);
-			mysql_stage_set_work_completed(pfs_stage_progress, i);
-		}
+	const ulint	start_time = ut_time_ms();
 
-		if (buf_load_abort_flag) {
-			if (space != NULL) {
-				fil_space_release(space);
-			}
-			buf_load_abort_flag = FALSE;
-			ut_free(dump);
-			buf_load_status(
-				STATUS_INFO,
-				"Buffer pool(s) load aborted on request");
-			/* Premature end, set estimated = completed = i and
-			end the current stage event. */
-			mysql_stage_set_work_estimated(pfs_stage_progress, i);
-			mysql_stage_set_work_completed(pfs_stage_progress, i);
-#ifdef HAVE_PSI_STAGE_INTERFACE
-			mysql_end_stage();
-#endif /* HAVE_PSI_STAGE_INTERFACE */
-			return;
-		}
+	/* Report the progress and the rate while the threads work. */
+	while (n_active.load() > 0) {
 
-		buf_load_throttle_if_needed(
-			&last_check_time, &last_activity_cnt, i);
+		os_thread_sleep(BUF_LOAD_PROGRESS_INTERVAL);
+
+		const ulint	loaded = n_loaded.load();
+		const ulint	elapsed = ut_time_ms() - start_time;
+
+		buf_load_status(STATUS_VERBOSE,
+				"Loaded " ULINTPF "/" ULINTPF " pages,"
+				" " ULINTPF " pages/s",
+				loaded, dump_n,
+				elapsed > 0 ? loaded * 1000 / elapsed : 0);
+
+		mysql_stage_set_work_completed(pfs_stage_progress, loaded);
 	}
 
-	if (space != NULL) {
-		fil_space_release(space);
+	for (auto& thread : threads) {
+		thread.join();
 	}
 
 	ut_free(dump);
 
+	if (buf_load_abort_flag) {
+		buf_load_abort_flag = FALSE;
+		buf_load_status(
+			STATUS_INFO,
+			"Buffer pool(s) load aborted on request");
+		/* Premature end, set estimated = completed and end the
+		current stage event. */
+		mysql_stage_set_work_estimated(
+			pfs_stage_progress, n_loaded.load());
+		mysql_stage_set_work_completed(
+			pfs_stage_progress, n_loaded.load());
+#ifdef HAVE_PSI_STAGE_INTERFACE
+		mysql_end_stage();
+#endif /* HAVE_PSI_STAGE_INTERFACE */
+		return;
+	}
+
+	/* The reads are asynchronous. Wait for them to complete, so that
+	the pages are in the buffer pool when the load is reported as
+	completed. Other reads may keep the count up, so do not wait for
+	more than a few seconds. */
+	for (i = 0; i < 500 && buf_get_n_pending_read_ios() > 0
+	     && !SHUTTING_DOWN(); i++) {
+
+		os_thread_sleep(10000);
+	}
+
 	ut_sprintf_timestamp(now);
 
 	buf_load_status(STATUS_INFO,
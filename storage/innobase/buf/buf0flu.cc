@@ -83,6 +83,12 @@ static ulint buf_flush_lsn_scan_factor = 3;
 /** Average redo generation rate */
 static lsn_t lsn_avg_rate = 0;
 
+/** Age of the oldest modification that adaptive flushing aims for, in
+percent of the distance from innodb_adaptive_flushing_lwm to the async
+flush point. It is lowered each time the age reaches the async point
+regardless, and slowly raised again afterwards. */
+static ulint buf_flush_target_age_pct = 50;
+
 /** Target oldest LSN for the requested flush_sync */
 static lsn_t buf_flush_sync_lsn = 0;
 
@@ -122,6 +128,17 @@ struct page_cleaner_slot_t {
 	ulint			n_pages_requested;
 					/*!< number of requested pages
 					for the slot */
+	lsn_t			oldest_modification_age;
+					/*!< age of the oldest modification
+					in the instance at the last
+					recommendation */
+	ulint			n_pages_by_age;
+					/*!< number of pages older than
+					the LSN target at the last
+					recommendation */
+	ulint			n_pages_decided;
+					/*!< number of pages requested
+					by the last recommendation */
 	/* These values are updated during state==PAGE_CLEANER_STATE_FLUSHING,
 	and commited with state==PAGE_CLEANER_STATE_FINISHED.
 	The consistency is protected by the 'state' */
@@ -178,6 +195,14 @@ struct page_cleaner_t {
 						requests for all slots */
 	ulint			flush_pass;	/*!< count to finish to flush
 						requests for all slots */
+	lsn_t			target_age;	/*!< age of the oldest
+						modification aimed for by
+						the last recommendation */
+	lsn_t			lsn_avg_rate;	/*!< redo generation rate
+						at the last recommendation */
+	lsn_t			lsn_target_rate;/*!< LSN progress rate aimed
+						for by the last
+						recommendation */
 	page_cleaner_slot_t*	slots;		/*!< pointer to the slots */
 	bool			is_running;	/*!< false if attempt
 						to shutdown */
@@ -953,6 +978,9 @@ buf_flush_init_for_writing(
 				case FIL_PAGE_SDI_BLOB:
 				case FIL_PAGE_SDI_ZBLOB:
 				case FIL_PAGE_TYPE_RSEG_ARRAY:
+				case FIL_PAGE_TYPE_LOB_FIRST:
+				case FIL_PAGE_TYPE_LOB_INDEX:
+				case FIL_PAGE_TYPE_LOB_DATA:
 					break;
 				case FIL_PAGE_TYPE_FSP_HDR:
 				case FIL_PAGE_TYPE_XDES:
@@ -1127,7 +1155,7 @@ buf_flush_write_block_low(
 		buf_dblwr_write_single_page(bpage, sync);
 	} else {
 		ut_ad(!sync);
-		buf_dblwr_add_to_batch(bpage);
+		buf_dblwr_add_to_batch(bpage, flush_type);
 	}
 
 	/* When doing single page flushing the IO is done synchronously
@@ -1248,7 +1276,8 @@ buf_flush_page(
 				/* avoiding deadlock possibility involves
 				doublewrite buffer, should flush it, because
 				it might hold the another block->lock. */
-				buf_dblwr_flush_buffered_writes();
+				buf_dblwr_flush_buffered_writes(
+					buf_pool, flush_type);
 			} else {
 				buf_dblwr_sync_datafiles();
 			}
@@ -2029,7 +2058,7 @@ buf_flush_end(
 	mutex_exit(&buf_pool->flush_state_mutex);
 
 	if (!srv_read_only_mode) {
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_buffered_writes(buf_pool, flush_type);
 	} else {
 		os_aio_simulated_wake_handler_threads();
 	}
@@ -2100,6 +2129,10 @@ buf_flush_do_batch(
 
 	buf_flush_end(buf_pool, type);
 
+	/* With io_uring, complete the writes that are already done here
+	rather than hand them over to the i/o handler threads. */
+	fil_aio_complete_writes(page_count);
+
 	if (n_processed != NULL) {
 		*n_processed = page_count;
 	}
@@ -2428,44 +2461,62 @@ af_get_pct_for_dirty()
 	return(0);
 }
 
-/*********************************************************************//**
-Calculates if flushing is required based on redo generation rate.
-@return percent of io_capacity to flush to manage redo space */
+/** Calculates how fast the oldest modification LSN should advance to
+keep the redo log from filling up. The page cleaners follow the redo
+generation rate, plus or minus the distance from the current age to the
+target age spread over innodb_flushing_avg_loops seconds. This changes
+smoothly with the age instead of jumping when a threshold is crossed.
+@param[in]	age		age of the oldest modification
+@param[in]	lsn_rate	average redo generation rate per second
+@param[out]	target_age	age that is aimed for
+@return LSN progress per second, or 0 if the redo log needs no flushing */
 static
-ulint
-af_get_pct_for_lsn(
-/*===============*/
-	lsn_t	age)	/*!< in: current age of LSN. */
+lsn_t
+af_get_lsn_progress(
+	lsn_t	age,
+	lsn_t	lsn_rate,
+	lsn_t*	target_age)
 {
-	lsn_t	max_async_age;
-	lsn_t	lsn_age_factor;
+	lsn_t	max_async_age = log_get_max_modified_age_async();
 	lsn_t	af_lwm = (srv_adaptive_flushing_lwm
 			  * log_get_capacity()) / 100;
 
+	if (af_lwm > max_async_age) {
+		af_lwm = max_async_age;
+	}
+
+	*target_age = af_lwm
+		+ (max_async_age - af_lwm) * buf_flush_target_age_pct / 100;
+
+	if (age >= max_async_age) {
+		/* We fell behind: start flushing earlier from now on. */
+		if (buf_flush_target_age_pct > 10) {
+			buf_flush_target_age_pct -= 5;
+		}
+	} else if (age < *target_age && buf_flush_target_age_pct < 50) {
+		++buf_flush_target_age_pct;
+	}
+
 	if (age < af_lwm) {
 		/* No adaptive flushing. */
 		return(0);
 	}
 
-	max_async_age = log_get_max_modified_age_async();
-
 	if (age < max_async_age && !srv_adaptive_flushing) {
 		/* We have still not reached the max_async point and
 		the user has disabled adaptive flushing. */
 		return(0);
 	}
 
-	/* If we are here then we know that either:
-	1) User has enabled adaptive flushing
-	2) User may have disabled adaptive flushing but we have reached
-	max_async_age. */
-	lsn_age_factor = (age * 100) / max_async_age;
+	lsn_t	horizon = std::max<lsn_t>(srv_flushing_avg_loops, 1);
 
-	ut_ad(srv_max_io_capacity >= srv_io_capacity);
-	return(static_cast<ulint>(
-		((srv_max_io_capacity / srv_io_capacity)
-		* (lsn_age_factor * sqrt((double)lsn_age_factor)))
-		/ 7.5));
+	if (age > *target_age) {
+		return(lsn_rate + (age - *target_age) / horizon);
+	}
+
+	lsn_t	slack = (*target_age - age) / horizon;
+
+	return(lsn_rate > slack ? lsn_rate - slack : 0);
 }
 
 /*********************************************************************//**
@@ -2488,14 +2539,17 @@ page_cleaner_flush_pages_recommendation(
 	static	ulint		avg_page_rate = 0;
 	static	ulint		n_iterations = 0;
 	static	time_t		prev_time;
+	static	lsn_t		rate_lsn;
+	static	uintmax_t	rate_time_us;
 	lsn_t			oldest_lsn;
 	lsn_t			cur_lsn;
 	lsn_t			age;
 	lsn_t			lsn_rate;
+	lsn_t			lsn_progress;
+	lsn_t			target_age;
 	ulint			n_pages = 0;
 	ulint			pct_for_dirty = 0;
 	ulint			pct_for_lsn = 0;
-	ulint			pct_total = 0;
 
 	cur_lsn = log_get_lsn();
 
@@ -2503,6 +2557,8 @@ page_cleaner_flush_pages_recommendation(
 		/* First time around. */
 		prev_lsn = cur_lsn;
 		prev_time = ut_time();
+		rate_lsn = cur_lsn;
+		rate_time_us = ut_time_us(NULL);
 		return(0);
 	}
 
@@ -2512,6 +2568,30 @@ page_cleaner_flush_pages_recommendation(
 
 	sum_pages += last_pages_in;
 
+	/* Follow the redo generation rate at every iteration, with an
+	exponential moving average over srv_flushing_avg_loops iterations,
+	so that a burst of writes is noticed within a few seconds. */
+	uintmax_t	rate_now_us = ut_time_us(NULL);
+
+	if (rate_now_us > rate_time_us) {
+		ulint	n_loops = std::max<ulint>(srv_flushing_avg_loops, 1);
+
+		lsn_rate = static_cast<lsn_t>(
+			static_cast<double>(cur_lsn - rate_lsn) * 1000000
+			/ (rate_now_us - rate_time_us));
+
+		lsn_avg_rate = (lsn_avg_rate * (n_loops - 1) + lsn_rate)
+			/ n_loops;
+
+		/* React to an increase at once. */
+		if (lsn_rate > lsn_avg_rate) {
+			lsn_avg_rate = (lsn_avg_rate + lsn_rate) / 2;
+		}
+
+		rate_lsn = cur_lsn;
+		rate_time_us = rate_now_us;
+	}
+
 	time_t	curr_time = ut_time();
 	double	time_elapsed = difftime(curr_time, prev_time);
 
@@ -2529,14 +2609,6 @@ page_cleaner_flush_pages_recommendation(
 			  / time_elapsed)
 			 + avg_page_rate) / 2);
 
-		/* How much LSN we have generated since last call. */
-		lsn_rate = static_cast<lsn_t>(
-			static_cast<double>(cur_lsn - prev_lsn)
-			/ time_elapsed);
-
-		lsn_avg_rate = (lsn_avg_rate + lsn_rate) / 2;
-
-
 		/* aggregate stats of all slots */
 		mutex_enter(&page_cleaner->mutex);
 
@@ -2628,70 +2700,99 @@ page_cleaner_flush_pages_recommendation(
 	age = cur_lsn > oldest_lsn ? cur_lsn - oldest_lsn : 0;
 
 	pct_for_dirty = af_get_pct_for_dirty();
-	pct_for_lsn = af_get_pct_for_lsn(age);
+	lsn_progress = af_get_lsn_progress(age, lsn_avg_rate, &target_age);
 
-	pct_total = ut_max(pct_for_dirty, pct_for_lsn);
-
-	/* Estimate pages to be flushed for the lsn progress */
+	/* Estimate pages to be flushed for the lsn progress. Each
+	instance is asked for the pages that are older than the target,
+	so that the instances with the oldest modifications do most of
+	the work. */
 	ulint	sum_pages_for_lsn = 0;
 	lsn_t	target_lsn = oldest_lsn
-			     + lsn_avg_rate * buf_flush_lsn_scan_factor;
+			     + lsn_progress * buf_flush_lsn_scan_factor;
 
 	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
 		buf_pool_t*	buf_pool = buf_pool_from_array(i);
 		ulint		pages_for_lsn = 0;
+		lsn_t		instance_age = 0;
 
 		buf_flush_list_mutex_enter(buf_pool);
-		for (buf_page_t* b = UT_LIST_GET_LAST(buf_pool->flush_list);
-		     b != NULL;
-		     b = UT_LIST_GET_PREV(list, b)) {
-			if (b->oldest_modification > target_lsn) {
-				break;
+
+		const buf_page_t*	oldest
+			= UT_LIST_GET_LAST(buf_pool->flush_list);
+
+		if (oldest != NULL && cur_lsn > oldest->oldest_modification) {
+			instance_age = cur_lsn - oldest->oldest_modification;
+		}
+
+		if (lsn_progress > 0) {
+			for (const buf_page_t* b = oldest;
+			     b != NULL;
+			     b = UT_LIST_GET_PREV(list, b)) {
+				if (b->oldest_modification > target_lsn) {
+					break;
+				}
+				++pages_for_lsn;
 			}
-			++pages_for_lsn;
 		}
+
 		buf_flush_list_mutex_exit(buf_pool);
 
+		pages_for_lsn /= buf_flush_lsn_scan_factor;
+
 		sum_pages_for_lsn += pages_for_lsn;
 
 		mutex_enter(&page_cleaner->mutex);
 		ut_ad(page_cleaner->slots[i].state
 		      == PAGE_CLEANER_STATE_NONE);
-		page_cleaner->slots[i].n_pages_requested
-			= pages_for_lsn / buf_flush_lsn_scan_factor + 1;
+		page_cleaner->slots[i].n_pages_requested = pages_for_lsn;
+		page_cleaner->slots[i].n_pages_by_age = pages_for_lsn;
+		page_cleaner->slots[i].oldest_modification_age = instance_age;
 		mutex_exit(&page_cleaner->mutex);
 	}
 
-	sum_pages_for_lsn /= buf_flush_lsn_scan_factor;
-	if(sum_pages_for_lsn < 1) {
-		sum_pages_for_lsn = 1;
-	}
-
 	/* Cap the maximum IO capacity that we are going to use by
 	max_io_capacity. Limit the value to avoid too quick increase */
 	ulint	pages_for_lsn =
 		std::min<ulint>(sum_pages_for_lsn, srv_max_io_capacity * 2);
 
-	n_pages = (PCT_IO(pct_total) + avg_page_rate + pages_for_lsn) / 3;
+	pct_for_lsn = pages_for_lsn * 100 / srv_io_capacity;
+
+	/* Average with the recent page rate so that the request does
+	not swing with every change of the age distribution. */
+	n_pages = std::max<ulint>(PCT_IO(pct_for_dirty),
+				  (avg_page_rate + pages_for_lsn) / 2);
 
 	if (n_pages > srv_max_io_capacity) {
 		n_pages = srv_max_io_capacity;
 	}
 
 	/* Normalize request for each instance */
+	ulint	max_instance_pages = 0;
+
 	mutex_enter(&page_cleaner->mutex);
 	ut_ad(page_cleaner->n_slots_requested == 0);
 	ut_ad(page_cleaner->n_slots_flushing == 0);
 	ut_ad(page_cleaner->n_slots_finished == 0);
 
 	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
-		/* if REDO has enough of free space,
-		don't care about age distribution of pages */
-		page_cleaner->slots[i].n_pages_requested = pct_for_lsn > 30 ?
-			page_cleaner->slots[i].n_pages_requested
-			* n_pages / sum_pages_for_lsn + 1
+		page_cleaner_slot_t*	slot = &page_cleaner->slots[i];
+
+		/* Without redo pressure the age distribution of the
+		pages does not matter. */
+		slot->n_pages_requested = sum_pages_for_lsn > 0
+			? slot->n_pages_requested * n_pages
+			/ sum_pages_for_lsn + 1
 			: n_pages / srv_buf_pool_instances;
+
+		max_instance_pages = std::max(
+			max_instance_pages, slot->n_pages_requested);
+
+		slot->n_pages_decided = slot->n_pages_requested;
 	}
+
+	page_cleaner->target_age = target_age;
+	page_cleaner->lsn_avg_rate = lsn_avg_rate;
+	page_cleaner->lsn_target_rate = lsn_progress;
 	mutex_exit(&page_cleaner->mutex);
 
 	MONITOR_SET(MONITOR_FLUSH_N_TO_FLUSH_REQUESTED, n_pages);
@@ -2702,6 +2803,10 @@ page_cleaner_flush_pages_recommendation(
 	MONITOR_SET(MONITOR_FLUSH_LSN_AVG_RATE, lsn_avg_rate);
 	MONITOR_SET(MONITOR_FLUSH_PCT_FOR_DIRTY, pct_for_dirty);
 	MONITOR_SET(MONITOR_FLUSH_PCT_FOR_LSN, pct_for_lsn);
+	MONITOR_SET(MONITOR_FLUSH_OLDEST_AGE, age);
+	MONITOR_SET(MONITOR_FLUSH_TARGET_AGE, target_age);
+	MONITOR_SET(MONITOR_FLUSH_LSN_TARGET_RATE, lsn_progress);
+	MONITOR_SET(MONITOR_FLUSH_N_TO_FLUSH_MAX_INSTANCE, max_instance_pages);
 
 	*lsn_limit = LSN_MAX;
 
@@ -2777,6 +2882,40 @@ buf_flush_page_cleaner_init(size_t n_page_cleaners)
 	}
 }
 
+/** Copy the latest adaptive flushing decisions.
+@param[out]	decisions	one decision per buffer pool instance,
+or none if the page cleaners are not running */
+void
+buf_flush_get_decisions(
+	std::vector<buf_flush_decision_t>*	decisions)
+{
+	decisions->clear();
+
+	if (page_cleaner == NULL) {
+		return;
+	}
+
+	mutex_enter(&page_cleaner->mutex);
+
+	for (ulint i = 0; i < page_cleaner->n_slots; i++) {
+		const page_cleaner_slot_t*	slot = &page_cleaner->slots[i];
+		buf_flush_decision_t		decision;
+
+		decision.pool_id = i;
+		decision.oldest_modification_age
+			= slot->oldest_modification_age;
+		decision.target_age = page_cleaner->target_age;
+		decision.lsn_avg_rate = page_cleaner->lsn_avg_rate;
+		decision.lsn_target_rate = page_cleaner->lsn_target_rate;
+		decision.n_pages_by_age = slot->n_pages_by_age;
+		decision.n_pages_requested = slot->n_pages_decided;
+
+		decisions->push_back(decision);
+	}
+
+	mutex_exit(&page_cleaner->mutex);
+}
+
 /**
 Close page_cleaner. */
 static
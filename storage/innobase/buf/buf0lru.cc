@@ -47,6 +47,7 @@ Created 11/5/1995 Heikki Tuuri
 #include "page0zip.h"
 #include "srv0mon.h"
 #include "srv0srv.h"
+#include "srv0start.h"
 #include "sync0rw.h"
 #include "ut0byte.h"
 #include "ut0rnd.h"
@@ -139,7 +140,8 @@ buf_page_get_mutex() and the hash_lock.
 If a compressed page is freed other compressed pages may be relocated.
 
 @param[in]	bpage		block, must contain a file page and
-				be in a state where it can be freed; there
+				be in a state where it can be freed and
+				frozen by buf_page_freeze(); there
 				may or may not be a hash index to the page
 @param[in]	zip		true if should remove also the
 				compressed page of an uncompressed page
@@ -823,9 +825,9 @@ scan_again:
 
 			if (
 				    bpage->id.space() != id
-				    || bpage->buf_fix_count > 0
 				    || (buf_page_get_io_fix(bpage)
-					!= BUF_IO_NONE)) {
+					!= BUF_IO_NONE)
+				    || !buf_page_freeze(bpage)) {
 
 				mutex_exit(block_mutex);
 
@@ -854,6 +856,8 @@ scan_again:
 			/* Do nothing, because the adaptive hash index
 			covers uncompressed pages only. */
 		} else if (((buf_block_t*) bpage)->index) {
+			buf_page_unfreeze(bpage);
+
 			mutex_exit(&buf_pool->LRU_list_mutex);
 
 			rw_lock_x_unlock(hash_lock);
@@ -1841,6 +1845,160 @@ buf_LRU_make_block_young(
 	buf_LRU_add_block_low(bpage, FALSE);
 }
 
+/** Maximum time in milliseconds that a thread keeps page accesses
+buffered before applying them to the LRU lists */
+static const ulint	BUF_LRU_ACCESS_MAX_AGE_MS = 1000;
+
+/** Page accesses of a thread that have not been applied to the LRU
+lists yet. @see buf_LRU_make_block_young_deferred() */
+struct buf_LRU_access_buf_t {
+	/** Applies the accesses of an exiting thread. */
+	~buf_LRU_access_buf_t();
+
+	/** Number of buffered accesses */
+	ulint		n;
+
+	/** Time of the oldest buffered access, from ut_time_ms() */
+	ulint		started;
+
+	/** Tablespaces of the accessed pages */
+	space_id_t	space[BUF_LRU_ACCESS_BATCH_MAX];
+
+	/** Page numbers of the accessed pages */
+	page_no_t	page_no[BUF_LRU_ACCESS_BATCH_MAX];
+};
+
+/** Page accesses buffered by the current thread */
+static thread_local buf_LRU_access_buf_t	buf_LRU_access_buf;
+
+/** Moves the pages of the buffered accesses to the start of the LRU
+lists, holding the LRU list mutex of each buffer pool instance once.
+@param[in,out]	buf	buffered accesses, emptied on return */
+static
+void
+buf_LRU_access_buf_flush(
+	buf_LRU_access_buf_t*	buf)
+{
+	bool	done[BUF_LRU_ACCESS_BATCH_MAX];
+
+	memset(done, 0, sizeof done);
+
+	for (ulint i = 0; i < buf->n; i++) {
+
+		if (done[i]) {
+			continue;
+		}
+
+		buf_pool_t*	buf_pool = buf_pool_get(
+			page_id_t(buf->space[i], buf->page_no[i]));
+
+		mutex_enter(&buf_pool->LRU_list_mutex);
+
+		for (ulint j = i; j < buf->n; j++) {
+			const page_id_t	page_id(buf->space[j], buf->page_no[j]);
+
+			if (done[j] || buf_pool_get(page_id) != buf_pool) {
+				continue;
+			}
+
+			done[j] = true;
+
+			rw_lock_t*	hash_lock = buf_page_hash_lock_get(
+				buf_pool, page_id);
+
+			rw_lock_s_lock(hash_lock);
+
+			buf_page_t*	bpage = buf_page_hash_get_low(
+				buf_pool, page_id);
+
+			/* The page may have been evicted or made young by
+			another thread after it was accessed. */
+			if (bpage != NULL
+			    && buf_page_in_file(bpage)
+			    && !buf_page_peek_if_young(bpage)) {
+
+				buf_LRU_make_block_young(bpage);
+			}
+
+			rw_lock_s_unlock(hash_lock);
+		}
+
+		mutex_exit(&buf_pool->LRU_list_mutex);
+	}
+
+	MONITOR_INC_VALUE_CUMULATIVE(
+		MONITOR_LRU_ACCESS_BATCH_PAGES,
+		MONITOR_LRU_ACCESS_BATCH_NUM_CALL,
+		MONITOR_LRU_ACCESS_BATCH_PAGES_PER_CALL,
+		buf->n);
+
+	buf->n = 0;
+}
+
+/** Applies the accesses of an exiting thread. */
+buf_LRU_access_buf_t::~buf_LRU_access_buf_t()
+{
+	/* Threads that exit during or after shutdown may outlive the
+	buffer pool; their accesses no longer matter. */
+	if (n > 0
+	    && srv_shutdown_state == SRV_SHUTDOWN_NONE
+	    && buf_pool_ptr != NULL) {
+
+		buf_LRU_access_buf_flush(this);
+	}
+}
+
+/** Remembers that a page should be moved to the start of the LRU list.
+The accesses are buffered per thread and applied with one acquisition
+of buf_pool->LRU_list_mutex per buffer pool instance once
+srv_LRU_access_batch of them have been collected, once the oldest of them
+is BUF_LRU_ACCESS_MAX_AGE_MS old, at transaction commit, or when the
+thread exits.
+@param[in]	page_id	page id of a buffer-fixed page */
+void
+buf_LRU_make_block_young_deferred(
+	const page_id_t&	page_id)
+{
+	buf_LRU_access_buf_t*	buf = &buf_LRU_access_buf;
+
+	if (buf->n > 0
+	    && buf->space[buf->n - 1] == page_id.space()
+	    && buf->page_no[buf->n - 1] == page_id.page_no()) {
+
+		/* The same page is often accessed several times
+		in a row. */
+		return;
+	}
+
+	const ulint	now = ut_time_ms();
+
+	if (buf->n == 0) {
+		buf->started = now;
+	}
+
+	buf->space[buf->n] = page_id.space();
+	buf->page_no[buf->n] = page_id.page_no();
+
+	if (++buf->n >= ut_min(srv_LRU_access_batch,
+			       ulong(BUF_LRU_ACCESS_BATCH_MAX))
+	    || now - buf->started >= BUF_LRU_ACCESS_MAX_AGE_MS) {
+
+		buf_LRU_access_buf_flush(buf);
+	}
+}
+
+/** Applies the page accesses buffered by the current thread to the LRU
+lists. The caller must not hold any buffer pool mutex. */
+void
+buf_LRU_access_flush()
+{
+	buf_LRU_access_buf_t*	buf = &buf_LRU_access_buf;
+
+	if (buf->n > 0) {
+		buf_LRU_access_buf_flush(buf);
+	}
+}
+
 /** Try to free a block.  If bpage is a descriptor of a compressed-only
 page, the descriptor object will be freed as well.
 NOTE: this function may temporarily release and relock the
@@ -1930,12 +2088,21 @@ not_freed:
 
 		goto not_freed;
 
+	} else if (!buf_page_freeze(bpage)) {
+		/* buf_page_hash_get_optimistic() buffer-fixed the
+		block after the check above. */
+		goto not_freed;
+
 	} else if (b != NULL) {
 		memcpy(b, bpage, sizeof *b);
+
+		/* Unlike bpage, the descriptor will stay in
+		buf_pool->page_hash. */
+		b->buf_fix_count = 0;
 	}
 
         ut_ad(rw_lock_own(hash_lock, RW_LOCK_X));
-	ut_ad(buf_page_can_relocate(bpage));
+	ut_ad(buf_page_get_io_fix(bpage) == BUF_IO_NONE);
 
 	if (!buf_LRU_block_remove_hashed(bpage, zip, false)) {
 
@@ -2196,7 +2363,8 @@ buf_page_get_mutex() and the hash_lock.
 If a compressed page is freed other compressed pages may be relocated.
 
 @param[in]	bpage		block, must contain a file page and
-				be in a state where it can be freed; there
+				be in a state where it can be freed and
+				frozen by buf_page_freeze(); there
 				may or may not be a hash index to the page
 @param[in]	zip		true if should remove also the
 				compressed page of an uncompressed page
@@ -2225,7 +2393,7 @@ buf_LRU_block_remove_hashed(
         ut_ad(rw_lock_own(hash_lock, RW_LOCK_X));
 
 	ut_a(buf_page_get_io_fix(bpage) == BUF_IO_NONE);
-	ut_a(bpage->buf_fix_count == 0);
+	ut_a(bpage->buf_fix_count == BUF_PAGE_FIX_FROZEN);
 
 	buf_LRU_remove_block(bpage);
 
@@ -2479,7 +2647,8 @@ buf_LRU_block_free_hashed_page(
 the LRU list and block mutexes and have page hash latched in X. The latch and
 the block mutexes will be released.
 @param[in,out]	bpage		block, must contain a file page and
-				be in a state where it can be freed; there
+				be in a state where it can be freed and
+				frozen by buf_page_freeze(); there
 				may or may not be a hash index to the page
 @param[in]	zip		true if should remove also the compressed page
 				of an uncompressed page
@@ -2780,9 +2949,9 @@ buf_LRU_print_instance(
 			fputs("old ", stderr);
 		}
 
-		if (bpage->buf_fix_count) {
+		if (buf_page_get_fix_count(bpage)) {
 			fprintf(stderr, "buffix count %lu ",
-				(ulong) bpage->buf_fix_count);
+				(ulong) buf_page_get_fix_count(bpage));
 		}
 
 		if (buf_page_get_io_fix(bpage)) {
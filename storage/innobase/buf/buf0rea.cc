@@ -39,6 +39,7 @@ Created 11/5/1995 Heikki Tuuri
 #include "my_dbug.h"
 #include "my_inttypes.h"
 #include "os0file.h"
+#include "srv0mon.h"
 #include "srv0srv.h"
 #include "srv0start.h"
 #include "trx0sys.h"
@@ -705,6 +706,89 @@ buf_read_ahead_linear(
 	return(count);
 }
 
+/** Issues asynchronous read requests for the leaf pages that an index range
+scan is about to visit, as found from the node pointers on the level above
+the leaves by btr_pcur_read_ahead_logical().  Unlike the linear read-ahead,
+the pages need not be adjacent in the file.  Does not read any page if too
+many reads are pending.
+NOTE: the calling thread must not own latches on pages.
+@param[in]	space_id	tablespace id
+@param[in]	page_size	page size
+@param[in]	page_nos	leaf page numbers in scan order
+@param[in]	n_pages		number of page numbers in the array
+@return number of page read requests issued */
+ulint
+buf_read_ahead_logical(
+	space_id_t		space_id,
+	const page_size_t&	page_size,
+	const page_no_t*	page_nos,
+	ulint			n_pages)
+{
+	ulint	count = 0;
+	ulint	n_hits = 0;
+
+	if (srv_startup_is_before_trx_rollback_phase) {
+		/* No read-ahead to avoid thread deadlocks */
+		return(0);
+	}
+
+	for (ulint i = 0; i < n_pages; ++i) {
+		const page_id_t	page_id(space_id, page_nos[i]);
+		buf_pool_t*	buf_pool = buf_pool_get(page_id);
+		dberr_t		err;
+
+		if (buf_page_peek(page_id)) {
+			++n_hits;
+			continue;
+		}
+
+		os_rmb;
+		if (buf_pool->n_pend_reads
+		    > buf_pool->curr_size / BUF_READ_AHEAD_PEND_LIMIT) {
+			break;
+		}
+
+		/* It is only sensible to do read-ahead in the non-sync
+		aio mode: hence false as the first parameter */
+
+		ulint	n_read = buf_read_page_low(
+			&err, false, IORequest::DO_NOT_WAKE,
+			BUF_READ_ANY_PAGE, page_id, page_size, false);
+
+		if (err == DB_TABLESPACE_DELETED) {
+			break;
+		}
+
+		buf_pool->stat.n_ra_pages_read += n_read;
+		count += n_read;
+	}
+
+	/* In simulated aio we wake the aio handler threads only after
+	queuing all aio requests, in native aio the following call does
+	nothing: */
+
+	os_aio_simulated_wake_handler_threads();
+
+	MONITOR_INC(MONITOR_READ_AHEAD_LOGICAL_REQUESTS);
+	MONITOR_INC_VALUE(MONITOR_READ_AHEAD_LOGICAL_HITS, n_hits);
+	MONITOR_INC_VALUE(MONITOR_READ_AHEAD_LOGICAL_MISSES, count);
+
+	if (count) {
+		DBUG_PRINT("ib_buf", ("logical read-ahead %u pages, %u:%u",
+				      (unsigned) count,
+				      (unsigned) space_id,
+				      (unsigned) page_nos[0]));
+
+		/* Read ahead is considered one I/O operation for the
+		purpose of LRU policy decision. */
+		buf_LRU_stat_inc_io();
+
+		srv_stats.buf_pool_reads.add(count);
+	}
+
+	return(count);
+}
+
 /********************************************************************//**
 Issues read requests for pages which the ibuf module wants to read in, in
 order to contract the insert buffer tree. Technically, this function is like
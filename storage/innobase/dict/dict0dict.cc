@@ -2863,6 +2863,10 @@ dict_index_remove_from_cache_low(
 	only free the dict_index_t struct when this count drops to
 	zero. See also: dict_table_can_be_evicted() */
 
+	/* The queued hash index builds of the pages of the index are
+	counted too; do not wait for the build thread to serve them. */
+	btr_search_build_cancel(index);
+
 	do {
 		ulint ref_count = btr_search_info_get_ref_count(info, index);
 
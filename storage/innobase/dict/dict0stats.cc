@@ -34,6 +34,7 @@ Created Jan 06, 2010 Vasil Dimov
 #include <vector>
 
 #include "dict0stats.h"
+#include "dict0stats_bg.h"
 #include "dyn0buf.h"
 #include "ha_prototypes.h"
 #include "lob0lob.h"
@@ -149,6 +150,9 @@ typedef ut_allocator<std::pair<const char* const, dict_index_t*> >
 typedef std::map<const char*, dict_index_t*, ut_strcmp_functor,
 		index_map_t_allocator>	index_map_t;
 
+/** List of indexes whose statistics are saved by dict_stats_save(). */
+typedef std::vector<index_id_t, ut_allocator<index_id_t> >	index_id_list_t;
+
 /*********************************************************************//**
 Checks whether an index should be ignored in stats manipulations:
 * stats fetch
@@ -2067,18 +2071,89 @@ found_level:
 	DBUG_VOID_RETURN;
 }
 
+/** Check whether an incremental recalculation of persistent statistics
+has to analyze an index again.
+@param[in]	index	index
+@return true if the index changed enough since it was last analyzed */
+static
+bool
+dict_stats_index_needs_analyze(
+	const dict_index_t*	index)
+{
+	/* Use the same threshold as row_update_statistics_if_needed()
+	uses for the whole table. */
+	return(index->stat_modified_counter
+	       > dict_table_get_n_rows(index->table) / 10);
+}
+
+/** Estimate the number of leaf pages that dict_stats_analyze_index()
+reads from an index.
+@param[in]	index	index
+@return estimated number of leaf pages */
+static
+ib_uint64_t
+dict_stats_index_analyze_cost(
+	const dict_index_t*	index)
+{
+	/* For each n-column prefix N_SAMPLE_PAGES(index) leaf pages are
+	sampled, unless that is more than the whole leaf level, which is
+	then scanned instead. */
+	return(std::min<ib_uint64_t>(
+		N_SAMPLE_PAGES(index) * dict_index_get_n_unique(index),
+		index->stat_n_leaf_pages));
+}
+
 /*********************************************************************//**
 Calculates new estimates for table and index statistics. This function
 is relatively slow and is used to calculate persistent statistics that
 will be saved on disk.
+
+In the incremental mode, only the indexes that changed enough since they
+were last analyzed are analyzed again, and the others keep their current
+estimates. At most srv_stats_auto_recalc_page_budget leaf pages (estimated)
+are sampled; the indexes that do not fit are left for a later run.
+@param[in,out]	table		table
+@param[in]	incremental	whether to only analyze the changed indexes
+@param[out]	analyzed	indexes that were analyzed
+@param[out]	deferred	whether some changed indexes were not
+analyzed because of the page budget
 @return DB_SUCCESS or error code */
 static
 dberr_t
 dict_stats_update_persistent(
-/*=========================*/
-	dict_table_t*	table)		/*!< in/out: table */
+	dict_table_t*		table,
+	bool			incremental,
+	index_id_list_t*	analyzed,
+	bool*			deferred)
 {
 	dict_index_t*	index;
+	ib_uint64_t	budget = srv_stats_auto_recalc_page_budget;
+	ib_uint64_t	spent = 0;
+
+	*deferred = false;
+
+	/* Whether an index should be analyzed in this run. At least one
+	index is analyzed in each run, so that the budget cannot stall the
+	recalculation. */
+	auto	should_analyze = [&](const dict_index_t* index) {
+		if (!incremental || !table->stat_initialized) {
+			return(true);
+		}
+
+		if (!dict_stats_index_needs_analyze(index)) {
+			return(false);
+		}
+
+		ib_uint64_t	cost = dict_stats_index_analyze_cost(index);
+
+		if (budget != 0 && spent != 0 && spent + cost > budget) {
+			*deferred = true;
+			return(false);
+		}
+
+		spent += cost;
+		return(true);
+	};
 
 	DEBUG_PRINTF("%s(table=%s)\n", __func__, table->name);
 
@@ -2101,13 +2176,18 @@ dict_stats_update_persistent(
 
 	ut_ad(!dict_index_is_ibuf(index));
 
-	dict_stats_analyze_index(index);
+	if (should_analyze(index)) {
+		dict_stats_analyze_index(index);
 
-	ulint	n_unique = dict_index_get_n_unique(index);
+		index->stat_modified_counter = 0;
+		analyzed->push_back(index_id_t(index->space, index->id));
 
-	table->stat_n_rows = index->stat_n_diff_key_vals[n_unique - 1];
+		ulint	n_unique = dict_index_get_n_unique(index);
 
-	table->stat_clustered_index_size = index->stat_index_size;
+		table->stat_n_rows = index->stat_n_diff_key_vals[n_unique - 1];
+
+		table->stat_clustered_index_size = index->stat_index_size;
+	}
 
 	/* analyze other indexes from the table, if any */
 
@@ -2121,8 +2201,21 @@ dict_stats_update_persistent(
 			continue;
 		}
 
+		if (!should_analyze(index)) {
+			/* Keep the current estimates. */
+			if (!dict_stats_should_ignore_index(index)) {
+				table->stat_sum_of_other_index_sizes
+					+= index->stat_index_size;
+			}
+
+			continue;
+		}
+
 		dict_stats_empty_index(index);
 
+		index->stat_modified_counter = 0;
+		analyzed->push_back(index_id_t(index->space, index->id));
+
 		if (dict_stats_should_ignore_index(index)) {
 			continue;
 		}
@@ -2243,16 +2336,16 @@ dict_stats_save_index_stat(
 }
 
 /** Save the table's statistics into the persistent statistics storage.
-@param[in]	table_orig	table whose stats to save
-@param[in]	only_for_index	if this is non-NULL, then stats for indexes
-that are not equal to it will not be saved, if NULL, then all indexes' stats
-are saved
+@param[in]	table_orig		table whose stats to save
+@param[in]	only_for_indexes	if this is non-NULL, then stats for
+indexes that are not in it will not be saved, if NULL, then all indexes'
+stats are saved
 @return DB_SUCCESS or error code */
 static
 dberr_t
 dict_stats_save(
 	dict_table_t*		table_orig,
-	const index_id_t*	only_for_index)
+	const index_id_list_t*	only_for_indexes)
 {
 	pars_info_t*	pinfo;
 	lint		now;
@@ -2357,9 +2450,11 @@ dict_stats_save(
 
 		index = it->second;
 
-		if (only_for_index != NULL
-		    && index->space != only_for_index->m_space_id
-		    && index->id != only_for_index->m_index_id) {
+		if (only_for_indexes != NULL
+		    && std::find(only_for_indexes->begin(),
+				 only_for_indexes->end(),
+				 index_id_t(index->space, index->id))
+		    == only_for_indexes->end()) {
 			continue;
 		}
 
@@ -2914,9 +3009,11 @@ dict_stats_update_for_index(
 	if (dict_stats_is_persistent_enabled(index->table)) {
 		dict_table_stats_lock(index->table, RW_X_LATCH);
 		dict_stats_analyze_index(index);
+		index->stat_modified_counter = 0;
 		dict_table_stats_unlock(index->table, RW_X_LATCH);
-		index_id_t	index_id(index->space, index->id);
-		dict_stats_save(index->table, &index_id);
+		index_id_list_t	index_ids;
+		index_ids.push_back(index_id_t(index->space, index->id));
+		dict_stats_save(index->table, &index_ids);
 		DBUG_VOID_RETURN;
 	}
 
@@ -2964,6 +3061,7 @@ dict_stats_update(
 		dberr_t	err;
 
 	case DICT_STATS_RECALC_PERSISTENT:
+	case DICT_STATS_RECALC_PERSISTENT_INCREMENTAL: {
 
 		if (srv_read_only_mode) {
 			break;
@@ -2971,7 +3069,7 @@ dict_stats_update(
 
 		/* Persistent recalculation requested, called from
 		1) ANALYZE TABLE, or
-		2) the auto recalculation background thread, or
+		2) the auto recalculation background thread (incremental), or
 		3) open table if stats do not exist on disk and auto recalc
 		   is enabled */
 
@@ -2979,13 +3077,26 @@ dict_stats_update(
 		persistent stats enabled */
 		ut_a(strchr(table->name.m_name, '/') != NULL);
 
-		err = dict_stats_update_persistent(table);
+		const bool	incremental = stats_upd_option
+			== DICT_STATS_RECALC_PERSISTENT_INCREMENTAL;
+		index_id_list_t	analyzed;
+		bool		deferred;
+
+		err = dict_stats_update_persistent(
+			table, incremental, &analyzed, &deferred);
 
 		if (err != DB_SUCCESS) {
 			return(err);
 		}
 
-		return(dict_stats_save(table, NULL));
+		if (deferred) {
+			/* Analyze the rest of the changed indexes in a
+			later run. */
+			dict_stats_recalc_pool_add(table);
+		}
+
+		return(dict_stats_save(table, incremental ? &analyzed : NULL));
+	}
 
 	case DICT_STATS_RECALC_TRANSIENT:
 		break;
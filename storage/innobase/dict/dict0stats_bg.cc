@@ -361,7 +361,8 @@ dict_stats_process_entry_from_recalc_pool(
 
 	} else {
 
-		dict_stats_update(table, DICT_STATS_RECALC_PERSISTENT);
+		dict_stats_update(
+			table, DICT_STATS_RECALC_PERSISTENT_INCREMENTAL);
 	}
 
 	mutex_enter(&dict_sys->mutex);
@@ -56,6 +56,7 @@ Created 10/25/1995 Heikki Tuuri
 # include "buf0lru.h"
 # include "ibuf0ibuf.h"
 # include "os0event.h"
+# include "srv0mon.h"
 # include "sync0sync.h"
 #else /* !UNIV_HOTBACKUP */
 # include "log0log.h"
@@ -65,7 +66,10 @@ Created 10/25/1995 Heikki Tuuri
 #include <fstream>
 #include <list>
 #include <array>
+#include <atomic>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #ifdef UNIV_PFS_IO
 mysql_pfs_key_t  innodb_tablespace_open_file_key;
@@ -817,6 +821,43 @@ Fil_Open::deleted(space_id_t space_id)
 	return(true);
 }
 
+/** Number of shards of the tablespace memory cache; a power of 2 */
+static const ulint	FIL_N_SHARDS = 64;
+
+/** A shard of the tablespace memory cache. A tablespace belongs to the
+shard selected by its space id. fil_io() and the i/o completion of reads
+look up the tablespace and start or complete the i/o on an open file
+holding only the mutex of the shard, so that page i/o on different
+tablespaces does not serialize on fil_system->mutex. */
+struct fil_shard_t {
+#ifndef UNIV_HOTBACKUP
+	ib_mutex_t	mutex;		/*!< The mutex protecting the LRU
+					list and fil_node_t::n_pending of
+					the files of the shard. It is held
+					together with fil_system->mutex
+					when modifying spaces, when opening
+					or closing a file and when setting
+					fil_space_t::stop_ios or stop_new_ops,
+					so that holding either one is enough
+					to read them */
+#endif /* !UNIV_HOTBACKUP */
+
+	Spaces		spaces;		/*!< Tablespace instances of the
+					shard hashed on the space id */
+
+	UT_LIST_BASE_NODE_T(fil_node_t) LRU;
+					/*!< base node for the LRU list of the
+					most recently used open files of the
+					shard with no pending i/o's; if we
+					start an i/o on the file, we first
+					remove it from this list, and return
+					it to the start of the list when the
+					i/o ends; log files and the system
+					tablespace are not put to this list:
+					they are opened after the startup,
+					and kept open until shutdown */
+};
+
 /** The tablespace memory cache; also the totality of logs (the log
 data space) is stored here; below we talk about tablespaces, but also
 the ib_logfiles form a 'space' and it is handled here */
@@ -825,8 +866,9 @@ struct fil_system_t {
 	ib_mutex_t	mutex;		/*!< The mutex protecting the cache */
 #endif /* !UNIV_HOTBACKUP */
 
-	Spaces		spaces;		/*!< Tablespace instances hashed on
-					the space id */
+	fil_shard_t	shards[FIL_N_SHARDS];
+					/*!< Tablespace instances hashed on
+					the space id, and the open files */
 
 	Names		names;		/*!< Tablespace instances hashed on
 					the space name */
@@ -834,17 +876,9 @@ struct fil_system_t {
 	/** Track the mapping from tablespace ID to file name on disk. */
 	Fil_Open	m_open;
 
-	UT_LIST_BASE_NODE_T(fil_node_t) LRU;
-					/*!< base node for the LRU list of the
-					most recently used open files with no
-					pending i/o's; if we start an i/o on
-					the file, we first remove it from this
-					list, and return it to the start of
-					the list when the i/o ends;
-					log files and the system tablespace are
-					not put to this list: they are opened
-					after the startup, and kept open until
-					shutdown */
+	ulint		next_lru_shard;	/*!< shard whose LRU list
+					fil_try_to_close_file_in_LRU() looks
+					at first */
 	UT_LIST_BASE_NODE_T(fil_space_t) unflushed_spaces;
 					/*!< base node for the list of those
 					tablespaces whose files contain
@@ -874,6 +908,28 @@ struct fil_system_t {
 initialized. */
 static fil_system_t*	fil_system	= NULL;
 
+#ifndef UNIV_HOTBACKUP
+/** How often the background tablespace extender looks at the
+tablespaces, in microseconds */
+static const ulint	FIL_EXTEND_AHEAD_INTERVAL = 1000000;
+
+/** Event that wakes up the background tablespace extender */
+static os_event_t	fil_extend_ahead_event;
+
+/** Whether the background tablespace extender is running */
+static std::atomic<bool>	fil_extend_ahead_running;
+#endif /* !UNIV_HOTBACKUP */
+
+/** Get the shard of the tablespace memory cache of a tablespace.
+@param[in]	space_id	Tablespace ID
+@return the shard */
+UNIV_INLINE
+fil_shard_t*
+fil_shard_get(space_id_t space_id)
+{
+	return(&fil_system->shards[space_id & (FIL_N_SHARDS - 1)]);
+}
+
 #ifdef UNIV_HOTBACKUP
 static ulint	srv_data_read;
 static ulint	srv_data_written;
@@ -922,7 +978,7 @@ fil_validate_skip(void)
 
 /********************************************************************//**
 Determines if a file node belongs to the least-recently-used list.
-@return true if the file belongs to fil_system->LRU mutex. */
+@return true if the file belongs to the LRU list of its shard. */
 UNIV_INLINE
 bool
 fil_space_belongs_in_lru(
@@ -1038,9 +1094,11 @@ fil_space_get_by_id(space_id_t id)
 {
 	ut_ad(mutex_own(&fil_system->mutex));
 
-	auto	it = fil_system->spaces.find(id);
+	const Spaces&	spaces = fil_shard_get(id)->spaces;
+
+	auto	it = spaces.find(id);
 
-	if (it == fil_system->spaces.end()) {
+	if (it == spaces.end()) {
 		return(nullptr);
 	}
 
@@ -1309,7 +1367,12 @@ fil_node_create_low(
 
 	node->atomic_write = atomic_write;
 
+	fil_shard_t*	shard = fil_shard_get(space->id);
+
+	mutex_enter(&shard->mutex);
 	UT_LIST_ADD_LAST(space->chain, node);
+	mutex_exit(&shard->mutex);
+
 	mutex_exit(&fil_system->mutex);
 
 	return(node);
@@ -1609,23 +1672,54 @@ add_size:
 		--node->in_use;
 	}
 
+	fil_shard_t*	shard = fil_shard_get(space->id);
+
+	mutex_enter(&shard->mutex);
+
 	if (fil_space_belongs_in_lru(space)) {
 
 		/* Put the node to the LRU list */
-		UT_LIST_ADD_FIRST(fil_system->LRU, node);
+		UT_LIST_ADD_FIRST(shard->LRU, node);
 	}
 
 	/* Set the open flag after writing the MLOG_FILE_OPEN log record. */
 	node->is_open = true;
 
+	mutex_exit(&shard->mutex);
+
 	++fil_n_file_opened;
 	++fil_system->n_open;
 
 	return(true);
 }
 
+/** Mark a file node closed, so that fil_io() does not start new i/o's on
+it, and take it off the LRU list. The caller must hold the shard mutex.
+@param[in,out]	node		File node
+@param[in,out]	shard		Shard of the tablespace of the file */
+static
+void
+fil_node_set_closed(fil_node_t* node, fil_shard_t* shard)
+{
+	ut_ad(mutex_own(&shard->mutex));
+
+	ut_a(node->is_open);
+	ut_a(node->n_pending == 0);
+
+	node->is_open = false;
+
+	if (fil_space_belongs_in_lru(node->space)) {
+
+		ut_a(UT_LIST_GET_LEN(shard->LRU) > 0);
+
+		/* The node is in the LRU list, remove it */
+		UT_LIST_REMOVE(shard->LRU, node);
+	}
+}
+
 /** Close a file node.
-@param[in]	lru_close	true if called from LRU close
+@param[in]	lru_close	true if called from LRU close, after
+fil_node_set_closed() was called on the node
 @param[in,out]	node		File node */
 static
 void
@@ -1633,7 +1727,7 @@ fil_node_close_file(fil_node_t* node, bool lru_close)
 {
 	ut_ad(mutex_own(&(fil_system->mutex)));
 
-	ut_a(node->is_open);
+	ut_a(lru_close || node->is_open);
 	ut_a(node->in_use == 0);
 	ut_a(node->n_pending == 0);
 	ut_a(node->n_pending_flushes == 0);
@@ -1644,24 +1738,22 @@ fil_node_close_file(fil_node_t* node, bool lru_close)
 	     || srv_fast_shutdown == 2);
 #endif /* !UNIV_HOTBACKUP */
 
+	if (!lru_close) {
+		fil_shard_t*	shard = fil_shard_get(node->space->id);
+
+		mutex_enter(&shard->mutex);
+		fil_node_set_closed(node, shard);
+		mutex_exit(&shard->mutex);
+	}
+
 	bool	ret = os_file_close(node->handle);
 	ut_a(ret);
 
-	node->is_open = false;
-
 	ut_a(fil_system->n_open > 0);
 
 	--fil_n_file_opened;
 	--fil_system->n_open;
 
-	if (fil_space_belongs_in_lru(node->space)) {
-
-		ut_a(UT_LIST_GET_LEN(fil_system->LRU) > 0);
-
-		/* The node is in the LRU list, remove it */
-		UT_LIST_REMOVE(fil_system->LRU, node);
-	}
-
 	/* Temporary tablespace is recreated on startup. It is never
 	recovered via redo. We can ignore it. */
 
@@ -1716,46 +1808,79 @@ fil_try_to_close_file_in_LRU(bool print_info)
 	ut_ad(mutex_own(&fil_system->mutex));
 
 	if (print_info) {
-		ib::info() << "fil_sys open file LRU len "
-			<< UT_LIST_GET_LEN(fil_system->LRU);
+		ulint	n_lru = 0;
+
+		for (const auto& shard : fil_system->shards) {
+			n_lru += UT_LIST_GET_LEN(shard.LRU);
+		}
+
+		ib::info() << "fil_sys open file LRU len " << n_lru;
 	}
 
-	for (auto node = UT_LIST_GET_LAST(fil_system->LRU);
-	     node != NULL;
-	     node = UT_LIST_GET_PREV(LRU, node)) {
+	/* Each shard keeps its own LRU list. Start from a different shard
+	each time, so that the files of all the shards get closed. */
 
-		if (node->modification_counter == node->flush_counter
-		    && node->n_pending_flushes == 0
-		    && node->in_use == 0) {
+	for (ulint i = 0; i < FIL_N_SHARDS; ++i) {
 
-			/* Will release the fil_system->mutex. */
-			fil_node_close_file(node, true);
+		ulint		shard_no = (fil_system->next_lru_shard + i)
+			& (FIL_N_SHARDS - 1);
+		fil_shard_t*	shard = &fil_system->shards[shard_no];
 
-			return(true);
-		}
+		mutex_enter(&shard->mutex);
 
-		if (!print_info) {
-			continue;
-		}
+		for (auto node = UT_LIST_GET_LAST(shard->LRU);
+		     node != NULL;
+		     node = UT_LIST_GET_PREV(LRU, node)) {
 
-		if (node->n_pending_flushes > 0) {
+			if (node->modification_counter == node->flush_counter
+			    && node->n_pending_flushes == 0
+			    && node->in_use == 0) {
 
-			ib::info() << "Cannot close file " << node->name
-				<< ", because n_pending_flushes "
-				<< node->n_pending_flushes;
-		}
+				/* Stop fil_io() from starting i/o's on the
+				file before releasing the shard mutex. */
+				fil_node_set_closed(node, shard);
 
-		if (node->modification_counter != node->flush_counter) {
-			ib::warn() << "Cannot close file " << node->name
-				<< ", because modification count "
-				<< node->modification_counter <<
-				" != flush count " << node->flush_counter;
-		}
+				mutex_exit(&shard->mutex);
+
+				fil_system->next_lru_shard = (shard_no + 1)
+					& (FIL_N_SHARDS - 1);
+
+				/* Will release the fil_system->mutex. */
+				fil_node_close_file(node, true);
+
+				return(true);
+			}
+
+			if (!print_info) {
+				continue;
+			}
+
+			if (node->n_pending_flushes > 0) {
+
+				ib::info() << "Cannot close file "
+					<< node->name
+					<< ", because n_pending_flushes "
+					<< node->n_pending_flushes;
+			}
+
+			if (node->modification_counter
+			    != node->flush_counter) {
+				ib::warn() << "Cannot close file "
+					<< node->name
+					<< ", because modification count "
+					<< node->modification_counter
+					<< " != flush count "
+					<< node->flush_counter;
+			}
 
-		if (node->in_use > 0) {
-			ib::info() << "Cannot close file " << node->name
-				<< ", because it is in use";
+			if (node->in_use > 0) {
+				ib::info() << "Cannot close file "
+					<< node->name
+					<< ", because it is in use";
+			}
 		}
+
+		mutex_exit(&shard->mutex);
 	}
 
 	return(false);
@@ -1941,7 +2066,11 @@ fil_space_detach(
 {
 	ut_ad(mutex_own(&fil_system->mutex));
 
-	fil_system->spaces.erase(space->id);
+	fil_shard_t*	shard = fil_shard_get(space->id);
+
+	mutex_enter(&shard->mutex);
+	shard->spaces.erase(space->id);
+	mutex_exit(&shard->mutex);
 
 	fil_system->names.erase(space->name);
 
@@ -2104,6 +2233,8 @@ fil_space_create(
 
 	space->encryption_type = Encryption::NONE;
 
+	space->extend_ahead_free = ULINT_UNDEFINED;
+
 	rw_lock_create(fil_space_latch_key, &space->latch, SYNC_FSP);
 
 	if (space->purpose == FIL_TYPE_TEMPORARY) {
@@ -2111,9 +2242,15 @@ fil_space_create(
 	}
 
 	{
-		auto	it = fil_system->spaces.insert(
+		fil_shard_t*	shard = fil_shard_get(id);
+
+		mutex_enter(&shard->mutex);
+
+		auto	it = shard->spaces.insert(
 			Spaces::value_type(id, space));
 
+		mutex_exit(&shard->mutex);
+
 		ut_a(it.second);
 	}
 
@@ -2437,7 +2574,15 @@ fil_init(
 	mutex_create(LATCH_ID_FIL_SYSTEM, &fil_system->mutex);
 
 	new(&fil_system->names) Names();
-	new(&fil_system->spaces) Spaces();
+
+	for (auto& shard : fil_system->shards) {
+
+		mutex_create(LATCH_ID_FIL_SHARD, &shard.mutex);
+
+		new(&shard.spaces) Spaces();
+
+		UT_LIST_INIT(shard.LRU, &fil_node_t::LRU);
+	}
 
 	if (fil_scanned != nullptr) {
 
@@ -2450,12 +2595,15 @@ fil_init(
 		new(&fil_system->m_open) Fil_Open();
 	}
 
-	UT_LIST_INIT(fil_system->LRU, &fil_node_t::LRU);
 	UT_LIST_INIT(fil_system->space_list, &fil_space_t::space_list);
 	UT_LIST_INIT(fil_system->unflushed_spaces,
 		     &fil_space_t::unflushed_spaces);
 
 	fil_system->max_n_open = max_n_open;
+
+#ifndef UNIV_HOTBACKUP
+	fil_extend_ahead_event = os_event_create(0);
+#endif /* !UNIV_HOTBACKUP */
 }
 
 /*******************************************************************//**
@@ -3123,7 +3271,14 @@ fil_check_pending_operations(
 	mutex_enter(&fil_system->mutex);
 	fil_space_t* sp = fil_space_get_by_id(id);
 	if (sp) {
+		fil_shard_t*	shard = fil_shard_get(id);
+
+		/* Stop fil_io() from starting i/o's without
+		fil_system->mutex, so that n_pending can only
+		decrease while we are holding fil_system->mutex. */
+		mutex_enter(&shard->mutex);
 		sp->stop_new_ops = true;
+		mutex_exit(&shard->mutex);
 	}
 	mutex_exit(&fil_system->mutex);
 
@@ -3520,7 +3675,11 @@ fil_truncate_tablespace(
 			node->name, node->handle, size, srv_read_only_mode);
 
 		if (success) {
+			fil_shard_t*	shard = fil_shard_get(space_id);
+
+			mutex_enter(&shard->mutex);
 			space->stop_new_ops = false;
+			mutex_exit(&shard->mutex);
 		}
 	}
 
@@ -3802,6 +3961,7 @@ fil_rename_tablespace(
 	fil_space_t*	space;
 	fil_node_t*	node;
 	ulint		count		= 0;
+	fil_shard_t*	shard		= fil_shard_get(id);
 	ut_a(id != 0);
 
 	ut_ad(strchr(new_name, '/') != NULL);
@@ -3836,7 +3996,9 @@ retry:
 
 	} else if (count > 25000) {
 
+		mutex_enter(&shard->mutex);
 		space->stop_ios = false;
+		mutex_exit(&shard->mutex);
 
 		mutex_exit(&fil_system->mutex);
 
@@ -3848,7 +4010,9 @@ retry:
 			<< "Cannot find " << space->name
 			<< " in tablespace memory cache";
 
+		mutex_enter(&shard->mutex);
 		space->stop_ios = false;
+		mutex_exit(&shard->mutex);
 
 		mutex_exit(&fil_system->mutex);
 
@@ -3873,7 +4037,9 @@ retry:
 					<< " is already in the tablespace"
 					<< " memory cache";
 
+				mutex_enter(&shard->mutex);
 				space->stop_ios = false;
+				mutex_exit(&shard->mutex);
 
 				mutex_exit(&fil_system->mutex);
 
@@ -3886,7 +4052,9 @@ retry:
 	operating systems can rename an open file. For the closing we have to
 	wait until there are no pending i/o's or flushes on the file. */
 
+	mutex_enter(&shard->mutex);
 	space->stop_ios = true;
+	mutex_exit(&shard->mutex);
 
 	/* The following code must change when InnoDB supports
 	multiple datafiles per tablespace. */
@@ -4000,7 +4168,9 @@ retry:
 	}
 
 	ut_ad(space->stop_ios);
+	mutex_enter(&shard->mutex);
 	space->stop_ios = false;
+	mutex_exit(&shard->mutex);
 	mutex_exit(&fil_system->mutex);
 
 	ut_free(old_file_name);
@@ -5031,13 +5201,18 @@ fil_write_zeros(
 }
 
 /** Try to extend a tablespace if it is smaller than the specified size.
-@param[in,out]	space	tablespace
-@param[in]	size	desired size in pages
+@param[in,out]	space		tablespace
+@param[in]	size		desired size in pages
+@param[in]	background	true if called by the background tablespace
+				extender, false if called by a thread that
+				needs the pages now
 @return whether the tablespace is at least as big as requested */
+static
 bool
-fil_space_extend(
+fil_space_extend_low(
 	fil_space_t*	space,
-	page_no_t	size)
+	page_no_t	size,
+	bool		background)
 {
 	/* In read-only mode we allow write to shared temporary tablespace
 	as intrinsic table created by Optimizer reside in this tablespace. */
@@ -5189,7 +5364,12 @@ retry:
 
 	mutex_enter(&fil_system->mutex);
 
+	fil_shard_t*	shard = fil_shard_get(space->id);
+
+	mutex_enter(&shard->mutex);
 	node->size += pages_added;
+	mutex_exit(&shard->mutex);
+
 	space->size += pages_added;
 
 	ut_a(node->in_use > 0);
@@ -5216,8 +5396,291 @@ retry:
 
 	fil_flush(space->id);
 
+#ifndef UNIV_HOTBACKUP
+	if (background) {
+		MONITOR_INC(MONITOR_FIL_EXTEND_AHEAD);
+		MONITOR_INC_VALUE(MONITOR_FIL_EXTEND_AHEAD_PAGES, pages_added);
+	}
+#endif /* !UNIV_HOTBACKUP */
+
+	return(success);
+}
+
+/** Try to extend a tablespace if it is smaller than the specified size.
+@param[in,out]	space	tablespace
+@param[in]	size	desired size in pages
+@return whether the tablespace is at least as big as requested */
+bool
+fil_space_extend(
+	fil_space_t*	space,
+	page_no_t	size)
+{
+	return(fil_space_extend_low(space, size, false));
+}
+
+#ifndef UNIV_HOTBACKUP
+/** Check if the background tablespace extender looks after a tablespace.
+Only file-per-table and general tablespaces qualify: the system and
+temporary tablespaces have their own autoextend sizes, and undo
+tablespaces are truncated.
+@param[in]	space	tablespace
+@return true if the tablespace is extended ahead of demand */
+static
+bool
+fil_extend_ahead_eligible(
+	const fil_space_t*	space)
+{
+	return(space->purpose == FIL_TYPE_TABLESPACE
+	       && !fsp_is_system_or_temp_tablespace(space->id)
+	       && !fsp_is_undo_tablespace(space->id));
+}
+
+/** Check if a tablespace is still small enough to be extended one
+extent at a time by fsp_try_extend_data_file(), which is cheap.
+@param[in]	space	tablespace
+@return true if the tablespace grows one extent at a time */
+static
+bool
+fil_extend_ahead_small(
+	const fil_space_t*	space)
+{
+	const page_size_t	page_size(space->flags);
+
+	return(fsp_get_pages_to_extend_ibd(page_size, space->size)
+	       <= fsp_get_extent_size_in_pages(page_size));
+}
+#endif /* !UNIV_HOTBACKUP */
+
+/** Try to extend a tablespace for a thread that needs the pages now.
+Counts the extension as a stall if the background tablespace extender
+should have done it.
+@param[in,out]	space	tablespace
+@param[in]	size	desired size in pages
+@return whether the tablespace is at least as big as requested */
+bool
+fil_space_extend_on_demand(
+	fil_space_t*	space,
+	page_no_t	size)
+{
+#ifndef UNIV_HOTBACKUP
+	if (!fil_extend_ahead_eligible(space)
+	    || fil_extend_ahead_small(space)) {
+
+		return(fil_space_extend_low(space, size, false));
+	}
+
+	const uintmax_t	start_us = ut_time_us(NULL);
+	const page_no_t	old_size = space->size;
+
+	bool	success = fil_space_extend_low(space, size, false);
+
+	/* Nothing was written if the background extender got there
+	first. */
+	if (space->size > old_size) {
+		MONITOR_INC(MONITOR_FIL_EXTEND_STALLS);
+		MONITOR_INC_VALUE(MONITOR_FIL_EXTEND_STALL_TIME,
+				  ut_time_us(NULL) - start_us);
+
+		/* Let the background extender look at the space again,
+		with the demand that caused this stall. */
+		if (fil_extend_ahead_running) {
+			os_event_set(fil_extend_ahead_event);
+		}
+	}
+
 	return(success);
+#else /* !UNIV_HOTBACKUP */
+	return(fil_space_extend_low(space, size, false));
+#endif /* !UNIV_HOTBACKUP */
+}
+
+#ifndef UNIV_HOTBACKUP
+/** Decide how far the background tablespace extender should extend a
+tablespace, and remember the state for the next round.  The free space
+of a tablespace is the extents in FSP_FREE plus the extents between
+FSP_FREE_LIMIT and the end of the file.  The demand is how much of it
+was consumed since the previous round.  The extender keeps about twice
+the demand of a round free, and extends by that much at a time, so that
+the extension size follows the growth rate of the tablespace.
+@param[in,out]	space		tablespace
+@param[in]	max_extents	maximum number of extents to keep free
+@return size in pages to extend the tablespace to, or 0 to leave it */
+static
+page_no_t
+fil_extend_ahead_size(
+	fil_space_t*	space,
+	ulint		max_extents)
+{
+	ut_ad(mutex_own(&fil_system->mutex));
+
+	const page_size_t	page_size(space->flags);
+	const page_no_t		extent_pages
+		= fsp_get_extent_size_in_pages(page_size);
+
+	/* Small tablespaces should stay small. */
+	if (space->size <= space->free_limit
+	    || fil_extend_ahead_small(space)) {
+
+		space->extend_ahead_free = ULINT_UNDEFINED;
+		return(0);
+	}
+
+	/* These are read without the space latch; an estimate will do. */
+	const ulint	free_extents = space->free_len
+		+ (space->size - space->free_limit) / extent_pages;
+
+	const ulint	prev_free = space->extend_ahead_free;
+
+	space->extend_ahead_free = free_extents;
+
+	if (prev_free == ULINT_UNDEFINED) {
+		return(0);
+	}
+
+	const ulint	demand = prev_free > free_extents
+		? prev_free - free_extents : 0;
+
+	/* Forget the demand of earlier rounds gradually. */
+	space->extend_ahead_target = std::min(
+		std::max(2 * demand, space->extend_ahead_target / 2),
+		max_extents);
+
+	if (space->extend_ahead_target == 0) {
+		return(0);
+	}
+
+	space->extend_ahead_target = std::max<ulint>(
+		space->extend_ahead_target,
+		std::min<ulint>(FSP_FREE_ADD, max_extents));
+
+	if (free_extents >= space->extend_ahead_target) {
+		return(0);
+	}
+
+	const ulint	n_extents = 2 * space->extend_ahead_target
+		- free_extents;
+
+	/* The extents added now are not demand in the next round. */
+	space->extend_ahead_free += n_extents;
+
+	return(static_cast<page_no_t>(
+		space->size + n_extents * extent_pages));
+}
+
+/** Extend the growing tablespaces ahead of demand.
+@param[in]	max_extents	maximum number of extents to keep free in
+				each tablespace */
+static
+void
+fil_extend_ahead(
+	ulint	max_extents)
+{
+	typedef std::pair<fil_space_t*, page_no_t>	Extend;
+
+	std::vector<Extend, ut_allocator<Extend> >	spaces;
+
+	mutex_enter(&fil_system->mutex);
+
+	for (fil_space_t* space = UT_LIST_GET_FIRST(fil_system->space_list);
+	     space != NULL;
+	     space = UT_LIST_GET_NEXT(space_list, space)) {
+
+		if (!fil_extend_ahead_eligible(space)
+		    || space->stop_new_ops
+		    || space->size_in_header == 0
+		    || UT_LIST_GET_LEN(space->chain) != 1) {
+
+			continue;
+		}
+
+		page_no_t	size = fil_extend_ahead_size(space, max_extents);
+
+		if (size > 0) {
+			/* Prevent the tablespace from being dropped. */
+			++space->n_pending_ops;
+
+			spaces.push_back(Extend(space, size));
+		}
+	}
+
+	mutex_exit(&fil_system->mutex);
+
+	for (auto& extend : spaces) {
+
+		if (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+			/* Only the file size changes. FSP_SIZE is updated
+			by the next fsp_try_extend_data_file(), which then
+			finds the pages already allocated, just like after
+			a restart. */
+			fil_space_extend_low(extend.first, extend.second, true);
+		}
+
+		fil_space_release(extend.first);
+	}
+}
+
+/** Background thread that extends growing tablespaces ahead of demand,
+so that the threads that insert rows rarely have to extend a file while
+they hold the tablespace latch. */
+void
+fil_extend_ahead_thread()
+{
+	my_thread_init();
+
+	ut_ad(!srv_read_only_mode);
+	ut_ad(fil_extend_ahead_running);
+
+	int64_t	sig_count = os_event_reset(fil_extend_ahead_event);
+
+	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+
+		os_event_wait_time_low(fil_extend_ahead_event,
+				       FIL_EXTEND_AHEAD_INTERVAL, sig_count);
+
+		sig_count = os_event_reset(fil_extend_ahead_event);
+
+		/* The maximum is in megabytes; an extent is one
+		megabyte for page sizes up to 16KiB. */
+		const ulint	max_extents = srv_extend_ahead_max_size
+			* 1024 * 1024 / (UNIV_PAGE_SIZE * FSP_EXTENT_SIZE);
+
+		if (max_extents > 0
+		    && srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+
+			fil_extend_ahead(max_extents);
+		}
+	}
+
+	fil_extend_ahead_running = false;
+
+	my_thread_end();
+}
+
+/** Make the background tablespace extender count as running before it
+is created, so that it is waited for at shutdown even if it has not
+started to run yet. */
+void
+fil_extend_ahead_thread_starting()
+{
+	ut_ad(!fil_extend_ahead_running);
+
+	fil_extend_ahead_running = true;
+}
+
+/** Wake up the background tablespace extender. */
+void
+fil_extend_ahead_thread_wakeup()
+{
+	os_event_set(fil_extend_ahead_event);
+}
+
+/** @return true if the background tablespace extender is running */
+bool
+fil_extend_ahead_thread_active()
+{
+	return(fil_extend_ahead_running);
 }
+#endif /* !UNIV_HOTBACKUP */
 
 #ifdef UNIV_HOTBACKUP
 /********************************************************************//**
@@ -5364,19 +5827,42 @@ fil_space_get_n_reserved_extents(
 
 /*============================ FILE I/O ================================*/
 
-/** NOTE: you must call fil_mutex_enter_and_prepare_for_io() first!
-
-Prepares a file node for i/o. Opens the file if it is closed. Updates the
-pending i/o's field in the node and the system appropriately. Takes the node
-off the LRU list if it is in the LRU list. The caller must hold the fil_sys
+/** Note that an i/o is about to start on an open file node. Takes the node
+off the LRU list if it is in the LRU list. The caller must hold the shard
 mutex.
-@param[in]	node		File node
-@param[in]	system		Tablespace memory cache
-@param[in]	space		Tablespace instance
-@param[in]	extend		true if file is being extended
-@return false if the file can't be opened, otherwise true */
+@param[in,out]	node		File node
+@param[in,out]	shard		Shard of the tablespace of the file */
 static
-bool
+void
+fil_node_start_io(fil_node_t* node, fil_shard_t* shard)
+{
+	ut_ad(mutex_own(&shard->mutex));
+	ut_a(node->is_open);
+
+	if (node->n_pending == 0 && fil_space_belongs_in_lru(node->space)) {
+		/* The node is in the LRU list, remove it */
+
+		ut_a(UT_LIST_GET_LEN(shard->LRU) > 0);
+
+		UT_LIST_REMOVE(shard->LRU, node);
+	}
+
+	++node->n_pending;
+}
+
+/** NOTE: you must call fil_mutex_enter_and_prepare_for_io() first!
+
+Prepares a file node for i/o. Opens the file if it is closed. Updates the
+pending i/o's field in the node and the system appropriately. Takes the node
+off the LRU list if it is in the LRU list. The caller must hold the fil_sys
+mutex.
+@param[in]	node		File node
+@param[in]	system		Tablespace memory cache
+@param[in]	space		Tablespace instance
+@param[in]	extend		true if file is being extended
+@return false if the file can't be opened, otherwise true */
+static
+bool
 fil_node_prepare_for_io(
 	fil_node_t*	node,
 	fil_system_t*	system,
@@ -5414,22 +5900,77 @@ fil_node_prepare_for_io(
 		}
 	}
 
-	if (node->n_pending == 0 && fil_space_belongs_in_lru(space)) {
-		/* The node is in the LRU list, remove it */
+	fil_shard_t*	shard = fil_shard_get(space->id);
+
+	mutex_enter(&shard->mutex);
+	fil_node_start_io(node, shard);
+	mutex_exit(&shard->mutex);
+
+	return(true);
+}
 
-		ut_a(UT_LIST_GET_LEN(system->LRU) > 0);
+/** Look up the file node of a page in a tablespace whose files are open
+and start an i/o on it, holding only the mutex of the shard of the
+tablespace. This is the common case of fil_io(): it does not need
+fil_system->mutex, because it does not open any file.
+@param[in]	page_id		page id
+@param[out]	space		tablespace
+@param[out]	page_no		page number within the file
+@return the file node
+@retval nullptr if the i/o must be prepared by fil_node_prepare_for_io() */
+static
+fil_node_t*
+fil_node_start_io_if_open(
+	const page_id_t&	page_id,
+	fil_space_t**		space,
+	page_no_t*		page_no)
+{
+	fil_shard_t*	shard = fil_shard_get(page_id.space());
 
-		UT_LIST_REMOVE(system->LRU, node);
+	mutex_enter(&shard->mutex);
+
+	auto	it = shard->spaces.find(page_id.space());
+
+	if (it == shard->spaces.end()
+	    || it->second->stop_new_ops
+	    || it->second->stop_ios) {
+
+		/* Let the slow path report the error or wait. */
+		mutex_exit(&shard->mutex);
+
+		return(nullptr);
 	}
 
-	node->n_pending++;
+	page_no_t	cur_page_no = page_id.page_no();
 
-	return(true);
+	for (auto node = UT_LIST_GET_FIRST(it->second->chain);
+	     node != NULL && node->is_open && node->size > 0;
+	     node = UT_LIST_GET_NEXT(chain, node)) {
+
+		if (node->size > cur_page_no) {
+
+			fil_node_start_io(node, shard);
+
+			mutex_exit(&shard->mutex);
+
+			*space = it->second;
+			*page_no = cur_page_no;
+
+			return(node);
+		}
+
+		cur_page_no -= node->size;
+	}
+
+	mutex_exit(&shard->mutex);
+
+	return(nullptr);
 }
 
 /********************************************************************//**
 Updates the data structures when an i/o operation finishes. Updates the
-pending i/o's field in the node appropriately. */
+pending i/o's field in the node appropriately. The caller must hold the
+fil_sys mutex if the i/o was a write. */
 static
 void
 fil_node_complete_io(
@@ -5439,11 +5980,9 @@ fil_node_complete_io(
 	const IORequest&type)	/*!< in: IO_TYPE_*, marks the node as
 				modified if TYPE_IS_WRITE() */
 {
-	ut_ad(mutex_own(&system->mutex));
+	ut_ad(!type.is_write() || mutex_own(&system->mutex));
 	ut_a(node->n_pending > 0);
 
-	--node->n_pending;
-
 	ut_ad(type.validate());
 
 	if (type.is_write()) {
@@ -5472,11 +6011,19 @@ fil_node_complete_io(
 		}
 	}
 
+	fil_shard_t*	shard = fil_shard_get(node->space->id);
+
+	mutex_enter(&shard->mutex);
+
+	--node->n_pending;
+
 	if (node->n_pending == 0 && fil_space_belongs_in_lru(node->space)) {
 
 		/* The node must be put back to the LRU list */
-		UT_LIST_ADD_FIRST(system->LRU, node);
+		UT_LIST_ADD_FIRST(shard->LRU, node);
 	}
+
+	mutex_exit(&shard->mutex);
 }
 
 /** Report information about an invalid page access. */
@@ -5550,98 +6097,33 @@ fil_io_set_encryption(
 	req_type.encryption_algorithm(Encryption::AES);
 }
 
-/** Read or write data. This operation could be asynchronous (aio).
-@param[in,out]	type		IO context
+/** Look up the file node of a page and start an i/o on it holding
+fil_system->mutex. Opens the file if it is closed.
+@param[in]	req_type	IO context
 @param[in]	sync		whether synchronous aio is desired
 @param[in]	page_id		page id
-@param[in]	page_size	page size
-@param[in]	byte_offset	remainder of offset in bytes; in aio this
-must be divisible by the OS block size
-@param[in]	len		how many bytes to read or write; this must
-not cross a file boundary; in aio this must be a block size multiple
-@param[in,out]	buf		buffer where to store read data or from where
-to write; in aio this must be appropriately aligned
-@param[in]	message		message for aio handler if !sync, else ignored
+@param[in]	byte_offset	remainder of offset in bytes
+@param[in]	len		how many bytes to read or write
+@param[out]	space_out	tablespace
+@param[out]	node_out	file node
+@param[out]	page_no		page number within the file
 @return error code
 @retval DB_SUCCESS on success
-@retval DB_TABLESPACE_DELETED if the tablespace does not exist */
+@retval DB_TABLESPACE_DELETED if the tablespace does not exist
+@retval DB_ERROR if the page does not exist and the request ignores
+missing pages */
+static
 dberr_t
-fil_io(
-	const IORequest&	type,
+fil_io_prepare(
+	const IORequest&	req_type,
 	bool			sync,
 	const page_id_t&	page_id,
-	const page_size_t&	page_size,
 	ulint			byte_offset,
 	ulint			len,
-	void*			buf,
-	void*			message)
+	fil_space_t**		space_out,
+	fil_node_t**		node_out,
+	page_no_t*		page_no)
 {
-	os_offset_t		offset;
-	IORequest		req_type(type);
-
-	ut_ad(req_type.validate());
-
-	ut_ad(len > 0);
-	ut_ad(byte_offset < UNIV_PAGE_SIZE);
-	ut_ad(!page_size.is_compressed() || byte_offset == 0);
-	ut_ad(UNIV_PAGE_SIZE == (ulong)(1 << UNIV_PAGE_SIZE_SHIFT));
-#if (1 << UNIV_PAGE_SIZE_SHIFT_MAX) != UNIV_PAGE_SIZE_MAX
-# error "(1 << UNIV_PAGE_SIZE_SHIFT_MAX) != UNIV_PAGE_SIZE_MAX"
-#endif
-#if (1 << UNIV_PAGE_SIZE_SHIFT_MIN) != UNIV_PAGE_SIZE_MIN
-# error "(1 << UNIV_PAGE_SIZE_SHIFT_MIN) != UNIV_PAGE_SIZE_MIN"
-#endif
-	ut_ad(fil_validate_skip());
-
-#ifndef UNIV_HOTBACKUP
-
-	/* ibuf bitmap pages must be read in the sync AIO mode: */
-	ut_ad(recv_no_ibuf_operations
-	      || req_type.is_write()
-	      || !ibuf_bitmap_page(page_id, page_size)
-	      || sync
-	      || req_type.is_log());
-
-	ulint	mode;
-
-	if (sync) {
-
-		mode = OS_AIO_SYNC;
-
-	} else if (req_type.is_log()) {
-
-		mode = OS_AIO_LOG;
-
-	} else if (req_type.is_read()
-		   && !recv_no_ibuf_operations
-		   && ibuf_page(page_id, page_size, NULL)) {
-
-		mode = OS_AIO_IBUF;
-
-		/* Reduce probability of deadlock bugs in connection with ibuf:
-		do not let the ibuf i/o handler sleep */
-
-		req_type.clear_do_not_wake();
-	} else {
-		mode = OS_AIO_NORMAL;
-	}
-#else /* !UNIV_HOTBACKUP */
-	ut_a(sync);
-	mode = OS_AIO_SYNC;
-#endif /* !UNIV_HOTBACKUP */
-
-	if (req_type.is_read()) {
-
-		srv_stats.data_read.add(len);
-
-	} else if (req_type.is_write()) {
-
-		ut_ad(!srv_read_only_mode
-		      || fsp_is_system_temporary(page_id.space()));
-
-		srv_stats.data_written.add(len);
-	}
-
 	/* Reserve the fil_system mutex and make sure that we can open at
 	least one file while holding it, if the file is not already open */
 
@@ -5680,8 +6162,6 @@ fil_io(
 		return(DB_TABLESPACE_DELETED);
 	}
 
-	ut_ad(mode != OS_AIO_IBUF || fil_type_is_data(space->purpose));
-
 	page_no_t	cur_page_no = page_id.page_no();
 	fil_node_t*	node = UT_LIST_GET_FIRST(space->chain);
 
@@ -5780,6 +6260,147 @@ fil_io(
 	/* Now we have made the changes in the data structures of fil_system */
 	mutex_exit(&fil_system->mutex);
 
+	*space_out = space;
+	*node_out = node;
+	*page_no = cur_page_no;
+
+	return(DB_SUCCESS);
+}
+
+/** Update the data structures when an i/o operation finishes. Reads do not
+need fil_system->mutex.
+@param[in,out]	node		File node
+@param[in]	type		IO context */
+static
+void
+fil_complete_io(fil_node_t* node, const IORequest& type)
+{
+	if (type.is_write()) {
+
+		mutex_enter(&fil_system->mutex);
+
+		fil_node_complete_io(node, fil_system, type);
+
+		mutex_exit(&fil_system->mutex);
+	} else {
+		fil_node_complete_io(node, fil_system, type);
+	}
+}
+
+/** Read or write data. This operation could be asynchronous (aio).
+@param[in,out]	type		IO context
+@param[in]	sync		whether synchronous aio is desired
+@param[in]	page_id		page id
+@param[in]	page_size	page size
+@param[in]	byte_offset	remainder of offset in bytes; in aio this
+must be divisible by the OS block size
+@param[in]	len		how many bytes to read or write; this must
+not cross a file boundary; in aio this must be a block size multiple
+@param[in,out]	buf		buffer where to store read data or from where
+to write; in aio this must be appropriately aligned
+@param[in]	message		message for aio handler if !sync, else ignored
+@return error code
+@retval DB_SUCCESS on success
+@retval DB_TABLESPACE_DELETED if the tablespace does not exist */
+dberr_t
+fil_io(
+	const IORequest&	type,
+	bool			sync,
+	const page_id_t&	page_id,
+	const page_size_t&	page_size,
+	ulint			byte_offset,
+	ulint			len,
+	void*			buf,
+	void*			message)
+{
+	os_offset_t		offset;
+	IORequest		req_type(type);
+
+	ut_ad(req_type.validate());
+
+	ut_ad(len > 0);
+	ut_ad(byte_offset < UNIV_PAGE_SIZE);
+	ut_ad(!page_size.is_compressed() || byte_offset == 0);
+	ut_ad(UNIV_PAGE_SIZE == (ulong)(1 << UNIV_PAGE_SIZE_SHIFT));
+#if (1 << UNIV_PAGE_SIZE_SHIFT_MAX) != UNIV_PAGE_SIZE_MAX
+# error "(1 << UNIV_PAGE_SIZE_SHIFT_MAX) != UNIV_PAGE_SIZE_MAX"
+#endif
+#if (1 << UNIV_PAGE_SIZE_SHIFT_MIN) != UNIV_PAGE_SIZE_MIN
+# error "(1 << UNIV_PAGE_SIZE_SHIFT_MIN) != UNIV_PAGE_SIZE_MIN"
+#endif
+	ut_ad(fil_validate_skip());
+
+#ifndef UNIV_HOTBACKUP
+
+	/* ibuf bitmap pages must be read in the sync AIO mode: */
+	ut_ad(recv_no_ibuf_operations
+	      || req_type.is_write()
+	      || !ibuf_bitmap_page(page_id, page_size)
+	      || sync
+	      || req_type.is_log());
+
+	ulint	mode;
+
+	if (sync) {
+
+		mode = OS_AIO_SYNC;
+
+	} else if (req_type.is_log()) {
+
+		mode = OS_AIO_LOG;
+
+	} else if (req_type.is_read()
+		   && !recv_no_ibuf_operations
+		   && ibuf_page(page_id, page_size, NULL)) {
+
+		mode = OS_AIO_IBUF;
+
+		/* Reduce probability of deadlock bugs in connection with ibuf:
+		do not let the ibuf i/o handler sleep */
+
+		req_type.clear_do_not_wake();
+	} else {
+		mode = OS_AIO_NORMAL;
+	}
+#else /* !UNIV_HOTBACKUP */
+	ut_a(sync);
+	mode = OS_AIO_SYNC;
+#endif /* !UNIV_HOTBACKUP */
+
+	if (req_type.is_read()) {
+
+		srv_stats.data_read.add(len);
+
+	} else if (req_type.is_write()) {
+
+		ut_ad(!srv_read_only_mode
+		      || fsp_is_system_temporary(page_id.space()));
+
+		srv_stats.data_written.add(len);
+	}
+
+	fil_space_t*	space = nullptr;
+	page_no_t	cur_page_no;
+
+	/* If the file of the page is open, start the i/o holding only the
+	mutex of the shard of the tablespace. */
+
+	fil_node_t*	node = fil_node_start_io_if_open(
+		page_id, &space, &cur_page_no);
+
+	if (node == nullptr) {
+
+		dberr_t	err = fil_io_prepare(
+			req_type, sync, page_id, byte_offset, len,
+			&space, &node, &cur_page_no);
+
+		if (err != DB_SUCCESS) {
+			return(err);
+		}
+	}
+
+	ut_ad(mode != OS_AIO_IBUF || fil_type_is_data(space->purpose));
+
 	/* Calculate the low 32 bits and the high 32 bits of the file offset */
 
 	if (!page_size.is_compressed()) {
@@ -5893,11 +6514,7 @@ fil_io(
 		/* The i/o operation is already completed when we return from
 		os_aio: */
 
-		mutex_enter(&fil_system->mutex);
-
-		fil_node_complete_io(node, fil_system, req_type);
-
-		mutex_exit(&fil_system->mutex);
+		fil_complete_io(node, req_type);
 
 		ut_ad(fil_validate_skip());
 	}
@@ -5934,11 +6551,7 @@ fil_aio_wait(
 
 	srv_set_io_thread_op_info(segment, "complete io for fil node");
 
-	mutex_enter(&fil_system->mutex);
-
-	fil_node_complete_io(node, fil_system, type);
-
-	mutex_exit(&fil_system->mutex);
+	fil_complete_io(node, type);
 
 	ut_ad(fil_validate_skip());
 
@@ -5968,6 +6581,55 @@ fil_aio_wait(
 
 	ut_ad(0);
 }
+
+/** Completes, in the calling thread, asynchronous page writes that the
+kernel has already finished, instead of leaving them to the i/o handler
+threads. This only does something with io_uring. The caller must not hold
+any latches.
+@param[in]	n_max	maximum number of writes to complete
+@return number of writes completed */
+ulint
+fil_aio_complete_writes(
+	ulint	n_max)
+{
+	ulint	n_completed = 0;
+
+	if (!srv_use_io_uring) {
+		return(0);
+	}
+
+	while (n_completed < n_max) {
+		fil_node_t*	node;
+		IORequest	type;
+		void*		message;
+
+		dberr_t	err = os_aio_reap_write(&node, &message, &type);
+
+		ut_a(err == DB_SUCCESS);
+
+		if (node == NULL) {
+			break;
+		}
+
+		ut_ad(type.is_write());
+
+		fil_complete_io(node, type);
+
+		/* The write array holds page writes only: the redo log
+		has an array of its own. */
+		ut_ad(node->space->purpose != FIL_TYPE_LOG);
+
+		/* async single page writes from the dblwr buffer don't have
+		access to the page */
+		if (message != NULL) {
+			buf_page_io_complete(static_cast<buf_page_t*>(message));
+		}
+
+		++n_completed;
+	}
+
+	return(n_completed);
+}
 #endif /* UNIV_HOTBACKUP */
 
 /**********************************************************************//**
@@ -6221,24 +6883,31 @@ fil_validate(void)
 
 	/* Look for spaces in the hash table */
 
-	for (auto& elem : fil_system->spaces) {
+	for (auto& shard : fil_system->shards) {
 
-		n_open += Check::validate(elem.second);
-	}
+		mutex_enter(&shard.mutex);
 
-	ut_a(fil_system->n_open == n_open);
+		for (auto& elem : shard.spaces) {
+
+			n_open += Check::validate(elem.second);
+		}
 
-	UT_LIST_CHECK(fil_system->LRU);
+		UT_LIST_CHECK(shard.LRU);
 
-	for (auto fil_node = UT_LIST_GET_FIRST(fil_system->LRU);
-	     fil_node != 0;
-	     fil_node = UT_LIST_GET_NEXT(LRU, fil_node)) {
+		for (auto fil_node = UT_LIST_GET_FIRST(shard.LRU);
+		     fil_node != 0;
+		     fil_node = UT_LIST_GET_NEXT(LRU, fil_node)) {
+
+			ut_a(fil_node->is_open);
+			ut_a(fil_node->n_pending == 0);
+			ut_a(fil_space_belongs_in_lru(fil_node->space));
+		}
 
-		ut_a(fil_node->is_open);
-		ut_a(fil_node->n_pending == 0);
-		ut_a(fil_space_belongs_in_lru(fil_node->space));
+		mutex_exit(&shard.mutex);
 	}
 
+	ut_a(fil_system->n_open == n_open);
+
 	mutex_exit(&fil_system->mutex);
 
 	return(true);
@@ -6323,11 +6992,17 @@ fil_close(void)
 
 	call_destructor(&fil_system->names);
 
-	call_destructor(&fil_system->spaces);
+	for (auto& shard : fil_system->shards) {
+
+		call_destructor(&shard.spaces);
+
+		ut_a(UT_LIST_GET_LEN(shard.LRU) == 0);
+
+		mutex_free(&shard.mutex);
+	}
 
 	call_destructor(&fil_system->m_open);
 
-	ut_a(UT_LIST_GET_LEN(fil_system->LRU) == 0);
 	ut_a(UT_LIST_GET_LEN(fil_system->unflushed_spaces) == 0);
 	ut_a(UT_LIST_GET_LEN(fil_system->space_list) == 0);
 
@@ -6335,6 +7010,10 @@ fil_close(void)
 
 	ut_free(fil_system);
 	fil_system = NULL;
+
+#ifndef UNIV_HOTBACKUP
+	os_event_destroy(fil_extend_ahead_event);
+#endif /* !UNIV_HOTBACKUP */
 }
 
 /********************************************************************//**
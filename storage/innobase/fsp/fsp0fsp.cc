@@ -1248,7 +1248,7 @@ fsp_try_extend_data_file_with_pages(
 
 	ut_a(page_no >= size);
 
-	success = fil_space_extend(space, page_no + 1);
+	success = fil_space_extend_on_demand(space, page_no + 1);
 	/* The size may be less than we wanted if we ran out of disk space. */
 	fsp_header_size_update(header, space->size, mtr);
 	space->size_in_header = space->size;
@@ -1344,7 +1344,7 @@ fsp_try_extend_data_file(
 		DBUG_RETURN(false);
 	}
 
-	if (!fil_space_extend(space, size + size_increase)) {
+	if (!fil_space_extend_on_demand(space, size + size_increase)) {
 		DBUG_RETURN(false);
 	}
 
@@ -23,7 +23,9 @@ Full Text Search interface
 
 #include <current_thd.h>
 #include <sys/types.h>
+#include <algorithm>
 #include <new>
+#include <vector>
 
 #include "btr0pcur.h"
 #include "dict0priv.h"
@@ -43,6 +45,7 @@ Full Text Search interface
 #include "row0mysql.h"
 #include "row0sel.h"
 #include "row0upd.h"
+#include "srv0mon.h"
 #include "sync0sync.h"
 #include "trx0roll.h"
 #include "ut0new.h"
@@ -4599,7 +4602,79 @@ fts_sync_add_deleted_cache(
 	return(error);
 }
 
-/** Write the words and ilist to disk.
+/** Maximum number of word nodes that fts_sync_write_words() writes
+with the cache lock released once */
+static const ulint FTS_SYNC_BATCH_NODES = 256;
+
+/** A copy of a word node of the index cache that is written by
+fts_sync_write_words().  The node is copied, because the cache lock is
+released while the batch is written, and fts_cache_add_doc() may then
+reallocate the node vector of the word. */
+struct fts_sync_node_t {
+	ulint		selected;	/*!< auxiliary index table number */
+	fts_string_t	word;		/*!< the word */
+	fts_node_t	node;		/*!< the node */
+};
+
+/** Write a batch of word nodes to the auxiliary index tables.  The nodes
+are written grouped by auxiliary index table and in word order within each
+table, so that the inserts into a table are sequential and reuse the same
+query graph.
+@param[in,out]	trx		transaction
+@param[in,out]	index_cache	index cache
+@param[in,out]	batch		nodes to write
+@return DB_SUCCESS if all went well else error code */
+static MY_ATTRIBUTE((nonnull, warn_unused_result))
+dberr_t
+fts_sync_write_batch(
+	trx_t*				trx,
+	fts_index_cache_t*		index_cache,
+	std::vector<fts_sync_node_t>&	batch)
+{
+	fts_table_t	fts_table;
+	dberr_t		error = DB_SUCCESS;
+
+	FTS_INIT_INDEX_TABLE(
+		&fts_table, NULL, FTS_INDEX_TABLE, index_cache->index);
+
+	/* The nodes were collected in word order. */
+	std::stable_sort(
+		batch.begin(), batch.end(),
+		[](const fts_sync_node_t& a, const fts_sync_node_t& b) {
+			return(a.selected < b.selected);
+		});
+
+	for (auto& sync_node : batch) {
+
+		fts_table.suffix = fts_get_suffix(sync_node.selected);
+
+		error = fts_write_node(
+			trx, &index_cache->ins_graph[sync_node.selected],
+			&fts_table, &sync_node.word, &sync_node.node);
+
+		DEBUG_SYNC_C("fts_write_node");
+		DBUG_EXECUTE_IF("fts_write_node_crash",
+			DBUG_SUICIDE(););
+
+		DBUG_EXECUTE_IF("fts_instrument_sync_sleep",
+			os_thread_sleep(1000000);
+		);
+
+		if (error != DB_SUCCESS) {
+			break;
+		}
+
+		MONITOR_INC(MONITOR_FTS_SYNC_NODES);
+	}
+
+	MONITOR_INC(MONITOR_FTS_SYNC_BATCHES);
+
+	return(error);
+}
+
+/** Write the words and ilist to disk.  The nodes are written in batches
+of up to FTS_SYNC_BATCH_NODES, and the cache lock is released once per
+batch instead of once per node.
 @param[in,out]	trx		transaction
 @param[in]	index_cache	index cache
 @param[in]	unlock_cache	whether unlock cache when write node
@@ -4611,16 +4686,15 @@ fts_sync_write_words(
 	fts_index_cache_t*	index_cache,
 	bool			unlock_cache)
 {
-	fts_table_t	fts_table;
 	ulint		n_nodes = 0;
 	ulint		n_words = 0;
 	const ib_rbt_node_t* rbt_node;
 	dberr_t		error = DB_SUCCESS;
 	ibool		print_error = FALSE;
 	dict_table_t*	table = index_cache->index->table;
+	std::vector<fts_sync_node_t>	batch;
 
-	FTS_INIT_INDEX_TABLE(
-		&fts_table, NULL, FTS_INDEX_TABLE, index_cache->index);
+	batch.reserve(FTS_SYNC_BATCH_NODES);
 
 	n_words = rbt_size(index_cache->words);
 
@@ -4640,8 +4714,6 @@ fts_sync_write_words(
 			index_cache->charset, word->text.f_str,
 			word->text.f_len);
 
-		fts_table.suffix = fts_get_suffix(selected);
-
 		/* We iterate over all the nodes even if there was an error */
 		for (i = 0; i < ib_vector_size(word->nodes); ++i) {
 
@@ -4656,33 +4728,39 @@ fts_sync_write_words(
 
 			/*FIXME: we need to handle the error properly. */
 			if (error == DB_SUCCESS) {
-				if (unlock_cache) {
-					rw_lock_x_unlock(
-						&table->fts->cache->lock);
-				}
-
-				error = fts_write_node(
-					trx,
-					&index_cache->ins_graph[selected],
-					&fts_table, &word->text, fts_node);
+				fts_sync_node_t	sync_node;
 
-				DEBUG_SYNC_C("fts_write_node");
-				DBUG_EXECUTE_IF("fts_write_node_crash",
-					DBUG_SUICIDE(););
+				sync_node.selected = selected;
+				sync_node.word = word->text;
+				sync_node.node = *fts_node;
 
-				DBUG_EXECUTE_IF("fts_instrument_sync_sleep",
-					os_thread_sleep(1000000);
-				);
-
-				if (unlock_cache) {
-					rw_lock_x_lock(
-						&table->fts->cache->lock);
-				}
+				batch.push_back(sync_node);
 			}
 		}
 
 		n_nodes += ib_vector_size(word->nodes);
 
+		/* Write the batch when it is full, or after the last word.
+		The text of the words and the ilists of synced nodes are not
+		modified or freed by other threads, so that the copies can
+		be written while the cache lock is released. */
+		if (!batch.empty()
+		    && (batch.size() >= FTS_SYNC_BATCH_NODES
+			|| rbt_next(index_cache->words, rbt_node) == NULL)) {
+
+			if (unlock_cache) {
+				rw_lock_x_unlock(&table->fts->cache->lock);
+			}
+
+			error = fts_sync_write_batch(trx, index_cache, batch);
+
+			if (unlock_cache) {
+				rw_lock_x_lock(&table->fts->cache->lock);
+			}
+
+			batch.clear();
+		}
+
 		if (error != DB_SUCCESS && !print_error) {
 			ib::error() << "(" << ut_strerr(error) << ") writing"
 				" word node to FTS auxiliary index table.";
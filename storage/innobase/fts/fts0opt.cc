@@ -32,6 +32,10 @@ Completed 2011/7/10 Sunny and Jimmy Yang
 #include <stdlib.h>
 #include <sys/types.h>
 #include <time.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "dict0dd.h"
 #include "fts0fts.h"
@@ -43,6 +47,7 @@ Completed 2011/7/10 Sunny and Jimmy Yang
 #include "os0thread-create.h"
 #include "que0types.h"
 #include "row0sel.h"
+#include "srv0mon.h"
 #include "srv0start.h"
 #include "ut0list.h"
 #include "ut0wqueue.h"
@@ -189,6 +194,23 @@ struct fts_optimize_t {
 					been optimized */
 	ibool		del_list_regenerated;
 					/*!< BEING_DELETED list regenarated */
+
+	bool		save_last_word;	/*!< true if fts_optimize_compact()
+					saves FTS_LAST_OPTIMIZED_WORD after
+					every word; false in the workers of a
+					parallel optimize, whose coordinator
+					saves it */
+
+	const std::vector<std::string>*
+			part_words;	/*!< Words of one auxiliary index
+					table that a parallel optimize worker
+					reads instead of zip, or NULL */
+
+	ulint		part_pos;	/*!< Position of the next word to
+					read in part_words */
+
+	ulint		n_words_done;	/*!< Number of words that
+					fts_optimize_compact() wrote back */
 };
 
 /** Used by the optimize, to keep state during compacting nodes. */
@@ -237,6 +259,10 @@ struct fts_msg_t {
 /** The number of words to read and optimize in a single pass. */
 ulong	fts_num_word_optimize;
 
+/** The number of threads that optimize the auxiliary index tables of a
+FULLTEXT index concurrently. */
+ulong	fts_optimize_threads;
+
 // FIXME
 bool	fts_enable_diag_print;
 
@@ -1582,6 +1608,11 @@ fts_optimize_compact(
 			trx, &optim->fts_index_table, &word->text, nodes);
 
 		if (error == DB_SUCCESS) {
+			++optim->n_words_done;
+			MONITOR_INC(MONITOR_FTS_OPTIMIZE_WORDS);
+		}
+
+		if (error == DB_SUCCESS && optim->save_last_word) {
 			/* Write the last word optimized to the config table,
 			we use this value for restarting optimize. */
 			error = fts_config_set_index_value(
@@ -1625,6 +1656,8 @@ fts_optimize_create(
 
 	optim->table = table;
 
+	optim->save_last_word = true;
+
 	optim->trx = trx_allocate_for_background();
 
 	optim->fts_common_table.parent = table->name.m_name;
@@ -1779,6 +1812,37 @@ fts_optimize_get_time_limit(
 }
 
 
+/**********************************************************************//**
+Read the next word to optimize, from the words of the auxiliary index
+table of a parallel optimize worker, or else from the zip buffer.
+@return true if a word was read */
+static
+bool
+fts_optimize_read_next_word(
+/*========================*/
+	fts_optimize_t*	optim,	/*!< in/out: optimize instance */
+	fts_string_t*	word)	/*!< out: the word, in a buffer of
+				FTS_MAX_WORD_LEN + 1 bytes */
+{
+	if (optim->part_words == NULL) {
+		return(fts_zip_read_word(optim->zip, word) != NULL);
+	}
+
+	if (optim->part_pos >= optim->part_words->size()) {
+		return(false);
+	}
+
+	const std::string&	str = (*optim->part_words)[optim->part_pos++];
+
+	ut_a(str.size() <= FTS_MAX_WORD_LEN);
+
+	memcpy(word->f_str, str.data(), str.size());
+	word->f_len = str.size();
+	word->f_str[word->f_len] = '\0';
+
+	return(true);
+}
+
 /**********************************************************************//**
 Run OPTIMIZE on the given table. Note: this can take a very long time
 (hours). */
@@ -1797,9 +1861,12 @@ fts_optimize_words(
 
 	ut_a(!optim->done);
 
-	/* Get the time limit from the config table. */
-	fts_optimize_time_limit = fts_optimize_get_time_limit(
-		optim->trx, &optim->fts_common_table);
+	/* Get the time limit from the config table.  The coordinator
+of a parallel optimize has read it for the workers. */
+	if (optim->part_words == NULL) {
+		fts_optimize_time_limit = fts_optimize_get_time_limit(
+			optim->trx, &optim->fts_common_table);
+	}
 
 	start_time = ut_time();
 
@@ -1842,7 +1909,7 @@ fts_optimize_words(
 
 		if (error == DB_SUCCESS) {
 			if (!optim->done) {
-				if (!fts_zip_read_word(optim->zip, word)) {
+				if (!fts_optimize_read_next_word(optim, word)) {
 					optim->done = TRUE;
 				} else if (selected
 					   != fts_select_index(
@@ -1962,6 +2029,206 @@ fts_optimize_index_read_words(
 	return(error);
 }
 
+/**********************************************************************//**
+Create the optimize instance of a parallel optimize worker. It shares the
+table, the FTS index and the doc ids to delete with the coordinator, and
+has its own transaction and word buffers.
+@return the worker instance */
+static
+fts_optimize_t*
+fts_optimize_create_worker(
+/*=======================*/
+	const fts_optimize_t*	optim)	/*!< in: coordinator instance */
+{
+	mem_heap_t*	heap = mem_heap_create(128);
+	fts_optimize_t*	worker = static_cast<fts_optimize_t*>(
+		mem_heap_alloc(heap, sizeof(*worker)));
+
+	*worker = *optim;
+
+	worker->self_heap = ib_heap_allocator_create(heap);
+
+	worker->words = ib_vector_create(
+		worker->self_heap, sizeof(fts_word_t), 256);
+
+	worker->trx = trx_allocate_for_background();
+
+	worker->zip = NULL;
+	worker->done = FALSE;
+	worker->n_completed = 0;
+	worker->save_last_word = false;
+	worker->part_words = NULL;
+	worker->part_pos = 0;
+	worker->n_words_done = 0;
+
+	memset(&worker->graph, 0x0, sizeof(worker->graph));
+
+	return(worker);
+}
+
+/**********************************************************************//**
+Free the optimize instance of a parallel optimize worker. */
+static
+void
+fts_optimize_free_worker(
+/*=====================*/
+	fts_optimize_t*	worker)	/*!< in: worker instance */
+{
+	mem_heap_t*	heap = static_cast<mem_heap_t*>(worker->self_heap->arg);
+
+	trx_free_for_background(worker->trx);
+
+	fts_optimize_graph_free(&worker->graph);
+
+	/* This will free the heap from which worker itself was allocated. */
+	mem_heap_free(heap);
+}
+
+/**********************************************************************//**
+Run OPTIMIZE on the words of one pass with up to fts_optimize_threads
+threads.  The words are split by the auxiliary index table that holds
+them, and each thread optimizes the words of one table at a time.  The
+tables hold disjoint ranges of words, so that the threads do not wait for
+each other.  Finally, the word before the first word that was not
+optimized is saved as FTS_LAST_OPTIMIZED_WORD, so that the next pass
+continues from there. */
+static
+void
+fts_optimize_words_parallel(
+/*========================*/
+	fts_optimize_t*	optim,	/*!< in: optimize instance */
+	dict_index_t*	index,	/*!< in: current FTS being optimized */
+	fts_string_t*	word)	/*!< in: the starting word to optimize */
+{
+	typedef std::vector<std::string>	word_list_t;
+
+	CHARSET_INFO*		charset = optim->fts_index_table.charset;
+	std::vector<word_list_t>	parts(FTS_NUM_AUX_INDEX);
+	std::vector<ulint>	n_done(FTS_NUM_AUX_INDEX, 0);
+	ulint			n_parts = 0;
+
+	ut_a(!optim->done);
+
+	do {
+		ulint	selected = fts_select_index(
+			charset, word->f_str, word->f_len);
+
+		if (parts[selected].empty()) {
+			++n_parts;
+		}
+
+		parts[selected].push_back(std::string(
+			reinterpret_cast<const char*>(word->f_str),
+			word->f_len));
+
+	} while (fts_zip_read_word(optim->zip, word));
+
+	/* Get the time limit from the config table. */
+	fts_optimize_time_limit = fts_optimize_get_time_limit(
+		optim->trx, &optim->fts_common_table);
+
+	const ib_time_t		start_time = ut_time();
+	std::atomic<ulint>	next(0);
+
+	auto	optimize = [&]()
+	{
+		THD*		thd = create_thd(false, true, true, 0);
+		fts_optimize_t*	worker = fts_optimize_create_worker(optim);
+
+		for (ulint i = next++; i < parts.size(); i = next++) {
+			byte		str[FTS_MAX_WORD_LEN + 1];
+			fts_string_t	part_word;
+
+			if (parts[i].empty()) {
+				continue;
+			}
+
+			if (fts_optimize_time_limit > 0
+			    && (ut_time() - start_time)
+			    > fts_optimize_time_limit) {
+				break;
+			}
+
+			worker->part_words = &parts[i];
+			worker->part_pos = 0;
+			worker->n_words_done = 0;
+			worker->done = FALSE;
+
+			part_word.f_str = str;
+
+			if (fts_optimize_read_next_word(worker, &part_word)) {
+				fts_optimize_words(worker, index, &part_word);
+			}
+
+			n_done[i] = worker->n_words_done;
+
+			MONITOR_INC(MONITOR_FTS_OPTIMIZE_PARALLEL_TASKS);
+		}
+
+		fts_optimize_free_worker(worker);
+
+		destroy_thd(thd);
+	};
+
+#ifdef UNIV_PFS_THREAD
+	Runnable	runnable(fts_parallel_optimize_thread_key);
+#else
+	Runnable	runnable(0);
+#endif /* UNIV_PFS_THREAD */
+
+	const ulint	n_threads = std::min<ulint>(fts_optimize_threads, n_parts);
+
+	std::vector<std::thread>	threads;
+
+	for (ulint i = 0; i < n_threads; ++i) {
+		threads.push_back(std::thread(runnable, optimize));
+	}
+
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	/* Words of later tables that were optimized past the saved word
+	are optimized again in the next pass, which is harmless. */
+	const std::string*	last = NULL;
+
+	for (ulint i = 0; i < parts.size(); ++i) {
+
+		if (n_done[i] > 0) {
+			last = &parts[i][n_done[i] - 1];
+		}
+
+		if (n_done[i] < parts[i].size()) {
+			break;
+		}
+	}
+
+	if (last != NULL) {
+		byte		str[FTS_MAX_WORD_LEN + 1];
+		fts_string_t	last_word;
+
+		memcpy(str, last->data(), last->size());
+
+		last_word.f_str = str;
+		last_word.f_len = last->size();
+
+		dberr_t	error = fts_config_set_index_value(
+			optim->trx, index, FTS_LAST_OPTIMIZED_WORD,
+			&last_word);
+
+		if (error == DB_SUCCESS) {
+			fts_sql_commit(optim->trx);
+		} else {
+			ib::error() << "(" << ut_strerr(error) << ") while"
+				" updating last optimized word!";
+
+			fts_sql_rollback(optim->trx);
+		}
+	}
+
+	optim->done = TRUE;
+}
+
 /**********************************************************************//**
 Run OPTIMIZE on the given FTS index. Note: this can take a very long
 time (hours).
@@ -2013,6 +2280,8 @@ fts_optimize_index(
 		if (!fts_zip_read_word(optim->zip, &word)) {
 
 			optim->done = TRUE;
+		} else if (fts_optimize_threads > 1) {
+			fts_optimize_words_parallel(optim, index, &word);
 		} else {
 			fts_optimize_words(optim, index, &word);
 		}
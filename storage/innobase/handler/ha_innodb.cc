@@ -126,6 +126,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "row0ins.h"
 #include "row0merge.h"
 #include "row0mysql.h"
+#include "row0pread.h"
 #include "row0quiesce.h"
 #include "row0sel.h"
 #include "row0upd.h"
@@ -510,6 +511,7 @@ is defined */
 static PSI_mutex_info all_innodb_mutexes[] = {
 	PSI_MUTEX_KEY(autoinc_mutex, 0, 0),
 	PSI_MUTEX_KEY(autoinc_persisted_mutex, 0, 0),
+	PSI_MUTEX_KEY(ahi_build_queue_mutex, 0, 0),
 #  ifndef PFS_SKIP_BUFFER_MUTEX_RWLOCK
 	PSI_MUTEX_KEY(buffer_block_mutex, 0, 0),
 #  endif /* !PFS_SKIP_BUFFER_MUTEX_RWLOCK */
@@ -525,6 +527,7 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	PSI_MUTEX_KEY(dict_sys_mutex, 0, 0),
 	PSI_MUTEX_KEY(recalc_pool_mutex, 0, 0),
 	PSI_MUTEX_KEY(fil_system_mutex, 0, 0),
+	PSI_MUTEX_KEY(fil_shard_mutex, 0, 0),
 	PSI_MUTEX_KEY(file_open_mutex, 0, 0),
 	PSI_MUTEX_KEY(flush_list_mutex, 0, 0),
 	PSI_MUTEX_KEY(fts_bg_threads_mutex, 0, 0),
@@ -545,6 +548,7 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	PSI_MUTEX_KEY(page_zip_stat_per_index_mutex, 0, 0),
 	PSI_MUTEX_KEY(page_cleaner_mutex, 0, 0),
 	PSI_MUTEX_KEY(purge_sys_pq_mutex, 0, 0),
+	PSI_MUTEX_KEY(purge_table_stats_mutex, 0, 0),
 	PSI_MUTEX_KEY(recv_sys_mutex, 0, 0),
 	PSI_MUTEX_KEY(recv_writer_mutex, 0, 0),
 	PSI_MUTEX_KEY(temp_space_rseg_mutex, 0, 0),
@@ -567,7 +571,7 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	PSI_MUTEX_KEY(trx_pool_mutex, 0, 0),
 	PSI_MUTEX_KEY(trx_pool_manager_mutex, 0, 0),
 	PSI_MUTEX_KEY(srv_sys_mutex, 0, 0),
-	PSI_MUTEX_KEY(lock_mutex, 0, 0),
+	PSI_MUTEX_KEY(lock_sys_page_mutex, 0, 0),
 	PSI_MUTEX_KEY(lock_wait_mutex, 0, 0),
 	PSI_MUTEX_KEY(trx_mutex, 0, 0),
 	PSI_MUTEX_KEY(srv_threads_mutex, 0, 0),
@@ -584,7 +588,8 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	PSI_MUTEX_KEY(master_key_id_mutex, 0, 0),
 	PSI_MUTEX_KEY(sync_array_mutex, 0, 0),
 	PSI_MUTEX_KEY(thread_mutex, 0, 0),
-	PSI_MUTEX_KEY(row_drop_list_mutex, 0, 0)
+	PSI_MUTEX_KEY(row_drop_list_mutex, 0, 0),
+	PSI_MUTEX_KEY(alter_stage_mutex, 0, 0)
 };
 # endif /* UNIV_PFS_MUTEX */
 
@@ -610,6 +615,7 @@ static PSI_rwlock_info all_innodb_rwlocks[] = {
 	PSI_RWLOCK_KEY(fts_cache_init_rw_lock),
 	PSI_RWLOCK_KEY(trx_i_s_cache_lock),
 	PSI_RWLOCK_KEY(trx_purge_latch),
+	PSI_RWLOCK_KEY(lock_sys_latch),
 	PSI_RWLOCK_KEY(index_tree_rw_lock),
 	PSI_RWLOCK_KEY(index_online_log),
 	PSI_RWLOCK_KEY(dict_table_stats),
@@ -622,16 +628,25 @@ static PSI_rwlock_info all_innodb_rwlocks[] = {
 performance schema instrumented if "UNIV_PFS_THREAD"
 is defined */
 static PSI_thread_info	all_innodb_threads[] = {
+	PSI_KEY(btr_search_build_thread),
 	PSI_KEY(buf_dump_thread),
+	PSI_KEY(buf_load_thread),
 	PSI_KEY(dict_stats_thread),
+	PSI_KEY(fil_extend_ahead_thread),
+	PSI_KEY(ibuf_merge_thread),
 	PSI_KEY(io_handler_thread),
 	PSI_KEY(io_ibuf_thread),
 	PSI_KEY(io_log_thread),
 	PSI_KEY(io_read_thread),
 	PSI_KEY(io_write_thread),
+	PSI_KEY(log_flusher_thread),
+	PSI_KEY(log_writer_thread),
 	PSI_KEY(buf_resize_thread),
 	PSI_KEY(recv_writer_thread),
+	PSI_KEY(recv_apply_thread),
+	PSI_KEY(row_merge_thread),
 	PSI_KEY(srv_error_monitor_thread),
+	PSI_KEY(srv_lock_deadlock_thread),
 	PSI_KEY(srv_lock_timeout_thread),
 	PSI_KEY(srv_master_thread),
 	PSI_KEY(srv_monitor_thread),
@@ -639,9 +654,11 @@ static PSI_thread_info	all_innodb_threads[] = {
 	PSI_KEY(srv_worker_thread),
 	PSI_KEY(trx_recovery_rollback_thread),
 	PSI_KEY(page_flush_thread),
+	PSI_KEY(parallel_read_thread),
 	PSI_KEY(page_flush_coordinator_thread),
 	PSI_KEY(fts_optimize_thread),
 	PSI_KEY(fts_parallel_merge_thread),
+	PSI_KEY(fts_parallel_optimize_thread),
 	PSI_KEY(fts_parallel_tokenization_thread)
 };
 # endif /* UNIV_PFS_THREAD */
@@ -883,6 +900,11 @@ static MYSQL_THDVAR_STR(tmpdir,
   "Directory for temporary non-tablespace files.",
   innodb_tmpdir_validate, NULL, NULL);
 
+static MYSQL_THDVAR_ULONG(parallel_read_threads, PLUGIN_VAR_RQCMDARG,
+  "Number of threads used to scan the clustered index for"
+  " SELECT COUNT(*), CHECK TABLE and parallel table scans.",
+  NULL, NULL, 4, 1, Parallel_reader::MAX_THREADS, 0);
+
 static SHOW_VAR innodb_status_variables[]= {
   {"buffer_pool_dump_status",
   (char*) &export_vars.innodb_buffer_pool_dump_status,	  SHOW_CHAR, SHOW_SCOPE_GLOBAL},
@@ -1911,6 +1933,16 @@ thd_lock_wait_timeout(
 	return(THDVAR(thd, lock_wait_timeout));
 }
 
+/** Get the number of threads to use for scans of a clustered index.
+@param[in]	thd	thread handle, or NULL to query the global
+			innodb_parallel_read_threads
+@return value of innodb_parallel_read_threads */
+ulong
+thd_parallel_read_threads(THD* thd)
+{
+	return(THDVAR(thd, parallel_read_threads));
+}
+
 /******************************************************************//**
 Set the time waited for the lock for the current query. */
 void
@@ -4382,8 +4414,30 @@ innodb_init_params()
 	}
 #endif /* HAVE_LZO1X */
 
-#ifdef LINUX_NATIVE_AIO
-	if (srv_use_native_aio) {
+#ifndef LINUX_IO_URING
+	if (srv_use_io_uring) {
+		ib::warn() << "io_uring is not supported on this platform,"
+			" ignoring innodb_use_io_uring";
+		srv_use_io_uring = false;
+	}
+#endif /* !LINUX_IO_URING */
+
+	/* io_uring is an implementation of native AIO. */
+	if (!srv_use_native_aio) {
+		srv_use_io_uring = false;
+	}
+
+#if defined LINUX_NATIVE_AIO || defined LINUX_IO_URING
+# ifndef LINUX_NATIVE_AIO
+	/* Without libaio, io_uring is the only native AIO. */
+	if (!srv_use_io_uring) {
+		srv_use_native_aio = FALSE;
+	}
+# endif /* !LINUX_NATIVE_AIO */
+
+	if (srv_use_io_uring) {
+		ib::info() << "Using io_uring";
+	} else if (srv_use_native_aio) {
 		ib::info() << "Using Linux native AIO";
 	}
 #elif !defined _WIN32
@@ -4411,11 +4465,13 @@ innodb_init_params()
 	srv_max_n_threads = 1   /* io_ibuf_thread */
 			    + 1 /* io_log_thread */
 			    + 1 /* lock_wait_timeout_thread */
+			    + 1 /* lock_deadlock_detector_thread */
 			    + 1 /* srv_error_monitor_thread */
 			    + 1 /* srv_monitor_thread */
 			    + 1 /* srv_master_thread */
 			    + 1 /* srv_purge_coordinator_thread */
 			    + 1 /* buf_dump_thread */
+			    + 1 /* btr_search_build_thread */
 			    + 1 /* dict_stats_thread */
 			    + 1 /* fts_optimize_thread */
 			    + 1 /* recv_writer_thread */
@@ -4425,11 +4481,17 @@ innodb_init_params()
 			    + max_connections
 			    + srv_n_read_io_threads
 			    + srv_n_write_io_threads
+			    + srv_n_recv_apply_threads
+			    + srv_n_ibuf_merge_threads
 			    + srv_n_purge_threads
 			    + srv_n_page_cleaners
 			    /* FTS Parallel Sort */
 			    + fts_sort_pll_degree * FTS_NUM_AUX_INDEX
-			      * max_connections;
+			      * max_connections
+			    /* FTS Parallel Optimize */
+			    + FTS_NUM_AUX_INDEX
+			    /* Parallel clustered index scans */
+			    + Parallel_reader::MAX_THREADS;
 
 	/* Set default InnoDB temp data file size to 12 MB and let it be
 	auto-extending. */
@@ -15399,6 +15461,212 @@ ha_innobase::records(
 	DBUG_RETURN(0);
 }
 
+/** Prepare a scan of the clustered index with several threads.
+@param[out]	scan_ctx	context of the scan
+@param[in,out]	num_threads	number of threads wanted, 0 for
+				innodb_parallel_read_threads; set to the
+				number of threads that will be used
+@return 0 or error code */
+int
+ha_innobase::parallel_scan_init(
+	void*&	scan_ctx,
+	size_t&	num_threads)
+{
+	DBUG_ENTER("ha_innobase::parallel_scan_init");
+
+	scan_ctx = NULL;
+
+	update_thd();
+
+	if (dict_table_is_discarded(m_prebuilt->table)) {
+		ib_senderrf(
+			m_user_thd,
+			IB_LOG_LEVEL_ERROR,
+			ER_TABLESPACE_DISCARDED,
+			table->s->table_name.str);
+
+		DBUG_RETURN(HA_ERR_NO_SUCH_TABLE);
+
+	} else if (m_prebuilt->table->ibd_file_missing) {
+		ib_senderrf(
+			m_user_thd, IB_LOG_LEVEL_ERROR,
+			ER_TABLESPACE_MISSING,
+			table->s->table_name.str);
+
+		DBUG_RETURN(HA_ERR_TABLESPACE_MISSING);
+
+	} else if (m_prebuilt->table->is_corrupted()) {
+		DBUG_RETURN(HA_ERR_INDEX_CORRUPT);
+	}
+
+	if (m_prebuilt->table->is_temporary()) {
+		/* Other threads cannot access the temporary table. */
+		DBUG_RETURN(HA_ERR_WRONG_COMMAND);
+	}
+
+	if (m_prebuilt->select_lock_type != LOCK_NONE) {
+		/* The reader only does consistent reads. */
+		DBUG_RETURN(HA_ERR_WRONG_COMMAND);
+	}
+
+	dict_index_t*	index = m_prebuilt->table->first_index();
+	trx_t*		trx = m_prebuilt->trx;
+
+	if (!index->is_usable(trx)) {
+		DBUG_RETURN(HA_ERR_TABLE_DEF_CHANGED);
+	}
+
+	trx_start_if_not_started(trx, false);
+
+	if (trx->isolation_level > TRX_ISO_READ_UNCOMMITTED) {
+		trx_assign_read_view(trx);
+	}
+
+	/* Build a template for reading whole rows from the clustered
+	index. The threads of the scan share it. */
+	m_prebuilt->index = index;
+	m_prebuilt->index_usable = true;
+	m_prebuilt->read_just_key = 0;
+	build_template(true);
+
+	if (num_threads == 0) {
+		num_threads = thd_parallel_read_threads(m_user_thd);
+	}
+
+	Parallel_reader*	reader = UT_NEW_NOKEY(
+		Parallel_reader(trx, index, num_threads));
+
+	num_threads = reader->n_threads();
+	scan_ctx = reader;
+
+	DBUG_RETURN(0);
+}
+
+/** Create the context in which a thread of a parallel scan converts
+records to the MySQL format. It shares the template of the handle, which
+is not modified during the scan, and owns nothing but its blob heap,
+because row_sel_store_mysql_rec() keeps the externally stored columns
+there.
+@param[in]	prebuilt	prebuilt struct of the handle
+@param[in,out]	heap		memory heap to allocate the context from
+@return prebuilt struct for one thread */
+static
+row_prebuilt_t*
+parallel_scan_prebuilt(
+	const row_prebuilt_t*	prebuilt,
+	mem_heap_t*		heap)
+{
+	row_prebuilt_t*	thread_prebuilt = static_cast<row_prebuilt_t*>(
+		mem_heap_zalloc(heap, sizeof(*thread_prebuilt)));
+
+	thread_prebuilt->table = prebuilt->table;
+	thread_prebuilt->index = prebuilt->index;
+	thread_prebuilt->trx = prebuilt->trx;
+	thread_prebuilt->default_rec = prebuilt->default_rec;
+	thread_prebuilt->mysql_template = prebuilt->mysql_template;
+	thread_prebuilt->n_template = prebuilt->n_template;
+	thread_prebuilt->mysql_row_len = prebuilt->mysql_row_len;
+	thread_prebuilt->templ_contains_blob = prebuilt->templ_contains_blob;
+	thread_prebuilt->read_just_key = prebuilt->read_just_key;
+	thread_prebuilt->m_read_virtual_key = prebuilt->m_read_virtual_key;
+	thread_prebuilt->fts_doc_id_in_read_set
+		= prebuilt->fts_doc_id_in_read_set;
+
+	return(thread_prebuilt);
+}
+
+/** Run a scan prepared by parallel_scan_init().
+@param[in]	scan_ctx	context of the scan
+@param[in]	thread_ctxs	contexts of the threads, passed to load_fn
+@param[in]	load_fn		callback for each row
+@return 0 or error code */
+int
+ha_innobase::parallel_scan(
+	void*		scan_ctx,
+	void**		thread_ctxs,
+	Load_cbk	load_fn)
+{
+	DBUG_ENTER("ha_innobase::parallel_scan");
+
+	Parallel_reader*	reader = static_cast<Parallel_reader*>(scan_ctx);
+	const size_t		n_threads = reader->n_threads();
+	const ulint		rec_len = m_prebuilt->mysql_row_len;
+	mem_heap_t*		heap = mem_heap_create(n_threads * rec_len);
+
+	std::vector<row_prebuilt_t*, ut_allocator<row_prebuilt_t*> >
+				prebuilts(n_threads);
+	std::vector<byte*, ut_allocator<byte*> >
+				bufs(n_threads);
+
+	for (size_t i = 0; i < n_threads; ++i) {
+		prebuilts[i] = parallel_scan_prebuilt(m_prebuilt, heap);
+		bufs[i] = static_cast<byte*>(mem_heap_alloc(heap, rec_len));
+	}
+
+	TrxInInnoDB	trx_in_innodb(m_prebuilt->trx);
+
+	m_prebuilt->trx->op_info = "parallel scan";
+
+	dberr_t	err = reader->run(
+		[&](const Parallel_reader::Ctx& ctx) -> dberr_t
+		{
+			row_prebuilt_t*	prebuilt = prebuilts[ctx.m_thread_id];
+			byte*		buf = bufs[ctx.m_thread_id];
+
+			memcpy(buf, prebuilt->default_rec, rec_len);
+
+			if (!row_sel_store_mysql_rec(
+				    buf, prebuilt, ctx.m_rec, NULL, TRUE,
+				    prebuilt->index, ctx.m_offsets, false)) {
+				return(DB_ERROR);
+			}
+
+			/* The callback asks us to stop the scan. */
+			if (load_fn(thread_ctxs[ctx.m_thread_id], buf)) {
+				return(DB_END_OF_INDEX);
+			}
+
+			return(DB_SUCCESS);
+		});
+
+	for (auto prebuilt : prebuilts) {
+		if (prebuilt->blob_heap != NULL) {
+			row_mysql_prebuilt_free_blob_heap(prebuilt);
+		}
+	}
+
+	mem_heap_free(heap);
+
+	m_prebuilt->trx->op_info = "";
+
+	switch (err) {
+	case DB_SUCCESS:
+	case DB_END_OF_INDEX:
+		break;
+	default:
+		DBUG_RETURN(convert_error_code_to_mysql(err, 0, m_user_thd));
+	}
+
+	if (thd_killed(m_user_thd)) {
+		DBUG_RETURN(HA_ERR_QUERY_INTERRUPTED);
+	}
+
+	DBUG_RETURN(0);
+}
+
+/** Release the context of a scan prepared by parallel_scan_init().
+@param[in]	scan_ctx	context of the scan */
+void
+ha_innobase::parallel_scan_end(
+	void*	scan_ctx)
+{
+	Parallel_reader*	reader = static_cast<Parallel_reader*>(scan_ctx);
+
+	UT_DELETE(reader);
+
+	reset_template();
+}
+
 /*********************************************************************//**
 Estimates the number of index records in a range.
 @return estimated number of rows */
@@ -20530,7 +20798,8 @@ innodb_buffer_pool_evict_uncompressed(void)
 			mutex_enter(&block->mutex);
 
 			if (!buf_page_can_relocate(&block->page)
-			    || block->page.oldest_modification) {
+			    || block->page.oldest_modification
+			    || !buf_page_freeze(&block->page)) {
 
 				rw_lock_x_unlock(hash_lock);
 
@@ -21307,6 +21576,13 @@ static MYSQL_SYSVAR_BOOL(doublewrite, innobase_use_doublewrite,
   " Disable with --skip-innodb-doublewrite.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_ULONG(doublewrite_files, srv_doublewrite_files,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Number of doublewrite files. Each buffer pool instance writes its"
+  " LRU and flush_list batches to its own file if there are enough of"
+  " them. 0 (the default) creates two files for each buffer pool instance.",
+  NULL, NULL, 0, 0, 2 * MAX_BUFFER_POOLS, 0);
+
 static MYSQL_SYSVAR_BOOL(stats_include_delete_marked,
   srv_stats_include_delete_marked,
   PLUGIN_VAR_OPCMDARG,
@@ -21372,7 +21648,7 @@ static MYSQL_SYSVAR_ULONG(purge_batch_size, srv_purge_batch_size,
   NULL, NULL,
   300,			/* Default setting */
   1,			/* Minimum value */
-  5000, 0);		/* Maximum value */
+  MAX_PURGE_BATCH_SIZE, 0);	/* Maximum value */
 
 static MYSQL_SYSVAR_ULONG(purge_threads, srv_n_purge_threads,
   PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
@@ -21401,6 +21677,14 @@ static MYSQL_SYSVAR_BOOL(file_per_table, srv_file_per_table,
   "Stores each InnoDB table to an .ibd file in the database dir.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_ULONG(extend_ahead_max_size, srv_extend_ahead_max_size,
+  PLUGIN_VAR_RQCMDARG,
+  "Maximum size in megabytes that a background thread keeps allocated"
+  " ahead of demand in each growing file-per-table or general tablespace."
+  " The size follows the growth rate of the tablespace."
+  " 0 disables the background extension.",
+  NULL, NULL, 64, 0, 65536, 0);
+
 static MYSQL_SYSVAR_STR(ft_server_stopword_table, innobase_server_stopword_table,
   PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_MEMALLOC,
   "The user supplied stopword table name.",
@@ -21530,6 +21814,14 @@ static MYSQL_SYSVAR_ULONGLONG(stats_persistent_sample_pages,
   " statistics (by ANALYZE, default 20)",
   NULL, NULL, 20, 1, ~0ULL, 0);
 
+static MYSQL_SYSVAR_ULONGLONG(stats_auto_recalc_page_budget,
+  srv_stats_auto_recalc_page_budget,
+  PLUGIN_VAR_RQCMDARG,
+  "The maximum number of leaf index pages that the automatic recalculation"
+  " of persistent statistics samples from one table at a time. Indexes that"
+  " do not fit are recalculated later (default 0, no limit)",
+  NULL, NULL, 0, 0, ~0ULL, 0);
+
 static MYSQL_SYSVAR_BOOL(adaptive_hash_index, btr_search_enabled,
   PLUGIN_VAR_OPCMDARG,
   "Enable InnoDB adaptive hash index (enabled by default). "
@@ -21544,6 +21836,13 @@ static MYSQL_SYSVAR_ULONG(adaptive_hash_index_parts, btr_ahi_parts,
   "Number of InnoDB Adapative Hash Index Partitions. (default = 8). ",
   NULL, NULL, 8, 1, 512, 0);
 
+static MYSQL_SYSVAR_BOOL(adaptive_hash_index_auto, btr_search_auto,
+  PLUGIN_VAR_OPCMDARG,
+  "Turn the InnoDB adaptive hash index off and on per index by its hit"
+  " rate and maintenance cost, and build it in a background thread"
+  " (enabled by default).",
+  NULL, NULL, true);
+
 static MYSQL_SYSVAR_ULONG(replication_delay, srv_replication_delay,
   PLUGIN_VAR_RQCMDARG,
   "Replication thread delay (ms) on the slave server if"
@@ -21669,11 +21968,25 @@ static MYSQL_SYSVAR_BOOL(buffer_pool_load_at_startup, srv_buffer_pool_load_at_st
   "Load the buffer pool from a file named @@innodb_buffer_pool_filename",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_ULONG(buffer_pool_load_threads, srv_buf_load_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads that issue the page reads of a buffer pool load."
+  " Each thread reads the pages of one tablespace range at a time,"
+  " hottest pages first.",
+  NULL, NULL, 4, 1, 64, 0);
+
 static MYSQL_SYSVAR_ULONG(lru_scan_depth, srv_LRU_scan_depth,
   PLUGIN_VAR_RQCMDARG,
   "How deep to scan LRU to keep it clean",
   NULL, NULL, 1024, 100, ~0UL, 0);
 
+static MYSQL_SYSVAR_ULONG(lru_access_batch, srv_LRU_access_batch,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of accesses to old pages that each thread collects before"
+  " moving the pages to the start of the buffer pool LRU list."
+  " 1 moves each page as soon as it is accessed.",
+  NULL, NULL, 32, 1, BUF_LRU_ACCESS_BATCH_MAX, 0);
+
 static MYSQL_SYSVAR_ULONG(flush_neighbors, srv_flush_neighbors,
   PLUGIN_VAR_OPCMDARG,
   "Set to 0 (don't flush neighbors from buffer pool),"
@@ -21699,6 +22012,14 @@ static MYSQL_SYSVAR_BOOL(deadlock_detect, innobase_deadlock_detect,
   " and we rely on innodb_lock_wait_timeout in case of deadlock.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(deadlock_detect_async,
+  innobase_deadlock_detect_async,
+  PLUGIN_VAR_NOCMDARG,
+  "Search for deadlocks in a background thread instead of in each"
+  " thread that starts a lock wait (default OFF). Only used when"
+  " innodb_deadlock_detect is ON.",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_LONG(fill_factor, innobase_fill_factor,
   PLUGIN_VAR_RQCMDARG,
   "Percentage of B-tree page filled during bulk insert",
@@ -21750,6 +22071,12 @@ static MYSQL_SYSVAR_ULONG(ft_num_word_optimize, fts_num_word_optimize,
   "InnoDB Fulltext search number of words to optimize for each optimize table call ",
   NULL, NULL, 2000, 1000, 10000, 0);
 
+static MYSQL_SYSVAR_ULONG(ft_optimize_threads, fts_optimize_threads,
+  PLUGIN_VAR_OPCMDARG,
+  "InnoDB Fulltext search number of threads that optimize the auxiliary"
+  " index tables of a FULLTEXT index concurrently",
+  NULL, NULL, 1, 1, FTS_NUM_AUX_INDEX, 0);
+
 static MYSQL_SYSVAR_ULONG(ft_sort_pll_degree, fts_sort_pll_degree,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
   "InnoDB Fulltext search parallel sort degree, will round up to nearest power of 2 number",
@@ -21780,6 +22107,12 @@ static MYSQL_SYSVAR_ULONG(write_io_threads, srv_n_write_io_threads,
   "Number of background write I/O threads in InnoDB.",
   NULL, NULL, 4, 1, 64, 0);
 
+static MYSQL_SYSVAR_ULONG(recovery_apply_threads, srv_n_recv_apply_threads,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Number of threads that apply redo log records to pages during crash"
+  " recovery.",
+  NULL, NULL, 4, 1, 64, 0);
+
 static MYSQL_SYSVAR_ULONG(force_recovery, srv_force_recovery,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
   "Helps to save your data in case the disk image of the database becomes corrupt.",
@@ -21820,6 +22153,19 @@ static MYSQL_SYSVAR_ULONG(log_write_ahead_size, srv_log_write_ahead_size,
   NULL, innodb_log_write_ahead_size_update,
   8*1024L, OS_FILE_LOG_BLOCK_SIZE, UNIV_PAGE_SIZE_DEF, OS_FILE_LOG_BLOCK_SIZE);
 
+static MYSQL_SYSVAR_BOOL(log_writer_threads, srv_log_writer_threads,
+  PLUGIN_VAR_OPCMDARG,
+  "Let the dedicated log writer and log flusher threads write and flush"
+  " the redo log, while committing threads wait for them to finish.",
+  NULL, NULL, TRUE);
+
+static MYSQL_SYSVAR_ULONG(log_wait_for_flush_spin_rounds,
+  srv_log_wait_for_flush_spin_rounds,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of spin rounds a thread waiting for the log writer or log"
+  " flusher thread does before it goes to sleep.",
+  NULL, NULL, 0L, 0L, 100000L, 0);
+
 static MYSQL_SYSVAR_UINT(old_blocks_pct, innobase_old_blocks_pct,
   PLUGIN_VAR_RQCMDARG,
   "Percentage of the buffer pool to reserve for 'old' blocks.",
@@ -21951,6 +22297,13 @@ static MYSQL_SYSVAR_BOOL(use_native_aio, srv_use_native_aio,
   "Use native AIO if supported on this platform.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(use_io_uring, srv_use_io_uring,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Use io_uring instead of libaio for native AIO, if supported on this"
+  " platform. Page i/o then uses the buffer pool as fixed buffers, and the"
+  " writes of a flush batch are submitted together.",
+  NULL, NULL, FALSE);
+
 #ifdef HAVE_LIBNUMA
 static MYSQL_SYSVAR_BOOL(numa_interleave, srv_numa_interleave,
   PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
@@ -22003,6 +22356,14 @@ static MYSQL_SYSVAR_UINT(change_buffer_max_size,
   NULL, innodb_change_buffer_max_size_update,
   CHANGE_BUFFER_DEFAULT_SIZE, 0, 50, 0);
 
+static MYSQL_SYSVAR_ULONG(change_buffer_merge_threads,
+  srv_n_ibuf_merge_threads,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Number of background threads that merge the change buffer. The merge"
+  " rate follows the size of the change buffer and the read capacity left"
+  " by foreground reads. 0 leaves the merge to the master thread.",
+  NULL, NULL, 0, 0, 32, 0);
+
 static MYSQL_SYSVAR_ENUM(stats_method, srv_innodb_stats_method,
    PLUGIN_VAR_RQCMDARG,
   "Specifies how InnoDB index statistics collection code should"
@@ -22039,6 +22400,14 @@ static MYSQL_SYSVAR_ULONG(read_ahead_threshold, srv_read_ahead_threshold,
   " trigger a readahead.",
   NULL, NULL, 56, 0, 64, 0);
 
+static MYSQL_SYSVAR_ULONG(logical_read_ahead_pages,
+  srv_logical_read_ahead_pages,
+  PLUGIN_VAR_RQCMDARG,
+  "Maximum number of leaf pages that an index range scan reads ahead"
+  " asynchronously, found from the node pointers of the level above the"
+  " leaves. 0 disables the logical read-ahead.",
+  NULL, NULL, 0, 0, 1024, 0);
+
 static MYSQL_SYSVAR_STR(monitor_enable, innobase_enable_monitor_counter,
   PLUGIN_VAR_RQCMDARG,
   "Turn on a monitor counter",
@@ -22109,6 +22478,15 @@ static MYSQL_SYSVAR_ENUM(default_row_format, innodb_default_row_format,
   NULL, NULL, DEFAULT_ROW_FORMAT_DYNAMIC,
   &innodb_default_row_format_typelib);
 
+static MYSQL_SYSVAR_BOOL(indexed_lob, srv_indexed_lob,
+  PLUGIN_VAR_NOCMDARG,
+  "Store new BLOB, TEXT and JSON values that need more than one page in"
+  " ROW_FORMAT=REDUNDANT, COMPACT and DYNAMIC tables in the indexed format,"
+  " which lets updates write only the pages that changed. Tablespaces that"
+  " contain such values cannot be opened by older server versions"
+  " (default OFF)",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_BOOL(redo_log_encrypt, srv_redo_log_encrypt,
   PLUGIN_VAR_OPCMDARG,
   "Enable or disable Encryption of REDO tablespace.",
@@ -22193,7 +22571,9 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(buffer_pool_load_now),
   MYSQL_SYSVAR(buffer_pool_load_abort),
   MYSQL_SYSVAR(buffer_pool_load_at_startup),
+  MYSQL_SYSVAR(buffer_pool_load_threads),
   MYSQL_SYSVAR(lru_scan_depth),
+  MYSQL_SYSVAR(lru_access_batch),
   MYSQL_SYSVAR(flush_neighbors),
   MYSQL_SYSVAR(checksum_algorithm),
   MYSQL_SYSVAR(log_checksums),
@@ -22204,14 +22584,18 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(temp_data_file_path),
   MYSQL_SYSVAR(data_home_dir),
   MYSQL_SYSVAR(doublewrite),
+  MYSQL_SYSVAR(doublewrite_files),
   MYSQL_SYSVAR(stats_include_delete_marked),
   MYSQL_SYSVAR(api_enable_binlog),
   MYSQL_SYSVAR(api_enable_mdl),
   MYSQL_SYSVAR(api_disable_rowlock),
   MYSQL_SYSVAR(fast_shutdown),
   MYSQL_SYSVAR(read_io_threads),
+  MYSQL_SYSVAR(parallel_read_threads),
   MYSQL_SYSVAR(write_io_threads),
+  MYSQL_SYSVAR(recovery_apply_threads),
   MYSQL_SYSVAR(file_per_table),
+  MYSQL_SYSVAR(extend_ahead_max_size),
   MYSQL_SYSVAR(flush_log_at_timeout),
   MYSQL_SYSVAR(flush_log_at_trx_commit),
   MYSQL_SYSVAR(flush_method),
@@ -22227,15 +22611,19 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(ft_max_token_size),
   MYSQL_SYSVAR(ft_min_token_size),
   MYSQL_SYSVAR(ft_num_word_optimize),
+  MYSQL_SYSVAR(ft_optimize_threads),
   MYSQL_SYSVAR(ft_sort_pll_degree),
   MYSQL_SYSVAR(force_load_corrupted),
   MYSQL_SYSVAR(lock_wait_timeout),
   MYSQL_SYSVAR(deadlock_detect),
+  MYSQL_SYSVAR(deadlock_detect_async),
   MYSQL_SYSVAR(page_size),
   MYSQL_SYSVAR(log_buffer_size),
   MYSQL_SYSVAR(log_file_size),
   MYSQL_SYSVAR(log_files_in_group),
   MYSQL_SYSVAR(log_write_ahead_size),
+  MYSQL_SYSVAR(log_writer_threads),
+  MYSQL_SYSVAR(log_wait_for_flush_spin_rounds),
   MYSQL_SYSVAR(log_group_home_dir),
   MYSQL_SYSVAR(log_compressed_pages),
   MYSQL_SYSVAR(max_dirty_pages_pct),
@@ -22261,8 +22649,10 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(stats_persistent),
   MYSQL_SYSVAR(stats_persistent_sample_pages),
   MYSQL_SYSVAR(stats_auto_recalc),
+  MYSQL_SYSVAR(stats_auto_recalc_page_budget),
   MYSQL_SYSVAR(adaptive_hash_index),
   MYSQL_SYSVAR(adaptive_hash_index_parts),
+  MYSQL_SYSVAR(adaptive_hash_index_auto),
   MYSQL_SYSVAR(stats_method),
   MYSQL_SYSVAR(replication_delay),
   MYSQL_SYSVAR(status_file),
@@ -22280,17 +22670,20 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(autoinc_lock_mode),
   MYSQL_SYSVAR(version),
   MYSQL_SYSVAR(use_native_aio),
+  MYSQL_SYSVAR(use_io_uring),
 #ifdef HAVE_LIBNUMA
   MYSQL_SYSVAR(numa_interleave),
 #endif /* HAVE_LIBNUMA */
   MYSQL_SYSVAR(change_buffering),
   MYSQL_SYSVAR(change_buffer_max_size),
+  MYSQL_SYSVAR(change_buffer_merge_threads),
 #if defined UNIV_DEBUG || defined UNIV_IBUF_DEBUG
   MYSQL_SYSVAR(change_buffering_debug),
   MYSQL_SYSVAR(disable_background_merge),
 #endif /* UNIV_DEBUG || UNIV_IBUF_DEBUG */
   MYSQL_SYSVAR(random_read_ahead),
   MYSQL_SYSVAR(read_ahead_threshold),
+  MYSQL_SYSVAR(logical_read_ahead_pages),
   MYSQL_SYSVAR(read_only),
   MYSQL_SYSVAR(io_capacity),
   MYSQL_SYSVAR(io_capacity_max),
@@ -22329,6 +22722,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(compression_failure_threshold_pct),
   MYSQL_SYSVAR(compression_pad_pct_max),
   MYSQL_SYSVAR(default_row_format),
+  MYSQL_SYSVAR(indexed_lob),
   MYSQL_SYSVAR(redo_log_encrypt),
 #ifdef UNIV_DEBUG
   MYSQL_SYSVAR(trx_rseg_n_slots_debug),
@@ -22391,7 +22785,10 @@ i_s_innodb_sys_foreign_cols,
 i_s_innodb_sys_tablespaces,
 i_s_innodb_sys_datafiles,
 i_s_innodb_sys_virtual,
-i_s_innodb_cached_indexes
+i_s_innodb_cached_indexes,
+i_s_innodb_purge_table_stats,
+i_s_innodb_ahi_index_stats,
+p_s_innodb_tables
 
 mysql_declare_plugin_end;
 
@@ -22876,6 +23273,12 @@ ha_innobase::idx_cond_push(
 	DBUG_RETURN(NULL);
 }
 
+/** Minimum number of rows that is_record_buffer_wanted() asks for */
+static const ha_rows	RECORD_BUFFER_MIN_ROWS = 100;
+
+/** Maximum number of rows that is_record_buffer_wanted() asks for */
+static const ha_rows	RECORD_BUFFER_MAX_ROWS = 1000;
+
 /** Find out if a Record_buffer is wanted by this handler, and what is the
 maximum buffer size the handler wants.
 
@@ -22895,11 +23298,23 @@ bool ha_innobase::is_record_buffer_wanted(ha_rows* const max_rows) const
 		return false;
 	}
 
-	/* Limit the number of rows in the buffer to 100 for now. We may want
-	to fine-tune this later, possibly taking record size and page size into
-	account. The optimizer might allocate an even smaller buffer if it
-	thinks a smaller number of rows will be fetched. */
-	*max_rows = 100;
+	/* Ask for room for the records of about one leaf page of the
+	scanned index, so that the scan fills the buffer from a page while
+	the page is latched instead of restoring the cursor every few rows.
+	The optimizer limits the buffer further by its estimate of the rows
+	that will be fetched and by the size of the records. */
+	const dict_table_t*	table = m_prebuilt->table;
+	const dict_index_t*	index = m_prebuilt->index;
+	ha_rows			rows_per_page = 0;
+
+	if (table->stat_initialized && index->stat_n_leaf_pages > 0) {
+		rows_per_page = table->stat_n_rows / index->stat_n_leaf_pages;
+	}
+
+	*max_rows = std::min<ha_rows>(
+		std::max<ha_rows>(rows_per_page, RECORD_BUFFER_MIN_ROWS),
+		RECORD_BUFFER_MAX_ROWS);
+
 	return true;
 }
 
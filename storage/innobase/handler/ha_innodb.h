@@ -232,6 +232,29 @@ public:
 
 	virtual int records(ha_rows* num_rows);
 
+	/** Prepare a scan of the clustered index with several threads.
+	@param[out]	scan_ctx	context of the scan
+	@param[in,out]	num_threads	number of threads wanted, 0 for
+					innodb_parallel_read_threads; set to
+					the number of threads that will be used
+	@return 0 or error code */
+	int parallel_scan_init(void*& scan_ctx, size_t& num_threads);
+
+	/** Run a scan prepared by parallel_scan_init().
+	@param[in]	scan_ctx	context of the scan
+	@param[in]	thread_ctxs	contexts of the threads, passed to
+					load_fn
+	@param[in]	load_fn		callback for each row
+	@return 0 or error code */
+	int parallel_scan(
+		void*		scan_ctx,
+		void**		thread_ctxs,
+		Load_cbk	load_fn);
+
+	/** Release the context of a scan prepared by parallel_scan_init().
+	@param[in]	scan_ctx	context of the scan */
+	void parallel_scan_end(void* scan_ctx);
+
 	ha_rows records_in_range(
 		uint			inx,
 		key_range*		min_key,
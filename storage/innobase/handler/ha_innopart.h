@@ -705,6 +705,17 @@ public:
 		return(HA_ERR_WRONG_COMMAND);
 	}
 
+	/** The parallel reader scans one index tree, not all partitions. */
+	int
+	parallel_scan_init(
+		void*&	scan_ctx,
+		size_t&	num_threads)
+	{
+		scan_ctx = NULL;
+		num_threads = 0;
+		return(HA_ERR_WRONG_COMMAND);
+	}
+
 	void
 	free_foreign_key_create_info(
 		char*	str)
@@ -34,6 +34,7 @@ Created July 18, 2007 Vasil Dimov
 
 #include "btr0btr.h"
 #include "btr0pcur.h"
+#include "btr0sea.h"
 #include "btr0types.h"
 #include "dict0dict.h"
 #include "dict0dd.h"
@@ -60,6 +61,7 @@ Created July 18, 2007 Vasil Dimov
 #include "srv0mon.h"
 #include "srv0start.h"
 #include "trx0i_s.h"
+#include "trx0purge.h"
 #include "trx0trx.h"
 #include "ut0new.h"
 
@@ -120,6 +122,9 @@ static buf_page_desc_t	i_s_page_type[] = {
 	{"SDI_COMPRESSED_BLOB", FIL_PAGE_SDI_ZBLOB},
 	{"COMPRESSED_BLOB3", FIL_PAGE_TYPE_ZBLOB3},
 	{"RSEG_ARRAY", FIL_PAGE_TYPE_RSEG_ARRAY},
+	{"LOB_FIRST", FIL_PAGE_TYPE_LOB_FIRST},
+	{"LOB_INDEX", FIL_PAGE_TYPE_LOB_INDEX},
+	{"LOB_DATA", FIL_PAGE_TYPE_LOB_DATA},
 	{"RTREE_INDEX", I_S_PAGE_TYPE_RTREE},
 	{"IBUF_INDEX", I_S_PAGE_TYPE_IBUF},
 	{"SDI_INDEX", I_S_PAGE_TYPE_SDI}
@@ -5086,7 +5091,7 @@ i_s_innodb_buffer_page_get_info(
 
 		page_info->flush_type = bpage->flush_type;
 
-		page_info->fix_count = bpage->buf_fix_count;
+		page_info->fix_count = buf_page_get_fix_count(bpage);
 
 		page_info->newest_mod = bpage->newest_modification;
 
@@ -8866,3 +8871,446 @@ struct st_mysql_plugin	i_s_innodb_cached_indexes =
 	/* unsigned long */
 	STRUCT_FLD(flags, 0UL),
 };
+
+/** INFORMATION_SCHEMA.INNODB_PURGE_TABLE_STATS */
+
+/* Fields of the dynamic table INFORMATION_SCHEMA.INNODB_PURGE_TABLE_STATS */
+static ST_FIELD_INFO	innodb_purge_table_stats_fields_info[] =
+{
+#define PURGE_TABLE_STATS_TABLE_ID	0
+	{STRUCT_FLD(field_name,		"TABLE_ID"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define PURGE_TABLE_STATS_N_UNDO_RECS	1
+	{STRUCT_FLD(field_name,		"N_UNDO_RECS"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define PURGE_TABLE_STATS_N_BATCHES	2
+	{STRUCT_FLD(field_name,		"N_BATCHES"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define PURGE_TABLE_STATS_LAST_BATCH_RECS	3
+	{STRUCT_FLD(field_name,		"LAST_BATCH_UNDO_RECS"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define PURGE_TABLE_STATS_LAST_TRX_NO	4
+	{STRUCT_FLD(field_name,		"LAST_TRX_NO"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define PURGE_TABLE_STATS_LAG	5
+	{STRUCT_FLD(field_name,		"PURGE_LAG"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+	END_OF_ST_FIELD_INFO
+};
+
+/** Fill INFORMATION_SCHEMA.INNODB_PURGE_TABLE_STATS with the purge
+statistics of the tables.
+@param[in]	thd	thread
+@param[in,out]	tables	tables to fill
+@return 0 on success */
+static
+int
+i_s_innodb_purge_table_stats_fill_table(
+	THD*		thd,
+	TABLE_LIST*	tables,
+	Item*		/* not used */)
+{
+	DBUG_ENTER("i_s_innodb_purge_table_stats_fill_table");
+
+	/* deny access to user without PROCESS_ACL privilege */
+	if (check_global_access(thd, PROCESS_ACL)) {
+		DBUG_RETURN(0);
+	}
+
+	purge_table_stats_list_t	stats;
+
+	trx_purge_get_table_stats(stats);
+
+	TABLE*	table_to_fill = tables->table;
+	Field**	fields = table_to_fill->field;
+
+	for (const auto& table_stats : stats) {
+
+		OK(fields[PURGE_TABLE_STATS_TABLE_ID]->store(
+			   table_stats.table_id, true));
+
+		OK(fields[PURGE_TABLE_STATS_N_UNDO_RECS]->store(
+			   table_stats.n_recs, true));
+
+		OK(fields[PURGE_TABLE_STATS_N_BATCHES]->store(
+			   table_stats.n_batches, true));
+
+		OK(fields[PURGE_TABLE_STATS_LAST_BATCH_RECS]->store(
+			   table_stats.last_batch_recs, true));
+
+		OK(fields[PURGE_TABLE_STATS_LAST_TRX_NO]->store(
+			   table_stats.last_trx_no, true));
+
+		OK(fields[PURGE_TABLE_STATS_LAG]->store(
+			   table_stats.lag, true));
+
+		OK(schema_table_store_record(thd, table_to_fill));
+	}
+
+	DBUG_RETURN(0);
+}
+
+/** Bind the dynamic table INFORMATION_SCHEMA.INNODB_PURGE_TABLE_STATS.
+@param[in,out]	p	table schema object
+@return 0 on success */
+static
+int
+innodb_purge_table_stats_init(
+	void*	p)
+{
+	ST_SCHEMA_TABLE*	schema;
+
+	DBUG_ENTER("innodb_purge_table_stats_init");
+
+	schema = static_cast<ST_SCHEMA_TABLE*>(p);
+
+	schema->fields_info = innodb_purge_table_stats_fields_info;
+	schema->fill_table = i_s_innodb_purge_table_stats_fill_table;
+
+	DBUG_RETURN(0);
+}
+
+struct st_mysql_plugin	i_s_innodb_purge_table_stats =
+{
+	/* the plugin type (a MYSQL_XXX_PLUGIN value) */
+	/* int */
+	STRUCT_FLD(type, MYSQL_INFORMATION_SCHEMA_PLUGIN),
+
+	/* pointer to type-specific plugin descriptor */
+	/* void* */
+	STRUCT_FLD(info, &i_s_info),
+
+	/* plugin name */
+	/* const char* */
+	STRUCT_FLD(name, "INNODB_PURGE_TABLE_STATS"),
+
+	/* plugin author (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(author, plugin_author),
+
+	/* general descriptive text (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(descr, "InnoDB purge statistics of tables"),
+
+	/* the plugin license (PLUGIN_LICENSE_XXX) */
+	/* int */
+	STRUCT_FLD(license, PLUGIN_LICENSE_GPL),
+
+	/* the function to invoke when plugin is loaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(init, innodb_purge_table_stats_init),
+
+	/* the function to invoke when plugin is un installed */
+	/* int (*)(void*); */
+	NULL,
+
+	/* the function to invoke when plugin is unloaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(deinit, i_s_common_deinit),
+
+	/* plugin version (for SHOW PLUGINS) */
+	/* unsigned int */
+	STRUCT_FLD(version, INNODB_VERSION_SHORT),
+
+	/* struct st_mysql_show_var* */
+	STRUCT_FLD(status_vars, NULL),
+
+	/* struct st_mysql_sys_var** */
+	STRUCT_FLD(system_vars, NULL),
+
+	/* reserved for dependency checking */
+	/* void* */
+	STRUCT_FLD(__reserved1, NULL),
+
+	/* Plugin flags */
+	/* unsigned long */
+	STRUCT_FLD(flags, 0UL),
+};
+
+/** INFORMATION_SCHEMA.INNODB_AHI_INDEX_STATS */
+
+/* Fields of the dynamic table INFORMATION_SCHEMA.INNODB_AHI_INDEX_STATS */
+static ST_FIELD_INFO	innodb_ahi_index_stats_fields_info[] =
+{
+#define AHI_INDEX_STATS_SPACE_ID	0
+	{STRUCT_FLD(field_name,		"SPACE_ID"),
+	 STRUCT_FLD(field_length,	MY_INT32_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define AHI_INDEX_STATS_INDEX_ID	1
+	{STRUCT_FLD(field_name,		"INDEX_ID"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define AHI_INDEX_STATS_TABLE_NAME	2
+	{STRUCT_FLD(field_name,		"TABLE_NAME"),
+	 STRUCT_FLD(field_length,	1024),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	0),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define AHI_INDEX_STATS_INDEX_NAME	3
+	{STRUCT_FLD(field_name,		"INDEX_NAME"),
+	 STRUCT_FLD(field_length,	1024),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	0),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define AHI_INDEX_STATS_STATUS	4
+	{STRUCT_FLD(field_name,		"STATUS"),
+	 STRUCT_FLD(field_length,	8),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	0),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define AHI_INDEX_STATS_N_PAGES	5
+	{STRUCT_FLD(field_name,		"N_PAGES"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define AHI_INDEX_STATS_N_HITS	6
+	{STRUCT_FLD(field_name,		"N_HITS"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define AHI_INDEX_STATS_N_MISSES	7
+	{STRUCT_FLD(field_name,		"N_MISSES"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define AHI_INDEX_STATS_N_ROWS_ADDED	8
+	{STRUCT_FLD(field_name,		"N_ROWS_ADDED"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define AHI_INDEX_STATS_N_ROWS_REMOVED	9
+	{STRUCT_FLD(field_name,		"N_ROWS_REMOVED"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define AHI_INDEX_STATS_N_SWITCHES	10
+	{STRUCT_FLD(field_name,		"N_SWITCHES"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+	END_OF_ST_FIELD_INFO
+};
+
+/** Fill INFORMATION_SCHEMA.INNODB_AHI_INDEX_STATS with the effectiveness
+of the adaptive hash index of the cached indexes.
+@param[in]	thd	thread
+@param[in,out]	tables	tables to fill
+@return 0 on success */
+static
+int
+i_s_innodb_ahi_index_stats_fill_table(
+	THD*		thd,
+	TABLE_LIST*	tables,
+	Item*		/* not used */)
+{
+	DBUG_ENTER("i_s_innodb_ahi_index_stats_fill_table");
+
+	/* deny access to user without PROCESS_ACL privilege */
+	if (check_global_access(thd, PROCESS_ACL)) {
+		DBUG_RETURN(0);
+	}
+
+	btr_search_index_stats_list_t	stats;
+
+	btr_search_get_index_stats(stats);
+
+	TABLE*	table_to_fill = tables->table;
+	Field**	fields = table_to_fill->field;
+
+	for (const auto& index_stats : stats) {
+
+		OK(fields[AHI_INDEX_STATS_SPACE_ID]->store(
+			   index_stats.space_id, true));
+
+		OK(fields[AHI_INDEX_STATS_INDEX_ID]->store(
+			   index_stats.index_id, true));
+
+		OK(field_store_string(fields[AHI_INDEX_STATS_TABLE_NAME],
+				      index_stats.table_name.c_str()));
+
+		OK(field_store_string(fields[AHI_INDEX_STATS_INDEX_NAME],
+				      index_stats.index_name.c_str()));
+
+		OK(field_store_string(fields[AHI_INDEX_STATS_STATUS],
+				      index_stats.enabled
+				      ? "ENABLED" : "DISABLED"));
+
+		OK(fields[AHI_INDEX_STATS_N_PAGES]->store(
+			   index_stats.n_pages, true));
+
+		OK(fields[AHI_INDEX_STATS_N_HITS]->store(
+			   index_stats.n_hits, true));
+
+		OK(fields[AHI_INDEX_STATS_N_MISSES]->store(
+			   index_stats.n_misses, true));
+
+		OK(fields[AHI_INDEX_STATS_N_ROWS_ADDED]->store(
+			   index_stats.n_rows_added, true));
+
+		OK(fields[AHI_INDEX_STATS_N_ROWS_REMOVED]->store(
+			   index_stats.n_rows_removed, true));
+
+		OK(fields[AHI_INDEX_STATS_N_SWITCHES]->store(
+			   index_stats.n_switches, true));
+
+		OK(schema_table_store_record(thd, table_to_fill));
+	}
+
+	DBUG_RETURN(0);
+}
+
+/** Bind the dynamic table INFORMATION_SCHEMA.INNODB_AHI_INDEX_STATS.
+@param[in,out]	p	table schema object
+@return 0 on success */
+static
+int
+innodb_ahi_index_stats_init(
+	void*	p)
+{
+	ST_SCHEMA_TABLE*	schema;
+
+	DBUG_ENTER("innodb_ahi_index_stats_init");
+
+	schema = static_cast<ST_SCHEMA_TABLE*>(p);
+
+	schema->fields_info = innodb_ahi_index_stats_fields_info;
+	schema->fill_table = i_s_innodb_ahi_index_stats_fill_table;
+
+	DBUG_RETURN(0);
+}
+
+struct st_mysql_plugin	i_s_innodb_ahi_index_stats =
+{
+	/* the plugin type (a MYSQL_XXX_PLUGIN value) */
+	/* int */
+	STRUCT_FLD(type, MYSQL_INFORMATION_SCHEMA_PLUGIN),
+
+	/* pointer to type-specific plugin descriptor */
+	/* void* */
+	STRUCT_FLD(info, &i_s_info),
+
+	/* plugin name */
+	/* const char* */
+	STRUCT_FLD(name, "INNODB_AHI_INDEX_STATS"),
+
+	/* plugin author (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(author, plugin_author),
+
+	/* general descriptive text (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(descr, "InnoDB adaptive hash index statistics of indexes"),
+
+	/* the plugin license (PLUGIN_LICENSE_XXX) */
+	/* int */
+	STRUCT_FLD(license, PLUGIN_LICENSE_GPL),
+
+	/* the function to invoke when plugin is loaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(init, innodb_ahi_index_stats_init),
+
+	/* the function to invoke when plugin is un installed */
+	/* int (*)(void*); */
+	NULL,
+
+	/* the function to invoke when plugin is unloaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(deinit, i_s_common_deinit),
+
+	/* plugin version (for SHOW PLUGINS) */
+	/* unsigned int */
+	STRUCT_FLD(version, INNODB_VERSION_SHORT),
+
+	/* struct st_mysql_show_var* */
+	STRUCT_FLD(status_vars, NULL),
+
+	/* struct st_mysql_sys_var** */
+	STRUCT_FLD(system_vars, NULL),
+
+	/* reserved for dependency checking */
+	/* void* */
+	STRUCT_FLD(__reserved1, NULL),
+
+	/* Plugin flags */
+	/* unsigned long */
+	STRUCT_FLD(flags, 0UL),
+};
@@ -60,6 +60,8 @@ extern struct st_mysql_plugin	i_s_innodb_sys_tablespaces;
 extern struct st_mysql_plugin	i_s_innodb_sys_datafiles;
 extern struct st_mysql_plugin	i_s_innodb_sys_virtual;
 extern struct st_mysql_plugin	i_s_innodb_cached_indexes;
+extern struct st_mysql_plugin	i_s_innodb_purge_table_stats;
+extern struct st_mysql_plugin	i_s_innodb_ahi_index_stats;
 
 /** Fill handlerton based INFORMATION_SCHEMA.FILES table.
 @param[in,out]	thd	thread/connection descriptor
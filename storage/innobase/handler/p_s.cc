@@ -27,10 +27,15 @@ InnoDB performance_schema tables interface to MySQL.
 #include <stdlib.h>
 #include <sys/types.h>
 
+#include "buf0flu.h" // buf_flush_get_decisions
+#include "i_s.h" // plugin_author
 #include "lock0iter.h" // lock_queue_iterator_t
 #include "lock0lock.h" // lock_mutex_enter
 #include "my_inttypes.h"
 #include "my_io.h"
+#include "mysql/components/services/pfs_plugin_table_service.h"
+#include "mysql/plugin.h"
+#include "mysql/service_plugin_registry.h"
 #include "sql_table.h" // parse_filename
 #include "table.h" // system_charset_info
 #include "trx0i_s.h" // trx_i_s_create_lock_id
@@ -1528,3 +1533,340 @@ Innodb_data_lock_wait_iterator::scan_trx(
 	return found;
 }
 
+
+/** Registry of the server, to look up the pfs_plugin_table service */
+static SERVICE_TYPE(registry)*		p_s_registry = NULL;
+
+/** Handle of the pfs_plugin_table service */
+static my_h_service			p_s_table_svc_handle = NULL;
+
+/** The pfs_plugin_table service */
+static SERVICE_TYPE(pfs_plugin_table)*	p_s_table_svc = NULL;
+
+/** Position in performance_schema.innodb_flush_decisions */
+struct Flush_decisions_pos {
+	/** Row number, which is the buffer pool instance number */
+	unsigned int	m_index;
+};
+
+/** Open handle of performance_schema.innodb_flush_decisions */
+struct Flush_decisions_handle {
+	/** Current position */
+	Flush_decisions_pos			m_pos;
+
+	/** Position of the next row */
+	Flush_decisions_pos			m_next_pos;
+
+	/** Decisions copied when the table was first read */
+	std::vector<buf_flush_decision_t>	m_rows;
+};
+
+/** Open performance_schema.innodb_flush_decisions.
+@param[out]	pos	position of the new handle
+@return the new handle */
+static
+PSI_table_handle*
+flush_decisions_open_table(
+	PSI_pos**	pos)
+{
+	Flush_decisions_handle*	h = new Flush_decisions_handle();
+
+	h->m_pos.m_index = 0;
+	h->m_next_pos.m_index = 0;
+
+	*pos = reinterpret_cast<PSI_pos*>(&h->m_pos);
+
+	return(reinterpret_cast<PSI_table_handle*>(h));
+}
+
+/** Close performance_schema.innodb_flush_decisions.
+@param[in]	handle	handle returned by flush_decisions_open_table() */
+static
+void
+flush_decisions_close_table(
+	PSI_table_handle*	handle)
+{
+	delete reinterpret_cast<Flush_decisions_handle*>(handle);
+}
+
+/** Start reading performance_schema.innodb_flush_decisions. A table
+scan takes a new copy of the decisions, so that the rows of one scan
+come from a single recommendation of the page cleaner coordinator.
+@param[in,out]	handle	table handle
+@param[in]	scan	true for a table scan, false before positioned
+reads of the rows of an earlier scan
+@return 0 */
+static
+int
+flush_decisions_rnd_init(
+	PSI_table_handle*	handle,
+	bool			scan)
+{
+	Flush_decisions_handle*	h
+		= reinterpret_cast<Flush_decisions_handle*>(handle);
+
+	if (scan || h->m_rows.empty()) {
+		buf_flush_get_decisions(&h->m_rows);
+	}
+
+	return(0);
+}
+
+/** Move to the next row of performance_schema.innodb_flush_decisions.
+@param[in,out]	handle	table handle
+@return 0 or PFS_HA_ERR_END_OF_FILE */
+static
+int
+flush_decisions_rnd_next(
+	PSI_table_handle*	handle)
+{
+	Flush_decisions_handle*	h
+		= reinterpret_cast<Flush_decisions_handle*>(handle);
+
+	if (h->m_next_pos.m_index >= h->m_rows.size()) {
+		return(PFS_HA_ERR_END_OF_FILE);
+	}
+
+	h->m_pos = h->m_next_pos;
+	h->m_next_pos.m_index++;
+
+	return(0);
+}
+
+/** Check the row that a positioned read of
+performance_schema.innodb_flush_decisions has moved to.
+@param[in]	handle	table handle
+@return 0 or PFS_HA_ERR_RECORD_DELETED */
+static
+int
+flush_decisions_rnd_pos(
+	PSI_table_handle*	handle)
+{
+	Flush_decisions_handle*	h
+		= reinterpret_cast<Flush_decisions_handle*>(handle);
+
+	if (h->m_pos.m_index >= h->m_rows.size()) {
+		return(PFS_HA_ERR_RECORD_DELETED);
+	}
+
+	return(0);
+}
+
+/** Rewind performance_schema.innodb_flush_decisions.
+@param[in,out]	handle	table handle */
+static
+void
+flush_decisions_reset_position(
+	PSI_table_handle*	handle)
+{
+	Flush_decisions_handle*	h
+		= reinterpret_cast<Flush_decisions_handle*>(handle);
+
+	h->m_pos.m_index = 0;
+	h->m_next_pos.m_index = 0;
+}
+
+/** Read a column of the current row of
+performance_schema.innodb_flush_decisions.
+@param[in]	handle	table handle
+@param[out]	field	the column
+@param[in]	index	column number
+@return 0 */
+static
+int
+flush_decisions_read_column_value(
+	PSI_table_handle*	handle,
+	PSI_field*		field,
+	uint			index)
+{
+	const Flush_decisions_handle*	h
+		= reinterpret_cast<Flush_decisions_handle*>(handle);
+	const buf_flush_decision_t&	row = h->m_rows[h->m_pos.m_index];
+	PSI_ubigint			value;
+
+	value.is_null = false;
+
+	switch (index) {
+	case 0: /* POOL_ID */
+		{
+			PSI_uint	pool_id;
+
+			pool_id.val = static_cast<unsigned long>(row.pool_id);
+			pool_id.is_null = false;
+
+			p_s_table_svc->set_field_uinteger(field, pool_id);
+		}
+		return(0);
+	case 1: /* OLDEST_MODIFICATION_AGE */
+		value.val = row.oldest_modification_age;
+		break;
+	case 2: /* TARGET_AGE */
+		value.val = row.target_age;
+		break;
+	case 3: /* LSN_AVG_RATE */
+		value.val = row.lsn_avg_rate;
+		break;
+	case 4: /* LSN_TARGET_RATE */
+		value.val = row.lsn_target_rate;
+		break;
+	case 5: /* PAGES_BY_AGE */
+		value.val = row.n_pages_by_age;
+		break;
+	case 6: /* PAGES_REQUESTED */
+		value.val = row.n_pages_requested;
+		break;
+	default:
+		ut_error;
+	}
+
+	p_s_table_svc->set_field_ubigint(field, value);
+
+	return(0);
+}
+
+/** @return the number of rows of performance_schema.innodb_flush_decisions,
+one per buffer pool instance */
+static
+unsigned long long
+flush_decisions_get_row_count()
+{
+	return(srv_buf_pool_instances);
+}
+
+/** Share of performance_schema.innodb_flush_decisions */
+static PFS_engine_table_share_proxy	flush_decisions_share;
+
+/** Tables added by InnoDB to performance_schema */
+static PFS_engine_table_share_proxy*	p_s_shares[] = {
+	&flush_decisions_share
+};
+
+/** Release the pfs_plugin_table service and the registry. */
+static
+void
+p_s_release_service()
+{
+	if (p_s_registry == NULL) {
+		return;
+	}
+
+	if (p_s_table_svc_handle != NULL) {
+		p_s_registry->release(p_s_table_svc_handle);
+		p_s_table_svc_handle = NULL;
+		p_s_table_svc = NULL;
+	}
+
+	mysql_plugin_registry_release(p_s_registry);
+	p_s_registry = NULL;
+}
+
+/** Add the InnoDB tables to performance_schema. This cannot be done when
+InnoDB itself is initialized, because the tables are created in the data
+dictionary, which is not available until InnoDB is running.
+@return 0 on success */
+static
+int
+innodb_p_s_tables_init(
+	void*)
+{
+	DBUG_ENTER("innodb_p_s_tables_init");
+
+	p_s_registry = mysql_plugin_registry_acquire();
+
+	if (p_s_registry == NULL
+	    || p_s_registry->acquire("pfs_plugin_table",
+				     &p_s_table_svc_handle)) {
+		p_s_release_service();
+		DBUG_RETURN(1);
+	}
+
+	p_s_table_svc = reinterpret_cast<SERVICE_TYPE(pfs_plugin_table)*>(
+		p_s_table_svc_handle);
+
+	flush_decisions_share.m_table_name = "innodb_flush_decisions";
+	flush_decisions_share.m_table_name_length = static_cast<uint>(
+		strlen(flush_decisions_share.m_table_name));
+	flush_decisions_share.m_table_definition =
+		"POOL_ID INTEGER UNSIGNED not null, "
+		"OLDEST_MODIFICATION_AGE BIGINT UNSIGNED not null, "
+		"TARGET_AGE BIGINT UNSIGNED not null, "
+		"LSN_AVG_RATE BIGINT UNSIGNED not null, "
+		"LSN_TARGET_RATE BIGINT UNSIGNED not null, "
+		"PAGES_BY_AGE BIGINT UNSIGNED not null, "
+		"PAGES_REQUESTED BIGINT UNSIGNED not null";
+	flush_decisions_share.m_ref_length = sizeof(Flush_decisions_pos);
+	flush_decisions_share.m_acl = READONLY;
+	flush_decisions_share.get_row_count = flush_decisions_get_row_count;
+	flush_decisions_share.delete_all_rows = NULL;
+
+	/* The table has no index and cannot be written. */
+	flush_decisions_share.m_proxy_engine_table = {
+		flush_decisions_rnd_next,
+		flush_decisions_rnd_init,
+		flush_decisions_rnd_pos,
+		NULL,
+		NULL,
+		NULL,
+		flush_decisions_read_column_value,
+		flush_decisions_reset_position,
+		NULL,
+		NULL,
+		NULL,
+		NULL,
+		NULL,
+		flush_decisions_open_table,
+		flush_decisions_close_table};
+
+	if (p_s_table_svc->add_tables(
+		    p_s_shares, UT_ARR_SIZE(p_s_shares))) {
+		p_s_release_service();
+		DBUG_RETURN(1);
+	}
+
+	DBUG_RETURN(0);
+}
+
+/** Remove the InnoDB tables from performance_schema.
+@return 0 on success */
+static
+int
+innodb_p_s_tables_deinit(
+	void*)
+{
+	DBUG_ENTER("innodb_p_s_tables_deinit");
+
+	int	err = 0;
+
+	if (p_s_table_svc != NULL
+	    && p_s_table_svc->delete_tables(
+		    p_s_shares, UT_ARR_SIZE(p_s_shares))) {
+		err = 1;
+	}
+
+	p_s_release_service();
+
+	DBUG_RETURN(err);
+}
+
+/** Descriptor of the plugin that adds the InnoDB tables */
+static struct st_mysql_daemon	p_s_info = {
+	MYSQL_DAEMON_INTERFACE_VERSION
+};
+
+struct st_mysql_plugin	p_s_innodb_tables =
+{
+	MYSQL_DAEMON_PLUGIN,
+	&p_s_info,
+	"INNODB_PERFORMANCE_SCHEMA_TABLES",
+	plugin_author,
+	"InnoDB tables in performance_schema",
+	PLUGIN_LICENSE_GPL,
+	innodb_p_s_tables_init, /* Plugin Init */
+	NULL, /* Plugin Check uninstall */
+	innodb_p_s_tables_deinit, /* Plugin Deinit */
+	INNODB_VERSION_SHORT,
+	NULL, /* status variables */
+	NULL, /* system variables */
+	NULL, /* reserved */
+	0,    /* flags */
+};
@@ -46,4 +46,7 @@ public:
 		PSI_engine_data_lock_wait_iterator *it);
 };
 
+/** Plugin that adds the InnoDB tables to performance_schema */
+extern struct st_mysql_plugin	p_s_innodb_tables;
+
 #endif /* p_s_h */
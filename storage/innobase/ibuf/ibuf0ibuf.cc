@@ -24,6 +24,7 @@ Created 7/19/1997 Heikki Tuuri
 *******************************************************/
 
 #include <sys/types.h>
+#include <atomic>
 
 #include "btr0sea.h"
 #include "ha_prototypes.h"
@@ -64,6 +65,7 @@ bool	srv_ibuf_disable_background_merge;
 #include "rem0rec.h"
 #include "row0upd.h"
 #include "srv0start.h" /* srv_shutdown_state */
+#include "srv0srv.h"
 #include "trx0sys.h"
 
 /*	STRUCTURE OF AN INSERT BUFFER RECORD
@@ -288,6 +290,16 @@ static ib_mutex_t	ibuf_mutex;
 /** The mutex protecting the insert buffer bitmaps */
 static ib_mutex_t	ibuf_bitmap_mutex;
 
+/** Event that wakes up the change buffer merge threads */
+static os_event_t	ibuf_merge_event;
+
+/** Number of change buffer merge threads that are running */
+static std::atomic<ulint>	ibuf_merge_n_threads_active;
+
+/** Number of pages that the change buffer merge threads may still read
+in during the current second; refilled by ibuf_merge_thread() number 0 */
+static std::atomic<lint>	ibuf_merge_quota;
+
 /** The area in pages from which contract looks for page numbers for merge */
 const ulint		IBUF_MERGE_AREA = 8;
 
@@ -463,6 +475,9 @@ ibuf_close(void)
 
 	mutex_free(&ibuf_bitmap_mutex);
 
+	ut_ad(ibuf_merge_n_threads_active == 0);
+	os_event_destroy(ibuf_merge_event);
+
 	dict_table_t*	ibuf_table = ibuf->index->table;
 	rw_lock_free(&ibuf->index->lock);
 	dict_mem_index_free(ibuf->index);
@@ -521,6 +536,8 @@ ibuf_init_at_db_start(void)
 	mutex_create(LATCH_ID_IBUF_PESSIMISTIC_INSERT,
 		     &ibuf_pessimistic_insert_mutex);
 
+	ibuf_merge_event = os_event_create(0);
+
 	mtr_start(&mtr);
 
 	mtr_x_lock_space(fil_space_get_sys_space(), &mtr);
@@ -2730,6 +2747,144 @@ ibuf_merge_in_background(
 	return(sum_bytes);
 }
 
+/** Compute how many pages the change buffer merge threads may read in
+during the next second.  The demand grows with the fill ratio of the
+change buffer, from PCT_IO(5) when it is nearly empty to
+innodb_io_capacity_max when it is full, and is PCT_IO(100) or more when
+there were no foreground reads, like the merge of an idle master thread.
+The demand is capped by the read capacity that foreground reads left
+unused, but never below PCT_IO(5), so that the change buffer drains even
+under a read-heavy load.
+@param[in]	n_fg_reads	number of pages read on demand in the last
+second
+@return number of pages */
+static
+ulint
+ibuf_merge_rate(
+	ulint	n_fg_reads)
+{
+	mutex_enter(&ibuf_mutex);
+
+	/* +1 is to avoid division by zero. */
+	const ulint	fill = std::min<ulint>(
+		100, ibuf->size * 100 / (ibuf->max_size + 1));
+
+	mutex_exit(&ibuf_mutex);
+
+	const ulint	low = PCT_IO(5);
+	const ulint	high = std::max<ulint>(low, srv_max_io_capacity);
+	ulint		demand = low + (high - low) * fill / 100;
+
+	if (n_fg_reads == 0) {
+		demand = std::max<ulint>(demand, PCT_IO(100));
+	}
+
+	const ulint	headroom = high > n_fg_reads ? high - n_fg_reads : 0;
+
+	return(std::max(low, std::min(demand, headroom)));
+}
+
+/** Change buffer merge thread.  The threads share a budget of pages per
+second, which thread number 0 computes with ibuf_merge_rate().  Each
+thread takes batches of the budget and merges them from a random position
+of the change buffer tree.  The pages are read in with asynchronous I/O,
+and the buffered changes are applied by the I/O handler threads as the
+reads complete.
+@param[in]	thread_no	number of the thread, from 0 */
+void
+ibuf_merge_thread(
+	size_t	thread_no)
+{
+	my_thread_init();
+
+	ut_ad(!srv_read_only_mode);
+	ut_ad(ibuf_merge_n_threads_active > 0);
+
+	uintmax_t	last_refill = 0;
+	ulint		last_reads = srv_stats.buf_pool_reads;
+	int64_t		sig_count = os_event_reset(ibuf_merge_event);
+
+	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+
+		os_event_wait_time_low(ibuf_merge_event, 1000000, sig_count);
+
+		sig_count = os_event_reset(ibuf_merge_event);
+
+		if (srv_shutdown_state != SRV_SHUTDOWN_NONE) {
+			break;
+		}
+
+#if defined UNIV_DEBUG || defined UNIV_IBUF_DEBUG
+		if (srv_ibuf_disable_background_merge) {
+			continue;
+		}
+#endif /* UNIV_DEBUG || UNIV_IBUF_DEBUG */
+
+		if (thread_no == 0) {
+			const uintmax_t	now = ut_time_us(NULL);
+
+			if (now - last_refill >= 1000000) {
+				const ulint	reads = srv_stats.buf_pool_reads;
+
+				ibuf_merge_quota = ibuf_merge_rate(
+					reads - last_reads);
+
+				last_reads = reads;
+				last_refill = now;
+
+				/* Wake up the other threads to share the
+				new budget. */
+				os_event_set(ibuf_merge_event);
+				sig_count = os_event_reset(ibuf_merge_event);
+			}
+		}
+
+		while (srv_shutdown_state == SRV_SHUTDOWN_NONE
+		       && ibuf_merge_quota.fetch_sub(IBUF_MAX_N_PAGES_MERGED)
+		       > 0) {
+
+			ulint	n_pages;
+
+			if (ibuf_merge(&n_pages, false) == 0) {
+				/* The change buffer is empty. */
+				ibuf_merge_quota = 0;
+				break;
+			}
+		}
+	}
+
+	--ibuf_merge_n_threads_active;
+
+	my_thread_end();
+}
+
+/** Count the change buffer merge threads before they are created, so
+that they are waited for at shutdown even if they have not started to
+run yet.
+@param[in]	n_threads	number of threads that will be created */
+void
+ibuf_merge_threads_starting(
+	ulint	n_threads)
+{
+	ut_ad(ibuf_merge_n_threads_active == 0);
+
+	ibuf_merge_n_threads_active = n_threads;
+}
+
+/** Wake up the change buffer merge threads. */
+void
+ibuf_merge_threads_wakeup()
+{
+	os_event_set(ibuf_merge_event);
+}
+
+/** @return number of change buffer merge threads that are running */
+ulint
+ibuf_merge_threads_active()
+{
+	return(ibuf_merge_n_threads_active);
+}
+
 /*********************************************************************//**
 Contract insert buffer trees after insert if they are too big. */
 UNIV_INLINE
@@ -351,6 +351,28 @@ btr_pcur_move_to_next_page(
 	btr_pcur_t*	cursor,	/*!< in: persistent cursor; must be on the
 				last record of the current page */
 	mtr_t*		mtr);	/*!< in: mtr */
+
+/** Reads ahead the leaf pages that follow the stored position of a
+persistent cursor in ascending order.  The page numbers are taken from the
+node pointers on the level above the leaves, so that the pages are found
+without reading them even when they are not adjacent in the file.  The
+reads are asynchronous.  The read-ahead stops at the first node pointer
+that is greater than end_tuple, because the scan ends before that page.
+NOTE: the caller must not hold any page latches, and this must not be
+called in read-only mode.
+@param[in]	cursor		persistent cursor whose position has been
+stored
+@param[in]	n_pages		maximum number of leaf pages to read ahead
+@param[in]	end_tuple	last key of the scan, or NULL if the scan
+may continue to the end of the index
+@return number of leaf pages that follow the stored position, up to
+n_pages; less than n_pages if the scan reaches the end of the index or
+of the range */
+ulint
+btr_pcur_read_ahead_logical(
+	const btr_pcur_t*	cursor,
+	ulint			n_pages,
+	const dtuple_t*		end_tuple);
 #ifdef UNIV_DEBUG
 /*********************************************************//**
 Returns the btr cursor component of a persistent cursor.
@@ -34,6 +34,9 @@ Created 2/17/1996 Heikki Tuuri
 #include "mtr0mtr.h"
 #include "ha0ha.h"
 
+#include <string>
+#include <vector>
+
 /** Creates and initializes the adaptive search system at a database start.
 @param[in]	hash_size	hash table size. */
 void
@@ -304,6 +307,31 @@ struct btr_search_t{
 				the same prefix should be indexed in the
 				hash index */
 	/*---------------------- @} */
+	/* @{ Self-tuning of the hash index of the index, see
+	btr_search_tune(). The counters are not protected by any latch
+	and may lose updates. */
+	ibool	disabled;	/*!< TRUE if the hash index is neither used
+				nor built for this index, because it did
+				not pay off */
+	ulint	n_switches;	/*!< number of times disabled was changed */
+	ulint	n_hits;		/*!< number of successful hash searches */
+	ulint	n_misses;	/*!< number of failed hash searches */
+	ulint	n_rows_added;	/*!< number of hash nodes added or updated */
+	ulint	n_rows_removed;	/*!< number of hash nodes removed */
+	ulint	tune_hits;	/*!< successful hash searches in the current
+				window, or while disabled, analysed searches
+				that would have succeeded */
+	ulint	tune_misses;	/*!< failed hash searches in the current
+				window, or while disabled, searches that
+				would have failed */
+	ulint	tune_rows;	/*!< n_rows_added + n_rows_removed when the
+				current window started */
+	ulint	tune_strikes;	/*!< number of consecutive windows that
+				voted for changing disabled */
+	ulint	n_build_pending;/*!< number of pages of the index that are
+				queued for the hash index build thread;
+				updated with atomic operations */
+	/* @} */
 #ifdef UNIV_SEARCH_PERF_STAT
 	ulint	n_hash_succ;	/*!< number of successful hash searches thus
 				far */
@@ -319,13 +347,95 @@ struct btr_search_t{
 #endif /* UNIV_DEBUG */
 };
 
+/** Queue of page hash index builds of an adaptive hash index part */
+struct btr_search_build_queue_t;
+
 /** The hash index system */
 struct btr_search_sys_t{
 	hash_table_t**	hash_tables;	/*!< the adaptive hash tables,
 					mapping dtuple_fold values
 					to rec_t pointers on index pages */
+	btr_search_build_queue_t**
+			build_queues;	/*!< pages waiting for the hash
+					index build thread, one queue per
+					hash table */
+};
+
+/** Effectiveness of the adaptive hash index of an index, for
+INFORMATION_SCHEMA.INNODB_AHI_INDEX_STATS */
+struct btr_search_index_stats_t {
+	/** Tablespace id */
+	space_id_t	space_id;
+
+	/** Index id */
+	space_index_t	index_id;
+
+	/** Table name */
+	std::string	table_name;
+
+	/** Index name */
+	std::string	index_name;
+
+	/** true if the hash index is used and built for the index */
+	bool		enabled;
+
+	/** Number of pages of the index that have a hash index */
+	ulint		n_pages;
+
+	/** Number of successful hash searches */
+	ulint		n_hits;
+
+	/** Number of failed hash searches */
+	ulint		n_misses;
+
+	/** Number of hash nodes added or updated */
+	ulint		n_rows_added;
+
+	/** Number of hash nodes removed */
+	ulint		n_rows_removed;
+
+	/** Number of times the hash index was turned off or on */
+	ulint		n_switches;
 };
 
+typedef std::vector<btr_search_index_stats_t,
+		    ut_allocator<btr_search_index_stats_t> >
+	btr_search_index_stats_list_t;
+
+/** Get the effectiveness of the adaptive hash index of the cached indexes
+that have used it.
+@param[out]	stats	statistics of the indexes */
+void
+btr_search_get_index_stats(
+	btr_search_index_stats_list_t&	stats);
+
+/** Background thread that builds and drops the hash index of the pages
+that btr_search_info_update_slow() queued. */
+void
+btr_search_build_thread();
+
+/** Let the hash index build thread accept requests before it is
+created, so that it is waited for at shutdown even if it has not started
+to run yet. */
+void
+btr_search_build_thread_starting();
+
+/** Wake up the hash index build thread. */
+void
+btr_search_build_thread_wakeup();
+
+/** Remove the queued hash index builds of the pages of an index. A
+request that the hash index build thread is serving stays counted in
+n_build_pending until the thread is done with it.
+@param[in]	index	index */
+void
+btr_search_build_cancel(
+	const dict_index_t*	index);
+
+/** @return true if the hash index build thread is running */
+bool
+btr_search_build_thread_active();
+
 /** Latches protecting access to adaptive hash index. */
 extern rw_lock_t**		btr_search_latches;
 
@@ -47,6 +47,10 @@ extern bool	btr_search_enabled;
 /** Number of adaptive hash index partition. */
 extern ulong	btr_ahi_parts;
 
+/** Whether the adaptive hash index is turned off and on per index by its
+effectiveness, and page hash indexes are built in the background. */
+extern bool	btr_search_auto;
+
 /** The size of a reference to data stored on a different page.
 The reference is stored at the end of the prefix of the field
 in the index record. */
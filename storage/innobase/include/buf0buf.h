@@ -628,6 +628,45 @@ ulint
 buf_block_unfix(
 	buf_block_t*	block);
 
+/** Buffer-fixes a page that was found without holding the page_hash
+latch, unless buf_page_freeze() has been called on it.
+@param[in,out]	bpage	block to bufferfix
+@return true if the page was buffer-fixed */
+UNIV_INLINE
+bool
+buf_block_fix_if_not_frozen(
+	buf_page_t*	bpage)
+	MY_ATTRIBUTE((warn_unused_result));
+
+/** Prevents buf_block_fix_if_not_frozen() from buffer-fixing a page
+before it is removed from buf_pool->page_hash or relocated. The caller
+must hold the page_hash X-latch and the block mutex.
+@param[in,out]	bpage	block that is about to be removed or relocated
+@return true if the page was not buffer-fixed and is now frozen */
+UNIV_INLINE
+bool
+buf_page_freeze(
+	buf_page_t*	bpage)
+	MY_ATTRIBUTE((warn_unused_result));
+
+/** Undoes buf_page_freeze() when the page stays in
+buf_pool->page_hash after all.
+@param[in,out]	bpage	frozen block */
+UNIV_INLINE
+void
+buf_page_unfreeze(
+	buf_page_t*	bpage);
+
+/** Gets the number of buffer-fixes of a page, without the
+BUF_PAGE_FIX_FROZEN flag.
+@param[in]	bpage	block
+@return buffer-fix count */
+UNIV_INLINE
+ib_uint32_t
+buf_page_get_fix_count(
+	const buf_page_t*	bpage)
+	MY_ATTRIBUTE((warn_unused_result));
+
 /** Unfixes the page, unlatches the page,
 removes it from page_hash and removes it from LRU.
 @param[in,out]	bpage	pointer to the block */
@@ -1367,6 +1406,10 @@ buf_page_get_io_fix_unlocked(
 /** The common buffer control block structure
 for compressed and uncompressed frames */
 
+/** Flag in buf_page_t::buf_fix_count of a block that lock-free page_hash
+lookups must not buffer-fix. @see buf_page_freeze() */
+#define BUF_PAGE_FIX_FROZEN	(1U << 31)
+
 /** Number of bits used for buffer page states. */
 #define BUF_PAGE_STATE_BITS	3
 
@@ -1385,7 +1428,10 @@ public:
 	/** Page size. */
 	page_size_t	size;
 
-	/** Count of how manyfold this block is currently bufferfixed. */
+	/** Count of how manyfold this block is currently bufferfixed.
+	BUF_PAGE_FIX_FROZEN is set while the block is being removed
+	from buf_pool->page_hash or relocated, and while an uncompressed
+	block is not in buf_pool->page_hash. @see buf_page_freeze() */
 	ib_uint32_t	buf_fix_count;
 
 	/** type of pending I/O operation. */
@@ -53,7 +53,8 @@ At a database startup initializes the doublewrite buffer memory structure if
 we already have a doublewrite buffer created in the data files. If we are
 upgrading to an InnoDB version which supports multiple tablespaces, then this
 function performs the necessary update operations. If we are in a crash
-recovery, this function loads the pages from double write buffer into memory.
+recovery, this function loads the pages from double write buffer and from
+the doublewrite files into memory.
 @return DB_SUCCESS or error code */
 dberr_t
 buf_dblwr_init_or_load_pages(
@@ -64,6 +65,11 @@ buf_dblwr_init_or_load_pages(
 void
 buf_dblwr_process(void);
 
+/** Free the pages that were read from the doublewrite buffer and files at
+startup, once crash recovery no longer needs them. */
+void
+buf_dblwr_free_recovery_pages();
+
 /****************************************************************//**
 frees doublewrite buffer. */
 void
@@ -86,12 +92,14 @@ buf_dblwr_page_inside(
 	page_no_t	page_no);	/*!< in: page number */
 
 /** Posts a buffer page for writing. If the doublewrite memory buffer
-is full, calls buf_dblwr_flush_buffered_writes and waits for for free
-space to appear.
-@param[in]	bpage	buffer block to write */
+of the shard is full, calls buf_dblwr_flush_buffered_writes and waits
+for free space to appear.
+@param[in]	bpage		buffer block to write
+@param[in]	flush_type	BUF_FLUSH_LRU or BUF_FLUSH_LIST */
 void
 buf_dblwr_add_to_batch(
-	buf_page_t*	bpage);
+	buf_page_t*	bpage,
+	buf_flush_t	flush_type);
 
 /********************************************************************//**
 Flush a batch of writes to the datafiles that have already been
@@ -99,15 +107,18 @@ written to the dblwr buffer on disk. */
 void
 buf_dblwr_sync_datafiles();
 
-/********************************************************************//**
-Flushes possible buffered writes from the doublewrite memory buffer to disk,
-and also wakes up the aio thread if simulated aio is used. It is very
-important to call this function after a batch of writes has been posted,
-and also when we may have to wait for a page latch! Otherwise a deadlock
-of threads can occur. */
+/** Flushes possible buffered writes of a buffer pool instance from the
+doublewrite memory buffer to disk, and also wakes up the aio thread if
+simulated aio is used. It is very important to call this function after
+a batch of writes has been posted, and also when we may have to wait for
+a page latch! Otherwise a deadlock of threads can occur.
+@param[in]	buf_pool	buffer pool instance
+@param[in]	flush_type	BUF_FLUSH_LRU or BUF_FLUSH_LIST */
 void
-buf_dblwr_flush_buffered_writes(void);
-/*=================================*/
+buf_dblwr_flush_buffered_writes(
+	const buf_pool_t*	buf_pool,
+	buf_flush_t		flush_type);
+
 /********************************************************************//**
 Writes a page to the doublewrite buffer on disk, sync it, then write
 the page to the datafile and sync the datafile. This function is used
@@ -129,13 +140,15 @@ tablespace they belong to.
 void
 buf_dblwr_recover_pages(fil_space_t* space);
 
-/** Doublewrite control struct */
-struct buf_dblwr_t{
+/** One doublewrite file. The first srv_doublewrite_batch_size pages of
+the file are used for batch flushes, the rest for single page flushes.
+Each buffer pool instance writes its LRU and flush_list batches to its
+own shard, so that page cleaners do not wait for each other. */
+struct buf_dblwr_shard_t{
 	ib_mutex_t	mutex;	/*!< mutex protecting the first_free
 				field and write_buf */
-	page_no_t	block1;	/*!< the page number of the first
-				doublewrite block (64 pages) */
-	page_no_t	block2;	/*!< page number of the second block */
+	char*		name;	/*!< path of the doublewrite file */
+	pfs_os_file_t	file;	/*!< handle to the doublewrite file */
 	page_no_t	first_free;/*!< first free position in write_buf
 				measured in units of UNIV_PAGE_SIZE */
 	ulint		b_reserved;/*!< number of slots currently reserved
@@ -153,7 +166,7 @@ struct buf_dblwr_t{
 				is being written from the doublewrite
 				buffer. */
 	byte*		write_buf;/*!< write buffer used in writing to the
-				doublewrite buffer, aligned to an
+				doublewrite file, aligned to an
 				address divisible by UNIV_PAGE_SIZE
 				(which is required by Windows aio) */
 	byte*		write_buf_unaligned;/*!< pointer to write_buf,
@@ -163,6 +176,21 @@ struct buf_dblwr_t{
 				cached to write_buf */
 };
 
+/** Doublewrite control struct */
+struct buf_dblwr_t{
+	page_no_t	block1;	/*!< the page number of the first
+				doublewrite block (64 pages) in the
+				system tablespace. It is no longer
+				written to, but it is still read at
+				crash recovery. */
+	page_no_t	block2;	/*!< page number of the second block */
+	ulint		n_shards;/*!< number of doublewrite files */
+	buf_dblwr_shard_t*	shards;/*!< the doublewrite files */
+	byte*		recv_buf_unaligned;/*!< pages read from the
+				doublewrite buffer and files at startup,
+				or NULL */
+};
+
 
 #endif /* UNIV_HOTBACKUP */
 
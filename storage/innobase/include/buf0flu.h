@@ -32,6 +32,8 @@ Created 11/5/1995 Heikki Tuuri
 #ifndef UNIV_HOTBACKUP
 #include "buf0types.h"
 
+#include <vector>
+
 /** Flag indicating if the page_cleaner is in active state. */
 extern bool buf_page_cleaner_is_active;
 
@@ -237,6 +239,33 @@ buf_flush_page_cleaner_init(size_t n_page_cleaners);
 void
 buf_flush_wait_LRU_batch_end();
 
+/** The latest adaptive flushing decision for one buffer pool instance,
+as shown in performance_schema.innodb_flush_decisions */
+struct buf_flush_decision_t {
+	/** buffer pool instance number */
+	ulint	pool_id;
+	/** LSN age of the oldest modification in the instance */
+	lsn_t	oldest_modification_age;
+	/** LSN age of the oldest modification that is aimed for */
+	lsn_t	target_age;
+	/** estimated redo generation rate, in LSN per second */
+	lsn_t	lsn_avg_rate;
+	/** rate at which the oldest modification is to advance,
+	in LSN per second */
+	lsn_t	lsn_target_rate;
+	/** pages of the instance that are older than the LSN target */
+	ulint	n_pages_by_age;
+	/** pages requested from the instance */
+	ulint	n_pages_requested;
+};
+
+/** Copy the latest adaptive flushing decisions.
+@param[out]	decisions	one decision per buffer pool instance,
+or none if the page cleaners are not running */
+void
+buf_flush_get_decisions(
+	std::vector<buf_flush_decision_t>*	decisions);
+
 #if defined UNIV_DEBUG || defined UNIV_BUF_DEBUG
 /******************************************************************//**
 Validates the flush list.
@@ -54,6 +54,10 @@ These are low-level functions
 /** Minimum LRU list length for which the LRU_old pointer is defined */
 #define BUF_LRU_OLD_MIN_LEN	512	/* 8 megabytes of 16k pages */
 
+/** Maximum value of innodb_lru_access_batch: number of page accesses that
+a thread may buffer before applying them to the LRU lists */
+#define BUF_LRU_ACCESS_BATCH_MAX	256
+
 /******************************************************************//**
 Flushes all dirty pages or removes all pages belonging
 to a given tablespace. A PROBLEM: if readahead is being started, what
@@ -182,6 +186,21 @@ void
 buf_LRU_make_block_young(
 	buf_page_t*	bpage);
 
+/** Remembers that a page should be moved to the start of the LRU list.
+The accesses are buffered per thread and applied with one acquisition
+of buf_pool->LRU_list_mutex per buffer pool instance once
+srv_LRU_access_batch of them have been collected, once the oldest of them
+is one second old, at transaction commit, or when the thread exits.
+@param[in]	page_id	page id of a buffer-fixed page */
+void
+buf_LRU_make_block_young_deferred(
+	const page_id_t&	page_id);
+
+/** Applies the page accesses buffered by the current thread to the LRU
+lists. The caller must not hold any buffer pool mutex. */
+void
+buf_LRU_access_flush();
+
 /**********************************************************************//**
 Updates buf_pool->LRU_old_ratio.
 @return updated old_pct */
@@ -204,7 +223,8 @@ buf_LRU_stat_update(void);
 the LRU list and block mutexes and have page hash latched in X. The latch and
 the block mutexes will be released.
 @param[in,out]	bpage		block, must contain a file page and
-				be in a state where it can be freed; there
+				be in a state where it can be freed and
+				frozen by buf_page_freeze(); there
 				may or may not be a hash index to the page
 @param[in]	zip		true if should remove also the compressed page
 				of an uncompressed page
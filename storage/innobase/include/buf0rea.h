@@ -110,6 +110,24 @@ buf_read_ahead_linear(
 	const page_size_t&	page_size,
 	ibool			inside_ibuf);
 
+/** Issues asynchronous read requests for the leaf pages that an index range
+scan is about to visit, as found from the node pointers on the level above
+the leaves by btr_pcur_read_ahead_logical().  Unlike the linear read-ahead,
+the pages need not be adjacent in the file.  Does not read any page if too
+many reads are pending.
+NOTE: the calling thread must not own latches on pages.
+@param[in]	space_id	tablespace id
+@param[in]	page_size	page size
+@param[in]	page_nos	leaf page numbers in scan order
+@param[in]	n_pages		number of page numbers in the array
+@return number of page read requests issued */
+ulint
+buf_read_ahead_logical(
+	space_id_t		space_id,
+	const page_size_t&	page_size,
+	const page_no_t*	page_nos,
+	ulint			n_pages);
+
 /********************************************************************//**
 Issues read requests for pages which the ibuf module wants to read in, in
 order to contract the insert buffer tree. Technically, this function is like
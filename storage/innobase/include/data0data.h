@@ -631,7 +631,8 @@ struct big_rec_field_t {
 	big_rec_field_t(ulint field_no_, ulint len_, void* data_)
 		: field_no(field_no_),
 		  len(len_),
-		  data(data_)
+		  data(data_),
+		  old_ref(NULL)
 	{}
 
 	byte*	ptr() const
@@ -642,6 +643,10 @@ struct big_rec_field_t {
 	ulint		field_no;	/*!< field number in record */
 	ulint		len;		/*!< stored data length, in bytes */
 	void*		data;		/*!< stored data */
+	const byte*	old_ref;	/*!< copy of the external field
+					reference of the version that an
+					update replaces, or NULL; used for
+					partial updates of indexed LOBs */
 };
 
 /** Storage format for overflow data in a big record, that is, a
@@ -1045,6 +1045,14 @@ struct dict_index_t{
 	ulint		stat_n_leaf_pages;
 				/*!< approximate number of leaf pages in the
 				index tree */
+	ib_uint64_t	stat_modified_counter;
+				/*!< number of records inserted, updated or
+				delete-marked in the index since its
+				statistics were last calculated; used by the
+				automatic recalculation of persistent
+				statistics to sample only the indexes that
+				changed. Not protected by any latch, because
+				it is only used for heuristics. */
 	/* @} */
 	last_ops_cur_t*	last_ins_cur;
 				/*!< cache the last insert position.
@@ -1911,7 +1919,7 @@ struct dict_table_t {
 	ulong					n_waiting_or_granted_auto_inc_locks;
 
 	/** The transaction that currently holds the the AUTOINC lock on this
-	table. Protected by lock_sys->mutex. */
+	table. Protected by lock_sys->latch. */
 	const trx_t*				autoinc_trx;
 
 	/* @} */
@@ -1926,7 +1934,7 @@ struct dict_table_t {
 
 	/** Count of the number of record locks on this table. We use this to
 	determine whether we can evict the table from the dictionary cache.
-	It is protected by lock_sys->mutex. */
+	It is updated atomically while holding lock_sys->latch. */
 	ulint					n_rec_locks;
 
 #ifndef UNIV_DEBUG
@@ -1938,7 +1946,7 @@ private:
 	ulint					n_ref_count;
 
 public:
-	/** List of locks on the table. Protected by lock_sys->mutex. */
+	/** List of locks on the table. Protected by lock_sys->latch. */
 	table_lock_list_t			locks;
 
 	/** Timestamp of the last modification of this table. */
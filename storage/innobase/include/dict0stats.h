@@ -48,10 +48,17 @@ enum dict_stats_upd_option_t {
 				members. The resulting stats correspond to an
 				empty table. If the table is using persistent
 				statistics, then they are saved on disk. */
-	DICT_STATS_FETCH_ONLY_IF_NOT_IN_MEMORY /* fetch the stats
+	DICT_STATS_FETCH_ONLY_IF_NOT_IN_MEMORY, /* fetch the stats
 				from the persistent storage if the in-memory
 				structures have not been initialized yet,
 				otherwise do nothing */
+	DICT_STATS_RECALC_PERSISTENT_INCREMENTAL /* like
+				DICT_STATS_RECALC_PERSISTENT, but only
+				recalculate the indexes that have changed
+				enough since their statistics were last
+				calculated, within the page budget
+				innodb_stats_auto_recalc_page_budget, and only
+				save the statistics of those indexes */
 };
 
 /** Set the persistent statistics flag for a given table. This is set only in
@@ -117,6 +124,15 @@ dict_stats_deinit(
 /*==============*/
 	dict_table_t*	table);	/*!< in/out: table */
 
+/** Note that a record was inserted, updated or delete-marked in an index,
+so that the automatic recalculation of persistent statistics knows which
+indexes have changed.
+@param[in,out]	index	index */
+UNIV_INLINE
+void
+dict_stats_index_modified(
+	dict_index_t*	index);
+
 /*********************************************************************//**
 Calculates new estimates for table and index statistics. The statistics
 are used in query optimization.
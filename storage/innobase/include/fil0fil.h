@@ -36,6 +36,7 @@ Created 10/25/1995 Heikki Tuuri
 #include "ibuf0types.h"
 #endif /* !UNIV_HOTBACKUP */
 
+#include <atomic>
 #include <list>
 #include <vector>
 
@@ -94,7 +95,8 @@ struct fil_space_t {
 	lsn_t		max_lsn;
 
 	/** true if we want to rename the .ibd file of tablespace and
-	want to stop temporarily posting of new i/o requests on the file */
+	want to stop temporarily posting of new i/o requests on the file.
+	Written while holding both fil_system->mutex and the shard mutex. */
 	bool		stop_ios;
 
 	/** we set this true when we start deleting a single-table
@@ -103,7 +105,8 @@ struct fil_space_t {
 	* ibuf merge
 	* file flush
 	Note that we can still possibly have new write operations because we
-	don't check this flag when doing flush batches. */
+	don't check this flag when doing flush batches.
+	Written while holding both fil_system->mutex and the shard mutex. */
 	bool		stop_new_ops;
 
 #ifdef UNIV_DEBUG
@@ -139,6 +142,16 @@ struct fil_space_t {
 	B-tree page split */
 	ulint		n_reserved_extents;
 
+	/** free extents when the background tablespace extender last
+	looked at the tablespace, or ULINT_UNDEFINED;
+	protected by fil_system->mutex */
+	ulint		extend_ahead_free;
+
+	/** number of free extents that the background tablespace extender
+	keeps in the tablespace, following its growth rate;
+	protected by fil_system->mutex */
+	ulint		extend_ahead_target;
+
 	/** this is positive when flushing the tablespace to disk;
 	dropping of the tablespace is forbidden if this is positive */
 	ulint		n_pending_flushes;
@@ -223,7 +236,9 @@ struct fil_node_t {
 	char*		name;
 	/** whether this file is open. Note: We set the is_open flag after
 	we increase the write the MLOG_FILE_OPEN record to redo log. Therefore
-	we increment the in_use reference count before setting the OPEN flag. */
+	we increment the in_use reference count before setting the OPEN flag.
+	Changed holding both fil_system->mutex and the mutex of the
+	fil_system shard of the tablespace. */
 	bool		is_open;
 	/** file handle (valid if is_open) */
 	pfs_os_file_t	handle;
@@ -240,8 +255,11 @@ struct fil_node_t {
 	page_no_t	init_size;
 	/** maximum size of the file in database pages */
 	page_no_t	max_size;
-	/** count of pending i/o's; is_open must be true if nonzero */
-	ulint		n_pending;
+	/** count of pending i/o's; is_open must be true if nonzero.
+	Modified under the mutex of the fil_system shard of the tablespace,
+	which fil_io() and the i/o completion may hold without holding
+	fil_system->mutex */
+	std::atomic<ulint>	n_pending;
 	/** count of pending flushes; is_open must be true if nonzero */
 	ulint		n_pending_flushes;
 	/** e.g., when a file is being extended or just opened. */
@@ -252,7 +270,8 @@ struct fil_node_t {
 	int64_t		flush_counter;
 	/** link to other files in this tablespace */
 	UT_LIST_NODE_T(fil_node_t) chain;
-	/** link to the fil_system->LRU list (keeping track of open files) */
+	/** link to the LRU list of the fil_system shard (keeping track of
+	open files) */
 	UT_LIST_NODE_T(fil_node_t) LRU;
 
 	/** whether the file system of this file supports PUNCH HOLE */
@@ -465,9 +484,12 @@ typedef	uint16_t	page_type_t;
 #define FIL_PAGE_SDI_ZBLOB	19	/*!< Commpressed SDI BLOB page */
 #define FIL_PAGE_TYPE_ZBLOB3	20	/*!< Independently compressed LOB page*/
 #define FIL_PAGE_TYPE_RSEG_ARRAY 21	/*!< Rollback Segment Array page */
+#define FIL_PAGE_TYPE_LOB_FIRST	22	/*!< First page of an indexed LOB */
+#define FIL_PAGE_TYPE_LOB_INDEX	23	/*!< Index page of an indexed LOB */
+#define FIL_PAGE_TYPE_LOB_DATA	24	/*!< Data page of an indexed LOB */
 
 /** Used by i_s.cc to index into the text description. */
-#define FIL_PAGE_TYPE_LAST	FIL_PAGE_TYPE_RSEG_ARRAY
+#define FIL_PAGE_TYPE_LAST	FIL_PAGE_TYPE_LOB_DATA
 					/*!< Last page type */
 /* @} */
 
@@ -975,6 +997,39 @@ bool
 fil_space_extend(
 	fil_space_t*	space,
 	page_no_t	size);
+
+/** Try to extend a tablespace for a thread that needs the pages now.
+Counts the extension as a stall if the background tablespace extender
+should have done it.
+@param[in,out]	space	tablespace
+@param[in]	size	desired size in pages
+@return whether the tablespace is at least as big as requested */
+bool
+fil_space_extend_on_demand(
+	fil_space_t*	space,
+	page_no_t	size);
+
+#ifndef UNIV_HOTBACKUP
+/** Background thread that extends growing tablespaces ahead of demand,
+so that the threads that insert rows rarely have to extend a file while
+they hold the tablespace latch. */
+void
+fil_extend_ahead_thread();
+
+/** Make the background tablespace extender count as running before it
+is created, so that it is waited for at shutdown even if it has not
+started to run yet. */
+void
+fil_extend_ahead_thread_starting();
+
+/** Wake up the background tablespace extender. */
+void
+fil_extend_ahead_thread_wakeup();
+
+/** @return true if the background tablespace extender is running */
+bool
+fil_extend_ahead_thread_active();
+#endif /* !UNIV_HOTBACKUP */
 /*******************************************************************//**
 Tries to reserve free extents in a file space.
 @return true if succeed */
@@ -1035,6 +1090,16 @@ fil_aio_wait(
 /*=========*/
 	ulint	segment);	/*!< in: the number of the segment in the aio
 				array to wait for */
+
+/** Completes, in the calling thread, asynchronous page writes that the
+kernel has already finished, instead of leaving them to the i/o handler
+threads. This only does something with io_uring. The caller must not hold
+any latches.
+@param[in]	n_max	maximum number of writes to complete
+@return number of writes completed */
+ulint
+fil_aio_complete_writes(
+	ulint	n_max);
 /**********************************************************************//**
 Flushes to disk possible writes cached by the OS. If the space does not exist
 or is being dropped, does not do anything. */
@@ -148,6 +148,10 @@ extern ulong		fts_sort_pll_degree;
 call */
 extern ulong		fts_num_word_optimize;
 
+/** Variable specifying the number of threads that optimize the auxiliary
+index tables of a FULLTEXT index concurrently */
+extern ulong		fts_optimize_threads;
+
 /** Variable specifying whether we do additional FTS diagnostic printout
 in the log */
 extern bool		fts_enable_diag_print;
@@ -259,6 +259,13 @@ innobase_get_at_most_n_mbchars(
 	ulint data_len,		/*!< in: length of the string in bytes */
 	const char* str);	/*!< in: character string */
 
+/** Get the number of threads to use for scans of a clustered index.
+@param[in]	thd	thread handle, or NULL to query the global
+			innodb_parallel_read_threads
+@return value of innodb_parallel_read_threads */
+ulong
+thd_parallel_read_threads(THD* thd);
+
 /******************************************************************//**
 Returns the lock wait timeout for the current connection.
 @return the lock wait timeout, in seconds */
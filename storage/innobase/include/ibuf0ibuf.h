@@ -363,6 +363,30 @@ ulint
 ibuf_merge_in_background(
 	bool	full);
 
+/** Change buffer merge thread.  The threads share a budget of pages per
+second, which thread number 0 computes from the size of the change buffer
+and the foreground read rate.
+@param[in]	thread_no	number of the thread, from 0 */
+void
+ibuf_merge_thread(
+	size_t	thread_no);
+
+/** Count the change buffer merge threads before they are created, so
+that they are waited for at shutdown even if they have not started to
+run yet.
+@param[in]	n_threads	number of threads that will be created */
+void
+ibuf_merge_threads_starting(
+	ulint	n_threads);
+
+/** Wake up the change buffer merge threads. */
+void
+ibuf_merge_threads_wakeup();
+
+/** @return number of change buffer merge threads that are running */
+ulint
+ibuf_merge_threads_active();
+
 /** Contracts insert buffer trees by reading pages referring to space_id
 to the buffer pool.
 @returns number of pages merged.*/
@@ -375,6 +375,21 @@ btr_store_big_rec_extern_fields(
 	opcode			op)
 	MY_ATTRIBUTE((warn_unused_result));
 
+/** Remember the external field references of the record that an update
+replaces, so that the unchanged data pages of LOBs in the indexed format
+can be shared with the new version.  Nothing is done if sharing is not
+possible for the index.
+@param[in]	index		clustered index
+@param[in]	rec		record before the update
+@param[in]	offsets		rec_get_offsets(rec, index)
+@param[in,out]	big_rec_vec	fields to be stored externally */
+void
+btr_rec_copy_old_field_refs(
+	const dict_index_t*	index,
+	const rec_t*		rec,
+	const ulint*		offsets,
+	big_rec_t*		big_rec_vec);
+
 /** Copies an externally stored field of a record to mem heap.
 @param[in]	rec		record in a clustered index; must be
 				protected by a lock or a page latch
@@ -1405,13 +1420,25 @@ struct Reader
 	:
 	m_rctx(ctx),
 	m_cur_block(NULL),
-	m_copied_len(0)
+	m_copied_len(0),
+	m_skip(0),
+	m_indexed(false)
 	{}
 
 	/** Fetch the complete or prefix of the uncompressed LOB data.
 	@return bytes of LOB data fetched. */
 	ulint fetch();
 
+	/** Fetch a byte range of the uncompressed LOB data.  For a LOB in
+	the indexed format, only the pages that hold the range are read.
+	@param[in]	offset	start of the range
+	@return bytes of LOB data fetched. */
+	ulint fetch(ulint offset)
+	{
+		m_skip = offset;
+		return(fetch());
+	}
+
 	/** Fetch one BLOB page. */
 	void fetch_page();
 
@@ -1424,6 +1451,14 @@ struct Reader
 	LOB pages. This is a cumulative value.  When this value reaches
 	m_rctx.m_len, then the read operation is completed. */
 	ulint		m_copied_len;
+
+	/** Bytes of LOB data still to be skipped before the range
+	that is being fetched */
+	ulint		m_skip;
+
+	/** true if the LOB is stored in the indexed format, see
+	lob0ind.h */
+	bool		m_indexed;
 };
 
 /** The context information when the delete operation on LOB is
@@ -1543,6 +1578,12 @@ private:
 	/* Obtain an x-latch on the clustered index record page.*/
 	void x_latch_rec_page();
 
+	/** Free the data pages and the index pages of a LOB in the indexed
+	format.  Only the first page is left, for free_first_page().  For a
+	LOB in another format, nothing is done.
+	@return DB_SUCCESS on success, error code on failure. */
+	dberr_t free_indexed_pages();
+
 	bool validate_page_type(const page_t*	page) const
 	{
 		return(m_ctx.is_compressed()
@@ -1572,6 +1613,7 @@ private:
 		switch (type) {
 		case FIL_PAGE_TYPE_BLOB:
 		case FIL_PAGE_SDI_BLOB:
+		case FIL_PAGE_TYPE_LOB_FIRST:
 		break;
 		default:
 #ifndef UNIV_DEBUG /* Improve debug test coverage */
@@ -1665,6 +1707,30 @@ btr_copy_externally_stored_field_prefix_func(
 #endif /* UNIV_DEBUG */
 	ulint			local_len);
 
+/** Copies a byte range of the externally stored part of a field of a
+record.  The clustered index record must be protected by a lock or a page
+latch.  For a LOB in the indexed format, only the pages that hold the
+range are read.  The page size must not be compressed.
+@param[out]	buf		the range
+@param[in]	offset		start of the range within the externally
+stored part
+@param[in]	len		length of buf, in bytes
+@param[in]	page_size	BLOB page size
+@param[in]	data		'internally' stored part of the field
+containing also the reference to the external part; must be protected by
+a lock or a page latch
+@param[in]	local_len	length of data, in bytes
+@return the length of the copied range, less than len if the field ends
+before it, or 0 if the column was being or has been deleted */
+ulint
+btr_copy_externally_stored_field_range(
+	byte*			buf,
+	ulint			offset,
+	ulint			len,
+	const page_size_t&	page_size,
+	const byte*		data,
+	ulint			local_len);
+
 /** Copies an externally stored field of a record to mem heap.
 The clustered index record must be protected by a lock or a page latch.
 @param[out]	len		length of the whole field
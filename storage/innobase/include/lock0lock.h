@@ -44,6 +44,7 @@ Created 5/7/1996 Heikki Tuuri
 class ReadView;
 
 extern bool	innobase_deadlock_detect;
+extern bool	innobase_deadlock_detect_async;
 
 /*********************************************************************//**
 Gets the size of a lock struct.
@@ -640,7 +641,7 @@ lock_print_info_all_transactions(
 Return approximate number or record locks (bits set in the bitmap) for
 this transaction. Since delete-marked records may be removed, the
 record count will not be precise.
-The caller must be holding lock_sys->mutex. */
+The caller must be holding lock_sys->latch. */
 ulint
 lock_number_of_rows_locked(
 /*=======================*/
@@ -649,7 +650,7 @@ lock_number_of_rows_locked(
 
 /*********************************************************************//**
 Return the number of table locks for a transaction.
-The caller must be holding lock_sys->mutex. */
+The caller must be holding lock_sys->latch. */
 ulint
 lock_number_of_tables_locked(
 /*=========================*/
@@ -781,6 +782,17 @@ lock_table_has_locks(
 void
 lock_wait_timeout_thread();
 
+/** A thread which searches the wait-for graph for deadlocks in the
+background, when innodb_deadlock_detect_async is set. */
+void
+lock_deadlock_detector_thread();
+
+/** Make the deadlock detector thread count as active before it is
+created, so that it is waited for at shutdown even if it has not started
+to run yet. */
+void
+lock_deadlock_detector_thread_starting();
+
 /********************************************************************//**
 Releases a user OS thread waiting for a lock to be released, if the
 thread is already suspended. */
@@ -943,14 +955,41 @@ struct lock_op_t{
 
 typedef ib_mutex_t LockMutex;
 
-/** The lock system struct */
+/** Number of shards of the record lock queues. The queues of the pages
+in a shard are protected by the same lock_sys_t::page_mutexes element. */
+#define LOCK_SYS_N_PAGE_SHARDS	256
+
+/** A mutex protecting the record lock queues of one page shard */
+struct lock_page_mutex_t {
+	LockMutex	mutex;			/*!< The mutex */
+	char		pad[CACHE_LINE_SIZE];	/*!< Padding to keep the
+						mutexes of different shards
+						on different cache lines */
+};
+
+/** The lock system struct
+
+The locks are protected by lock_sys_t::latch. Holding it in X mode
+(lock_mutex_enter()) gives exclusive access to all the locks. Operations
+on the record lock queue of a single page may instead hold it in S mode
+together with the mutex of the page shard (lock_shard_enter()), so that
+record locks on pages in different shards can be acquired and released in
+parallel. Everything that involves more than one page, such as table
+locks, lock waits, deadlock detection and moving locks between pages,
+requires X mode. */
 struct lock_sys_t{
 	char		pad1[CACHE_LINE_SIZE];	/*!< padding to prevent other
 						memory update hotspots from
 						residing on the same memory
 						cache line */
-	LockMutex	mutex;			/*!< Mutex protecting the
-						locks */
+	rw_lock_t	latch;			/*!< Global latch protecting
+						the locks */
+	lock_page_mutex_t
+			page_mutexes[LOCK_SYS_N_PAGE_SHARDS];
+						/*!< Mutexes protecting the
+						record lock queues of the
+						pages in each shard when the
+						latch is held in S mode */
 	hash_table_t*	rec_hash;		/*!< hash table of the record
 						locks */
 	hash_table_t*	prdt_hash;		/*!< hash table of the predicate
@@ -973,7 +1012,7 @@ struct lock_sys_t{
 						/*!< TRUE if rollback of all
 						recovered transactions is
 						complete. Protected by
-						lock_sys->mutex */
+						lock_sys->latch */
 
 	ulint		n_lock_max_wait_time;	/*!< Max wait time */
 
@@ -984,6 +1023,13 @@ struct lock_sys_t{
 
 	bool		timeout_thread_active;	/*!< True if the timeout thread
 						is running */
+
+	os_event_t	deadlock_event;		/*!< Set when a lock wait is
+						suspended, to wake up the
+						deadlock detector thread */
+
+	bool		deadlock_thread_active;	/*!< True if the deadlock
+						detector thread is running */
 };
 
 /*************************************************************//**
@@ -1030,21 +1076,53 @@ lock_rec_trx_wait(
 /** The lock system */
 extern lock_sys_t*	lock_sys;
 
-/** Test if lock_sys->mutex can be acquired without waiting. */
+/** Try to acquire lock_sys->latch in X mode without waiting.
+@return 0 if the latch was acquired */
 #define lock_mutex_enter_nowait() 		\
-	(lock_sys->mutex.trylock(__FILE__, __LINE__))
+	(!rw_lock_x_lock_nowait(&lock_sys->latch))
+
+/** Test if lock_sys->latch is owned in X mode. */
+#define lock_mutex_own() (rw_lock_own(&lock_sys->latch, RW_LOCK_X))
 
-/** Test if lock_sys->mutex is owned. */
-#define lock_mutex_own() (lock_sys->mutex.is_owned())
+/** Test if lock_sys->latch is owned in S or X mode. */
+#define lock_latch_own()						\
+	(lock_mutex_own() || rw_lock_own(&lock_sys->latch, RW_LOCK_S))
 
-/** Acquire the lock_sys->mutex. */
+/** Acquire lock_sys->latch in X mode. */
 #define lock_mutex_enter() do {			\
-	mutex_enter(&lock_sys->mutex);		\
+	rw_lock_x_lock(&lock_sys->latch);	\
 } while (0)
 
-/** Release the lock_sys->mutex. */
+/** Release lock_sys->latch from X mode. */
 #define lock_mutex_exit() do {			\
-	lock_sys->mutex.exit();			\
+	rw_lock_x_unlock(&lock_sys->latch);	\
+} while (0)
+
+/** Get the mutex of the page shard of a record lock queue. The caller
+must hold lock_sys->latch, because the shard depends on the size of the
+record lock hash table. */
+#define lock_shard_mutex(space, page_no)				\
+	(&lock_sys->page_mutexes[lock_rec_hash(space, page_no)		\
+				 % LOCK_SYS_N_PAGE_SHARDS].mutex)
+
+/** Test if the record lock queue of a page is latched, either by
+lock_mutex_enter() or by lock_shard_enter(). */
+#define lock_shard_own(space, page_no)					\
+	(lock_mutex_own()						\
+	 || (rw_lock_own(&lock_sys->latch, RW_LOCK_S)			\
+	     && lock_shard_mutex(space, page_no)->is_owned()))
+
+/** Acquire lock_sys->latch in S mode and the mutex of the page shard
+of a record lock queue. */
+#define lock_shard_enter(space, page_no) do {				\
+	rw_lock_s_lock(&lock_sys->latch);				\
+	mutex_enter(lock_shard_mutex(space, page_no));			\
+} while (0)
+
+/** Release the latches acquired by lock_shard_enter(). */
+#define lock_shard_exit(space, page_no) do {				\
+	lock_shard_mutex(space, page_no)->exit();			\
+	rw_lock_s_unlock(&lock_sys->latch);				\
 } while (0)
 
 /** Test if lock_sys->wait_mutex is owned. */
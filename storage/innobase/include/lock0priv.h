@@ -106,7 +106,7 @@ operator<<(std::ostream& out, const lock_rec_t& lock)
 	return(lock.print(out));
 }
 
-/** Lock struct; protected by lock_sys->mutex */
+/** Lock struct; protected by lock_sys->latch */
 struct lock_t {
 	trx_t*		trx;		/*!< transaction owning the
 					lock */
@@ -848,7 +848,7 @@ private:
 	Setup the context from the requirements */
 	void init(const page_t* page)
 	{
-		ut_ad(lock_mutex_own());
+		ut_ad(lock_shard_own(m_rec_id.m_space_id, m_rec_id.m_page_no));
 		ut_ad(!srv_read_only_mode);
 		ut_ad(m_index->is_clustered()
 		      || !dict_index_is_online_ddl(m_index));
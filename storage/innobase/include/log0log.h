@@ -104,20 +104,42 @@ void
 log_margin_checkpoint_age(
 	ulint	len);
 
-/** Open the log for log_write_low. The log must be closed with log_close.
+/** Open the log for log_buffer_reserve. The log must be closed with
+log_close.
 @param[in]	len	length of the data to be written
 @return start lsn of the log record */
 lsn_t
 log_reserve_and_open(
 	ulint	len);
-/************************************************************//**
-Writes to the log the string given. It is assumed that the caller holds the
-log mutex. */
+
+/** Reserve space for a log record group in the log buffer. The log block
+headers of the reserved area are prepared, and log_sys->lsn and
+log_sys->buf_free are advanced past it, so that the log mutex can be
+released before the data is copied in with log_buffer_write(). The log
+buffer is not switched or moved until log_buffer_write_completed() is
+called. It is assumed that the caller holds the log mutex.
+@param[in]	len	length of the data
+@return offset of the reserved area within log_sys->buf */
+ulint
+log_buffer_reserve(
+	ulint	len);
+
+/** Copy data into an area of the log buffer that was reserved with
+log_buffer_reserve(). Does not require the log mutex.
+@param[in]	offset	offset within log_sys->buf to copy to
+@param[in]	str	data to copy
+@param[in]	len	length of the data
+@return offset within log_sys->buf following the copied data */
+ulint
+log_buffer_write(
+	ulint		offset,
+	const byte*	str,
+	ulint		len);
+
+/** Note that all data for a reservation made by log_buffer_reserve()
+has been copied to the log buffer. Does not require the log mutex. */
 void
-log_write_low(
-/*==========*/
-	const byte*	str,		/*!< in: string */
-	ulint		str_len);	/*!< in: string length */
+log_buffer_write_completed();
 /************************************************************//**
 Closes the log.
 @return lsn */
@@ -220,6 +242,32 @@ also to be flushed to disk. */
 void
 log_buffer_flush_to_disk(
 	bool sync = true);
+
+/** The log writer thread. It writes the log buffer to the log files
+whenever it is woken up by a thread waiting in log_write_up_to(), and
+at least once per second. Threads waiting for the write are woken up
+through log_sys->write_events. */
+void
+log_writer_thread();
+
+/** The log flusher thread. It flushes the written log to disk whenever
+a thread is waiting for that in log_write_up_to(), and at least once per
+second. Threads waiting for the flush are woken up through
+log_sys->flush_events. */
+void
+log_flusher_thread();
+
+/** Make the log writer and log flusher threads count as active before
+they are created, so that they are waited for at shutdown even if they
+have not started to run yet. */
+void
+log_writer_threads_starting();
+
+/** Wake up the log writer and log flusher threads so that they notice
+a shutdown.
+@return name of the log thread that is still active, or NULL */
+const char*
+log_writer_threads_active();
 /****************************************************************//**
 This functions writes the log buffer to the log file and if 'flush'
 is set it forces a flush of the log file as well. This is meant to be
@@ -436,6 +484,40 @@ log_block_init(
 	byte*	log_block,
 	lsn_t	lsn);
 
+/** Prepare the log block headers for a log record group of the given
+length which starts at the given offset of a log buffer. The data itself
+is copied in later with log_buffer_copy().
+@param[in,out]	buf		log buffer
+@param[in]	offset		start offset of the data within buf
+@param[in]	lsn		log sequence number at offset
+@param[in]	len		length of the data
+@param[in]	checkpoint_no	checkpoint number to store in full blocks
+@return number of bytes spanned in buf, including block headers
+and trailers */
+UNIV_INLINE
+ulint
+log_buffer_frame(
+	byte*		buf,
+	ulint		offset,
+	lsn_t		lsn,
+	ulint		len,
+	ib_uint64_t	checkpoint_no);
+
+/** Copy log record data into a log buffer area which has been framed
+with log_buffer_frame(), skipping the block headers and trailers.
+@param[in,out]	buf	log buffer
+@param[in]	offset	offset within buf to start copying to
+@param[in]	str	data to copy
+@param[in]	len	length of the data
+@return offset within buf following the copied data */
+UNIV_INLINE
+ulint
+log_buffer_copy(
+	byte*		buf,
+	ulint		offset,
+	const byte*	str,
+	ulint		len);
+
 #ifdef UNIV_HOTBACKUP
 /************************************************************//**
 Initializes a log block in the log buffer in the old, < 3.23.52 format, where
@@ -597,6 +679,12 @@ enum log_header_format_t
 					header */
 #define LOG_FILE_HDR_SIZE	(4 * OS_FILE_LOG_BLOCK_SIZE)
 
+/** Number of events in log_sys->write_events and log_sys->flush_events.
+Threads waiting for the log to be written or flushed up to an lsn wait on
+the event selected by the log block number of that lsn, so that they are
+only woken up when the write or flush reaches their lsn. */
+#define LOG_N_WAIT_EVENTS	1024
+
 /** The state of a log group */
 enum log_group_state_t {
 	/** No corruption detected */
@@ -683,6 +771,13 @@ struct log_t{
 					half of the aligned(buf_ptr), false
 					if the second half */
 	ulint		buf_size;	/*!< log buffer size of each in bytes */
+	volatile ulint	n_pending_copies;/*!< number of areas reserved in
+					the log buffer with log_buffer_reserve()
+					whose data has not been copied in yet;
+					incremented under the log mutex and
+					decremented atomically without it; the
+					buffer must not be written out, switched
+					or moved while this is nonzero */
 	ulint		max_buf_free;	/*!< recommended maximum value of
 					buf_free for the buffer in use, after
 					which the buffer is flushed */
@@ -734,6 +829,31 @@ struct log_t{
 					owning the log mutex, but NOTE that
 					to set this event, the
 					thread MUST own the log mutex! */
+	os_event_t	writer_event;	/*!< set to wake up the log writer
+					thread */
+	os_event_t	flusher_event;	/*!< set to wake up the log flusher
+					thread */
+	os_event_t*	write_events;	/*!< LOG_N_WAIT_EVENTS events set by the
+					log writer thread when write_lsn
+					passes the log blocks they map to */
+	os_event_t*	flush_events;	/*!< LOG_N_WAIT_EVENTS events set by the
+					log flusher thread when
+					flushed_to_disk_lsn passes the log
+					blocks they map to */
+	volatile lsn_t	write_requested_lsn;
+					/*!< highest lsn up to which a thread
+					has asked the log writer thread to
+					write the log */
+	volatile lsn_t	flush_requested_lsn;
+					/*!< highest lsn up to which a thread
+					has asked the log flusher thread to
+					flush the log */
+	volatile bool	writer_thread_active;
+					/*!< true if the log writer thread
+					is running */
+	volatile bool	flusher_thread_active;
+					/*!< true if the log flusher thread
+					is running */
 	ulint		n_log_ios;	/*!< number of log i/os initiated thus
 					far */
 	ulint		n_log_ios_old;	/*!< number of log i/o's at the
@@ -50,6 +50,8 @@ Created 10/21/1995 Heikki Tuuri
 
 #include <functional>
 #include <stack>
+#include <utility>
+#include <vector>
 
 /** File node of a tablespace or the log data space */
 struct fil_node_t;
@@ -1893,10 +1895,39 @@ be other, synchronous, pending writes. */
 void
 os_aio_wait_until_no_pending_writes();
 
-/** Wakes up simulated aio i/o-handler threads if they have something to do. */
+/** Wakes up simulated aio i/o-handler threads if they have something to do.
+With io_uring, submits the requests that were queued without waking. */
 void
 os_aio_simulated_wake_handler_threads();
 
+/** Memory areas for page i/o: start and length of each */
+typedef std::vector<std::pair<byte*, ulint> >	os_aio_buffers_t;
+
+/** Registers memory areas that hold the buffers of page i/o with the
+asynchronous i/o system, replacing any earlier registration. With io_uring
+they become the fixed buffers of the rings of the read and write arrays,
+so that the kernel does not have to map the pages of each request. The
+areas must not be freed while they are registered. Does nothing with the
+other AIO implementations.
+@param[in]	areas	the memory areas, or empty to drop the
+			registration */
+void
+os_aio_register_buffers(const os_aio_buffers_t& areas);
+
+/** Takes a completed asynchronous write without waiting, so that the
+caller can complete it instead of an i/o handler thread. This is only
+possible with io_uring, where completions are seen without a system call;
+with the other AIO implementations no write is ever returned.
+@param[out]	m1		the messages passed with the AIO request,
+@param[out]	m2		NULL if no write has completed
+@param[out]	request		OS_FILE_WRITE
+@return DB_SUCCESS or error code */
+dberr_t
+os_aio_reap_write(
+	fil_node_t**	m1,
+	void**		m2,
+	IORequest*	request);
+
 /** This function can be called if one wants to post a batch of reads and
 prefers an i/o-handler thread to handle them all at once later. You must
 call os_aio_simulated_wake_handler_threads later to ensure the threads
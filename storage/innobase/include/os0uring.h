@@ -0,0 +1,187 @@
+/*****************************************************************************
+
+Copyright (c) 2017, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/os0uring.h
+The interface to the Linux io_uring asynchronous i/o system calls
+
+The rings are driven through the system calls directly, so that no
+user space library is needed.
+*******************************************************/
+
+#ifndef os0uring_h
+#define os0uring_h
+
+#ifdef LINUX_IO_URING
+
+#include <stdint.h>
+#include <sys/uio.h>
+
+#include <linux/io_uring.h>
+
+#include "univ.i"
+
+/** A submission queue and a completion queue shared with the kernel.
+The submission queue has a single producer and the completion queue a
+single consumer: the callers must serialize prepare() and reap()
+respectively.  submit() and wait() may be called by any thread at any
+time, because the kernel takes only the requests that have been
+published by prepare(). */
+class IoUring {
+public:
+	IoUring();
+
+	~IoUring()
+	{
+		close();
+	}
+
+	/** Create the rings.
+	@param[in]	entries		size of the submission queue; the
+					completion queue is twice as large
+	@return 0 or -errno; -EOPNOTSUPP if the kernel cannot wait for
+	completions with a timeout */
+	int open(ulint entries);
+
+	/** Destroy the rings. */
+	void close();
+
+	/** @return true if the rings have been created */
+	bool is_open() const
+	{
+		return(m_fd >= 0);
+	}
+
+	/** Register fixed buffers, replacing any earlier registration.
+	@param[in]	iov	buffers, each of at most 1GiB
+	@param[in]	n	number of buffers, 0 to drop the registration
+	@return 0 or -errno */
+	int register_buffers(const struct iovec* iov, ulint n);
+
+	/** Queue a read or a write in the submission queue.  The kernel
+	will not see it before the next submit() or wait().
+	@param[in]	read		true for a read, false for a write
+	@param[in]	fd		file descriptor
+	@param[in]	buf		buffer
+	@param[in]	len		number of bytes to transfer
+	@param[in]	offset		file offset
+	@param[in]	data		returned with the completion
+	@param[in]	buf_index	index of the fixed buffer that holds
+					buf, or -1 if it is not in one
+	@return false if the submission queue is full */
+	bool prepare(
+		bool		read,
+		int		fd,
+		void*		buf,
+		ulint		len,
+		uint64_t	offset,
+		void*		data,
+		int		buf_index);
+
+	/** @return number of prepared requests that the kernel has not
+	taken yet */
+	ulint n_queued() const
+	{
+		return(__atomic_load_n(m_sq_tail, __ATOMIC_ACQUIRE)
+		       - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE));
+	}
+
+	/** Pass the prepared requests to the kernel.
+	@return number of requests submitted, or -errno */
+	int submit()
+	{
+		return(enter(n_queued(), 0, 0));
+	}
+
+	/** Pass the prepared requests to the kernel and wait until at
+	least one completion is available.
+	@param[in]	timeout_ns	maximum time to wait, in nanoseconds
+	@return number of requests submitted, or -errno; -ETIME if the
+	wait timed out */
+	int wait(uint64_t timeout_ns)
+	{
+		return(enter(n_queued(), 1, timeout_ns));
+	}
+
+	/** Take a completion from the completion queue.
+	@param[out]	data	the data passed to prepare()
+	@param[out]	res	number of bytes transferred or -errno
+	@return false if the completion queue is empty */
+	bool reap(void** data, int* res);
+
+private:
+	/** Call io_uring_enter().
+	@param[in]	to_submit	number of requests to submit
+	@param[in]	min_complete	number of completions to wait for
+	@param[in]	timeout_ns	maximum time to wait, in nanoseconds
+	@return number of requests submitted, or -errno */
+	int enter(ulint to_submit, ulint min_complete, uint64_t timeout_ns);
+
+	/** File descriptor of the rings, -1 if not open */
+	int			m_fd;
+
+	/** Mapping of the submission queue ring */
+	void*			m_sq_ring;
+
+	/** Size of m_sq_ring */
+	size_t			m_sq_ring_size;
+
+	/** Mapping of the completion queue ring; m_sq_ring if the kernel
+	maps both rings at once */
+	void*			m_cq_ring;
+
+	/** Size of m_cq_ring */
+	size_t			m_cq_ring_size;
+
+	/** Mapping of the submission queue entries */
+	struct io_uring_sqe*	m_sqes;
+
+	/** Size of m_sqes */
+	size_t			m_sqes_size;
+
+	/** Number of submission queue entries */
+	unsigned		m_sq_entries;
+
+	/** Kernel owned head of the submission queue */
+	unsigned*		m_sq_head;
+
+	/** Head of the submission queue that we own */
+	unsigned*		m_sq_tail;
+
+	/** Mask of the submission queue indexes */
+	unsigned		m_sq_mask;
+
+	/** Indexes of the submission queue entries */
+	unsigned*		m_sq_array;
+
+	/** Head of the completion queue that we own */
+	unsigned*		m_cq_head;
+
+	/** Kernel owned tail of the completion queue */
+	unsigned*		m_cq_tail;
+
+	/** Mask of the completion queue indexes */
+	unsigned		m_cq_mask;
+
+	/** Completion queue entries */
+	struct io_uring_cqe*	m_cqes;
+};
+
+#endif /* LINUX_IO_URING */
+
+#endif /* os0uring_h */
@@ -318,6 +318,11 @@ private:
 	they can be removed in purge if not needed by other views */
 	trx_id_t	m_low_limit_no;
 
+	/** Value of trx_sys_t::rw_trx_ids_version when the snapshot was
+	taken. Used to decide whether a closed view can be reopened without
+	acquiring the trx_sys_t::mutex. */
+	ulint		m_rw_trx_ids_version;
+
 	/** AC-NL-RO transaction view that has been "closed". */
 	bool		m_closed;
 
@@ -51,6 +51,14 @@ row_mysql_prebuilt_free_blob_heap(
 /*==============================*/
 	row_prebuilt_t*	prebuilt);	/*!< in: prebuilt struct of a
 					ha_innobase:: table handle */
+
+/** Frees the prefetch cache in prebuilt, checking the magic numbers
+around the cached rows.
+@param[in,out]	prebuilt	prebuilt struct of a ha_innobase table handle */
+void
+row_mysql_prebuilt_free_fetch_cache(
+	row_prebuilt_t*	prebuilt);
+
 /*******************************************************************//**
 Stores a >= 5.0.3 format true VARCHAR length to dest, in the MySQL row
 format.
@@ -612,6 +620,12 @@ struct mysql_row_templ_t {
 #define MYSQL_FETCH_CACHE_SIZE		8
 /* After fetching this many rows, we start caching them in fetch_cache */
 #define MYSQL_FETCH_CACHE_THRESHOLD	4
+/* The number of rows that a long scan caches in fetch_cache at a time
+grows up to this */
+#define MYSQL_FETCH_CACHE_MAX_SIZE	64
+/* The number of rows that a scan caches in fetch_cache at a time grows
+only while the cache stays within this many bytes */
+#define MYSQL_FETCH_CACHE_MAX_BYTES	(128 * 1024)
 
 #define ROW_PREBUILT_ALLOCATED	78540783
 #define ROW_PREBUILT_FREED	26423527
@@ -784,7 +798,7 @@ struct row_prebuilt_t {
 	ulint		n_rows_fetched;	/*!< number of rows fetched after
 					positioning the current cursor */
 	ulint		fetch_direction;/*!< ROW_SEL_NEXT or ROW_SEL_PREV */
-	byte*		fetch_cache[MYSQL_FETCH_CACHE_SIZE];
+	byte*		fetch_cache[MYSQL_FETCH_CACHE_MAX_SIZE];
 					/*!< a cache for fetched rows if we
 					fetch many rows from the same cursor:
 					it saves CPU time to fetch them in a
@@ -794,6 +808,15 @@ struct row_prebuilt_t {
 					allocated mem buf start, because
 					there is a 4 byte magic number at the
 					start and at the end */
+	ulint		fetch_cache_size;/*!< number of rows allocated in
+					fetch_cache */
+	ulint		fetch_cache_limit;/*!< number of rows to cache in
+					fetch_cache at a time in the current
+					scan; starts at MYSQL_FETCH_CACHE_SIZE
+					and doubles every time the cache is
+					filled, up to
+					MYSQL_FETCH_CACHE_MAX_SIZE rows and
+					MYSQL_FETCH_CACHE_MAX_BYTES */
 	ibool		keep_other_fields_on_keyread; /*!< when using fetch
 					cache with HA_EXTRA_KEYREAD, don't
 					overwrite other fields in mysql row
@@ -889,6 +912,14 @@ struct row_prebuilt_t {
 	/** True if exceeded the end_range while filling the prefetch cache. */
 	bool		m_end_range;
 
+	/** Number of leaf pages that the current scan has moved to */
+	ulint		m_lra_n_pages_scanned;
+
+	/** Number of leaf pages read ahead by the logical read-ahead of the
+	current scan that the scan has not moved to yet, or ULINT_UNDEFINED
+	if the read-ahead has reached the end of the index */
+	ulint		m_lra_n_pages_ahead;
+
 	/** Can a record buffer or a prefetch cache be utilized for prefetching
 	records in this scan?
 	@retval true   if records can be prefetched
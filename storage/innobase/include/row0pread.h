@@ -0,0 +1,192 @@
+/*****************************************************************************
+
+Copyright (c) 2017, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/row0pread.h
+Parallel read of a clustered index
+
+Created 2017-Nov-02
+*******************************************************/
+
+#ifndef row0pread_h
+#define row0pread_h
+
+#include "univ.i"
+#include "buf0types.h"
+#include "data0data.h"
+#include "dict0types.h"
+#include "mem0mem.h"
+#include "rem0types.h"
+#include "trx0types.h"
+#include "ut0new.h"
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+/** Reads the records of a clustered index with several threads.
+
+The index is split into key ranges at the highest B-tree level that has
+enough node pointers for the requested number of threads. The ranges are
+handed out to a pool of worker threads; each of them scans the leaf pages
+of a range with its own cursor and mini-transaction. All threads use the
+read view of the transaction that requested the scan, so the records that
+are passed to the callback are the versions visible to that transaction,
+and delete-marked records are skipped. Without a read view (READ
+UNCOMMITTED) the latest versions are read. */
+class Parallel_reader {
+public:
+	/** Maximum number of worker threads of all parallel reads */
+	static const size_t	MAX_THREADS = 256;
+
+	/** Number of ranges per thread we try to split the index into,
+	so that threads that finish early can pick up more work */
+	static const size_t	RANGES_PER_THREAD = 8;
+
+	/** A record to be processed by the callback */
+	struct Ctx {
+		/** Id of the thread, from 0 to n_threads() - 1 */
+		size_t			m_thread_id;
+
+		/** Key range that the record belongs to */
+		size_t			m_range_id;
+
+		/** true if this is the first record read from the range */
+		bool			m_first;
+
+		/** Record, or the version of it that is visible to the
+		read view */
+		const rec_t*		m_rec;
+
+		/** rec_get_offsets(m_rec, index) */
+		const ulint*		m_offsets;
+
+		/** Leaf page that contains the record, or its latest
+		version; it is latched while the callback runs */
+		const buf_block_t*	m_block;
+	};
+
+	/** Callback for each record. It is called concurrently from
+	several threads, but never from two threads with the same
+	m_thread_id at the same time.
+	@return DB_SUCCESS or an error code to stop the read */
+	typedef std::function<dberr_t(const Ctx&)>	F;
+
+	/** Constructor.
+	@param[in]	trx		transaction whose read view to use
+	@param[in]	index		clustered index to read
+	@param[in]	n_threads	number of threads requested, including
+					the calling thread */
+	Parallel_reader(
+		trx_t*		trx,
+		dict_index_t*	index,
+		size_t		n_threads);
+
+	/** Destructor. Releases the reserved threads. */
+	~Parallel_reader();
+
+	/** @return the number of threads that run the read, including
+	the calling thread */
+	size_t n_threads() const
+	{
+		return(m_n_threads);
+	}
+
+	/** Split the index into ranges and read them.
+	@param[in]	f	callback for each visible record
+	@return DB_SUCCESS or the first error encountered */
+	dberr_t run(F f);
+
+	/** Reserve worker threads from the global limit MAX_THREADS.
+	@param[in]	n	number of worker threads wanted
+	@return number of worker threads reserved, can be 0 */
+	static size_t reserve_threads(size_t n);
+
+	/** Give back worker threads that were reserved.
+	@param[in]	n	number of worker threads to release */
+	static void release_threads(size_t n);
+
+private:
+	/** Key range [m_start, m_end) of the index */
+	struct range_t {
+		/** First key of the range, NULL for the start of the index */
+		const dtuple_t*	m_start;
+
+		/** First key after the range, NULL for the end of the index */
+		const dtuple_t*	m_end;
+	};
+
+	typedef std::vector<range_t, ut_allocator<range_t> >	ranges_t;
+
+	/** Split the index into key ranges.
+	@return DB_SUCCESS or error code */
+	dberr_t split();
+
+	/** Read key ranges until there are no more of them.
+	@param[in]	thread_id	id of the thread */
+	void worker(size_t thread_id);
+
+	/** Read the records of a key range.
+	@param[in]	thread_id	id of the thread
+	@param[in]	range_id	key range to read
+	@param[in,out]	heap		memory heap for old versions
+	@return DB_SUCCESS or error code */
+	dberr_t read_range(
+		size_t		thread_id,
+		size_t		range_id,
+		mem_heap_t*	heap);
+
+	/** Remember the first error that was encountered.
+	@param[in]	err	error code */
+	void set_error(dberr_t err);
+
+	/** @return true if a thread has encountered an error */
+	bool is_error_set() const
+	{
+		return(m_err.load(std::memory_order_relaxed) != DB_SUCCESS);
+	}
+
+	/** Transaction whose read view is used */
+	trx_t*			m_trx;
+
+	/** Clustered index to read */
+	dict_index_t*		m_index;
+
+	/** Number of threads, including the calling thread */
+	size_t			m_n_threads;
+
+	/** Heap for the range keys */
+	mem_heap_t*		m_heap;
+
+	/** Key ranges of the index */
+	ranges_t		m_ranges;
+
+	/** Next key range to hand out */
+	std::atomic<size_t>	m_next_range;
+
+	/** First error encountered */
+	std::atomic<dberr_t>	m_err;
+
+	/** Callback for each record */
+	F			m_f;
+
+	/** Number of worker threads of all parallel reads */
+	static std::atomic<size_t>	s_active_threads;
+};
+
+#endif /* !row0pread_h */
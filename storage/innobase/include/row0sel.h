@@ -259,6 +259,38 @@ row_search_max_autoinc(
 	ib_uint64_t*	value)		/*!< out: AUTOINC value read */
 	MY_ATTRIBUTE((warn_unused_result));
 
+/** Convert a row in the Innobase format to a row in the MySQL format.
+Note that the template in prebuilt may advise us to copy only a few
+columns to mysql_rec, other columns are left blank. All columns may not
+be needed in the query.
+@param[out]	mysql_rec		row in the MySQL format
+@param[in]	prebuilt		prebuilt structure
+@param[in]	rec			Innobase record in the index
+					which was described in prebuilt's
+					template, or in the clustered index;
+					must be protected by a page latch
+@param[in]	vrow			virtual columns
+@param[in]	rec_clust		TRUE if rec is in the clustered index
+					instead of prebuilt->index
+@param[in]	index			index of rec
+@param[in]	offsets			array returned by rec_get_offsets(rec)
+@param[in]	clust_templ_for_sec	TRUE if rec belongs to secondary index
+					but the prebuilt->template is in
+					clustered index format and it
+					is used only for end range comparison
+@return TRUE on success, FALSE if not all columns could be retrieved */
+ibool
+row_sel_store_mysql_rec(
+	byte*			mysql_rec,
+	row_prebuilt_t*		prebuilt,
+	const rec_t*		rec,
+	const dtuple_t*		vrow,
+	ibool			rec_clust,
+	const dict_index_t*	index,
+	const ulint*		offsets,
+	bool			clust_templ_for_sec)
+	MY_ATTRIBUTE((warn_unused_result));
+
 /** A structure for caching column values for prefetched rows */
 struct sel_buf_t{
 	byte*		data;	/*!< data, or NULL; if not NULL, this field
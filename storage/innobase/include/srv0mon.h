@@ -137,6 +137,8 @@ enum monitor_id_t {
 	MONITOR_MODULE_LOCK,
 	MONITOR_DEADLOCK,
 	MONITOR_TIMEOUT,
+	MONITOR_DEADLOCK_SCAN,
+	MONITOR_DEADLOCK_STALE,
 	MONITOR_LOCKREC_WAIT,
 	MONITOR_TABLELOCK_WAIT,
 	MONITOR_NUM_RECLOCK_REQ,
@@ -161,6 +163,9 @@ enum monitor_id_t {
 	MONITOR_OVLD_BUF_POOL_WAIT_FREE,
 	MONITOR_OVLD_BUF_POOL_READ_AHEAD,
 	MONITOR_OVLD_BUF_POOL_READ_AHEAD_EVICTED,
+	MONITOR_READ_AHEAD_LOGICAL_REQUESTS,
+	MONITOR_READ_AHEAD_LOGICAL_HITS,
+	MONITOR_READ_AHEAD_LOGICAL_MISSES,
 	MONITOR_OVLD_BUF_POOL_PAGE_TOTAL,
 	MONITOR_OVLD_BUF_POOL_PAGE_MISC,
 	MONITOR_OVLD_BUF_POOL_PAGES_DATA,
@@ -205,6 +210,10 @@ enum monitor_id_t {
 	MONITOR_FLUSH_LSN_AVG_RATE,
 	MONITOR_FLUSH_PCT_FOR_DIRTY,
 	MONITOR_FLUSH_PCT_FOR_LSN,
+	MONITOR_FLUSH_OLDEST_AGE,
+	MONITOR_FLUSH_TARGET_AGE,
+	MONITOR_FLUSH_LSN_TARGET_RATE,
+	MONITOR_FLUSH_N_TO_FLUSH_MAX_INSTANCE,
 	MONITOR_FLUSH_SYNC_WAITS,
 	MONITOR_FLUSH_ADAPTIVE_TOTAL_PAGE,
 	MONITOR_FLUSH_ADAPTIVE_COUNT,
@@ -235,6 +244,9 @@ enum monitor_id_t {
 	MONITOR_LRU_UNZIP_SEARCH_SCANNED,
 	MONITOR_LRU_UNZIP_SEARCH_SCANNED_NUM_CALL,
 	MONITOR_LRU_UNZIP_SEARCH_SCANNED_PER_CALL,
+	MONITOR_LRU_ACCESS_BATCH_PAGES,
+	MONITOR_LRU_ACCESS_BATCH_NUM_CALL,
+	MONITOR_LRU_ACCESS_BATCH_PAGES_PER_CALL,
 
 	/* Buffer Page I/O specific counters. */
 	MONITOR_MODULE_BUF_PAGE,
@@ -290,6 +302,7 @@ enum monitor_id_t {
 	MONITOR_TRX_RW_COMMIT,
 	MONITOR_TRX_RO_COMMIT,
 	MONITOR_TRX_NL_RO_COMMIT,
+	MONITOR_TRX_VIEW_REUSED,
 	MONITOR_TRX_COMMIT_UNDO,
 	MONITOR_TRX_ROLLBACK,
 	MONITOR_TRX_ROLLBACK_SAVEPOINT,
@@ -306,6 +319,7 @@ enum monitor_id_t {
 	MONITOR_N_UPD_EXIST_EXTERN,
 	MONITOR_PURGE_INVOKED,
 	MONITOR_PURGE_N_PAGE_HANDLED,
+	MONITOR_PURGE_BATCH_SIZE,
 	MONITOR_DML_PURGE_DELAY,
 	MONITOR_PURGE_STOP_COUNT,
 	MONITOR_PURGE_RESUME_COUNT,
@@ -327,6 +341,9 @@ enum monitor_id_t {
 	MONITOR_OVLD_LOG_WRITE_REQUEST,
 	MONITOR_OVLD_LOG_WRITES,
 	MONITOR_OVLD_LOG_PADDED,
+	MONITOR_LOG_ON_WRITE_WAITS,
+	MONITOR_LOG_ON_FLUSH_WAITS,
+	MONITOR_LOG_LSN_WAIT_TIME,
 
 	/* Page Manager related counters */
 	MONITOR_MODULE_PAGE,
@@ -343,6 +360,8 @@ enum monitor_id_t {
 	MONITOR_INDEX_REORG_ATTEMPTS,
 	MONITOR_INDEX_REORG_SUCCESSFUL,
 	MONITOR_INDEX_DISCARD,
+	MONITOR_LOB_PAGES_WRITTEN,
+	MONITOR_LOB_PAGES_SHARED,
 
 	/* Adaptive Hash Index related counters */
 	MONITOR_MODULE_ADAPTIVE_HASH,
@@ -354,10 +373,17 @@ enum monitor_id_t {
 	MONITOR_ADAPTIVE_HASH_ROW_REMOVED,
 	MONITOR_ADAPTIVE_HASH_ROW_REMOVE_NOT_FOUND,
 	MONITOR_ADAPTIVE_HASH_ROW_UPDATED,
+	MONITOR_ADAPTIVE_HASH_INDEX_OFF,
+	MONITOR_ADAPTIVE_HASH_INDEX_ON,
+	MONITOR_ADAPTIVE_HASH_PAGE_QUEUED,
 
 	/* Tablespace related counters */
 	MONITOR_MODULE_FIL_SYSTEM,
 	MONITOR_OVLD_N_FILE_OPENED,
+	MONITOR_FIL_EXTEND_STALLS,
+	MONITOR_FIL_EXTEND_STALL_TIME,
+	MONITOR_FIL_EXTEND_AHEAD,
+	MONITOR_FIL_EXTEND_AHEAD_PAGES,
 
 	/* InnoDB Change Buffer related counters */
 	MONITOR_MODULE_IBUF_SYSTEM,
@@ -419,6 +445,13 @@ enum monitor_id_t {
 	MONITOR_ICP_OUT_OF_RANGE,
 	MONITOR_ICP_MATCH,
 
+	/* Full text search related counters */
+	MONITOR_MODULE_FTS,
+	MONITOR_FTS_OPTIMIZE_WORDS,
+	MONITOR_FTS_OPTIMIZE_PARALLEL_TASKS,
+	MONITOR_FTS_SYNC_NODES,
+	MONITOR_FTS_SYNC_BATCHES,
+
 	/* Mutex/RW-Lock related counters */
 	MONITOR_MODULE_LATCHES,
 	MONITOR_LATCHES,
@@ -161,6 +161,9 @@ and/or load it during startup. */
 extern bool		srv_buffer_pool_dump_at_shutdown;
 extern bool		srv_buffer_pool_load_at_startup;
 
+/** Number of threads that read pages during a buffer pool load */
+extern ulong		srv_buf_load_threads;
+
 /* Whether to disable file system cache if it is defined */
 extern bool		srv_disable_sort_file_cache;
 
@@ -201,6 +204,9 @@ extern bool high_level_read_only;
 /** store to its own file each table created by an user; data
 dictionary tables are in the system tablespace 0 */
 extern bool	srv_file_per_table;
+/** Store new uncompressed LOBs in the indexed format, which supports
+random access and partial updates */
+extern bool	srv_indexed_lob;
 /** Sleep delay for threads waiting to enter InnoDB. In micro-seconds. */
 extern	ulong	srv_thread_sleep_delay;
 /** Maximum sleep delay (in micro-seconds), value of 0 disables it.*/
@@ -217,6 +223,9 @@ OS (provided we compiled Innobase with it in), otherwise we will
 use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 extern bool	srv_use_native_aio;
+/** If this flag is true and native aio is used, then we use io_uring
+instead of libaio on Linux (provided we compiled Innobase with it in) */
+extern bool	srv_use_io_uring;
 extern bool	srv_numa_interleave;
 #endif /* !UNIV_HOTBACKUP */
 
@@ -272,6 +281,12 @@ extern ulong	srv_log_buffer_size;
 extern ulong	srv_flush_log_at_trx_commit;
 extern uint	srv_flush_log_at_timeout;
 extern ulong	srv_log_write_ahead_size;
+/** If true, redo log writes and flushes requested by user threads are
+done by the log writer and log flusher threads (innodb_log_writer_threads) */
+extern bool	srv_log_writer_threads;
+/** Number of spin rounds before a thread waiting for the log writer or
+log flusher thread goes to sleep (innodb_log_wait_for_flush_spin_rounds) */
+extern ulong	srv_log_wait_for_flush_spin_rounds;
 extern bool	srv_adaptive_flushing;
 extern bool	srv_flush_sync;
 
@@ -297,6 +312,9 @@ extern const ulong	srv_buf_pool_instances_default;
 extern ulong	srv_n_page_hash_locks;
 /** Scan depth for LRU flush batch i.e.: number of blocks scanned*/
 extern ulong	srv_LRU_scan_depth;
+/** Number of page accesses that a thread buffers before moving the
+pages to the start of the LRU list; 1 moves them immediately */
+extern ulong	srv_LRU_access_batch;
 /** Whether or not to flush neighbors of a block */
 extern ulong	srv_flush_neighbors;
 /** Previously requested size. Accesses protected by memory barriers. */
@@ -313,11 +331,22 @@ extern ulint	srv_lock_table_size;
 extern ulint	srv_n_file_io_threads;
 extern bool	srv_random_read_ahead;
 extern ulong	srv_read_ahead_threshold;
+/** Maximum number of leaf pages that an index range scan reads ahead
+from the node pointers of the level above the leaves; 0 disables */
+extern ulong	srv_logical_read_ahead_pages;
+/** Maximum size in megabytes that the background tablespace extender
+keeps allocated ahead of demand in each growing tablespace; 0 disables */
+extern ulong	srv_extend_ahead_max_size;
 extern ulong	srv_n_read_io_threads;
 extern ulong	srv_n_write_io_threads;
+extern ulong	srv_n_recv_apply_threads;
 
 extern uint	srv_change_buffer_max_size;
 
+/** Number of change buffer merge threads, 0 if the master thread merges
+the change buffer */
+extern ulong	srv_n_ibuf_merge_threads;
+
 /* Number of IO operations per second the server can do */
 extern ulong    srv_io_capacity;
 
@@ -334,6 +363,9 @@ is 5% of the max where max is srv_io_capacity.  */
 /** Maximum number of purge threads, including the purge coordinator */
 #define MAX_PURGE_THREADS	32
 
+/** Maximum value of innodb_purge_batch_size */
+#define MAX_PURGE_BATCH_SIZE	5000
+
 /* The "innodb_stats_method" setting, decides how InnoDB is going
 to treat NULL value when collecting statistics. It is not defined
 as enum type because the configure option takes unsigned integer type. */
@@ -373,10 +405,12 @@ extern unsigned long long	srv_stats_transient_sample_pages;
 extern bool			srv_stats_persistent;
 extern unsigned long long	srv_stats_persistent_sample_pages;
 extern bool			srv_stats_auto_recalc;
+extern unsigned long long	srv_stats_auto_recalc_page_budget;
 extern bool			srv_stats_include_delete_marked;
 
 extern ibool	srv_use_doublewrite_buf;
 extern ulong	srv_doublewrite_batch_size;
+extern ulong	srv_doublewrite_files;
 extern ulong	srv_checksum_algorithm;
 
 extern double	srv_max_buf_pool_modified_pct;
@@ -457,21 +491,32 @@ extern srv_stats_t	srv_stats;
 /* Keys to register InnoDB threads with performance schema */
 
 # ifdef UNIV_PFS_THREAD
+extern mysql_pfs_key_t	btr_search_build_thread_key;
 extern mysql_pfs_key_t	buf_dump_thread_key;
+extern mysql_pfs_key_t	buf_load_thread_key;
 extern mysql_pfs_key_t	buf_resize_thread_key;
 extern mysql_pfs_key_t	dict_stats_thread_key;
+extern mysql_pfs_key_t	fil_extend_ahead_thread_key;
 extern mysql_pfs_key_t	fts_optimize_thread_key;
 extern mysql_pfs_key_t	fts_parallel_merge_thread_key;
+extern mysql_pfs_key_t	fts_parallel_optimize_thread_key;
 extern mysql_pfs_key_t	fts_parallel_tokenization_thread_key;
+extern mysql_pfs_key_t	ibuf_merge_thread_key;
 extern mysql_pfs_key_t	io_handler_thread_key;
 extern mysql_pfs_key_t	io_ibuf_thread_key;
 extern mysql_pfs_key_t	io_log_thread_key;
 extern mysql_pfs_key_t	io_read_thread_key;
 extern mysql_pfs_key_t	io_write_thread_key;
+extern mysql_pfs_key_t	log_flusher_thread_key;
+extern mysql_pfs_key_t	log_writer_thread_key;
 extern mysql_pfs_key_t	page_flush_coordinator_thread_key;
 extern mysql_pfs_key_t	page_flush_thread_key;
+extern mysql_pfs_key_t	parallel_read_thread_key;
 extern mysql_pfs_key_t	recv_writer_thread_key;
+extern mysql_pfs_key_t	recv_apply_thread_key;
+extern mysql_pfs_key_t	row_merge_thread_key;
 extern mysql_pfs_key_t	srv_error_monitor_thread_key;
+extern mysql_pfs_key_t	srv_lock_deadlock_thread_key;
 extern mysql_pfs_key_t	srv_lock_timeout_thread_key;
 extern mysql_pfs_key_t	srv_master_thread_key;
 extern mysql_pfs_key_t	srv_monitor_thread_key;
@@ -890,6 +935,7 @@ struct srv_slot_t{
 #else /* !UNIV_HOTBACKUP */
 # define srv_use_adaptive_hash_indexes		FALSE
 # define srv_use_native_aio			FALSE
+# define srv_use_io_uring			false
 # define srv_numa_interleave			FALSE
 # define srv_force_recovery			0UL
 # define srv_set_io_thread_op_info(t,info)	((void) 0)
@@ -168,7 +168,11 @@ V
 lock_sys_wait_mutex			Mutex protecting lock timeout data
 |
 V
-lock_sys_mutex				Mutex protecting lock_sys_t
+lock_sys_latch				RW-latch protecting lock_sys_t
+|
+V
+lock_sys_page_mutex			Mutex protecting the record lock
+|					queues of a page shard
 |
 V
 trx_sys->mutex				Mutex protecting trx_sys_t
@@ -194,6 +198,12 @@ Log mutex
 Any other latch
 |
 V
+btr_search_build_queue_t::mutex		Mutex protecting a queue of the
+|					adaptive hash index build thread
+V
+fil_shard_t::mutex			Mutex protecting a shard of the
+|					tablespace memory cache
+V
 Memory pool mutex */
 
 /** Latching order levels. If you modify these, you have to also update
@@ -214,6 +224,10 @@ enum latch_level_t {
 
 	SYNC_MONITOR_MUTEX,
 
+	SYNC_FIL_SHARD,
+
+	SYNC_AHI_BUILD_QUEUE,
+
 	SYNC_ANY_LATCH,
 
 	SYNC_DOUBLEWRITE,
@@ -250,6 +264,7 @@ enum latch_level_t {
 	SYNC_THREADS,
 	SYNC_TRX,
 	SYNC_TRX_SYS,
+	SYNC_LOCK_SYS_SHARDED,
 	SYNC_LOCK_SYS,
 	SYNC_LOCK_WAIT_SYS,
 
@@ -320,6 +335,7 @@ up its meta-data. See sync0debug.c. */
 enum latch_id_t {
 	LATCH_ID_NONE = 0,
 	LATCH_ID_AUTOINC,
+	LATCH_ID_AHI_BUILD_QUEUE,
 	LATCH_ID_BUF_BLOCK_MUTEX,
 	LATCH_ID_BUF_POOL_ZIP,
 	LATCH_ID_BUF_POOL_LRU_LIST,
@@ -331,6 +347,7 @@ enum latch_id_t {
 	LATCH_ID_DICT_FOREIGN_ERR,
 	LATCH_ID_DICT_SYS,
 	LATCH_ID_FIL_SYSTEM,
+	LATCH_ID_FIL_SHARD,
 	LATCH_ID_FLUSH_LIST,
 	LATCH_ID_FTS_BG_THREADS,
 	LATCH_ID_FTS_DELETE,
@@ -351,6 +368,7 @@ enum latch_id_t {
 	LATCH_ID_DICT_PERSIST_CHECKPOINT,
 	LATCH_ID_PAGE_CLEANER,
 	LATCH_ID_PURGE_SYS_PQ,
+	LATCH_ID_PURGE_TABLE_STATS,
 	LATCH_ID_RECALC_POOL,
 	LATCH_ID_RECV_SYS,
 	LATCH_ID_RECV_WRITER,
@@ -375,6 +393,7 @@ enum latch_id_t {
 	LATCH_ID_TRX_POOL_MANAGER,
 	LATCH_ID_TRX,
 	LATCH_ID_LOCK_SYS,
+	LATCH_ID_LOCK_SYS_PAGE,
 	LATCH_ID_LOCK_SYS_WAIT,
 	LATCH_ID_TRX_SYS,
 	LATCH_ID_SRV_SYS,
@@ -391,6 +410,7 @@ enum latch_id_t {
 	LATCH_ID_OS_AIO_IBUF_MUTEX,
 	LATCH_ID_OS_AIO_SYNC_MUTEX,
 	LATCH_ID_ROW_DROP_LIST,
+	LATCH_ID_ALTER_STAGE,
 	LATCH_ID_INDEX_ONLINE_LOG,
 	LATCH_ID_WORK_QUEUE,
 	LATCH_ID_BTR_SEARCH,
@@ -35,6 +35,10 @@ Created 3/26/1996 Heikki Tuuri
 #include "usr0sess.h"
 #include "fil0fil.h"
 #include "read0types.h"
+#include "ut0new.h"
+
+#include <map>
+#include <vector>
 
 /** The global data structure coordinating a purge */
 extern trx_purge_t*	purge_sys;
@@ -115,9 +119,48 @@ purge_state_t
 trx_purge_state(void);
 /*=================*/
 
+/** Purge statistics of a table, for
+INFORMATION_SCHEMA.INNODB_PURGE_TABLE_STATS */
+struct purge_table_stats_t {
+	/** Table id */
+	table_id_t	table_id;
+
+	/** Number of undo records of the table that were purged */
+	ulint		n_recs;
+
+	/** Number of purge batches that contained records of the table */
+	ulint		n_batches;
+
+	/** Number of undo records of the table in the last batch that
+	contained any */
+	ulint		last_batch_recs;
+
+	/** Number of the oldest transaction whose undo records of the
+	table were purged in that batch */
+	trx_id_t	last_trx_no;
+
+	/** Number of transactions that had been started after that
+	transaction, when the batch was run */
+	trx_id_t	lag;
+};
+
+typedef std::vector<purge_table_stats_t, ut_allocator<purge_table_stats_t> >
+	purge_table_stats_list_t;
+
+/** Get a copy of the purge statistics of the tables.
+@param[out]	stats	statistics of the tables that purge has seen */
+void
+trx_purge_get_table_stats(
+	purge_table_stats_list_t&	stats);
+
 // Forward declaration
 struct TrxUndoRsegsIterator;
 
+typedef std::map<
+	table_id_t, purge_table_stats_t, std::less<table_id_t>,
+	ut_allocator<std::pair<const table_id_t, purge_table_stats_t> > >
+	purge_table_stats_map_t;
+
 /** This is the purge pointer/iterator. We need both the undo no and the
 transaction no up to which purge has parsed and applied the records. */
 struct purge_iter_t {
@@ -722,6 +765,13 @@ struct trx_purge_t{
 
 	mem_heap_t*	heap;		/*!< Heap for reading the undo log
 					records */
+
+	ib_mutex_t	table_stats_mutex;
+					/*!< Mutex protecting table_stats */
+
+	purge_table_stats_map_t*
+			table_stats;	/*!< Purge statistics of the tables,
+					by table id */
 };
 
 /** Choose the rollback segment with the smallest trx_no. */
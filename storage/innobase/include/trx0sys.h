@@ -168,6 +168,12 @@ trx_id_t
 trx_sys_get_max_trx_id(void);
 /*========================*/
 
+/** Determine the version of the rw_trx_ids array.
+@return value of trx_sys_t::rw_trx_ids_version; may be stale */
+UNIV_INLINE
+ulint
+trx_sys_get_rw_trx_ids_version();
+
 #ifdef UNIV_DEBUG
 /* Flag to control TRX_RSEG_N_SLOTS behavior debugging. */
 extern uint			trx_rseg_n_slots_debug;
@@ -509,6 +515,15 @@ struct trx_sys_t {
 					to ensure right order of removal and
 					consistent snapshot. */
 
+	volatile ulint	rw_trx_ids_version;
+					/*!< Incremented whenever a transaction
+					is removed from rw_trx_ids. Together
+					with max_trx_id, which changes when a
+					transaction is added, this tells
+					whether a ReadView snapshot is still
+					current. Modified under the mutex,
+					read without it. */
+
 	char		pad3[64];	/*!< To avoid false sharing */
 
 	Rsegs		rsegs;		/*!< Vector of pointers to rollback
@@ -54,8 +54,16 @@ extern ut_crc32_func_t	ut_crc32_legacy_big_endian;
 but very slow). */
 extern ut_crc32_func_t	ut_crc32_byte_by_byte;
 
+/** Pointer to the software CRC32 calculation function, which does not use
+CPU instructions. */
+extern ut_crc32_func_t	ut_crc32_sw_func;
+
 /** Flag that tells whether the CPU supports CRC32 or not.
-The CRC32 instructions are part of the SSE4.2 instruction set. */
+The CRC32 instructions are part of the SSE4.2 instruction set on x86_64
+and an optional extension of ARMv8.0. */
 extern bool		ut_crc32_cpu_enabled;
 
+/** Name of the implementation that ut_crc32() uses. */
+extern const char*	ut_crc32_implementation;
+
 #endif /* ut0crc32_h */
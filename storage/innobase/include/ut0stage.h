@@ -34,6 +34,7 @@ Created Nov 12, 2014 Vasil Dimov
 #include "row0log.h" /* row_log_estimate_work() */
 #include "srv0srv.h" /* ut_stage_alter_t */
 #include "univ.i"
+#include "ut0mutex.h"
 
 #ifdef HAVE_PSI_STAGE_INTERFACE
 
@@ -66,7 +67,14 @@ begin_phase_end()
 destructor
 
 This class knows the specifics of each phase and tries to increment the
-progress in an even manner across the entire ALTER TABLE lifetime. */
+progress in an even manner across the entire ALTER TABLE lifetime.
+
+n_pk_recs_inc() and inc() may be called concurrently from several threads,
+for example by the threads of a parallel scan or sort. The phase changes
+are only done by the thread that runs the ALTER TABLE; a phase change to
+the current phase is ignored, so that the threads of a parallel sort or
+insert can call begin_phase_sort() and begin_phase_insert() after the
+ALTER TABLE thread has started the phase on their behalf. */
 class ut_stage_alter_t {
 public:
 	/** Constructor.
@@ -83,6 +91,7 @@ public:
 		m_n_flush_pages(0),
 		m_cur_phase(NOT_STARTED)
 	{
+		mutex_create(LATCH_ID_ALTER_STAGE, &m_mutex);
 	}
 
 	/** Destructor. */
@@ -95,13 +104,15 @@ public:
 	begin_phase_read_pk(
 		ulint	n_sort_indexes);
 
-	/** Increment the number of records in PK (table) with 1.
+	/** Increment the number of records in PK (table).
 	This is used to get more accurate estimate about the number of
 	records per page which is needed because some phases work on
 	per-page basis while some work on per-record basis and we want
-	to get the progress as even as possible. */
+	to get the progress as even as possible.
+	@param[in]	n	number of records read */
 	void
-	n_pk_recs_inc();
+	n_pk_recs_inc(
+		ulint	n = 1);
 
 	/** Flag either one record or one page processed, depending on the
 	current phase.
@@ -159,6 +170,9 @@ private:
 	change_phase(
 		const PSI_stage_info*	new_stage);
 
+	/** Protects the counters against concurrent inc() calls */
+	ib_mutex_t		m_mutex;
+
 	/** Performance schema accounting object. */
 	PSI_stage_progress*	m_progress;
 
@@ -208,6 +222,8 @@ private:
 inline
 ut_stage_alter_t::~ut_stage_alter_t()
 {
+	mutex_free(&m_mutex);
+
 	if (m_progress == NULL) {
 		return;
 	}
@@ -240,16 +256,20 @@ ut_stage_alter_t::begin_phase_read_pk(
 	reestimate();
 }
 
-/** Increment the number of records in PK (table) with 1.
+/** Increment the number of records in PK (table).
 This is used to get more accurate estimate about the number of
 records per page which is needed because some phases work on
 per-page basis while some work on per-record basis and we want
-to get the progress as even as possible. */
+to get the progress as even as possible.
+@param[in]	n	number of records read */
 inline
 void
-ut_stage_alter_t::n_pk_recs_inc()
+ut_stage_alter_t::n_pk_recs_inc(
+	ulint	n /* = 1 */)
 {
-	m_n_pk_recs++;
+	mutex_enter(&m_mutex);
+	m_n_pk_recs += n;
+	mutex_exit(&m_mutex);
 }
 
 /** Flag either one record or one page processed, depending on the
@@ -264,6 +284,8 @@ ut_stage_alter_t::inc(
 		return;
 	}
 
+	mutex_enter(&m_mutex);
+
 	ulint	multi_factor = 1;
 	bool	should_proceed = true;
 
@@ -319,6 +341,8 @@ ut_stage_alter_t::inc(
 		mysql_stage_inc_work_completed(m_progress, inc_val);
 		reestimate();
 	}
+
+	mutex_exit(&m_mutex);
 }
 
 /** Flag the end of reading of the primary key.
@@ -351,6 +375,11 @@ void
 ut_stage_alter_t::begin_phase_sort(
 	double	sort_multi_factor)
 {
+	if (m_progress == NULL || m_cur_phase == SORT) {
+		/* Started by the ALTER TABLE thread for a parallel sort */
+		return;
+	}
+
 	if (sort_multi_factor <= 1.0) {
 		m_sort_multi_factor = 1;
 	} else {
@@ -366,6 +395,11 @@ inline
 void
 ut_stage_alter_t::begin_phase_insert()
 {
+	if (m_cur_phase == INSERT) {
+		/* Started by the ALTER TABLE thread for a parallel insert */
+		return;
+	}
+
 	change_phase(&srv_stage_alter_table_insert);
 }
 
@@ -490,6 +524,8 @@ ut_stage_alter_t::change_phase(
 		ut_error;
 	}
 
+	mutex_enter(&m_mutex);
+
 	const ulonglong	c = mysql_stage_get_work_completed(m_progress);
 	const ulonglong	e = mysql_stage_get_work_estimated(m_progress);
 
@@ -497,6 +533,8 @@ ut_stage_alter_t::change_phase(
 
 	mysql_stage_set_work_completed(m_progress, c);
 	mysql_stage_set_work_estimated(m_progress, e);
+
+	mutex_exit(&m_mutex);
 }
 #else /* HAVE_PSI_STAGE_INTERFACE */
 
@@ -515,7 +553,8 @@ public:
 	}
 
 	void
-	n_pk_recs_inc()
+	n_pk_recs_inc(
+		ulint	n = 1)
 	{
 	}
 
@@ -38,6 +38,24 @@ IF(UNIX)
       LINK_LIBRARIES(aio)
     ENDIF()
 
+    # io_uring is used through the system calls; waiting for completions
+    # with a timeout needs IORING_FEAT_EXT_ARG (Linux 5.11).
+    CHECK_C_SOURCE_COMPILES(
+    "
+    #include <sys/syscall.h>
+    #include <linux/io_uring.h>
+    int main()
+    {
+      struct io_uring_getevents_arg arg;
+      return(IORING_FEAT_EXT_ARG + IORING_OP_READ_FIXED
+             + __NR_io_uring_enter + (int) sizeof(arg));
+    }"
+    HAVE_IO_URING)
+
+    IF(HAVE_IO_URING)
+      ADD_DEFINITIONS(-DLINUX_IO_URING=1)
+    ENDIF()
+
   ELSEIF(CMAKE_SYSTEM_NAME STREQUAL "SunOS")
     ADD_DEFINITIONS("-DUNIV_SOLARIS")
   ENDIF()
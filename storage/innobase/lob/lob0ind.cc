@@ -0,0 +1,630 @@
+/*****************************************************************************
+
+Copyright (c) 2017, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+#include "btr0btr.h"
+#include "lob0ind.h"
+#include "lob0lob.h"
+#include "srv0mon.h"
+#include "srv0srv.h"
+
+namespace lob {
+
+/** Latch a directory page of the LOB.
+@param[in]	page_no		first page or index page of the LOB
+@param[in]	rw_latch	RW_S_LATCH or RW_X_LATCH
+@param[in,out]	mtr		mini-transaction
+@return the latched block */
+buf_block_t*
+DirCursor::get_block(
+	page_no_t	page_no,
+	ulint		rw_latch,
+	mtr_t*		mtr) const
+{
+	buf_block_t*	block = buf_page_get(
+		page_id_t(m_space_id, page_no), m_page_size, rw_latch, mtr);
+
+	buf_block_dbg_add_level(block, SYNC_EXTERN_STORAGE);
+
+	ut_a(fil_page_get_type(block->frame)
+	     == (page_no == m_first_page_no
+		 ? FIL_PAGE_TYPE_LOB_FIRST : FIL_PAGE_TYPE_LOB_INDEX));
+
+	return(block);
+}
+
+/** Latch the directory page that holds an entry.
+@param[in]	n		entry number
+@param[in]	rw_latch	RW_S_LATCH or RW_X_LATCH
+@param[in,out]	mtr		mini-transaction
+@return the entry */
+byte*
+DirCursor::entry(
+	ulint		n,
+	ulint		rw_latch,
+	mtr_t*		mtr)
+{
+	ut_ad(m_first_page_no != FIL_NULL);
+
+	if (n < m_base) {
+		m_page_no = m_first_page_no;
+		m_base = 0;
+	}
+
+	for (;;) {
+		const bool	is_first = (m_page_no == m_first_page_no);
+		const ulint	capacity = is_first
+			? first_capacity(m_page_size)
+			: index_capacity(m_page_size);
+
+		buf_block_t*	block = get_block(m_page_no, rw_latch, mtr);
+
+		if (n < m_base + capacity) {
+			const ulint	hdr_size = is_first
+				? LOB_FIRST_HDR_SIZE : LOB_INDEX_HDR_SIZE;
+
+			return(block->frame + FIL_PAGE_DATA + hdr_size
+			       + (n - m_base) * LOB_ENTRY_SIZE);
+		}
+
+		const page_no_t	next = mach_read_from_4(
+			block->frame + FIL_PAGE_DATA + LOB_DIR_NEXT);
+
+		ut_a(next != FIL_NULL);
+
+		m_page_no = next;
+		m_base += capacity;
+	}
+}
+
+/** Constructor.
+@param[in]	ctx	blob operation context. */
+IndexInserter::IndexInserter(InsertContext* ctx)
+	:
+	BaseInserter(ctx),
+	m_dir(ctx->space(), ctx->page_size(), FIL_NULL),
+	m_dir_capacity(0),
+	m_dir_last_page_no(FIL_NULL),
+	m_old_dir(ctx->space(), ctx->page_size(), FIL_NULL),
+	m_old_n_entries(0)
+{}
+
+/** Check whether a field is stored in the indexed format.
+@param[in]	ctx	blob operation context.
+@param[in]	field	the big record field.
+@return true if IndexInserter must write the field. */
+bool
+IndexInserter::is_used(
+	InsertContext*		ctx,
+	const big_rec_field_t&	field)
+{
+	/* A LOB that fits on one page gains nothing from the directory. */
+	return(srv_indexed_lob
+	       && !dict_index_is_sdi(ctx->index())
+	       && !ctx->page_size().is_compressed()
+	       && field.len > index_chunk_size(ctx->page_size()));
+}
+
+/** Write one blob field data.  If the field has a previous version
+in the indexed format, the data pages that did not change are shared
+with it.
+@param[in]	field	the big record field.
+@return DB_SUCCESS on success, error code on failure. */
+dberr_t
+IndexInserter::write_one_blob(big_rec_field_t& field)
+{
+	const ulint	chunk_size = index_chunk_size(m_ctx->page_size());
+	const ulint	n_chunks = (field.len + chunk_size - 1) / chunk_size;
+
+	m_ctx->check_redolog();
+
+	write_first_page(field);
+
+	for (ulint n = 0; is_ok() && n < n_chunks; ++n) {
+
+		const ulint	commit_freq = 4;
+
+		if (n > 0 && n % commit_freq == 0) {
+			m_ctx->check_redolog();
+		}
+
+		write_chunk(field, n);
+	}
+
+	m_ctx->make_nth_extern(field.field_no);
+
+	return(m_status);
+}
+
+/** Allocate the first page, find the previous version of the
+field and point the blob reference to the first page.
+@param[in]	field	the big record field. */
+void
+IndexInserter::write_first_page(big_rec_field_t& field)
+{
+	buf_block_t*	rec_block	= m_ctx->block();
+	mtr_t*		mtr		= start_blob_mtr();
+
+	buf_page_get(rec_block->page.id,
+		     rec_block->page.size, RW_X_LATCH, mtr);
+
+	page_no_t	old_page_no = FIL_NULL;
+
+	if (field.old_ref != NULL) {
+		const ref_t	old_ref(const_cast<byte*>(field.old_ref));
+
+		if (!old_ref.is_null()
+		    && old_ref.is_owner()
+		    && old_ref.length() > 0
+		    && old_ref.space_id() == m_ctx->space()
+		    && old_ref.offset() == FIL_PAGE_DATA) {
+
+			buf_block_t*	old_block = buf_page_get(
+				page_id_t(m_ctx->space(), old_ref.page_no()),
+				m_ctx->page_size(), RW_S_LATCH, mtr);
+
+			buf_block_dbg_add_level(old_block,
+						SYNC_EXTERN_STORAGE);
+
+			if (fil_page_get_type(old_block->frame)
+			    == FIL_PAGE_TYPE_LOB_FIRST) {
+
+				old_page_no = old_ref.page_no();
+				m_old_n_entries = mach_read_from_4(
+					old_block->frame + FIL_PAGE_DATA
+					+ LOB_FIRST_N_ENTRIES);
+				m_old_dir.open(old_page_no);
+			}
+		}
+	}
+
+	if (alloc_blob_page() == NULL) {
+		if (mtr->is_active()) {
+			mtr->commit();
+		}
+		return;
+	}
+
+	if (dict_index_is_online_ddl(m_ctx->index())) {
+		row_log_table_blob_alloc(m_ctx->index(),
+					 m_cur_blob_page_no);
+	}
+
+	page_t*	page = cur_page();
+
+	mlog_write_ulint(page + FIL_PAGE_TYPE, FIL_PAGE_TYPE_LOB_FIRST,
+			 MLOG_2BYTES, mtr);
+	mlog_write_ulint(page + FIL_PAGE_DATA + LOB_DIR_NEXT,
+			 FIL_NULL, MLOG_4BYTES, mtr);
+	mlog_write_ulint(page + FIL_PAGE_DATA + LOB_FIRST_DATA_LEN,
+			 0, MLOG_4BYTES, mtr);
+	mlog_write_ulint(page + FIL_PAGE_DATA + LOB_FIRST_N_ENTRIES,
+			 0, MLOG_4BYTES, mtr);
+	mlog_write_ulint(page + FIL_PAGE_DATA + LOB_FIRST_PREV_VERSION,
+			 old_page_no, MLOG_4BYTES, mtr);
+
+	m_dir.open(m_cur_blob_page_no);
+	m_dir_capacity = DirCursor::first_capacity(m_ctx->page_size());
+	m_dir_last_page_no = m_cur_blob_page_no;
+
+	byte*	field_ref = btr_rec_get_field_ref(
+		m_ctx->rec(), m_ctx->get_offsets(), field.field_no);
+	ref_t	blobref(field_ref);
+
+	blobref.set_length(0, mtr);
+	blobref.update(m_ctx->space(), m_cur_blob_page_no,
+		       FIL_PAGE_DATA, mtr);
+
+	m_prev_page_no = m_cur_blob_page_no;
+
+	mtr->commit();
+}
+
+/** Latch the directory entry of a new chunk, adding an index page
+to the directory if it is full.
+@param[in]	n	chunk number
+@return the entry, or NULL if out of file space */
+byte*
+IndexInserter::new_entry(ulint n)
+{
+	ut_ad(n <= m_dir_capacity);
+
+	if (n == m_dir_capacity) {
+		buf_block_t*	last = m_dir.get_block(
+			m_dir_last_page_no, RW_X_LATCH, &m_blob_mtr);
+
+		if (alloc_blob_page() == NULL) {
+			return(NULL);
+		}
+
+		page_t*	page = cur_page();
+
+		mlog_write_ulint(page + FIL_PAGE_TYPE, FIL_PAGE_TYPE_LOB_INDEX,
+				 MLOG_2BYTES, &m_blob_mtr);
+		mlog_write_ulint(page + FIL_PAGE_DATA + LOB_DIR_NEXT,
+				 FIL_NULL, MLOG_4BYTES, &m_blob_mtr);
+		mlog_write_ulint(last->frame + FIL_PAGE_DATA + LOB_DIR_NEXT,
+				 m_cur_blob_page_no, MLOG_4BYTES, &m_blob_mtr);
+
+		m_dir_capacity += DirCursor::index_capacity(
+			m_ctx->page_size());
+		m_dir_last_page_no = m_cur_blob_page_no;
+		m_prev_page_no = m_cur_blob_page_no;
+	}
+
+	return(m_dir.entry(n, RW_X_LATCH, &m_blob_mtr));
+}
+
+/** Take over the data page of a chunk from the previous version,
+if its contents are equal.
+@param[in]	n	chunk number
+@param[in]	data	new data of the chunk
+@param[in]	len	length of data
+@return the data page number, or FIL_NULL if it cannot be shared */
+page_no_t
+IndexInserter::share_old_page(
+	ulint		n,
+	const byte*	data,
+	ulint		len)
+{
+	ut_ad(n < m_old_n_entries);
+
+	byte*		old_entry = m_old_dir.entry(n, RW_X_LATCH, &m_blob_mtr);
+	const page_no_t	page_no = mach_read_from_4(
+		old_entry + LOB_ENTRY_PAGE_NO);
+	const ulint	flags = mach_read_from_1(old_entry + LOB_ENTRY_FLAGS);
+
+	if (page_no == FIL_NULL || !(flags & LOB_ENTRY_OWNED)) {
+		return(FIL_NULL);
+	}
+
+	buf_block_t*	block = buf_page_get(
+		page_id_t(m_ctx->space(), page_no),
+		m_ctx->page_size(), RW_S_LATCH, &m_blob_mtr);
+
+	buf_block_dbg_add_level(block, SYNC_EXTERN_STORAGE);
+
+	const page_t*	page = buf_block_get_frame(block);
+
+	ut_a(fil_page_get_type(page) == FIL_PAGE_TYPE_LOB_DATA);
+
+	if (mach_read_from_4(page + FIL_PAGE_DATA + LOB_DATA_LEN) != len
+	    || memcmp(page + FIL_PAGE_DATA + LOB_DATA_HDR_SIZE, data, len)) {
+		return(FIL_NULL);
+	}
+
+	/* The new version owns the page from now on.  Purge of the old
+	version will leave it alone, and a rollback of the new version
+	will give it back. */
+	mlog_write_ulint(old_entry + LOB_ENTRY_FLAGS,
+			 flags & ~LOB_ENTRY_OWNED, MLOG_1BYTE, &m_blob_mtr);
+
+	return(page_no);
+}
+
+/** Add the data page of one chunk of the field to the directory,
+sharing it with the previous version if the data did not change.
+@param[in]	field	the big record field.
+@param[in]	n	chunk number */
+void
+IndexInserter::write_chunk(big_rec_field_t& field, ulint n)
+{
+	const ulint	chunk_size = index_chunk_size(m_ctx->page_size());
+	const ulint	offset = n * chunk_size;
+	const ulint	len = std::min(chunk_size, field.len - offset);
+	const byte*	data = (const byte*) field.data + offset;
+	buf_block_t*	rec_block = m_ctx->block();
+	mtr_t*		mtr = start_blob_mtr();
+
+	buf_page_get(rec_block->page.id,
+		     rec_block->page.size, RW_X_LATCH, mtr);
+
+	byte*	entry = new_entry(n);
+
+	if (entry == NULL) {
+		if (mtr->is_active()) {
+			mtr->commit();
+		}
+		return;
+	}
+
+	page_no_t	page_no = FIL_NULL;
+	ulint		flags = LOB_ENTRY_OWNED;
+
+	if (n < m_old_n_entries) {
+		page_no = share_old_page(n, data, len);
+	}
+
+	if (page_no != FIL_NULL) {
+		flags |= LOB_ENTRY_INHERITED;
+
+		MONITOR_INC(MONITOR_LOB_PAGES_SHARED);
+	} else {
+		if (alloc_blob_page() == NULL) {
+			if (mtr->is_active()) {
+				mtr->commit();
+			}
+			return;
+		}
+
+		page_t*	page = cur_page();
+
+		mlog_write_ulint(page + FIL_PAGE_TYPE, FIL_PAGE_TYPE_LOB_DATA,
+				 MLOG_2BYTES, mtr);
+		mlog_write_ulint(page + FIL_PAGE_DATA + LOB_DATA_LEN,
+				 len, MLOG_4BYTES, mtr);
+		mlog_write_string(page + FIL_PAGE_DATA + LOB_DATA_HDR_SIZE,
+				  data, len, mtr);
+
+		page_no = m_cur_blob_page_no;
+		m_prev_page_no = m_cur_blob_page_no;
+
+		MONITOR_INC(MONITOR_LOB_PAGES_WRITTEN);
+	}
+
+	mlog_write_ulint(entry + LOB_ENTRY_PAGE_NO, page_no,
+			 MLOG_4BYTES, mtr);
+	mlog_write_ulint(entry + LOB_ENTRY_FLAGS, flags, MLOG_1BYTE, mtr);
+
+	buf_block_t*	first = m_dir.get_block(
+		m_dir.first_page_no(), RW_X_LATCH, mtr);
+
+	mlog_write_ulint(first->frame + FIL_PAGE_DATA + LOB_FIRST_N_ENTRIES,
+			 n + 1, MLOG_4BYTES, mtr);
+	mlog_write_ulint(first->frame + FIL_PAGE_DATA + LOB_FIRST_DATA_LEN,
+			 offset + len, MLOG_4BYTES, mtr);
+
+	byte*	field_ref = btr_rec_get_field_ref(
+		m_ctx->rec(), m_ctx->get_offsets(), field.field_no);
+	ref_t	blobref(field_ref);
+
+	blobref.set_length(offset + len, mtr);
+
+	mtr->commit();
+}
+
+/** Copy a byte range of the externally stored part of the LOB to
+the buffer of the read context.  The directory is followed to the
+entry of the data page that holds the start of the range, and only
+the data pages that hold the range are read.
+@param[in]	offset	start of the range
+@return number of bytes copied, less than the length of the buffer
+if the LOB ends before it */
+ulint
+IndexReader::fetch(ulint offset)
+{
+	const page_size_t&	page_size = m_rctx.m_page_size;
+	const ulint		chunk_size = index_chunk_size(page_size);
+	DirCursor		dir(m_rctx.m_space_id, page_size,
+				    m_rctx.m_page_no);
+	mtr_t			mtr;
+
+	mtr_start(&mtr);
+
+	const ulint	n_entries = mach_read_from_4(
+		dir.get_block(m_rctx.m_page_no, RW_S_LATCH, &mtr)->frame
+		+ FIL_PAGE_DATA + LOB_FIRST_N_ENTRIES);
+
+	mtr_commit(&mtr);
+
+	/* Every data page but the last one is full, so the entry of the
+	page that holds the offset follows from the offset alone.  Only
+	the directory pages before that entry are read to reach it. */
+	ulint	copied = 0;
+	ulint	skip = offset % chunk_size;
+
+	for (ulint n = offset / chunk_size;
+	     n < n_entries && copied < m_rctx.m_len; ++n) {
+
+		mtr_start(&mtr);
+
+		const page_no_t	page_no = mach_read_from_4(
+			dir.entry(n, RW_S_LATCH, &mtr) + LOB_ENTRY_PAGE_NO);
+
+		if (page_no == FIL_NULL) {
+			/* The LOB is being freed. */
+			mtr_commit(&mtr);
+			break;
+		}
+
+		buf_block_t*	block = buf_page_get(
+			page_id_t(m_rctx.m_space_id, page_no),
+			page_size, RW_S_LATCH, &mtr);
+
+		buf_block_dbg_add_level(block, SYNC_EXTERN_STORAGE);
+
+		const page_t*	page = buf_block_get_frame(block);
+
+		ut_a(fil_page_get_type(page) == FIL_PAGE_TYPE_LOB_DATA);
+
+		const ulint	part_len = mach_read_from_4(
+			page + FIL_PAGE_DATA + LOB_DATA_LEN);
+
+		if (skip < part_len) {
+			const ulint	copy_len = std::min(
+				part_len - skip, m_rctx.m_len - copied);
+
+			memcpy(m_rctx.m_buf + copied,
+			       page + FIL_PAGE_DATA + LOB_DATA_HDR_SIZE + skip,
+			       copy_len);
+
+			copied += copy_len;
+		}
+
+		mtr_commit(&mtr);
+
+		skip = 0;
+	}
+
+	return(copied);
+}
+
+/** Free the data pages and the index pages of a LOB in the indexed
+format.  Only the first page is left, for free_first_page().  For a
+LOB in another format, nothing is done.
+@return DB_SUCCESS on success, error code on failure. */
+dberr_t
+Deleter::free_indexed_pages()
+{
+	const space_id_t	space_id = m_ctx.m_blobref.space_id();
+	const page_no_t		first_page_no = m_ctx.m_blobref.page_no();
+	const mtr_log_t		log_mode = m_ctx.m_mtr->get_log_mode();
+
+	mtr_start(&m_mtr);
+	m_mtr.set_log_mode(log_mode);
+
+	x_latch_rec_page();
+
+	buf_block_t*	block = buf_page_get(
+		page_id_t(space_id, first_page_no), m_ctx.m_page_size,
+		RW_S_LATCH, &m_mtr);
+
+	buf_block_dbg_add_level(block, SYNC_EXTERN_STORAGE);
+
+	if (fil_page_get_type(block->frame) != FIL_PAGE_TYPE_LOB_FIRST) {
+		mtr_commit(&m_mtr);
+		return(DB_SUCCESS);
+	}
+
+	const ulint	n_entries = mach_read_from_4(
+		block->frame + FIL_PAGE_DATA + LOB_FIRST_N_ENTRIES);
+	const page_no_t	prev_page_no = mach_read_from_4(
+		block->frame + FIL_PAGE_DATA + LOB_FIRST_PREV_VERSION);
+
+	mtr_commit(&m_mtr);
+
+	DirCursor	dir(space_id, m_ctx.m_page_size, first_page_no);
+	DirCursor	prev_dir(space_id, m_ctx.m_page_size, prev_page_no);
+
+	/* Free the data pages one at a time, marking every freed entry,
+	so that the work is not repeated after a crash. */
+	for (ulint n = 0; n < n_entries; ++n) {
+
+		mtr_start(&m_mtr);
+		m_mtr.set_log_mode(log_mode);
+
+		x_latch_rec_page();
+
+		byte*		entry = dir.entry(n, RW_X_LATCH, &m_mtr);
+		const page_no_t	page_no = mach_read_from_4(
+			entry + LOB_ENTRY_PAGE_NO);
+		const ulint	flags = mach_read_from_1(
+			entry + LOB_ENTRY_FLAGS);
+
+		if (page_no == FIL_NULL) {
+
+			mtr_commit(&m_mtr);
+
+		} else if (m_ctx.m_rollback
+			   && (flags & LOB_ENTRY_INHERITED)) {
+
+			/* Give the page back to the version that it was
+			taken over from. */
+			ut_a(prev_page_no != FIL_NULL);
+
+			byte*	prev_entry = prev_dir.entry(
+				n, RW_X_LATCH, &m_mtr);
+
+			ut_a(mach_read_from_4(prev_entry + LOB_ENTRY_PAGE_NO)
+			     == page_no);
+
+			mlog_write_ulint(
+				prev_entry + LOB_ENTRY_FLAGS,
+				mach_read_from_1(prev_entry + LOB_ENTRY_FLAGS)
+				| LOB_ENTRY_OWNED, MLOG_1BYTE, &m_mtr);
+			mlog_write_ulint(entry + LOB_ENTRY_PAGE_NO, FIL_NULL,
+					 MLOG_4BYTES, &m_mtr);
+
+			mtr_commit(&m_mtr);
+
+		} else if (flags & LOB_ENTRY_OWNED) {
+
+			buf_block_t*	data_block = buf_page_get(
+				page_id_t(space_id, page_no),
+				m_ctx.m_page_size, RW_X_LATCH, &m_mtr);
+
+			buf_block_dbg_add_level(data_block,
+						SYNC_EXTERN_STORAGE);
+
+			ut_a(fil_page_get_type(data_block->frame)
+			     == FIL_PAGE_TYPE_LOB_DATA);
+
+			btr_page_free_low(m_ctx.m_index, data_block,
+					  ULINT_UNDEFINED, &m_mtr);
+
+			mlog_write_ulint(entry + LOB_ENTRY_PAGE_NO, FIL_NULL,
+					 MLOG_4BYTES, &m_mtr);
+
+			/* Commit mtr and release the block to save
+			memory. */
+			blob_free(m_ctx.m_index, data_block, TRUE, &m_mtr);
+
+		} else {
+			/* A newer version owns the page. */
+			mtr_commit(&m_mtr);
+		}
+	}
+
+	/* Forget the entries before freeing the index pages that hold
+	them, so that a restarted free does not look for them. */
+	mtr_start(&m_mtr);
+	m_mtr.set_log_mode(log_mode);
+
+	x_latch_rec_page();
+
+	block = dir.get_block(first_page_no, RW_X_LATCH, &m_mtr);
+
+	mlog_write_ulint(block->frame + FIL_PAGE_DATA + LOB_FIRST_N_ENTRIES,
+			 0, MLOG_4BYTES, &m_mtr);
+
+	mtr_commit(&m_mtr);
+
+	for (;;) {
+		mtr_start(&m_mtr);
+		m_mtr.set_log_mode(log_mode);
+
+		x_latch_rec_page();
+
+		block = dir.get_block(first_page_no, RW_X_LATCH, &m_mtr);
+
+		const page_no_t	page_no = mach_read_from_4(
+			block->frame + FIL_PAGE_DATA + LOB_DIR_NEXT);
+
+		if (page_no == FIL_NULL) {
+			mtr_commit(&m_mtr);
+			break;
+		}
+
+		buf_block_t*	index_block = dir.get_block(
+			page_no, RW_X_LATCH, &m_mtr);
+
+		mlog_write_ulint(
+			block->frame + FIL_PAGE_DATA + LOB_DIR_NEXT,
+			mach_read_from_4(index_block->frame + FIL_PAGE_DATA
+					 + LOB_DIR_NEXT),
+			MLOG_4BYTES, &m_mtr);
+
+		btr_page_free_low(m_ctx.m_index, index_block,
+				  ULINT_UNDEFINED, &m_mtr);
+
+		blob_free(m_ctx.m_index, index_block, TRUE, &m_mtr);
+	}
+
+	return(DB_SUCCESS);
+}
+
+} // namespace lob
@@ -0,0 +1,299 @@
+/*****************************************************************************
+
+Copyright (c) 2017, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+#ifndef lob0ind_h
+#define lob0ind_h
+
+#include "lob0lob.h"
+
+/**
+@file
+@brief Implements the indexed format of uncompressed LOBs.
+
+A LOB in the indexed format is made of a first page (FIL_PAGE_TYPE_LOB_FIRST),
+which holds a directory of the data pages of the LOB, any number of index
+pages (FIL_PAGE_TYPE_LOB_INDEX) that continue the directory, and the data pages
+(FIL_PAGE_TYPE_LOB_DATA).  Every data page except the last one is full, so the
+data page that holds a given byte of the LOB is found from the directory
+without reading the pages before it.
+
+Data pages are never modified after they have been written.  When an update
+stores a new version of a LOB, the data pages whose contents did not change
+are shared with the previous version instead of being written again.  Every
+version stays readable through its own directory for as long as the undo log
+refers to it.  Each directory entry carries an OWNED flag.  The newest version
+owns the pages that it shares, and purging an older version frees only the
+data pages that it still owns.  The INHERITED flag marks the entries that were
+taken over from the previous version, whose first page number is stored in the
+header of the first page, so that a rollback can give them back. */
+
+namespace lob {
+
+/** Offset within the first page and the index pages of the page number
+of the next index page of the directory, FIL_NULL if none. */
+const ulint LOB_DIR_NEXT		= 0;
+
+/** Offset within the first page of the length of the LOB data that has
+been written so far. */
+const ulint LOB_FIRST_DATA_LEN		= 4;
+
+/** Offset within the first page of the number of directory entries
+in use. */
+const ulint LOB_FIRST_N_ENTRIES		= 8;
+
+/** Offset within the first page of the first page number of the version
+of the LOB that this version was stored from by an update, FIL_NULL if
+none. */
+const ulint LOB_FIRST_PREV_VERSION	= 12;
+
+/** Size of the header of the first page, in bytes */
+const ulint LOB_FIRST_HDR_SIZE		= 16;
+
+/** Size of the header of an index page, in bytes */
+const ulint LOB_INDEX_HDR_SIZE		= 4;
+
+/** Offset within a data page of the length of the data on the page. */
+const ulint LOB_DATA_LEN		= 0;
+
+/** Size of the header of a data page, in bytes */
+const ulint LOB_DATA_HDR_SIZE		= 4;
+
+/** Offset within a directory entry of the data page number */
+const ulint LOB_ENTRY_PAGE_NO		= 0;
+
+/** Offset within a directory entry of the flags */
+const ulint LOB_ENTRY_FLAGS		= 4;
+
+/** Size of a directory entry, in bytes */
+const ulint LOB_ENTRY_SIZE		= 5;
+
+/** The version owns the data page and frees it when it is freed. */
+const ulint LOB_ENTRY_OWNED		= 1;
+
+/** The data page was taken over from the previous version. */
+const ulint LOB_ENTRY_INHERITED		= 2;
+
+/** Number of bytes of LOB data on a full data page.
+@param[in]	page_size	page size of the tablespace
+@return payload of a data page, in bytes */
+inline
+ulint
+index_chunk_size(const page_size_t& page_size)
+{
+	return(page_size.physical() - FIL_PAGE_DATA - LOB_DATA_HDR_SIZE
+	       - FIL_PAGE_DATA_END);
+}
+
+/** Positions on the directory entries of an indexed LOB.  The cursor
+remembers the directory page of the last entry that it visited, so that
+visiting the entries in ascending order reads each directory page once. */
+class DirCursor
+{
+public:
+	/** Constructor.
+	@param[in]	space_id	tablespace of the LOB
+	@param[in]	page_size	page size of the tablespace
+	@param[in]	first_page_no	first page of the LOB, or FIL_NULL */
+	DirCursor(
+		space_id_t		space_id,
+		const page_size_t&	page_size,
+		page_no_t		first_page_no)
+	:
+	m_space_id(space_id),
+	m_page_size(page_size),
+	m_first_page_no(first_page_no),
+	m_page_no(first_page_no),
+	m_base(0)
+	{}
+
+	/** Position the cursor on another LOB.
+	@param[in]	first_page_no	first page of the LOB */
+	void open(page_no_t first_page_no)
+	{
+		m_first_page_no = first_page_no;
+		m_page_no = first_page_no;
+		m_base = 0;
+	}
+
+	/** @return the first page of the LOB */
+	page_no_t first_page_no() const
+	{
+		return(m_first_page_no);
+	}
+
+	/** Latch a directory page of the LOB.
+	@param[in]	page_no		first page or index page of the LOB
+	@param[in]	rw_latch	RW_S_LATCH or RW_X_LATCH
+	@param[in,out]	mtr		mini-transaction
+	@return the latched block */
+	buf_block_t* get_block(
+		page_no_t	page_no,
+		ulint		rw_latch,
+		mtr_t*		mtr) const;
+
+	/** Latch the directory page that holds an entry.
+	@param[in]	n		entry number
+	@param[in]	rw_latch	RW_S_LATCH or RW_X_LATCH
+	@param[in,out]	mtr		mini-transaction
+	@return the entry */
+	byte* entry(
+		ulint		n,
+		ulint		rw_latch,
+		mtr_t*		mtr);
+
+	/** Number of directory entries on the first page.
+	@param[in]	page_size	page size of the tablespace
+	@return number of entries */
+	static ulint first_capacity(const page_size_t& page_size)
+	{
+		return((page_size.physical() - FIL_PAGE_DATA
+			- LOB_FIRST_HDR_SIZE - FIL_PAGE_DATA_END)
+		       / LOB_ENTRY_SIZE);
+	}
+
+	/** Number of directory entries on an index page.
+	@param[in]	page_size	page size of the tablespace
+	@return number of entries */
+	static ulint index_capacity(const page_size_t& page_size)
+	{
+		return((page_size.physical() - FIL_PAGE_DATA
+			- LOB_INDEX_HDR_SIZE - FIL_PAGE_DATA_END)
+		       / LOB_ENTRY_SIZE);
+	}
+
+private:
+	/** Tablespace of the LOB */
+	space_id_t	m_space_id;
+
+	/** Page size of the tablespace */
+	page_size_t	m_page_size;
+
+	/** First page of the LOB */
+	page_no_t	m_first_page_no;
+
+	/** Directory page of the last visited entry */
+	page_no_t	m_page_no;
+
+	/** Number of the first entry on m_page_no */
+	ulint		m_base;
+};
+
+/** Writes an uncompressed LOB in the indexed format. */
+class IndexInserter : private BaseInserter
+{
+public:
+	/** Constructor.
+	@param[in]	ctx	blob operation context. */
+	explicit IndexInserter(InsertContext* ctx);
+
+	/** Check whether a field is stored in the indexed format.
+	@param[in]	ctx	blob operation context.
+	@param[in]	field	the big record field.
+	@return true if IndexInserter must write the field. */
+	static bool is_used(
+		InsertContext*		ctx,
+		const big_rec_field_t&	field);
+
+	/** Write one blob field data.  If the field has a previous version
+	in the indexed format, the data pages that did not change are shared
+	with it.
+	@param[in]	field	the big record field.
+	@return DB_SUCCESS on success, error code on failure. */
+	dberr_t write_one_blob(big_rec_field_t& field);
+
+private:
+	/** Check if the BLOB operation has reported any errors.
+	@return	true if BLOB operation is successful, false otherwise. */
+	bool is_ok() const
+	{
+		return(m_status == DB_SUCCESS);
+	}
+
+	/** Allocate the first page, find the previous version of the
+	field and point the blob reference to the first page.
+	@param[in]	field	the big record field. */
+	void write_first_page(big_rec_field_t& field);
+
+	/** Add the data page of one chunk of the field to the directory,
+	sharing it with the previous version if the data did not change.
+	@param[in]	field	the big record field.
+	@param[in]	n	chunk number */
+	void write_chunk(big_rec_field_t& field, ulint n);
+
+	/** Latch the directory entry of a new chunk, adding an index page
+	to the directory if it is full.
+	@param[in]	n	chunk number
+	@return the entry, or NULL if out of file space */
+	byte* new_entry(ulint n);
+
+	/** Take over the data page of a chunk from the previous version,
+	if its contents are equal.
+	@param[in]	n	chunk number
+	@param[in]	data	new data of the chunk
+	@param[in]	len	length of data
+	@return the data page number, or FIL_NULL if it cannot be shared */
+	page_no_t share_old_page(
+		ulint		n,
+		const byte*	data,
+		ulint		len);
+
+	/** Directory of the LOB being written */
+	DirCursor	m_dir;
+
+	/** Number of directory entries that fit on the pages that have
+	been allocated for the directory */
+	ulint		m_dir_capacity;
+
+	/** Last page of the directory */
+	page_no_t	m_dir_last_page_no;
+
+	/** Directory of the previous version */
+	DirCursor	m_old_dir;
+
+	/** Number of chunks of the previous version, 0 if it is not stored
+	in the indexed format */
+	ulint		m_old_n_entries;
+};
+
+/** Reads an uncompressed LOB in the indexed format. */
+class IndexReader
+{
+public:
+	/** Constructor.
+	@param[in]	ctx	the read context. */
+	explicit IndexReader(const ReadContext& ctx)
+	:
+	m_rctx(ctx)
+	{}
+
+	/** Copy a byte range of the externally stored part of the LOB to
+	the buffer of the read context.  The directory is followed to the
+	entry of the data page that holds the start of the range, and only
+	the data pages that hold the range are read.
+	@param[in]	offset	start of the range
+	@return number of bytes copied, less than the length of the buffer
+	if the LOB ends before it */
+	ulint fetch(ulint offset);
+
+private:
+	/** The read context */
+	const ReadContext&	m_rctx;
+};
+
+} // namespace lob
+
+#endif /* lob0ind_h */
@@ -21,11 +21,13 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "btr0pcur.h"
 #include "fil0fil.h"
 #include "lob0fit.h"
+#include "lob0ind.h"
 #include "lob0lob.h"
 #include "lob0zip.h"
 #include "my_dbug.h"
 #include "my_inttypes.h"
 #include "row0upd.h"
+#include "srv0srv.h"
 
 namespace lob {
 
@@ -779,6 +781,49 @@ insert_single_zstream:
 #endif /* UNIV_DEBUG */
 }
 
+/** Remember the external field references of the record that an update
+replaces, so that the unchanged data pages of LOBs in the indexed format
+can be shared with the new version.  Nothing is done if sharing is not
+possible for the index.
+@param[in]	index		clustered index
+@param[in]	rec		record before the update
+@param[in]	offsets		rec_get_offsets(rec, index)
+@param[in,out]	big_rec_vec	fields to be stored externally */
+void
+btr_rec_copy_old_field_refs(
+	const dict_index_t*	index,
+	const rec_t*		rec,
+	const ulint*		offsets,
+	big_rec_t*		big_rec_vec)
+{
+	ut_ad(rec_offs_validate(rec, index, offsets));
+	ut_ad(index->is_clustered());
+
+	/* The pages of a temporary table are not covered by undo, and
+	the pages of a table that is being rebuilt online are tracked by
+	the row log, which does not know about shared pages. */
+	if (!srv_indexed_lob
+	    || index->table->is_temporary()
+	    || dict_index_is_online_ddl(index)
+	    || dict_index_is_sdi(index)
+	    || dict_table_page_size(index->table).is_compressed()) {
+		return;
+	}
+
+	for (ulint i = 0; i < big_rec_vec->n_fields; i++) {
+		big_rec_field_t&	field = big_rec_vec->fields[i];
+
+		if (!rec_offs_nth_extern(offsets, field.field_no)) {
+			continue;
+		}
+
+		field.old_ref = static_cast<const byte*>(mem_heap_dup(
+			big_rec_vec->heap,
+			btr_rec_get_field_ref(rec, offsets, field.field_no),
+			BTR_EXTERN_FIELD_REF_SIZE));
+	}
+}
+
 /** Copies an externally stored field of a record to mem heap.
 @param[in]	rec		record in a clustered index; must be
 				protected by a lock or a page latch
@@ -866,6 +911,13 @@ Inserter::write_one_blob(size_t blob_j)
 	const big_rec_t*	vec = m_ctx->get_big_rec_vec();
 	big_rec_field_t&	field = vec->fields[blob_j];
 
+	if (IndexInserter::is_used(m_ctx, field)) {
+		IndexInserter	writer(m_ctx);
+
+		m_status = writer.write_one_blob(field);
+		return(m_status);
+	}
+
 	m_ctx->check_redolog();
 
 	m_status = write_first_page(blob_j, field);
@@ -1064,6 +1116,9 @@ dberr_t	Deleter::free_first_page()
 
 	if (m_ctx.is_compressed()) {
 		next_page_no = mach_read_from_4(page + FIL_PAGE_NEXT);
+	} else if (fil_page_get_type(page) == FIL_PAGE_TYPE_LOB_FIRST) {
+		/* The other pages were freed by free_indexed_pages(). */
+		next_page_no = FIL_NULL;
 	} else {
 		next_page_no = btr_blob_get_next_page_no(
 			page + FIL_PAGE_DATA);
@@ -1104,6 +1159,13 @@ dberr_t	Deleter::destroy()
 					m_ctx.m_blobref.page_no());
 	}
 
+	if (!m_ctx.is_compressed()) {
+		err = free_indexed_pages();
+		if (err != DB_SUCCESS) {
+			return(err);
+		}
+	}
+
 	while (m_ctx.m_blobref.page_no() != FIL_NULL) {
 		ut_ad(m_ctx.m_blobref.page_no() > 0);
 
@@ -1214,15 +1276,32 @@ void Reader::fetch_page()
 	buf_block_dbg_add_level(m_cur_block, SYNC_EXTERN_STORAGE);
 	page_t*	page = buf_block_get_frame(m_cur_block);
 
+	if (fil_page_get_type(page) == FIL_PAGE_TYPE_LOB_FIRST) {
+		/* The LOB is read through its directory, see fetch(). */
+		m_indexed = true;
+		mtr_commit(&mtr);
+		return;
+	}
+
 	btr_check_blob_fil_page_type(m_rctx.m_space_id, m_rctx.m_page_no,
 				     page, TRUE);
 
 	byte*	blob_header = page + m_rctx.m_offset;
 	part_len = btr_blob_get_part_len(blob_header);
-	copy_len = ut_min(part_len, m_rctx.m_len - m_copied_len);
 
-	memcpy(m_rctx.m_buf + m_copied_len, blob_header + LOB_HDR_SIZE,
-	       copy_len);
+	if (m_skip >= part_len) {
+		/* The range starts on a later page. */
+		m_skip -= part_len;
+		copy_len = 0;
+	} else {
+		copy_len = ut_min(part_len - m_skip,
+				  m_rctx.m_len - m_copied_len);
+
+		memcpy(m_rctx.m_buf + m_copied_len,
+		       blob_header + LOB_HDR_SIZE + m_skip, copy_len);
+
+		m_skip = 0;
+	}
 
 	m_copied_len += copy_len;
 	m_rctx.m_page_no = btr_blob_get_next_page_no(blob_header);
@@ -1247,6 +1326,12 @@ ulint	Reader::fetch()
 		}
 
 		fetch_page();
+
+		if (m_indexed) {
+			ut_ad(m_copied_len == 0);
+			m_copied_len = IndexReader(m_rctx).fetch(m_skip);
+			return(m_copied_len);
+		}
 	}
 
 	/* Assure that we have fetched the requested amount or the LOB
@@ -1331,6 +1416,55 @@ btr_copy_externally_stored_field_prefix_func(
 	return(local_len + fetch_len);
 }
 
+/** Copies a byte range of the externally stored part of a field of a
+record.  The clustered index record must be protected by a lock or a page
+latch.  For a LOB in the indexed format, only the pages that hold the
+range are read.  The page size must not be compressed.
+@param[out]	buf		the range
+@param[in]	offset		start of the range within the externally
+stored part
+@param[in]	len		length of buf, in bytes
+@param[in]	page_size	BLOB page size
+@param[in]	data		'internally' stored part of the field
+containing also the reference to the external part; must be protected by
+a lock or a page latch
+@param[in]	local_len	length of data, in bytes
+@return the length of the copied range, less than len if the field ends
+before it, or 0 if the column was being or has been deleted */
+ulint
+btr_copy_externally_stored_field_range(
+	byte*			buf,
+	ulint			offset,
+	ulint			len,
+	const page_size_t&	page_size,
+	const byte*		data,
+	ulint			local_len)
+{
+	ut_a(local_len >= BTR_EXTERN_FIELD_REF_SIZE);
+	ut_ad(!page_size.is_compressed());
+
+	const byte*	field_ref = data + local_len - BTR_EXTERN_FIELD_REF_SIZE;
+
+	ut_a(memcmp(field_ref, field_ref_zero, BTR_EXTERN_FIELD_REF_SIZE));
+
+	if (!mach_read_from_4(field_ref + BTR_EXTERN_LEN + 4)) {
+		/* The externally stored part of the column has been
+		(partially) deleted. */
+		return(0);
+	}
+
+	ReadContext	rctx(
+		page_size, data, local_len, buf, len
+#ifdef UNIV_DEBUG
+		, false
+#endif /* UNIV_DEBUG */
+		);
+
+	Reader	reader(rctx);
+
+	return(reader.fetch(offset));
+}
+
 /** Copies an externally stored field of a record to mem heap.
 The clustered index record must be protected by a lock or a page latch.
 @param[out]	len		length of the whole field
@@ -1382,6 +1516,16 @@ btr_copy_externally_stored_field_func(
 		*len = reader.length();
 		return(buf);
 	} else {
+		DBUG_EXECUTE_IF(
+			"innodb_lob_read_second_half",
+			/* Return only the second half of the externally
+			stored part, to test byte range reads. */
+			*len = btr_copy_externally_stored_field_range(
+				buf, extern_len / 2, extern_len - extern_len / 2,
+				page_size, data,
+				local_len + BTR_EXTERN_FIELD_REF_SIZE);
+			return(buf););
+
 		memcpy(buf, data, local_len);
 		Reader	reader(rctx);
 		ulint fetch_len = reader.fetch();
@@ -27,7 +27,9 @@ Created 5/7/1996 Heikki Tuuri
 
 #include <mysql/service_thd_engine_lock.h>
 #include <sys/types.h>
+#include <algorithm>
 #include <set>
+#include <vector>
 
 #include "btr0btr.h"
 #include "current_thd.h"
@@ -45,6 +47,7 @@ Created 5/7/1996 Heikki Tuuri
 #include "row0mysql.h"
 #include "row0sel.h"
 #include "srv0mon.h"
+#include "srv0start.h"
 #include "trx0purge.h"
 #include "trx0sys.h"
 #include "usr0sess.h"
@@ -54,6 +57,9 @@ Created 5/7/1996 Heikki Tuuri
 /* Flag to enable/disable deadlock detector. */
 bool	innobase_deadlock_detect = TRUE;
 
+/* Flag to move deadlock detection to lock_deadlock_detector_thread(). */
+bool	innobase_deadlock_detect_async = FALSE;
+
 /** Total number of cached record locks */
 static const ulint	REC_LOCK_CACHE = 8;
 
@@ -226,6 +232,8 @@ private:
 	@param lock lock trx wants */
 	static void rollback_print(const trx_t* trx, const lock_t* lock);
 
+	friend class DeadlockDetector;
+
 private:
 	/** DFS state information, used during deadlock checking. */
 	struct state_t {
@@ -234,7 +242,7 @@ private:
 		ulint		m_heap_no;	/*!< heap number if rec lock */
 	};
 
-	/** Used in deadlock tracking. Protected by lock_sys->mutex. */
+	/** Used in deadlock tracking. Protected by lock_sys->latch. */
 	static ib_uint64_t	s_lock_mark_counter;
 
 	/** Calculation steps thus far. It is the count of the nodes visited. */
@@ -444,12 +452,19 @@ lock_sys_create(
 
 	lock_sys->last_slot = lock_sys->waiting_threads;
 
-	mutex_create(LATCH_ID_LOCK_SYS, &lock_sys->mutex);
+	rw_lock_create(lock_sys_latch_key, &lock_sys->latch, SYNC_LOCK_SYS);
+
+	for (ulint i = 0; i < LOCK_SYS_N_PAGE_SHARDS; ++i) {
+		mutex_create(LATCH_ID_LOCK_SYS_PAGE,
+			     &lock_sys->page_mutexes[i].mutex);
+	}
 
 	mutex_create(LATCH_ID_LOCK_SYS_WAIT, &lock_sys->wait_mutex);
 
 	lock_sys->timeout_event = os_event_create(0);
 
+	lock_sys->deadlock_event = os_event_create(0);
+
 	lock_sys->rec_hash = hash_create(n_cells);
 	lock_sys->prdt_hash = hash_create(n_cells);
 	lock_sys->prdt_page_hash = hash_create(n_cells);
@@ -545,7 +560,14 @@ lock_sys_close(void)
 
 	os_event_destroy(lock_sys->timeout_event);
 
-	mutex_destroy(&lock_sys->mutex);
+	os_event_destroy(lock_sys->deadlock_event);
+
+	rw_lock_free(&lock_sys->latch);
+
+	for (ulint i = 0; i < LOCK_SYS_N_PAGE_SHARDS; ++i) {
+		mutex_destroy(&lock_sys->page_mutexes[i].mutex);
+	}
+
 	mutex_destroy(&lock_sys->wait_mutex);
 
 	srv_slot_t*	slot = lock_sys->waiting_threads;
@@ -571,6 +593,25 @@ lock_get_size(void)
 	return((ulint) sizeof(lock_t));
 }
 
+#ifdef UNIV_DEBUG
+/** Check if the queue that a lock belongs to is latched.
+@param[in]	lock	record or table lock
+@return true if lock_sys->latch is owned in X mode, or the lock is a record
+lock and its page shard is latched */
+static
+bool
+lock_queue_own(
+	const lock_t*	lock)
+{
+	if (lock_get_type_low(lock) == LOCK_REC) {
+		return(lock_shard_own(lock->un_member.rec_lock.space,
+				      lock->un_member.rec_lock.page_no));
+	}
+
+	return(lock_mutex_own());
+}
+#endif /* UNIV_DEBUG */
+
 /*********************************************************************//**
 Sets the wait flag of a lock and the back pointer in trx to lock. */
 UNIV_INLINE
@@ -601,7 +642,7 @@ lock_reset_lock_and_trx_wait(
 {
 	ut_ad(lock->trx->lock.wait_lock == lock);
 	ut_ad(lock_get_wait(lock));
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_queue_own(lock));
 
 	lock->trx->lock.wait_lock = NULL;
 	lock->type_mode &= ~LOCK_WAIT;
@@ -1211,7 +1252,7 @@ lock_rec_other_trx_holds_expl(
 Return approximate number or record locks (bits set in the bitmap) for
 this transaction. Since delete-marked records may be removed, the
 record count will not be precise.
-The caller must be holding lock_sys->mutex. */
+The caller must be holding lock_sys->latch. */
 ulint
 lock_number_of_rows_locked(
 /*=======================*/
@@ -1224,7 +1265,7 @@ lock_number_of_rows_locked(
 
 /*********************************************************************//**
 Return the number of table locks for a transaction.
-The caller must be holding lock_sys->mutex. */
+The caller must be holding lock_sys->latch. */
 ulint
 lock_number_of_tables_locked(
 /*=========================*/
@@ -1313,7 +1354,7 @@ RecLock::lock_alloc(
 	const RecID&	rec_id,
 	ulint		size)
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_shard_own(rec_id.m_space_id, rec_id.m_page_no));
 
 	lock_t*	lock;
 
@@ -1363,9 +1404,9 @@ RecLock::lock_alloc(
 
 	lock_rec_set_nth_bit(lock, rec_id.m_heap_no);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK);
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK);
 
-	MONITOR_INC(MONITOR_RECLOCK_CREATED);
+	MONITOR_ATOMIC_INC(MONITOR_RECLOCK_CREATED);
 
 	return(lock);
 }
@@ -1377,13 +1418,13 @@ Add the lock to the record lock hash and the transaction's lock list
 void
 RecLock::lock_add(lock_t* lock, bool add_to_hash)
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_shard_own(m_rec_id.m_space_id, m_rec_id.m_page_no));
 	ut_ad(trx_mutex_own(lock->trx));
 
 	if (add_to_hash) {
 		ulint	key = m_rec_id.fold();
 
-		++lock->index->table->n_rec_locks;
+		os_atomic_increment_ulint(&lock->index->table->n_rec_locks, 1);
 
 		HASH_INSERT(lock_t, hash, lock_hash_get(m_mode), key, lock);
 	}
@@ -1419,7 +1460,7 @@ RecLock::create(
 	bool	add_to_hash,
 	const	lock_prdt_t* prdt)
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_shard_own(m_rec_id.m_space_id, m_rec_id.m_page_no));
 	ut_ad(owns_trx_mutex == trx_mutex_own(trx));
 
 	/* Create the explicit lock instance and initialise it. */
@@ -1772,7 +1813,8 @@ lock_rec_lock_fast(
 	dict_index_t*		index,	/*!< in: index of record */
 	que_thr_t*		thr)	/*!< in: query thread */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_shard_own(block->page.id.space(),
+			     block->page.id.page_no()));
 	ut_ad(!srv_read_only_mode);
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_S
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
@@ -1939,7 +1981,10 @@ lock_rec_lock_slow(
 possible, enqueues a waiting lock request. This is a low-level function
 which does NOT look at implicit locks! Checks lock compatibility within
 explicit locks. This function sets a normal next-key lock, or in the case
-of a page supremum record, a gap type lock.
+of a page supremum record, a gap type lock. The common cases are handled
+while holding only the page shard of the record lock queue; if that is not
+possible, the request is retried while holding lock_sys->latch in X mode,
+because it may have to wait and check for deadlocks.
 @param[in]	impl		if TRUE, no lock is set	if no wait is
 				necessary: we assume that the caller will
 				set an implicit lock
@@ -1964,7 +2009,7 @@ lock_rec_lock(
 	dict_index_t*		index,
 	que_thr_t*		thr)
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(!lock_mutex_own());
 	ut_ad(!srv_read_only_mode);
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_S
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
@@ -1977,20 +2022,38 @@ lock_rec_lock(
 	      || mode - (LOCK_MODE_MASK & mode) == 0);
 	ut_ad(index->is_clustered() || !dict_index_is_online_ddl(index));
 
+	const space_id_t	space = block->page.id.space();
+	const page_no_t		page_no = block->page.id.page_no();
+
 	/* We try a simplified and faster subroutine for the most
 	common cases */
-	switch (lock_rec_lock_fast(impl, mode, block, heap_no, index, thr)) {
+	lock_shard_enter(space, page_no);
+
+	lock_rec_req_status	status = lock_rec_lock_fast(
+		impl, mode, block, heap_no, index, thr);
+
+	lock_shard_exit(space, page_no);
+
+	switch (status) {
 	case LOCK_REC_SUCCESS:
 		return(DB_SUCCESS);
 	case LOCK_REC_SUCCESS_CREATED:
 		return(DB_SUCCESS_LOCKED_REC);
 	case LOCK_REC_FAIL:
-		return(lock_rec_lock_slow(impl, sel_mode, mode, block,
-					  heap_no, index, thr));
+		break;
 	}
 
-	ut_error;
-	return(DB_ERROR);
+	/* The queue may have changed after we released the page shard,
+	but lock_rec_lock_slow() looks at it again from the start. */
+
+	lock_mutex_enter();
+
+	dberr_t	err = lock_rec_lock_slow(
+		impl, sel_mode, mode, block, heap_no, index, thr);
+
+	lock_mutex_exit();
+
+	return(err);
 }
 
 /*********************************************************************//**
@@ -2010,7 +2073,7 @@ lock_rec_has_to_wait_in_queue(
 	ulint		bit_offset;
 	hash_table_t*	hash;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_queue_own(wait_lock));
 	ut_ad(lock_get_wait(wait_lock));
 	ut_ad(lock_get_type_low(wait_lock) == LOCK_REC);
 
@@ -2042,14 +2105,15 @@ lock_rec_has_to_wait_in_queue(
 
 /*************************************************************//**
 Grants a lock to a waiting lock request and releases the waiting transaction.
-The caller must hold lock_sys->mutex but not lock->trx->mutex. */
+The caller must hold lock_sys->latch in X mode, or the page shard of a record
+lock, but not lock->trx->mutex. */
 static
 void
 lock_grant(
 /*=======*/
 	lock_t*	lock)	/*!< in/out: waiting lock request */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_queue_own(lock));
 
 	lock_reset_lock_and_trx_wait(lock);
 
@@ -2233,7 +2297,7 @@ RecLock::lock_add_priority(
 	/* Add the lock to lock hash table. */
 	lock->hash = add_position->hash;
 	add_position->hash = lock;
-	++lock->index->table->n_rec_locks;
+	os_atomic_increment_ulint(&lock->index->table->n_rec_locks, 1);
 
 	return(grant_lock);
 }
@@ -2371,7 +2435,7 @@ lock_rec_dequeue_from_page(
 	trx_lock_t*	trx_lock;
 	hash_table_t*	lock_hash;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_queue_own(in_lock));
 	ut_ad(lock_get_type_low(in_lock) == LOCK_REC);
 	/* We may or may not be holding in_lock->trx->mutex here. */
 
@@ -2381,7 +2445,7 @@ lock_rec_dequeue_from_page(
 	page_no = in_lock->un_member.rec_lock.page_no;
 
 	ut_ad(in_lock->index->table->n_rec_locks > 0);
-	in_lock->index->table->n_rec_locks--;
+	os_atomic_decrement_ulint(&in_lock->index->table->n_rec_locks, 1);
 
 	lock_hash = lock_hash_get(in_lock->type_mode);
 
@@ -2390,8 +2454,8 @@ lock_rec_dequeue_from_page(
 
 	UT_LIST_REMOVE(trx_lock->trx_locks, in_lock);
 
-	MONITOR_INC(MONITOR_RECLOCK_REMOVED);
-	MONITOR_DEC(MONITOR_NUM_RECLOCK);
+	MONITOR_ATOMIC_INC(MONITOR_RECLOCK_REMOVED);
+	MONITOR_ATOMIC_DEC(MONITOR_NUM_RECLOCK);
 
 	/* Check if waiting locks in the queue can now be granted: grant
 	locks if there are no conflicting locks ahead. Stop at the first
@@ -2433,15 +2497,15 @@ lock_rec_discard(
 	page_no = in_lock->un_member.rec_lock.page_no;
 
 	ut_ad(in_lock->index->table->n_rec_locks > 0);
-	in_lock->index->table->n_rec_locks--;
+	os_atomic_decrement_ulint(&in_lock->index->table->n_rec_locks, 1);
 
 	HASH_DELETE(lock_t, hash, lock_hash_get(in_lock->type_mode),
 			    lock_rec_fold(space, page_no), in_lock);
 
 	UT_LIST_REMOVE(trx_lock->trx_locks, in_lock);
 
-	MONITOR_INC(MONITOR_RECLOCK_REMOVED);
-	MONITOR_DEC(MONITOR_NUM_RECLOCK);
+	MONITOR_ATOMIC_INC(MONITOR_RECLOCK_REMOVED);
+	MONITOR_ATOMIC_DEC(MONITOR_NUM_RECLOCK);
 }
 
 /*************************************************************//**
@@ -4198,7 +4262,10 @@ lock_rec_unlock(
 
 	heap_no = page_rec_get_heap_no(rec);
 
-	lock_mutex_enter();
+	const space_id_t	space = block->page.id.space();
+	const page_no_t		page_no = block->page.id.page_no();
+
+	lock_shard_enter(space, page_no);
 	trx_mutex_enter(trx);
 
 	first_lock = lock_rec_get_first(lock_sys->rec_hash, block, heap_no);
@@ -4213,7 +4280,7 @@ lock_rec_unlock(
 		}
 	}
 
-	lock_mutex_exit();
+	lock_shard_exit(space, page_no);
 	trx_mutex_exit(trx);
 
 	stmt = innobase_get_stmt_unsafe(trx->mysql_thd, &stmt_len);
@@ -4244,7 +4311,7 @@ released:
 		}
 	}
 
-	lock_mutex_exit();
+	lock_shard_exit(space, page_no);
 	trx_mutex_exit(trx);
 }
 
@@ -4291,7 +4358,11 @@ lock_check_dict_lock(
 
 /*********************************************************************//**
 Releases transaction locks, and releases possible other transactions waiting
-because of these locks. */
+because of these locks. The record locks are released first, while holding
+lock_sys->latch in S mode and the page shard mutex of each lock, so that
+transactions that release locks on different pages do not serialize. The
+table locks are then released while holding lock_sys->latch in X mode. The
+caller must hold lock_sys->latch in S mode; it is released by this function. */
 static
 void
 lock_release(
@@ -4302,10 +4373,58 @@ lock_release(
 	ulint		count = 0;
 	trx_id_t	max_trx_id = trx_sys_get_max_trx_id();
 
-	ut_ad(lock_mutex_own());
+	ut_ad(rw_lock_own(&lock_sys->latch, RW_LOCK_S));
 	ut_ad(!trx_mutex_own(trx));
 	ut_ad(!trx->is_dd_trx);
 
+	/* No other thread modifies the list of our record locks while we
+	hold the latch in S mode, because the transaction is no longer
+	active and only we release its locks. */
+
+	for (lock = UT_LIST_GET_LAST(trx->lock.trx_locks); lock != NULL; ) {
+
+		lock_t*	prev = UT_LIST_GET_PREV(trx_locks, lock);
+
+		if (lock_get_type_low(lock) == LOCK_REC) {
+
+			ut_d(lock_check_dict_lock(lock));
+
+			LockMutex*	mutex = lock_shard_mutex(
+				lock->un_member.rec_lock.space,
+				lock->un_member.rec_lock.page_no);
+
+			mutex_enter(mutex);
+
+			lock_rec_dequeue_from_page(lock);
+
+			mutex_exit(mutex);
+
+			if (++count == LOCK_RELEASE_INTERVAL) {
+				/* Release the latch for a while, so that
+				we do not block the threads that wait for
+				it in X mode. They may move our locks to
+				other pages, therefore start again from the
+				end of the list. */
+
+				rw_lock_s_unlock(&lock_sys->latch);
+
+				rw_lock_s_lock(&lock_sys->latch);
+
+				prev = UT_LIST_GET_LAST(trx->lock.trx_locks);
+
+				count = 0;
+			}
+		}
+
+		lock = prev;
+	}
+
+	rw_lock_s_unlock(&lock_sys->latch);
+
+	lock_mutex_enter();
+
+	count = 0;
+
 	for (lock = UT_LIST_GET_LAST(trx->lock.trx_locks);
 	     lock != NULL;
 	     lock = UT_LIST_GET_LAST(trx->lock.trx_locks)) {
@@ -4346,6 +4465,8 @@ lock_release(
 
 		++count;
 	}
+
+	lock_mutex_exit();
 }
 
 /* True if a lock mode is S or X */
@@ -4480,7 +4601,7 @@ lock_remove_recovered_trx_record_locks(
 			continue;
 		}
 
-		/* Because we are holding the lock_sys->mutex,
+		/* Because we are holding the lock_sys->latch,
 		implicit locks cannot be converted to explicit ones
 		while we are scanning the explicit locks. */
 
@@ -5304,7 +5425,7 @@ lock_table_queue_validate(
 		/* lock->trx->state cannot change from or to NOT_STARTED
 		while we are holding the trx_sys->mutex. It may change
 		from ACTIVE to PREPARED, but it may not change to
-		COMMITTED, because we are holding the lock_sys->mutex. */
+		COMMITTED, because we are holding the lock_sys->latch. */
 		ut_ad(trx_assert_started(lock->trx));
 
 		if (!lock_get_wait(lock)) {
@@ -5394,7 +5515,7 @@ lock_rec_queue_validate(
 
 		ut_ad(lock_mutex_own());
 		/* impl_trx cannot be committed until lock_mutex_exit()
-		because lock_trx_release_locks() acquires lock_sys->mutex */
+		because lock_trx_release_locks() acquires lock_sys->latch */
 
 		if (impl_trx != NULL) {
 			const lock_t*	other_lock
@@ -5996,16 +6117,12 @@ lock_clust_rec_modify_check_and_lock(
 
 	lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 
-	lock_mutex_enter();
-
 	ut_ad(lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 
 	err = lock_rec_lock(TRUE, SELECT_ORDINARY, LOCK_X | LOCK_REC_NOT_GAP,
 			    block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -6056,16 +6173,12 @@ lock_sec_rec_modify_check_and_lock(
 	index record, and this would not have been possible if another active
 	transaction had modified this secondary index record. */
 
-	lock_mutex_enter();
-
 	ut_ad(lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 
 	err = lock_rec_lock(TRUE, SELECT_ORDINARY, LOCK_X | LOCK_REC_NOT_GAP,
 			    block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 #ifdef UNIV_DEBUG
 	{
@@ -6159,8 +6272,6 @@ lock_sec_rec_read_check_and_lock(
 		lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 	}
 
-	lock_mutex_enter();
-
 	ut_ad(mode != LOCK_X
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 	ut_ad(mode != LOCK_S
@@ -6169,9 +6280,7 @@ lock_sec_rec_read_check_and_lock(
 	err = lock_rec_lock(FALSE, sel_mode, mode | gap_mode,
 			    block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -6235,8 +6344,6 @@ lock_clust_rec_read_check_and_lock(
 		lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 	}
 
-	lock_mutex_enter();
-
 	ut_ad(mode != LOCK_X
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 	ut_ad(mode != LOCK_S
@@ -6244,9 +6351,7 @@ lock_clust_rec_read_check_and_lock(
 
 	err = lock_rec_lock(FALSE, sel_mode, mode | gap_mode, block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -6714,12 +6819,14 @@ lock_trx_release_locks(
 
 	release_lock = (UT_LIST_GET_LEN(trx->lock.trx_locks) > 0);
 
-	/* Don't take lock_sys mutex if trx didn't acquire any lock. */
+	/* Don't take lock_sys latch if trx didn't acquire any lock. */
 	if (release_lock) {
 
 		/* The transition of trx->state to TRX_STATE_COMMITTED_IN_MEMORY
-		is protected by both the lock_sys->mutex and the trx->mutex. */
-		lock_mutex_enter();
+		is protected by both the lock_sys->latch and the trx->mutex.
+		S mode is enough, because the threads that look at the state
+		without holding the trx->mutex hold the latch in X mode. */
+		rw_lock_s_lock(&lock_sys->latch);
 	}
 
 	trx_mutex_enter(trx);
@@ -6746,7 +6853,7 @@ lock_trx_release_locks(
 
 		ut_a(release_lock);
 
-		lock_mutex_exit();
+		rw_lock_s_unlock(&lock_sys->latch);
 
 		while (trx_is_referenced(trx)) {
 
@@ -6763,7 +6870,7 @@ lock_trx_release_locks(
 
 		trx_mutex_exit(trx);
 
-		lock_mutex_enter();
+		rw_lock_s_lock(&lock_sys->latch);
 
 		trx_mutex_enter(trx);
 	}
@@ -6787,9 +6894,8 @@ lock_trx_release_locks(
 
 	if (release_lock) {
 
+		/* Releases the lock_sys->latch. */
 		lock_release(trx);
-
-		lock_mutex_exit();
 	}
 
 	trx->lock.n_rec_locks = 0;
@@ -7487,6 +7593,11 @@ DeadlockChecker::check_and_resolve(const lock_t* lock, trx_t* trx)
 		return(trx);
 	} else if (!innobase_deadlock_detect) {
 		return(NULL);
+	} else if (innobase_deadlock_detect_async) {
+		/* The wait-for graph will be searched by
+		lock_deadlock_detector_thread(), which is woken up
+		when this transaction suspends for the lock wait. */
+		return(NULL);
 	}
 
 	/*  Release the mutex to obey the latching order.
@@ -7548,6 +7659,484 @@ DeadlockChecker::check_and_resolve(const lock_t* lock, trx_t* trx)
 	return(victim_trx);
 }
 
+/** Call a functor for each lock that is ahead of a waiting lock in its
+queue and that the waiting lock has to wait for.
+@param[in]	wait_lock	waiting record or table lock
+@param[in,out]	f		functor called with each blocking lock */
+template <typename F>
+static
+void
+lock_wait_for_each_blocker(const lock_t* wait_lock, F& f)
+{
+	ut_ad(lock_mutex_own());
+	ut_ad(lock_get_wait(wait_lock));
+
+	if (lock_get_type_low(wait_lock) == LOCK_REC) {
+		ulint		heap_no = lock_rec_find_set_bit(wait_lock);
+		const lock_t*	lock = lock_rec_get_first_on_page_addr(
+			lock_hash_get(wait_lock->type_mode),
+			wait_lock->un_member.rec_lock.space,
+			wait_lock->un_member.rec_lock.page_no);
+
+		if (!lock_rec_get_nth_bit(lock, heap_no)) {
+			lock = lock_rec_get_next_const(heap_no, lock);
+		}
+
+		for (; lock != wait_lock && lock != NULL;
+		     lock = lock_rec_get_next_const(heap_no, lock)) {
+
+			if (lock_has_to_wait(wait_lock, lock)) {
+				f(lock);
+			}
+		}
+	} else {
+		ut_ad(lock_get_type_low(wait_lock) == LOCK_TABLE);
+
+		for (const lock_t* lock = UT_LIST_GET_PREV(
+			     un_member.tab_lock.locks, wait_lock);
+		     lock != NULL;
+		     lock = UT_LIST_GET_PREV(un_member.tab_lock.locks, lock)) {
+
+			if (lock_has_to_wait(wait_lock, lock)) {
+				f(lock);
+			}
+		}
+	}
+}
+
+/** Background deadlock detector. Instead of searching the wait-for graph
+each time a lock wait is enqueued, lock_deadlock_detector_thread() takes
+a snapshot of the graph, searches it for cycles without holding
+lock_sys->latch and resolves the cycles that still exist afterwards. */
+class DeadlockDetector {
+public:
+	/** Take a snapshot of the wait-for graph, search it for cycles
+	and roll back one transaction of each cycle that is still there. */
+	void run();
+
+private:
+	/** A waiting transaction in the snapshot */
+	struct node_t {
+		const trx_t*	m_trx;		/*!< Waiting transaction */
+		const lock_t*	m_wait_lock;	/*!< Lock that m_trx waits
+						for */
+		ulint		m_weight;	/*!< TRX_WEIGHT() of m_trx */
+		bool		m_high_priority;/*!< true if m_trx must not
+						be chosen as a victim */
+		ulint		m_first_edge;	/*!< Offset of the first
+						outgoing edge in m_edges */
+		ulint		m_n_edges;	/*!< Number of outgoing
+						edges */
+	};
+
+	typedef std::vector<node_t, ut_allocator<node_t> >	nodes_t;
+	typedef std::vector<ulint, ut_allocator<ulint> >	ulint_vec_t;
+
+	/** Order nodes by transaction, for lookups in the snapshot */
+	struct node_less {
+		bool operator()(const node_t& lhs, const node_t& rhs) const
+		{
+			return(lhs.m_trx < rhs.m_trx);
+		}
+	};
+
+	/** Collects the waiting transactions that block a lock */
+	struct collect_t {
+		DeadlockDetector*	m_detector;	/*!< The snapshot */
+
+		void operator()(const lock_t* lock)
+		{
+			ulint	i = m_detector->find(lock->trx);
+
+			if (i != ULINT_UNDEFINED) {
+				m_detector->m_edges.push_back(i);
+			}
+		}
+	};
+
+	/** Checks whether a given transaction blocks a lock */
+	struct match_t {
+		const trx_t*	m_trx;		/*!< Blocking transaction */
+		bool		m_found;	/*!< true if m_trx blocks */
+
+		void operator()(const lock_t* lock)
+		{
+			m_found = m_found || lock->trx == m_trx;
+		}
+	};
+
+	/** Look up a transaction in the snapshot.
+	@param[in]	trx	transaction
+	@return index of trx in m_nodes, or ULINT_UNDEFINED if it was not
+	waiting */
+	ulint find(const trx_t* trx) const;
+
+	/** Copy the waiting transactions and the edges between them.
+	@return true if there are at least two waiting transactions */
+	bool snapshot();
+
+	/** Search the snapshot for a cycle that goes through nodes that
+	have not been chosen as victims yet.
+	@return true if a cycle was found and copied to m_cycle */
+	bool search();
+
+	/** Pick the transaction to roll back in m_cycle.
+	@return index of the victim in m_nodes */
+	ulint select_victim() const;
+
+	/** Check that m_cycle still exists and resolve it.
+	@param[in]	victim	index of the victim in m_nodes
+	@return true if the victim was rolled back */
+	bool resolve(ulint victim);
+
+	/** Waiting transactions, sorted by node_less */
+	nodes_t		m_nodes;
+
+	/** Outgoing edges of the nodes: indexes of blocking nodes */
+	ulint_vec_t	m_edges;
+
+	/** DFS state of each node: 0 unvisited, 1 on the stack,
+	2 searched, 3 chosen as a victim */
+	ulint_vec_t	m_state;
+
+	/** DFS stack of node indexes */
+	ulint_vec_t	m_stack;
+
+	/** Next edge to follow for each node on m_stack */
+	ulint_vec_t	m_next;
+
+	/** Last cycle that was found, as indexes in m_nodes */
+	ulint_vec_t	m_cycle;
+};
+
+/** Look up a transaction in the snapshot.
+@param[in]	trx	transaction
+@return index of trx in m_nodes, or ULINT_UNDEFINED if it was not waiting */
+ulint
+DeadlockDetector::find(const trx_t* trx) const
+{
+	node_t	key;
+
+	key.m_trx = trx;
+
+	nodes_t::const_iterator	it = std::lower_bound(
+		m_nodes.begin(), m_nodes.end(), key, node_less());
+
+	if (it == m_nodes.end() || it->m_trx != trx) {
+		return(ULINT_UNDEFINED);
+	}
+
+	return(it - m_nodes.begin());
+}
+
+/** Copy the waiting transactions and the edges between them.
+@return true if there are at least two waiting transactions */
+bool
+DeadlockDetector::snapshot()
+{
+	m_nodes.clear();
+	m_edges.clear();
+
+	lock_wait_mutex_enter();
+
+	if (lock_sys->last_slot - lock_sys->waiting_threads < 2) {
+		lock_wait_mutex_exit();
+		return(false);
+	}
+
+	lock_mutex_enter();
+
+	for (const srv_slot_t* slot = lock_sys->waiting_threads;
+	     slot < lock_sys->last_slot;
+	     ++slot) {
+
+		if (!slot->in_use) {
+			continue;
+		}
+
+		const trx_t*	trx = thr_get_trx(slot->thr);
+
+		if (trx->lock.que_state != TRX_QUE_LOCK_WAIT
+		    || trx->lock.wait_lock == NULL) {
+			continue;
+		}
+
+		node_t	node;
+
+		node.m_trx = trx;
+		node.m_wait_lock = trx->lock.wait_lock;
+		node.m_weight = TRX_WEIGHT(trx);
+		node.m_high_priority = trx_is_high_priority(trx);
+		node.m_first_edge = 0;
+		node.m_n_edges = 0;
+
+		m_nodes.push_back(node);
+	}
+
+	lock_wait_mutex_exit();
+
+	std::sort(m_nodes.begin(), m_nodes.end(), node_less());
+
+	collect_t	collect;
+
+	collect.m_detector = this;
+
+	for (nodes_t::iterator it = m_nodes.begin();
+	     it != m_nodes.end();
+	     ++it) {
+
+		it->m_first_edge = m_edges.size();
+
+		lock_wait_for_each_blocker(it->m_wait_lock, collect);
+
+		it->m_n_edges = m_edges.size() - it->m_first_edge;
+	}
+
+	lock_mutex_exit();
+
+	m_state.assign(m_nodes.size(), 0);
+
+	return(m_nodes.size() > 1);
+}
+
+/** Search the snapshot for a cycle that goes through nodes that have not
+been chosen as victims yet.
+@return true if a cycle was found and copied to m_cycle */
+bool
+DeadlockDetector::search()
+{
+	for (ulint i = 0; i < m_state.size(); ++i) {
+		if (m_state[i] != 3) {
+			m_state[i] = 0;
+		}
+	}
+
+	for (ulint start = 0; start < m_nodes.size(); ++start) {
+
+		if (m_state[start] != 0) {
+			continue;
+		}
+
+		m_stack.clear();
+		m_next.clear();
+
+		m_stack.push_back(start);
+		m_next.push_back(0);
+		m_state[start] = 1;
+
+		while (!m_stack.empty()) {
+			const node_t&	node = m_nodes[m_stack.back()];
+			ulint&		next = m_next.back();
+
+			if (next == node.m_n_edges) {
+				/* All edges searched, backtrack. */
+				m_state[m_stack.back()] = 2;
+				m_stack.pop_back();
+				m_next.pop_back();
+				continue;
+			}
+
+			ulint	to = m_edges[node.m_first_edge + next++];
+
+			switch (m_state[to]) {
+			case 0:
+				m_stack.push_back(to);
+				m_next.push_back(0);
+				m_state[to] = 1;
+				break;
+			case 1:
+				/* Found a cycle: the part of the stack
+				from the node that closes it. */
+				m_cycle.assign(
+					std::find(m_stack.begin(),
+						  m_stack.end(), to),
+					m_stack.end());
+				return(true);
+			}
+		}
+	}
+
+	return(false);
+}
+
+/** Pick the transaction to roll back in m_cycle. Like
+DeadlockChecker::select_victim(), prefer the transaction that has done
+the least work, but never pick a high priority transaction if another
+one can be picked.
+@return index of the victim in m_nodes */
+ulint
+DeadlockDetector::select_victim() const
+{
+	ulint	victim = m_cycle.front();
+
+	for (ulint_vec_t::const_iterator it = m_cycle.begin();
+	     it != m_cycle.end();
+	     ++it) {
+
+		const node_t&	node = m_nodes[*it];
+		const node_t&	best = m_nodes[victim];
+
+		if (node.m_high_priority != best.m_high_priority) {
+			if (!node.m_high_priority) {
+				victim = *it;
+			}
+		} else if (node.m_weight < best.m_weight) {
+			victim = *it;
+		}
+	}
+
+	return(victim);
+}
+
+/** Check that m_cycle still exists and resolve it. The transactions in
+the cycle cannot have released any lock while they were waiting, so the
+cycle still exists if each of them waits for the same lock as in the
+snapshot and is still blocked by the next one.
+@param[in]	victim	index of the victim in m_nodes
+@return true if the victim was rolled back */
+bool
+DeadlockDetector::resolve(ulint victim)
+{
+	lock_mutex_enter();
+
+	for (ulint i = 0; i < m_cycle.size(); ++i) {
+		const node_t&	node = m_nodes[m_cycle[i]];
+		const node_t&	next = m_nodes[
+			m_cycle[(i + 1) % m_cycle.size()]];
+
+		if (node.m_trx->lock.wait_lock != node.m_wait_lock) {
+			lock_mutex_exit();
+			return(false);
+		}
+
+		match_t	match;
+
+		match.m_trx = next.m_trx;
+		match.m_found = false;
+
+		lock_wait_for_each_blocker(node.m_wait_lock, match);
+
+		if (!match.m_found) {
+			lock_mutex_exit();
+			return(false);
+		}
+	}
+
+	DeadlockChecker::start_print();
+
+	for (ulint i = 0; i < m_cycle.size(); ++i) {
+		const node_t&	node = m_nodes[m_cycle[i]];
+		char		buf[80];
+
+		snprintf(buf, sizeof(buf), "\n*** (" ULINTPF ") TRANSACTION:\n",
+			 i + 1);
+		DeadlockChecker::print(buf);
+
+		DeadlockChecker::print(node.m_trx, 3000);
+
+		snprintf(buf, sizeof(buf),
+			 "*** (" ULINTPF ") WAITING FOR THIS LOCK"
+			 " TO BE GRANTED:\n", i + 1);
+		DeadlockChecker::print(buf);
+
+		DeadlockChecker::print(node.m_wait_lock);
+	}
+
+	char	buf[64];
+
+	snprintf(buf, sizeof(buf), "*** WE ROLL BACK TRANSACTION (" ULINTPF
+		 ")\n", ulint(std::find(m_cycle.begin(), m_cycle.end(), victim)
+			      - m_cycle.begin()) + 1);
+	DeadlockChecker::print(buf);
+
+	trx_t*	trx = m_nodes[victim].m_wait_lock->trx;
+
+	trx_mutex_enter(trx);
+
+	trx->lock.was_chosen_as_deadlock_victim = true;
+
+	lock_cancel_waiting_and_release(trx->lock.wait_lock);
+
+	trx_mutex_exit(trx);
+
+	lock_deadlock_found = true;
+
+	lock_mutex_exit();
+
+	return(true);
+}
+
+/** Take a snapshot of the wait-for graph, search it for cycles and roll
+back one transaction of each cycle that is still there. */
+void
+DeadlockDetector::run()
+{
+	if (!snapshot()) {
+		return;
+	}
+
+	MONITOR_INC(MONITOR_DEADLOCK_SCAN);
+
+	while (search()) {
+		ulint	victim = select_victim();
+
+		/* Break the cycle in the snapshot, whether or not it
+		still exists, so that the search can go on. */
+		m_state[victim] = 3;
+
+		if (resolve(victim)) {
+			MONITOR_INC(MONITOR_DEADLOCK);
+		} else {
+			MONITOR_INC(MONITOR_DEADLOCK_STALE);
+		}
+	}
+}
+
+/** A thread which searches the wait-for graph for deadlocks in the
+background, when innodb_deadlock_detect_async is set. */
+void
+lock_deadlock_detector_thread()
+{
+	int64_t			sig_count = 0;
+	os_event_t		event = lock_sys->deadlock_event;
+	DeadlockDetector	detector;
+
+	ut_ad(!srv_read_only_mode);
+	ut_ad(lock_sys->deadlock_thread_active);
+
+	while (srv_shutdown_state < SRV_SHUTDOWN_CLEANUP) {
+
+		/* Wake up when a lock wait is suspended, and every second
+		in case innodb_deadlock_detect_async was just enabled. */
+
+		os_event_wait_time_low(event, 1000000, sig_count);
+		sig_count = os_event_reset(event);
+
+		if (srv_shutdown_state >= SRV_SHUTDOWN_CLEANUP) {
+			break;
+		}
+
+		if (innobase_deadlock_detect
+		    && innobase_deadlock_detect_async) {
+
+			detector.run();
+		}
+	}
+
+	lock_sys->deadlock_thread_active = false;
+}
+
+/** Make the deadlock detector thread count as active before it is
+created, so that it is waited for at shutdown even if it has not started
+to run yet. */
+void
+lock_deadlock_detector_thread_starting()
+{
+	ut_ad(!lock_sys->deadlock_thread_active);
+
+	lock_sys->deadlock_thread_active = true;
+}
+
 /**
 Allocate cached locks for the transaction.
 @param trx		allocate cached record locks for this transaction */
@@ -258,6 +258,12 @@ lock_wait_suspend_thread(
 
 	os_event_set(lock_sys->timeout_event);
 
+	/* Let the deadlock detector thread search for cycles */
+
+	if (innobase_deadlock_detect && innobase_deadlock_detect_async) {
+		os_event_set(lock_sys->deadlock_event);
+	}
+
 	lock_wait_mutex_exit();
 	trx_mutex_exit(trx);
 
@@ -396,13 +402,14 @@ lock_wait_release_thread_if_suspended(
 	que_thr_t*	thr)	/*!< in: query thread associated with the
 				user OS thread	 */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_latch_own());
 	ut_ad(trx_mutex_own(thr_get_trx(thr)));
 
-	/* We own both the lock mutex and the trx_t::mutex but not the
-	lock wait mutex. This is OK because other threads will see the state
-	of this slot as being in use and no other thread can change the state
-	of the slot to free unless that thread also owns the lock mutex. */
+	/* We own both the lock_sys->latch (in S or X mode) and the
+	trx_t::mutex but not the lock wait mutex. This is OK because other
+	threads will see the state of this slot as being in use and no other
+	thread can change the state of the slot to free unless that thread
+	owns the lock_sys->latch in X mode. */
 
 	if (thr->slot != NULL && thr->slot->in_use && thr->slot->thr == thr) {
 		trx_t*	trx = thr_get_trx(thr);
@@ -183,6 +183,27 @@ log_downgrade()
 		OS_FILE_LOG_BLOCK_SIZE, buf, group);
 }
 
+/** Wait until all the data for the areas reserved in the log buffer has
+been copied in. The caller must own the log mutex, so that no new areas
+can be reserved meanwhile. The copying threads do not wait for anything
+while a copy is pending, so this will not take long. */
+static
+void
+log_buffer_wait_for_copies()
+{
+	ut_ad(log_mutex_own());
+
+	for (ulint i = 0; log_sys->n_pending_copies > 0; ++i) {
+		if (i < srv_n_spin_wait_rounds) {
+			ut_delay(ut_rnd_interval(0, srv_spin_wait_delay));
+		} else {
+			os_thread_yield();
+		}
+	}
+
+	os_rmb;
+}
+
 /** Extends the log buffer.
 @param[in]	len	requested minimum size in bytes */
 void
@@ -235,6 +256,8 @@ log_buffer_extend(
 		log_mutex_enter_all();
 	}
 
+	log_buffer_wait_for_copies();
+
 	move_start = ut_calc_align_down(
 		log_sys->buf_free,
 		OS_FILE_LOG_BLOCK_SIZE);
@@ -371,7 +394,8 @@ log_margin_checkpoint_age(
 	return;
 }
 
-/** Open the log for log_write_low. The log must be closed with log_close.
+/** Open the log for log_buffer_reserve. The log must be closed with
+log_close.
 @param[in]	len	length of the data to be written
 @return start lsn of the log record */
 lsn_t
@@ -426,74 +450,64 @@ loop:
 	return(log_sys->lsn);
 }
 
-/************************************************************//**
-Writes to the log the string given. It is assumed that the caller holds the
-log mutex. */
-void
-log_write_low(
-/*==========*/
-	const byte*	str,		/*!< in: string */
-	ulint		str_len)	/*!< in: string length */
+/** Reserve space for a log record group in the log buffer. The log block
+headers of the reserved area are prepared, and log_sys->lsn and
+log_sys->buf_free are advanced past it, so that the log mutex can be
+released before the data is copied in with log_buffer_write(). The log
+buffer is not switched or moved until log_buffer_write_completed() is
+called. It is assumed that the caller holds the log mutex.
+@param[in]	len	length of the data
+@return offset of the reserved area within log_sys->buf */
+ulint
+log_buffer_reserve(
+	ulint	len)
 {
 	log_t*	log	= log_sys;
-	ulint	len;
-	ulint	data_len;
-	byte*	log_block;
+	ulint	offset	= log->buf_free;
 
 	ut_ad(log_mutex_own());
-part_loop:
-	/* Calculate a part length */
-
-	data_len = (log->buf_free % OS_FILE_LOG_BLOCK_SIZE) + str_len;
-
-	if (data_len <= OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
-
-		/* The string fits within the current log block */
-
-		len = str_len;
-	} else {
-		data_len = OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE;
-
-		len = OS_FILE_LOG_BLOCK_SIZE
-			- (log->buf_free % OS_FILE_LOG_BLOCK_SIZE)
-			- LOG_BLOCK_TRL_SIZE;
-	}
-
-	ut_memcpy(log->buf + log->buf_free, str, len);
+	ut_ad(len > 0);
 
-	str_len -= len;
-	str = str + len;
+	ulint	framed_len = log_buffer_frame(
+		log->buf, offset, log->lsn, len, log->next_checkpoint_no);
 
-	log_block = static_cast<byte*>(
-		ut_align_down(
-			log->buf + log->buf_free, OS_FILE_LOG_BLOCK_SIZE));
+	log->lsn += framed_len;
+	log->buf_free += framed_len;
 
-	log_block_set_data_len(log_block, data_len);
+	ut_ad(log->buf_free <= log->buf_size);
 
-	if (data_len == OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
-		/* This block became full */
-		log_block_set_data_len(log_block, OS_FILE_LOG_BLOCK_SIZE);
-		log_block_set_checkpoint_no(log_block,
-					    log_sys->next_checkpoint_no);
-		len += LOG_BLOCK_HDR_SIZE + LOG_BLOCK_TRL_SIZE;
+	os_atomic_increment_ulint(&log->n_pending_copies, 1);
 
-		log->lsn += len;
+	return(offset);
+}
 
-		/* Initialize the next block header */
-		log_block_init(log_block + OS_FILE_LOG_BLOCK_SIZE, log->lsn);
-	} else {
-		log->lsn += len;
-	}
+/** Copy data into an area of the log buffer that was reserved with
+log_buffer_reserve(). Does not require the log mutex.
+@param[in]	offset	offset within log_sys->buf to copy to
+@param[in]	str	data to copy
+@param[in]	len	length of the data
+@return offset within log_sys->buf following the copied data */
+ulint
+log_buffer_write(
+	ulint		offset,
+	const byte*	str,
+	ulint		len)
+{
+	ut_ad(log_sys->n_pending_copies > 0);
 
-	log->buf_free += len;
+	srv_stats.log_write_requests.inc();
 
-	ut_ad(log->buf_free <= log->buf_size);
+	return(log_buffer_copy(log_sys->buf, offset, str, len));
+}
 
-	if (str_len > 0) {
-		goto part_loop;
-	}
+/** Note that all data for a reservation made by log_buffer_reserve()
+has been copied to the log buffer. Does not require the log mutex. */
+void
+log_buffer_write_completed()
+{
+	ulint	n = os_atomic_decrement_ulint(&log_sys->n_pending_copies, 1);
 
-	srv_stats.log_write_requests.inc();
+	ut_a(n != ULINT_UNDEFINED);
 }
 
 /************************************************************//**
@@ -828,6 +842,19 @@ log_init(void)
 
 	os_event_set(log_sys->flush_event);
 
+	log_sys->writer_event = os_event_create(0);
+	log_sys->flusher_event = os_event_create(0);
+
+	log_sys->write_events = static_cast<os_event_t*>(
+		ut_zalloc_nokey(LOG_N_WAIT_EVENTS * sizeof(os_event_t)));
+	log_sys->flush_events = static_cast<os_event_t*>(
+		ut_zalloc_nokey(LOG_N_WAIT_EVENTS * sizeof(os_event_t)));
+
+	for (ulint i = 0; i < LOG_N_WAIT_EVENTS; ++i) {
+		log_sys->write_events[i] = os_event_create(0);
+		log_sys->flush_events[i] = os_event_create(0);
+	}
+
 	/*----------------------------*/
 
 	log_sys->last_checkpoint_lsn = log_sys->lsn;
@@ -1454,8 +1481,9 @@ wait and check if an already running write is covering the request.
 included in the redo log file write
 @param[in]	flush_to_disk	whether the written log should also
 be flushed to the file system */
+static
 void
-log_write_up_to(
+log_write_up_to_low(
 	lsn_t	lsn,
 	bool	flush_to_disk)
 {
@@ -1567,6 +1595,11 @@ loop:
 		}
 	}
 
+	/* Mini-transactions copy their log records to the log buffer
+	after releasing the log mutex. Let the copies to the area that
+	we are about to write finish. */
+	log_buffer_wait_for_copies();
+
 	start_offset = log_sys->buf_next_to_write;
 	end_offset = log_sys->buf_free;
 
@@ -1648,6 +1681,306 @@ loop:
 	}
 }
 
+/** Raise a requested lsn to at least the given lsn.
+@param[in,out]	requested	requested lsn
+@param[in]	lsn		lsn to request */
+static
+void
+log_request_lsn(
+	volatile lsn_t*	requested,
+	lsn_t		lsn)
+{
+	for (lsn_t old = *requested; old < lsn; old = *requested) {
+		if (os_compare_and_swap_uint64(requested, old, lsn)) {
+			break;
+		}
+	}
+}
+
+/** Wake up the threads waiting for the log to be written or flushed up to
+an lsn between two given lsns.
+@param[in]	events		log_sys->write_events or log_sys->flush_events
+@param[in]	old_lsn		lsn up to which the waiters were woken up
+@param[in]	new_lsn		lsn up to which the log was written or flushed
+*/
+static
+void
+log_wake_waiters(
+	os_event_t*	events,
+	lsn_t		old_lsn,
+	lsn_t		new_lsn)
+{
+	if (new_lsn <= old_lsn) {
+		return;
+	}
+
+	lsn_t	first = old_lsn / OS_FILE_LOG_BLOCK_SIZE;
+	lsn_t	last = new_lsn / OS_FILE_LOG_BLOCK_SIZE;
+
+	if (last - first >= LOG_N_WAIT_EVENTS) {
+		last = first + LOG_N_WAIT_EVENTS - 1;
+	}
+
+	for (lsn_t i = first; i <= last; ++i) {
+		os_event_set(events[i % LOG_N_WAIT_EVENTS]);
+	}
+}
+
+/** Check if log_write_up_to() can leave the work to the log writer
+and log flusher threads.
+@return true if the log writer and log flusher threads are running */
+static inline
+bool
+log_use_writer_threads()
+{
+#if UNIV_WORD_SIZE > 7
+	/* The waiting threads do dirty reads of write_lsn and
+	flushed_to_disk_lsn. */
+	return(srv_log_writer_threads
+	       && log_sys->writer_thread_active
+	       && log_sys->flusher_thread_active);
+#else
+	return(false);
+#endif /* UNIV_WORD_SIZE > 7 */
+}
+
+/** Wait until the log writer thread (and the log flusher thread, if
+requested) has written the log up to the given lsn.
+@param[in]	lsn		log sequence number that should be
+included in the redo log file write
+@param[in]	flush_to_disk	whether the written log should also
+be flushed to the file system */
+static
+void
+log_wait_for_lsn(
+	lsn_t	lsn,
+	bool	flush_to_disk)
+{
+	const volatile lsn_t*	done_lsn;
+	os_event_t		event;
+
+	if (flush_to_disk) {
+		done_lsn = &log_sys->flushed_to_disk_lsn;
+		event = log_sys->flush_events[
+			(lsn / OS_FILE_LOG_BLOCK_SIZE) % LOG_N_WAIT_EVENTS];
+
+		log_request_lsn(&log_sys->flush_requested_lsn, lsn);
+
+		MONITOR_ATOMIC_INC(MONITOR_LOG_ON_FLUSH_WAITS);
+	} else {
+		done_lsn = &log_sys->write_lsn;
+		event = log_sys->write_events[
+			(lsn / OS_FILE_LOG_BLOCK_SIZE) % LOG_N_WAIT_EVENTS];
+
+		MONITOR_ATOMIC_INC(MONITOR_LOG_ON_WRITE_WAITS);
+	}
+
+	log_request_lsn(&log_sys->write_requested_lsn, lsn);
+
+	if (log_sys->write_lsn >= lsn) {
+		os_event_set(log_sys->flusher_event);
+	} else {
+		os_event_set(log_sys->writer_event);
+	}
+
+	uintmax_t	start_time = ut_time_us(NULL);
+
+	for (ulint i = 0;
+	     i < srv_log_wait_for_flush_spin_rounds && *done_lsn < lsn;
+	     ++i) {
+		ut_delay(ut_rnd_interval(0, srv_spin_wait_delay));
+	}
+
+	while (*done_lsn < lsn) {
+		int64_t	sig_count = os_event_reset(event);
+
+		if (*done_lsn >= lsn) {
+			break;
+		}
+
+		if (!log_use_writer_threads()) {
+			/* The log threads are exiting at shutdown,
+			or were disabled meanwhile. */
+			log_write_up_to_low(lsn, flush_to_disk);
+			break;
+		}
+
+		/* Time out now and then to recheck the above, in case
+		a log thread exited without us noticing. */
+		os_event_wait_time_low(event, 100000, sig_count);
+	}
+
+	MONITOR_INC_TIME_IN_MICRO_SECS(MONITOR_LOG_LSN_WAIT_TIME, start_time);
+}
+
+/** Ensure that the log has been written to the log file up to a given
+log entry (such as that of a transaction commit). If the log writer
+threads are enabled, wait for them to do it, otherwise start a new write,
+or wait and check if an already running write is covering the request.
+@param[in]	lsn		log sequence number that should be
+included in the redo log file write, LSN_MAX for all of the log
+@param[in]	flush_to_disk	whether the written log should also
+be flushed to the file system */
+void
+log_write_up_to(
+	lsn_t	lsn,
+	bool	flush_to_disk)
+{
+	ut_ad(!srv_read_only_mode);
+
+	if (recv_no_ibuf_operations || !log_use_writer_threads()) {
+		log_write_up_to_low(lsn, flush_to_disk);
+		return;
+	}
+
+	if (lsn == LSN_MAX) {
+		lsn = log_get_lsn();
+	}
+
+	const lsn_t	done_lsn = flush_to_disk
+		? log_sys->flushed_to_disk_lsn
+		: log_sys->write_lsn;
+
+	if (done_lsn < lsn) {
+		log_wait_for_lsn(lsn, flush_to_disk);
+	}
+}
+
+/** The log writer thread. It writes the log buffer to the log files
+whenever it is woken up by a thread waiting in log_write_up_to(), and
+at least once per second. Threads waiting for the write are woken up
+through log_sys->write_events. */
+void
+log_writer_thread()
+{
+	my_thread_init();
+
+	ut_ad(!srv_read_only_mode);
+
+	lsn_t	notified_write_lsn = log_sys->write_lsn;
+	lsn_t	notified_flush_lsn = log_sys->flushed_to_disk_lsn;
+
+	ut_ad(log_sys->writer_thread_active);
+
+	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+		int64_t	sig_count = os_event_reset(log_sys->writer_event);
+
+		if (log_sys->write_lsn >= log_sys->write_requested_lsn) {
+			os_event_wait_time_low(
+				log_sys->writer_event, 1000000, sig_count);
+			continue;
+		}
+
+		/* Write all of the log that has been generated so far:
+		the threads that requested the write and all threads that
+		came after them are served by the same write. */
+		log_write_up_to_low(log_get_lsn(), false);
+
+		log_wake_waiters(log_sys->write_events,
+				 notified_write_lsn, log_sys->write_lsn);
+		notified_write_lsn = log_sys->write_lsn;
+
+		/* With O_DSYNC the write also flushed the log. */
+		log_wake_waiters(log_sys->flush_events,
+				 notified_flush_lsn,
+				 log_sys->flushed_to_disk_lsn);
+		notified_flush_lsn = log_sys->flushed_to_disk_lsn;
+
+		if (log_sys->flushed_to_disk_lsn
+		    < log_sys->flush_requested_lsn) {
+			os_event_set(log_sys->flusher_event);
+		}
+	}
+
+	log_sys->writer_thread_active = false;
+
+	/* Let the waiting threads do their writes themselves. */
+	log_wake_waiters(log_sys->write_events, 0, LSN_MAX);
+	log_wake_waiters(log_sys->flush_events, 0, LSN_MAX);
+
+	my_thread_end();
+}
+
+/** The log flusher thread. It flushes the written log to disk whenever
+a thread is waiting for that in log_write_up_to(), and at least once per
+second. Threads waiting for the flush are woken up through
+log_sys->flush_events. */
+void
+log_flusher_thread()
+{
+	my_thread_init();
+
+	ut_ad(!srv_read_only_mode);
+
+	lsn_t	notified_flush_lsn = log_sys->flushed_to_disk_lsn;
+
+	ut_ad(log_sys->flusher_thread_active);
+
+	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+		int64_t	sig_count = os_event_reset(log_sys->flusher_event);
+
+		const lsn_t	write_lsn = log_sys->write_lsn;
+
+		if (log_sys->flushed_to_disk_lsn
+		    >= log_sys->flush_requested_lsn
+		    || log_sys->flushed_to_disk_lsn >= write_lsn) {
+			/* Nothing requested, or the log writer thread
+			has not yet written what was requested. */
+			os_event_wait_time_low(
+				log_sys->flusher_event, 1000000, sig_count);
+			continue;
+		}
+
+		/* Flush what has been written so far. The log writer
+		thread keeps writing meanwhile. */
+		log_write_up_to_low(write_lsn, true);
+
+		log_wake_waiters(log_sys->flush_events,
+				 notified_flush_lsn,
+				 log_sys->flushed_to_disk_lsn);
+		notified_flush_lsn = log_sys->flushed_to_disk_lsn;
+	}
+
+	log_sys->flusher_thread_active = false;
+
+	log_wake_waiters(log_sys->flush_events, 0, LSN_MAX);
+
+	my_thread_end();
+}
+
+/** Make the log writer and log flusher threads count as active before
+they are created, so that they are waited for at shutdown even if they
+have not started to run yet. */
+void
+log_writer_threads_starting()
+{
+	ut_ad(!log_sys->writer_thread_active);
+	ut_ad(!log_sys->flusher_thread_active);
+
+	log_sys->writer_thread_active = true;
+	log_sys->flusher_thread_active = true;
+}
+
+/** Wake up the log writer and log flusher threads so that they notice
+a shutdown.
+@return name of the log thread that is still active, or NULL */
+const char*
+log_writer_threads_active()
+{
+	const char*	thread_active = NULL;
+
+	if (log_sys->writer_thread_active) {
+		thread_active = "log_writer_thread";
+	} else if (log_sys->flusher_thread_active) {
+		thread_active = "log_flusher_thread";
+	}
+
+	os_event_set(log_sys->writer_event);
+	os_event_set(log_sys->flusher_event);
+
+	return(thread_active);
+}
+
 /** write to the log file up to the last log entry.
 @param[in]	sync	whether we want the written log
 also to be flushed to disk. */
@@ -2629,6 +2962,22 @@ log_shutdown()
 
 	os_event_destroy(log_sys->flush_event);
 
+	ut_ad(!log_sys->writer_thread_active);
+	ut_ad(!log_sys->flusher_thread_active);
+
+	os_event_destroy(log_sys->writer_event);
+	os_event_destroy(log_sys->flusher_event);
+
+	for (ulint i = 0; i < LOG_N_WAIT_EVENTS; ++i) {
+		os_event_destroy(log_sys->write_events[i]);
+		os_event_destroy(log_sys->flush_events[i]);
+	}
+
+	ut_free(log_sys->write_events);
+	log_sys->write_events = NULL;
+	ut_free(log_sys->flush_events);
+	log_sys->flush_events = NULL;
+
 	rw_lock_free(&log_sys->checkpoint_lock);
 
 	mutex_free(&log_sys->mutex);
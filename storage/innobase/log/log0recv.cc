@@ -29,10 +29,13 @@ Created 9/20/1997 Heikki Tuuri
 #include <my_aes.h>
 #include <sys/types.h>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <map>
 #include <new>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "log0recv.h"
@@ -159,6 +162,7 @@ static lsn_t	recv_max_page_lsn;
 #ifndef UNIV_HOTBACKUP
 # ifdef UNIV_PFS_THREAD
 mysql_pfs_key_t	recv_writer_thread_key;
+mysql_pfs_key_t	recv_apply_thread_key;
 # endif /* UNIV_PFS_THREAD */
 
 /** Flag indicating if recv_writer thread is active. */
@@ -2420,8 +2424,14 @@ recv_apply_log_rec(recv_addr_t* recv_addr)
 	}
 }
 
+/** Pages with redo log records, assigned to one apply thread */
+using Recv_addrs = std::vector<recv_addr_t*, ut_allocator<recv_addr_t*>>;
+
 /** Empties the hash table of stored log records, applying them to appropriate
-pages.
+pages. The pages are partitioned by read-ahead area between
+srv_n_recv_apply_threads threads. Each thread applies the records of its
+pages that are in the buffer pool and reads in the others. The records of
+the pages read in are applied by the I/O handler threads on completion.
 @param[in]	allow_ibuf	if true, ibuf operations are allowed during
 				the application; if false, no ibuf operations
 				are allowed, and after the application all
@@ -2458,15 +2468,9 @@ recv_apply_hashed_log_recs(bool allow_ibuf)
 
 	auto	batch_size = recv_sys->n_addrs;
 
-	ib::info()
-		<< "Applying a batch of "
-		<< batch_size
-		<< " redo log records ...";
-
 	static const size_t	PCT = 10;
 
 	size_t	pct = PCT;
-	size_t	applied = 0;
 	auto	unit = batch_size / PCT;
 
 	if (unit <= PCT) {
@@ -2474,6 +2478,22 @@ recv_apply_hashed_log_recs(bool allow_ibuf)
 		unit = batch_size;
 	}
 
+	/* Assign the pages to the apply threads by read-ahead area, so
+	that every thread reads in and applies a disjoint set of pages. */
+
+	const size_t	n_threads = std::max<size_t>(
+		1, std::min<size_t>(
+			srv_n_recv_apply_threads,
+			batch_size / RECV_READ_AHEAD_AREA));
+
+	ib::info()
+		<< "Applying a batch of "
+		<< batch_size
+		<< " redo log records using "
+		<< n_threads << " threads ...";
+
+	std::vector<Recv_addrs>	parts(n_threads);
+
 	for (const auto& space : *recv_sys->spaces) {
 
 		fil_tablespace_open_for_recovery(space.first);
@@ -2482,17 +2502,70 @@ recv_apply_hashed_log_recs(bool allow_ibuf)
 
 			ut_ad(pages.second->space == space.first);
 
-			recv_apply_log_rec(pages.second);
+			ulint	fold = ut_fold_ulint_pair(
+				space.first,
+				pages.first / RECV_READ_AHEAD_AREA);
+
+			parts[fold % n_threads].push_back(pages.second);
+		}
+	}
+
+	mutex_exit(&recv_sys->mutex);
+
+	std::atomic<size_t>	applied(0);
 
-			++applied;
+	auto	apply = [&](size_t thread_id)
+	{
+		Recv_addrs&	addrs = parts[thread_id];
 
-			if (unit == 0 || (applied % unit) == 0) {
-				ib::info() << pct << "%";
-				pct += PCT;
+		/* Read the pages in ascending order, so that the read-ahead
+		areas are requested in file order. */
+
+		std::sort(
+			addrs.begin(), addrs.end(),
+			[](const recv_addr_t* lhs, const recv_addr_t* rhs)
+			{
+				return(lhs->space < rhs->space
+				       || (lhs->space == rhs->space
+					   && lhs->page_no < rhs->page_no));
+			});
+
+		mutex_enter(&recv_sys->mutex);
+
+		for (auto recv_addr : addrs) {
+
+			recv_apply_log_rec(recv_addr);
+
+			size_t	n = applied.fetch_add(1) + 1;
+
+			if (unit > 0 && (n % unit) == 0) {
+				ib::info() << (n / unit) * pct << "%";
 			}
 		}
+
+		mutex_exit(&recv_sys->mutex);
+	};
+
+#ifdef UNIV_PFS_THREAD
+	Runnable	runnable(recv_apply_thread_key);
+#else
+	Runnable	runnable(0);
+#endif /* UNIV_PFS_THREAD */
+
+	std::vector<std::thread>	threads;
+
+	for (size_t i = 1; i < n_threads; ++i) {
+		threads.push_back(std::thread(runnable, apply, i));
+	}
+
+	apply(0);
+
+	for (auto& thread : threads) {
+		thread.join();
 	}
 
+	mutex_enter(&recv_sys->mutex);
+
 	/* Wait until all the pages have been processed */
 
 	while (recv_sys->n_addrs != 0) {
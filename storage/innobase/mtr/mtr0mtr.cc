@@ -319,7 +319,8 @@ public:
 	@param[in,out]	mtr	mini-transaction */
 	explicit Command(mtr_t* mtr)
 		:
-		m_locks_released()
+		m_locks_released(),
+		m_log_offset(ULINT_UNDEFINED)
 	{
 		init(mtr);
 	}
@@ -334,6 +335,7 @@ public:
 	~Command()
 	{
 		ut_ad(m_impl == 0);
+		ut_ad(m_log_offset == ULINT_UNDEFINED);
 	}
 
 	/** Write the redo log record, add dirty pages to the flush list and
@@ -349,7 +351,8 @@ public:
 	/** Release the resources */
 	void release_resources();
 
-	/** Append the redo log records to the redo log buffer.
+	/** Reserve space for the redo log records in the redo log buffer,
+	or append them right away if they are short.
 	@param[in]	len	number of bytes to write */
 	void finish_write(ulint len);
 
@@ -358,6 +361,11 @@ private:
 	@return number of bytes to write in finish_write() */
 	ulint prepare_write();
 
+	/** Copy the redo log records to the area reserved for them in the
+	redo log buffer by finish_write(). Must be called after releasing
+	the log mutex. */
+	void copy_log();
+
 	/** true if it is a sync mini-transaction. */
 	bool			m_sync;
 
@@ -373,6 +381,10 @@ private:
 
 	/** End lsn of the possible log entry for this mtr */
 	lsn_t			m_end_lsn;
+
+	/** Offset of the area reserved in the log buffer for the log
+	records, or ULINT_UNDEFINED if there is nothing to copy */
+	ulint			m_log_offset;
 };
 
 /** Check if a mini-transaction is dirtying a clean page.
@@ -391,13 +403,26 @@ mtr_t::is_block_dirtied(const buf_block_t* block)
 
 /** Write the block contents to the REDO log */
 struct mtr_write_log_t {
-	/** Append a block to the redo log buffer.
+	/** Constructor
+	@param[in]	offset	offset of the area reserved in the log buffer */
+	explicit mtr_write_log_t(ulint offset)
+		:
+		m_offset(offset)
+	{
+		// Do nothing
+	}
+
+	/** Copy a block to the reserved area of the redo log buffer.
 	@return whether the appending should continue */
-	bool operator()(const mtr_buf_t::block_t* block) const
+	bool operator()(const mtr_buf_t::block_t* block)
 	{
-		log_write_low(block->begin(), block->used());
+		m_offset = log_buffer_write(
+			m_offset, block->begin(), block->used());
 		return(true);
 	}
+
+	/** Offset within the log buffer to copy the next block to */
+	ulint	m_offset;
 };
 
 /** Start a mini-transaction.
@@ -624,15 +649,37 @@ mtr_t::Command::finish_write(
 		}
 	}
 
-	/* Open the database log for log_write_low */
+	/* Open the database log for log_buffer_reserve */
 	m_start_lsn = log_reserve_and_open(len);
 
-	mtr_write_log_t	write_log;
-	m_impl->m_log.for_each_block(write_log);
+	/* Only reserve the space here; the records are copied in by
+	copy_log() after the log mutex has been released, so that
+	mini-transactions can fill the log buffer concurrently. */
+	m_log_offset = log_buffer_reserve(len);
 
 	m_end_lsn = log_close();
 }
 
+/** Copy the redo log records to the area reserved for them in the
+redo log buffer by finish_write(). */
+void
+mtr_t::Command::copy_log()
+{
+	ut_ad(!log_mutex_own());
+
+	if (m_log_offset == ULINT_UNDEFINED) {
+		return;
+	}
+
+	mtr_write_log_t	write_log(m_log_offset);
+
+	m_impl->m_log.for_each_block(write_log);
+
+	log_buffer_write_completed();
+
+	m_log_offset = ULINT_UNDEFINED;
+}
+
 /** Release the latches and blocks acquired by this mini-transaction */
 void
 mtr_t::Command::release_all()
@@ -677,6 +724,10 @@ mtr_t::Command::execute()
 	to insert into the flush list. */
 	log_mutex_exit();
 
+	/* The log buffer cannot be written out before the copy is
+	completed, so no waits are allowed until then. */
+	copy_log();
+
 	m_impl->m_mtr->m_commit_lsn = m_end_lsn;
 
 	add_dirty_blocks_to_flush_list();
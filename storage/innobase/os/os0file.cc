@@ -61,6 +61,7 @@ Created 10/21/1995 Heikki Tuuri
 # endif /* _WIN32 */
 #endif /* !UNIV_HOTBACKUP */
 
+#include <algorithm>
 #include <functional>
 #include <new>
 #include <vector>
@@ -69,6 +70,10 @@ Created 10/21/1995 Heikki Tuuri
 #include <libaio.h>
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_IO_URING
+#include "os0uring.h"
+#endif /* LINUX_IO_URING */
+
 #ifdef HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE
 # include <fcntl.h>
 # include <linux/falloc.h>
@@ -286,6 +291,11 @@ struct Slot {
 	ulint			n_bytes;
 #endif /* WIN_ASYNC_IO */
 
+#ifdef LINUX_IO_URING
+	/** io_uring return code: 0 or -errno */
+	int			uring_ret;
+#endif /* LINUX_IO_URING */
+
 	/** Length of the block before it was compressed */
 	uint32			original_len;
 
@@ -460,6 +470,88 @@ public:
 		MY_ATTRIBUTE((warn_unused_result));
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_IO_URING
+	/** Accessor for the io_uring rings
+	@param[in]	segment	Segment for which to get the rings
+	@return the rings of the segment */
+	IoUring* ring(ulint segment)
+		MY_ATTRIBUTE((warn_unused_result))
+	{
+		ut_ad(segment < get_n_segments());
+
+		return(&m_rings[segment]);
+	}
+
+	/** Queue an AIO request in the submission queue of the segment
+	of the slot. Assumes that the caller owns the mutex.
+	@param[in,out]	slot	an already reserved slot */
+	void uring_prepare(Slot* slot);
+
+	/** Dispatch an AIO request to the kernel with io_uring. A request
+	that does not ask to wake the i/o handler threads is only queued,
+	and submitted with the rest of its batch by
+	os_aio_simulated_wake_handler_threads().
+	@param[in,out]	slot	an already reserved slot */
+	void uring_dispatch(Slot* slot);
+
+	/** Submit the queued requests of a segment to the kernel.
+	@param[in]	segment	local segment */
+	void uring_submit(ulint segment);
+
+	/** Submit the queued requests of all segments to the kernel. */
+	static void uring_submit_all();
+
+	/** Register the fixed buffers of the rings of the read and write
+	arrays, replacing any earlier registration.
+	@param[in]	iov	buffers, in ascending order of address
+	@return 0 or -errno */
+	static int uring_register_buffers(const std::vector<struct iovec>& iov)
+		MY_ATTRIBUTE((warn_unused_result));
+
+	/** Take a completed write from the write array without waiting.
+	@param[out]	m1	the messages passed with the AIO request,
+	@param[out]	m2	NULL if no write has completed
+	@param[out]	request	IO context
+	@return DB_SUCCESS or error code */
+	static dberr_t uring_reap_write(
+		fil_node_t**	m1,
+		void**		m2,
+		IORequest*	request)
+		MY_ATTRIBUTE((warn_unused_result));
+
+	/** Checks if the system supports io_uring, also for the files in
+	tmpdir.
+	@return true if supported, false otherwise. */
+	static bool is_io_uring_supported()
+		MY_ATTRIBUTE((warn_unused_result));
+#endif /* LINUX_IO_URING */
+
+#if defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
+	/** Dispatch an AIO request to the kernel, with io_uring or with
+	libaio.
+	@param[in,out]	slot	an already reserved slot
+	@return true on success. */
+	bool native_dispatch(Slot* slot)
+		MY_ATTRIBUTE((warn_unused_result))
+	{
+# ifdef LINUX_IO_URING
+		if (srv_use_io_uring) {
+			/* The request is already in the submission queue:
+			it cannot be withdrawn any more. */
+			uring_dispatch(slot);
+			return(true);
+		}
+# endif /* LINUX_IO_URING */
+
+# ifdef LINUX_NATIVE_AIO
+		return(linux_dispatch(slot));
+# else
+		ut_error;
+		return(false);
+# endif /* LINUX_NATIVE_AIO */
+	}
+#endif /* LINUX_NATIVE_AIO || LINUX_IO_URING */
+
 #ifdef WIN_ASYNC_IO
 	/** Wakes up all async i/o threads in the array in Windows async I/O at
 	shutdown. */
@@ -653,6 +745,13 @@ private:
 		MY_ATTRIBUTE((warn_unused_result));
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_IO_URING
+	/** Initialise the io_uring rings
+	@return DB_SUCCESS or error code */
+	dberr_t init_io_uring()
+		MY_ATTRIBUTE((warn_unused_result));
+#endif /* LINUX_IO_URING */
+
 private:
 	typedef std::vector<Slot> Slots;
 
@@ -701,6 +800,13 @@ private:
 	IOEvents		m_events;
 #endif /* LINUX_NATIV_AIO */
 
+#ifdef LINUX_IO_URING
+	/** io_uring rings, one per segment. Each thread will work on
+	the rings of one segment exclusively; the submission queue is
+	filled and the completion queue drained under m_mutex. */
+	IoUring*		m_rings;
+#endif /* LINUX_IO_URING */
+
 	/** The aio arrays for non-ibuf i/o and ibuf i/o, as well as
 	sync AIO. These are NULL when the module has not yet been
 	initialized. */
@@ -739,6 +845,22 @@ static const ulint	OS_AIO_IO_SETUP_RETRY_SLEEP = 500000UL;
 static const int	OS_AIO_IO_SETUP_RETRY_ATTEMPTS = 5;
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_IO_URING
+/** timeout for each io_uring_enter() wait = 500ms. */
+static const uint64_t	OS_AIO_URING_REAP_TIMEOUT = 500000000ULL;
+
+/** Largest fixed buffer that io_uring accepts. */
+static const ulint	OS_AIO_URING_MAX_FIXED_BUF = 1UL << 30;
+
+/** Largest number of fixed buffers that io_uring accepts. */
+static const ulint	OS_AIO_URING_MAX_FIXED_BUFS = 1UL << 14;
+
+/** The fixed buffers registered with the rings of AIO::s_reads and
+AIO::s_writes, in ascending order of address. Protected by the mutexes
+of both arrays. */
+static std::vector<struct iovec>	os_aio_fixed_bufs;
+#endif /* LINUX_IO_URING */
+
 /** Array of events used in simulated AIO */
 static os_event_t*	os_aio_segment_wait_events = NULL;
 
@@ -1626,6 +1748,13 @@ AIO::release(Slot* slot)
 	}
 
 #endif /* WIN_ASYNC_IO */
+
+#ifdef LINUX_IO_URING
+	if (srv_use_io_uring) {
+		slot->uring_ret = 0;
+		slot->n_bytes = 0;
+	}
+#endif /* LINUX_IO_URING */
 }
 
 /** Frees a slot in the AIO array. Assumes caller doesn't own the mutex.
@@ -2850,174 +2979,917 @@ AIO::linux_create_io_ctx(
 					<< " attempts before giving up.";
 			}
 
-			if (n_retries < OS_AIO_IO_SETUP_RETRY_ATTEMPTS) {
+			if (n_retries < OS_AIO_IO_SETUP_RETRY_ATTEMPTS) {
+
+				++n_retries;
+
+				ib::warn()
+					<< "io_setup() attempt "
+					<< n_retries << ".";
+
+				os_thread_sleep(OS_AIO_IO_SETUP_RETRY_SLEEP);
+
+				continue;
+			}
+
+			/* Have tried enough. Better call it a day. */
+			ib::error()
+				<< "io_setup() failed with EAGAIN after "
+				<< OS_AIO_IO_SETUP_RETRY_ATTEMPTS
+				<< " attempts.";
+			break;
+
+		case -ENOSYS:
+			ib::error()
+				<< "Linux Native AIO interface"
+				" is not supported on this platform. Please"
+				" check your OS documentation and install"
+				" appropriate binary of InnoDB.";
+
+			break;
+
+		default:
+			ib::error()
+				<< "Linux Native AIO setup"
+				<< " returned following error["
+				<< ret << "]";
+			break;
+		}
+
+		ib::info()
+			<< "You can disable Linux Native AIO by"
+			" setting innodb_use_native_aio = 0 in my.cnf";
+
+		break;
+	}
+
+	return(false);
+}
+
+/** Checks if the system supports native linux aio. On some kernel
+versions where native aio is supported it won't work on tmpfs. In such
+cases we can't use native aio as it is not possible to mix simulated
+and native aio.
+@return: true if supported, false otherwise. */
+bool
+AIO::is_linux_native_aio_supported()
+{
+	int		fd;
+	io_context_t	io_ctx;
+	char		name[1000];
+
+	if (!linux_create_io_ctx(1, &io_ctx)) {
+
+		/* The platform does not support native aio. */
+
+		return(false);
+
+	} else if (!srv_read_only_mode) {
+
+		/* Now check if tmpdir supports native aio ops. */
+		fd = innobase_mysql_tmpfile(NULL);
+
+		if (fd < 0) {
+			ib::warn()
+				<< "Unable to create temp file to check"
+				" native AIO support.";
+
+			return(false);
+		}
+	} else {
+
+		os_normalize_path(srv_log_group_home_dir);
+
+		ulint	dirnamelen = strlen(srv_log_group_home_dir);
+
+		ut_a(dirnamelen < (sizeof name) - 10 - sizeof "ib_logfile");
+
+		memcpy(name, srv_log_group_home_dir, dirnamelen);
+
+		/* Add a path separator if needed. */
+		if (dirnamelen && name[dirnamelen - 1] != OS_PATH_SEPARATOR) {
+
+			name[dirnamelen++] = OS_PATH_SEPARATOR;
+		}
+
+		strcpy(name + dirnamelen, "ib_logfile0");
+
+		fd = ::open(name, O_RDONLY);
+
+		if (fd == -1) {
+
+			ib::warn()
+				<< "Unable to open"
+				<< " \"" << name << "\" to check native"
+				<< " AIO read support.";
+
+			return(false);
+		}
+	}
+
+	struct io_event	io_event;
+
+	memset(&io_event, 0x0, sizeof(io_event));
+
+	byte*	buf = static_cast<byte*>(ut_malloc_nokey(UNIV_PAGE_SIZE * 2));
+	byte*	ptr = static_cast<byte*>(ut_align(buf, UNIV_PAGE_SIZE));
+
+	struct iocb	iocb;
+
+	/* Suppress valgrind warning. */
+	memset(buf, 0x00, UNIV_PAGE_SIZE * 2);
+	memset(&iocb, 0x0, sizeof(iocb));
+
+	struct iocb*	p_iocb = &iocb;
+
+	if (!srv_read_only_mode) {
+
+		io_prep_pwrite(p_iocb, fd, ptr, UNIV_PAGE_SIZE, 0);
+
+	} else {
+		ut_a(UNIV_PAGE_SIZE >= 512);
+		io_prep_pread(p_iocb, fd, ptr, 512, 0);
+	}
+
+	int	err = io_submit(io_ctx, 1, &p_iocb);
+
+	if (err >= 1) {
+		/* Now collect the submitted IO request. */
+		err = io_getevents(io_ctx, 1, 1, &io_event, NULL);
+	}
+
+	ut_free(buf);
+	close(fd);
+
+	switch (err) {
+	case 1:
+		return(true);
+
+	case -EINVAL:
+	case -ENOSYS:
+		ib::error()
+			<< "Linux Native AIO not supported. You can either"
+			" move "
+			<< (srv_read_only_mode ? name : "tmpdir")
+			<< " to a file system that supports native"
+			" AIO or you can set innodb_use_native_aio to"
+			" FALSE to avoid this message.";
+
+		/* fall through. */
+	default:
+		ib::error()
+			<< "Linux Native AIO check on "
+			<< (srv_read_only_mode ? name : "tmpdir")
+			<< "returned error[" << -err << "]";
+	}
+
+	return(false);
+}
+
+#endif /* LINUX_NATIVE_AIO */
+
+#ifdef LINUX_IO_URING
+
+/** io_uring AIO handler. Like the Linux native AIO handler, it reaps the
+requests of one segment; the rings of the segment take the place of the
+io_context. Completions can also be taken without waiting, by the threads
+that submitted the requests. */
+class UringAIOHandler {
+public:
+	/**
+	@param[in]	array		AIO array
+	@param[in]	segment		local segment in the array
+	@param[in]	global_segment	the global segment of the i/o
+					handler thread, or ULINT_UNDEFINED
+					if not called by one */
+	UringAIOHandler(AIO* array, ulint segment, ulint global_segment)
+		:
+		m_array(array),
+		m_n_slots(array->slots_per_segment()),
+		m_segment(segment),
+		m_global_segment(global_segment)
+	{
+		ut_ad(m_segment < m_array->get_n_segments());
+	}
+
+	/**
+	Process an io_uring request
+	@param[out]	m1		the messages passed with the
+	@param[out]	m2		AIO request; note that in case the
+					AIO operation failed, these output
+					parameters are valid and can be used to
+					restart the operation.
+	@param[out]	request		IO context
+	@param[in]	wait		false to return NULL messages if
+					no request has completed
+	@return DB_SUCCESS or error code */
+	dberr_t poll(
+		fil_node_t**	m1,
+		void**		m2,
+		IORequest*	request,
+		bool		wait);
+
+private:
+	/** Resubmit an IO request that was only partially successful
+	@param[in,out]	slot		Request to resubmit
+	@return DB_SUCCESS or DB_IO_PARTIAL_FAILED if the IO resubmit
+	request failed */
+	dberr_t	resubmit(Slot* slot);
+
+	/** Check if the AIO succeeded
+	@param[in,out]	slot		The slot to check
+	@return DB_SUCCESS, DB_FAIL if the operation should be retried or
+		DB_IO_ERROR on all other errors */
+	dberr_t	check_state(Slot* slot);
+
+	/** @return true if a shutdown was detected */
+	bool is_shutdown() const
+	{
+		return(srv_shutdown_state == SRV_SHUTDOWN_EXIT_THREADS
+		       && !buf_page_cleaner_is_active);
+	}
+
+	/** Set the state of the i/o handler thread, if we are one.
+	@param[in]	info	the state */
+	void set_op_info(const char* info) const
+	{
+		if (m_global_segment != ULINT_UNDEFINED) {
+			srv_set_io_thread_op_info(m_global_segment, info);
+		}
+	}
+
+	/** If no slot was found then the m_array->m_mutex will be released.
+	@param[out]	n_pending	The number of pending IOs
+	@return NULL or a slot that has completed IO */
+	Slot* find_completed_slot(ulint* n_pending);
+
+	/** Take the completions from the completion queue and mark their
+	slots as done.
+	@return number of completions taken */
+	ulint reap();
+
+	/** Wait until the kernel has completed some requests of the
+	segment, submitting the requests that are still queued, and mark
+	their slots as done. The i/o handler thread also exits in this
+	function: it checks the server status at each wakeup. */
+	void collect();
+
+private:
+	/** Slot array */
+	AIO*			m_array;
+
+	/** Number of slots in the local segment */
+	ulint			m_n_slots;
+
+	/** The local segment to check */
+	ulint			m_segment;
+
+	/** The global segment, ULINT_UNDEFINED if not an i/o thread */
+	ulint			m_global_segment;
+};
+
+/** Resubmit an IO request that was only partially successful
+@param[in,out]	slot		Request to resubmit
+@return DB_SUCCESS or DB_IO_PARTIAL_FAILED if the IO resubmit request
+failed */
+dberr_t
+UringAIOHandler::resubmit(Slot* slot)
+{
+	ut_ad(m_array->is_mutex_owned());
+
+	slot->len -= slot->n_bytes;
+	slot->ptr += slot->n_bytes;
+	slot->offset += slot->n_bytes;
+
+	/* Resetting the bytes read/written */
+	slot->n_bytes = 0;
+	slot->uring_ret = 0;
+	slot->io_already_done = false;
+
+	m_array->uring_prepare(slot);
+
+	int	ret = m_array->ring(m_segment)->submit();
+
+	switch (ret) {
+	case -EAGAIN:
+	case -EBUSY:
+	case -EINTR:
+		/* The request stays queued, and collect() submits it. */
+		return(DB_SUCCESS);
+	}
+
+	if (ret < 0) {
+		errno = -ret;
+	}
+
+	return(ret < 0 ? DB_IO_PARTIAL_FAILED : DB_SUCCESS);
+}
+
+/** Check if the AIO succeeded
+@param[in,out]	slot		The slot to check
+@return DB_SUCCESS, DB_FAIL if the operation should be retried or
+	DB_IO_ERROR on all other errors */
+dberr_t
+UringAIOHandler::check_state(Slot* slot)
+{
+	ut_ad(m_array->is_mutex_owned());
+	ut_ad(slot->io_already_done);
+
+	set_op_info("processing completed aio requests");
+
+	dberr_t	err;
+
+	if (slot->uring_ret == 0) {
+
+		err = AIOHandler::post_io_processing(slot);
+
+	} else {
+		errno = -slot->uring_ret;
+
+		/* As with Linux native AIO, we do not retry the IO
+		when reaping requests from a different context than
+		the dispatcher. */
+		os_file_handle_error(slot->name, "io_uring");
+
+		err = DB_IO_ERROR;
+	}
+
+	return(err);
+}
+
+/** If no slot was found then the m_array->m_mutex will be released.
+@param[out]	n_pending		The number of pending IOs
+@return NULL or a slot that has completed IO */
+Slot*
+UringAIOHandler::find_completed_slot(ulint* n_pending)
+{
+	ulint	offset = m_n_slots * m_segment;
+
+	*n_pending = 0;
+
+	m_array->acquire();
+
+	Slot*	slot = m_array->at(offset);
+
+	for (ulint i = 0; i < m_n_slots; ++i, ++slot) {
+
+		if (slot->is_reserved) {
+
+			++*n_pending;
+
+			if (slot->io_already_done) {
+
+				/* Something for us to work on.
+				Note: We don't release the mutex. */
+				return(slot);
+			}
+		}
+	}
+
+	m_array->release();
+
+	return(NULL);
+}
+
+/** Take the completions from the completion queue and mark their slots
+as done.
+@return number of completions taken */
+ulint
+UringAIOHandler::reap()
+{
+	IoUring*	ring = m_array->ring(m_segment);
+
+	/* Starting point of the m_segment we will be working on. */
+	ulint		start_pos = m_segment * m_n_slots;
+
+	/* End point. */
+	ulint		end_pos = start_pos + m_n_slots;
+
+	ulint		n_reaped = 0;
+	void*		data;
+	int		res;
+
+	m_array->acquire();
+
+	while (ring->reap(&data, &res)) {
+
+		Slot*	slot = static_cast<Slot*>(data);
+
+		/* Some sanity checks. */
+		ut_a(slot != NULL);
+		ut_a(slot->is_reserved);
+		ut_a(!slot->io_already_done);
+		ut_a(slot->pos >= start_pos);
+		ut_a(slot->pos < end_pos);
+
+		slot->uring_ret = res < 0 ? res : 0;
+		slot->n_bytes = res < 0 ? 0 : res;
+
+		/* We never compress/decompress the first page */
+
+		if (res >= 0
+		    && slot->offset > 0
+		    && !slot->skip_punch_hole
+		    && slot->type.is_compression_enabled()
+		    && !slot->type.is_log()
+		    && slot->type.is_write()
+		    && slot->type.is_compressed()
+		    && slot->type.punch_hole()) {
+
+			slot->err = AIOHandler::io_complete(slot);
+		} else {
+			slot->err = DB_SUCCESS;
+		}
+
+		/* Mark this request as completed. The error handling
+		will be done in the calling function. */
+		slot->io_already_done = true;
+
+		++n_reaped;
+	}
+
+	m_array->release();
+
+	return(n_reaped);
+}
+
+/** Wait until the kernel has completed some requests of the segment,
+submitting the requests that are still queued, and mark their slots as
+done. The i/o handler thread also exits in this function: it checks the
+server status at each wakeup. */
+void
+UringAIOHandler::collect()
+{
+	IoUring*	ring = m_array->ring(m_segment);
+
+	for (;;) {
+		int	ret = ring->wait(OS_AIO_URING_REAP_TIMEOUT);
+
+		ulint	n_reaped = reap();
+
+		if (srv_shutdown_state == SRV_SHUTDOWN_EXIT_THREADS
+		    || !buf_page_cleaner_is_active
+		    || n_reaped > 0) {
+
+			break;
+		}
+
+		/* This error handling is for any error in collecting the
+		IO requests. The errors, if any, for any particular IO
+		request are simply passed on to the calling routine. */
+
+		if (ret >= 0) {
+			/* Another thread took the completions. */
+			continue;
+		}
+
+		switch (ret) {
+		case -ETIME:
+			/* No completed request! Go back and check again. */
+
+		case -EINTR:
+			/* Interrupted! */
+
+		case -EAGAIN:
+		case -EBUSY:
+			/* Not enough resources to submit the queued
+			requests! Try again. */
+
+			continue;
+		}
+
+		/* All other errors should cause a trap for now. */
+		ib::fatal()
+			<< "Unexpected ret_code[" << ret
+			<< "] from io_uring_enter()!";
+
+		break;
+	}
+}
+
+/** Process an io_uring request
+@param[out]	m1		the messages passed with the
+@param[out]	m2		AIO request; note that in case the
+				AIO operation failed, these output
+				parameters are valid and can be used to
+				restart the operation.
+@param[out]	request		IO context
+@param[in]	wait		false to return NULL messages if no request
+				has completed
+@return DB_SUCCESS or error code */
+dberr_t
+UringAIOHandler::poll(
+	fil_node_t**	m1,
+	void**		m2,
+	IORequest*	request,
+	bool		wait)
+{
+	dberr_t		err;
+	Slot*		slot;
+
+	if (!wait) {
+		reap();
+	}
+
+	/* Loop until we have found a completed request. */
+	for (;;) {
+
+		ulint	n_pending;
+
+		slot = find_completed_slot(&n_pending);
+
+		if (slot != NULL) {
+
+			ut_ad(m_array->is_mutex_owned());
+
+			err = check_state(slot);
+
+			/* DB_FAIL is not a hard error, we should retry */
+			if (err != DB_FAIL) {
+				break;
+			}
+
+			/* Partial IO, resubmit request for
+			remaining bytes to read/write */
+			err = resubmit(slot);
+
+			if (err != DB_SUCCESS) {
+				break;
+			}
+
+			m_array->release();
+
+		} else if (!wait || (is_shutdown() && n_pending == 0)) {
+
+			/* There is no completed request. If there is
+			no pending request at all, and the system is
+			being shut down, exit. */
+
+			*m1 = NULL;
+			*m2 = NULL;
+
+			return(DB_SUCCESS);
+
+		} else {
+
+			/* Wait for some request. Note that we return
+			from wait if we have found a request. */
+
+			set_op_info("waiting for completed aio requests");
+
+			collect();
+		}
+	}
+
+	if (err == DB_IO_PARTIAL_FAILED) {
+		/* Aborting in case of submit failure */
+		ib::fatal()
+			<< "io_uring_enter() call failed when"
+			" resubmitting a partial I/O request on the file "
+			<< slot->name << ".";
+	}
+
+	*m1 = slot->m1;
+	*m2 = slot->m2;
+
+	*request = slot->type;
+
+	m_array->release(slot);
+
+	m_array->release();
+
+	return(err);
+}
+
+/** This function is only used with io_uring.
+Waits for an aio operation to complete. This function is used to wait for
+the completed requests. The aio array of pending requests is divided
+into segments. The thread specifies which segment or slot it wants to wait
+for. NOTE: this function will also take care of freeing the aio slot,
+therefore no other thread is allowed to do the freeing!
+
+@param[in]	global_segment	segment number in the aio array
+				to wait for; segment 0 is the ibuf
+				i/o thread, segment 1 is log i/o thread,
+				then follow the non-ibuf read threads,
+				and the last are the non-ibuf write
+				threads.
+@param[out]	m1		the messages passed with the
+@param[out]	m2			AIO request; note that in case the
+				AIO operation failed, these output
+				parameters are valid and can be used to
+				restart the operation.
+@param[out]	request		IO context
+@return DB_SUCCESS if the IO was successful */
+static
+dberr_t
+os_aio_uring_handler(
+	ulint		global_segment,
+	fil_node_t**	m1,
+	void**		m2,
+	IORequest*	request)
+{
+	AIO*	array;
+	ulint	segment = AIO::get_array_and_local_segment(
+		&array, global_segment);
+
+	UringAIOHandler	handler(array, segment, global_segment);
+
+	dberr_t	err = handler.poll(m1, m2, request, true);
+
+	if (err == DB_IO_NO_PUNCH_HOLE) {
+		fil_no_punch_hole(*m1);
+		err = DB_SUCCESS;
+	}
+
+	return(err);
+}
+
+/** Look up the fixed buffer that holds a block.
+@param[in]	ptr	start of the block
+@param[in]	len	length of the block
+@return index of the fixed buffer, or -1 if the block is not in one */
+static
+int
+os_aio_fixed_buf_index(
+	const byte*	ptr,
+	ulint		len)
+{
+	std::vector<struct iovec>::const_iterator	it;
+
+	/* The first buffer that starts after ptr */
+	it = std::upper_bound(
+		os_aio_fixed_bufs.begin(), os_aio_fixed_bufs.end(), ptr,
+		[](const byte* p, const struct iovec& iov) {
+			return(p < static_cast<const byte*>(iov.iov_base));
+		});
+
+	if (it == os_aio_fixed_bufs.begin()) {
+		return(-1);
+	}
+
+	--it;
+
+	const byte*	base = static_cast<const byte*>(it->iov_base);
+
+	if (ptr + len > base + it->iov_len) {
+		return(-1);
+	}
+
+	return(static_cast<int>(it - os_aio_fixed_bufs.begin()));
+}
+
+/** Queue an AIO request in the submission queue of the segment of the
+slot. Assumes that the caller owns the mutex.
+@param[in,out]	slot	an already reserved slot */
+void
+AIO::uring_prepare(Slot* slot)
+{
+	ut_ad(is_mutex_owned());
+	ut_a(slot->is_reserved);
+	ut_ad(slot->type.validate());
+
+	/* The rings are one per segment, like the io_context. */
+	ulint	segment = (slot->pos * m_n_segments) / m_slots.size();
+
+	int	buf_index = -1;
+
+	if (this == s_reads || this == s_writes) {
+		buf_index = os_aio_fixed_buf_index(slot->ptr, slot->len);
+	}
+
+	/* A slot has at most one request in the queue, and the queue has
+	room for all the slots of the segment. */
+	bool	queued = m_rings[segment].prepare(
+		slot->type.is_read(), slot->file.m_file, slot->ptr, slot->len,
+		slot->offset, slot, buf_index);
+
+	ut_a(queued);
+}
+
+/** Dispatch an AIO request to the kernel with io_uring. A request that
+does not ask to wake the i/o handler threads is only queued, and
+submitted with the rest of its batch by
+os_aio_simulated_wake_handler_threads().
+@param[in,out]	slot	an already reserved slot */
+void
+AIO::uring_dispatch(Slot* slot)
+{
+	ut_a(slot->is_reserved);
+
+	if (slot->type.is_wake()) {
+		uring_submit((slot->pos * m_n_segments) / m_slots.size());
+	}
+}
+
+/** Submit the queued requests of a segment to the kernel.
+@param[in]	segment	local segment */
+void
+AIO::uring_submit(ulint segment)
+{
+	IoUring*	ring = this->ring(segment);
+
+	if (ring->n_queued() == 0) {
+		return;
+	}
+
+	int	ret = ring->submit();
+
+	switch (ret) {
+	case -EAGAIN:
+	case -EBUSY:
+	case -EINTR:
+		/* The requests stay queued, and the i/o handler thread
+		of the segment submits them when it next waits. */
+		return;
+	}
+
+	if (ret < 0) {
+		/* The requests are visible to the kernel already, and
+		their slots cannot be released. */
+		ib::fatal()
+			<< "io_uring_enter() failed to submit requests: "
+			<< strerror(-ret);
+	}
+}
+
+/** Submit the queued requests of all segments to the kernel. */
+void
+AIO::uring_submit_all()
+{
+	AIO*	arrays[] = { s_ibuf, s_log, s_reads, s_writes };
 
-				++n_retries;
+	for (ulint i = 0; i < UT_ARR_SIZE(arrays); ++i) {
 
-				ib::warn()
-					<< "io_setup() attempt "
-					<< n_retries << ".";
+		if (arrays[i] == NULL) {
+			continue;
+		}
 
-				os_thread_sleep(OS_AIO_IO_SETUP_RETRY_SLEEP);
+		for (ulint j = 0; j < arrays[i]->m_n_segments; ++j) {
+			arrays[i]->uring_submit(j);
+		}
+	}
+}
 
-				continue;
-			}
+/** Register the fixed buffers of the rings of the read and write
+arrays, replacing any earlier registration.
+@param[in]	iov	buffers, in ascending order of address
+@return 0 or -errno */
+int
+AIO::uring_register_buffers(const std::vector<struct iovec>& iov)
+{
+	AIO*	arrays[] = { s_reads, s_writes };
+	int	ret = 0;
 
-			/* Have tried enough. Better call it a day. */
-			ib::error()
-				<< "io_setup() failed with EAGAIN after "
-				<< OS_AIO_IO_SETUP_RETRY_ATTEMPTS
-				<< " attempts.";
-			break;
+	for (ulint i = 0; i < UT_ARR_SIZE(arrays); ++i) {
+		arrays[i]->acquire();
+	}
 
-		case -ENOSYS:
-			ib::error()
-				<< "Linux Native AIO interface"
-				" is not supported on this platform. Please"
-				" check your OS documentation and install"
-				" appropriate binary of InnoDB.";
+	/* Stop using the old buffers before they are replaced. */
+	os_aio_fixed_bufs.clear();
 
-			break;
+	for (ulint i = 0; i < UT_ARR_SIZE(arrays) && ret == 0; ++i) {
+		for (ulint j = 0; j < arrays[i]->m_n_segments; ++j) {
 
-		default:
-			ib::error()
-				<< "Linux Native AIO setup"
-				<< " returned following error["
-				<< ret << "]";
-			break;
+			ret = arrays[i]->m_rings[j].register_buffers(
+				iov.empty() ? NULL : &iov[0], iov.size());
+
+			if (ret != 0) {
+				break;
+			}
 		}
+	}
 
-		ib::info()
-			<< "You can disable Linux Native AIO by"
-			" setting innodb_use_native_aio = 0 in my.cnf";
+	if (ret == 0) {
+		os_aio_fixed_bufs = iov;
+	} else {
+		/* Some rings may have the buffers registered, but they
+		will not be used. */
+		for (ulint i = 0; i < UT_ARR_SIZE(arrays); ++i) {
+			for (ulint j = 0; j < arrays[i]->m_n_segments; ++j) {
+				arrays[i]->m_rings[j].register_buffers(
+					NULL, 0);
+			}
+		}
+	}
 
-		break;
+	for (ulint i = UT_ARR_SIZE(arrays); i-- > 0; ) {
+		arrays[i]->release();
 	}
 
-	return(false);
+	return(ret);
 }
 
-/** Checks if the system supports native linux aio. On some kernel
-versions where native aio is supported it won't work on tmpfs. In such
-cases we can't use native aio as it is not possible to mix simulated
-and native aio.
-@return: true if supported, false otherwise. */
-bool
-AIO::is_linux_native_aio_supported()
+/** Take a completed write from the write array without waiting.
+@param[out]	m1	the messages passed with the AIO request,
+@param[out]	m2	NULL if no write has completed
+@param[out]	request	IO context
+@return DB_SUCCESS or error code */
+dberr_t
+AIO::uring_reap_write(
+	fil_node_t**	m1,
+	void**		m2,
+	IORequest*	request)
 {
-	int		fd;
-	io_context_t	io_ctx;
-	char		name[1000];
-
-	if (!linux_create_io_ctx(1, &io_ctx)) {
-
-		/* The platform does not support native aio. */
+	*m1 = NULL;
+	*m2 = NULL;
 
-		return(false);
+	for (ulint i = 0; i < s_writes->m_n_segments; ++i) {
 
-	} else if (!srv_read_only_mode) {
+		UringAIOHandler	handler(s_writes, i, ULINT_UNDEFINED);
 
-		/* Now check if tmpdir supports native aio ops. */
-		fd = innobase_mysql_tmpfile(NULL);
+		dberr_t	err = handler.poll(m1, m2, request, false);
 
-		if (fd < 0) {
-			ib::warn()
-				<< "Unable to create temp file to check"
-				" native AIO support.";
+		if (err == DB_IO_NO_PUNCH_HOLE) {
+			fil_no_punch_hole(*m1);
+			err = DB_SUCCESS;
+		}
 
-			return(false);
+		if (err != DB_SUCCESS || *m1 != NULL) {
+			return(err);
 		}
-	} else {
+	}
 
-		os_normalize_path(srv_log_group_home_dir);
+	return(DB_SUCCESS);
+}
 
-		ulint	dirnamelen = strlen(srv_log_group_home_dir);
+/** Checks if the system supports io_uring, also for the files in tmpdir.
+@return true if supported, false otherwise. */
+bool
+AIO::is_io_uring_supported()
+{
+	IoUring	ring;
+	int	ret = ring.open(1);
 
-		ut_a(dirnamelen < (sizeof name) - 10 - sizeof "ib_logfile");
+	if (ret == -EOPNOTSUPP) {
+		ib::error()
+			<< "io_uring on this kernel cannot wait for"
+			" completions with a timeout; Linux 5.11 or later"
+			" is required.";
 
-		memcpy(name, srv_log_group_home_dir, dirnamelen);
+		return(false);
 
-		/* Add a path separator if needed. */
-		if (dirnamelen && name[dirnamelen - 1] != OS_PATH_SEPARATOR) {
+	} else if (ret != 0) {
+		ib::error()
+			<< "io_uring is not supported on this platform: "
+			<< strerror(-ret);
 
-			name[dirnamelen++] = OS_PATH_SEPARATOR;
-		}
+		return(false);
 
-		strcpy(name + dirnamelen, "ib_logfile0");
+	} else if (srv_read_only_mode) {
 
-		fd = ::open(name, O_RDONLY);
+		return(true);
+	}
 
-		if (fd == -1) {
+	/* Now check if tmpdir supports io_uring ops. */
+	int	fd = innobase_mysql_tmpfile(NULL);
 
-			ib::warn()
-				<< "Unable to open"
-				<< " \"" << name << "\" to check native"
-				<< " AIO read support.";
+	if (fd < 0) {
+		ib::warn()
+			<< "Unable to create temp file to check"
+			" io_uring support.";
 
-			return(false);
-		}
+		return(false);
 	}
 
-	struct io_event	io_event;
-
-	memset(&io_event, 0x0, sizeof(io_event));
-
 	byte*	buf = static_cast<byte*>(ut_malloc_nokey(UNIV_PAGE_SIZE * 2));
 	byte*	ptr = static_cast<byte*>(ut_align(buf, UNIV_PAGE_SIZE));
 
-	struct iocb	iocb;
-
-	/* Suppress valgrind warning. */
 	memset(buf, 0x00, UNIV_PAGE_SIZE * 2);
-	memset(&iocb, 0x0, sizeof(iocb));
-
-	struct iocb*	p_iocb = &iocb;
-
-	if (!srv_read_only_mode) {
 
-		io_prep_pwrite(p_iocb, fd, ptr, UNIV_PAGE_SIZE, 0);
+	bool	queued = ring.prepare(
+		false, fd, ptr, UNIV_PAGE_SIZE, 0, ptr, -1);
 
-	} else {
-		ut_a(UNIV_PAGE_SIZE >= 512);
-		io_prep_pread(p_iocb, fd, ptr, 512, 0);
-	}
+	ut_a(queued);
 
-	int	err = io_submit(io_ctx, 1, &p_iocb);
+	void*	data = NULL;
+	int	res = 0;
 
-	if (err >= 1) {
-		/* Now collect the submitted IO request. */
-		err = io_getevents(io_ctx, 1, 1, &io_event, NULL);
-	}
+	/* The buffer must not be freed before the write completes. */
+	do {
+		ret = ring.wait(OS_AIO_URING_REAP_TIMEOUT);
+	} while ((ret >= 0 || ret == -ETIME || ret == -EINTR)
+		 && !ring.reap(&data, &res));
 
 	ut_free(buf);
 	close(fd);
 
-	switch (err) {
-	case 1:
-		return(true);
+	if (ret < 0 && ret != -ETIME && ret != -EINTR) {
+		res = ret;
+	}
 
-	case -EINVAL:
-	case -ENOSYS:
+	if (res != static_cast<int>(UNIV_PAGE_SIZE)) {
 		ib::error()
-			<< "Linux Native AIO not supported. You can either"
-			" move "
-			<< (srv_read_only_mode ? name : "tmpdir")
-			<< " to a file system that supports native"
-			" AIO or you can set innodb_use_native_aio to"
-			" FALSE to avoid this message.";
+			<< "io_uring check on tmpdir returned error["
+			<< -res << "]";
 
-		/* fall through. */
-	default:
-		ib::error()
-			<< "Linux Native AIO check on "
-			<< (srv_read_only_mode ? name : "tmpdir")
-			<< "returned error[" << -err << "]";
+		return(false);
 	}
 
-	return(false);
+	return(true);
 }
 
-#endif /* LINUX_NATIVE_AIO */
+#endif /* LINUX_IO_URING */
 
 /** Retrieves the last error number if an error occurs in a file io function.
 The number should be retrieved before any other OS calls (because they may
@@ -6213,14 +7085,21 @@ os_aio_handler(
 
 		err = os_aio_windows_handler(segment, 0, m1, m2, request);
 
-#elif defined(LINUX_NATIVE_AIO)
+#else
 
-		err = os_aio_linux_handler(segment, m1, m2, request);
+# ifdef LINUX_IO_URING
+		if (srv_use_io_uring) {
+			return(os_aio_uring_handler(segment, m1, m2, request));
+		}
+# endif /* LINUX_IO_URING */
 
-#else
+# ifdef LINUX_NATIVE_AIO
+		err = os_aio_linux_handler(segment, m1, m2, request);
+# else
 		ut_error;
 
 		err = DB_ERROR; /* Eliminate compiler warning */
+# endif /* LINUX_NATIVE_AIO */
 
 #endif /* WIN_ASYNC_IO */
 
@@ -6251,6 +7130,9 @@ AIO::AIO(
 # elif defined(_WIN32)
 	,m_handles()
 # endif /* LINUX_NATIVE_AIO */
+# ifdef LINUX_IO_URING
+	,m_rings()
+# endif /* LINUX_IO_URING */
 {
 	ut_a(n > 0);
 	ut_a(m_n_segments > 0);
@@ -6298,6 +7180,10 @@ AIO::init_slots()
 		memset(&slot.control, 0x0, sizeof(slot.control));
 
 #endif /* WIN_ASYNC_IO */
+
+#ifdef LINUX_IO_URING
+		slot.uring_ret = 0;
+#endif /* LINUX_IO_URING */
 	}
 
 	return(DB_SUCCESS);
@@ -6340,6 +7226,40 @@ AIO::init_linux_native_aio()
 }
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_IO_URING
+/** Initialise the io_uring rings, one per segment in the array */
+dberr_t
+AIO::init_io_uring()
+{
+	ut_a(m_rings == NULL);
+
+	m_rings = UT_NEW_ARRAY_NOKEY(IoUring, m_n_segments);
+
+	if (m_rings == NULL) {
+		return(DB_OUT_OF_MEMORY);
+	}
+
+	for (ulint i = 0; i < m_n_segments; ++i) {
+
+		int	ret = m_rings[i].open(slots_per_segment());
+
+		if (ret != 0) {
+			ib::error()
+				<< "io_uring_setup() failed: "
+				<< strerror(-ret);
+
+			ib::info()
+				<< "You can disable io_uring by"
+				" setting innodb_use_io_uring = 0 in my.cnf";
+
+			return(DB_IO_ERROR);
+		}
+	}
+
+	return(DB_SUCCESS);
+}
+#endif /* LINUX_IO_URING */
+
 /** Initialise the array */
 dberr_t
 AIO::init()
@@ -6352,6 +7272,18 @@ AIO::init()
 	m_handles = UT_NEW_NOKEY(Handles(m_slots.size()));
 #endif /* _WIN32 */
 
+#ifdef LINUX_IO_URING
+	if (srv_use_io_uring) {
+		dberr_t	err = init_io_uring();
+
+		if (err != DB_SUCCESS) {
+			return(err);
+		}
+
+		return(init_slots());
+	}
+#endif /* LINUX_IO_URING */
+
 	if (srv_use_native_aio) {
 #ifdef LINUX_NATIVE_AIO
 		dberr_t	err = init_linux_native_aio();
@@ -6426,6 +7358,12 @@ AIO::~AIO()
 	}
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_IO_URING
+	if (m_rings != NULL) {
+		UT_DELETE_ARRAY(m_rings);
+	}
+#endif /* LINUX_IO_URING */
+
 	m_slots.clear();
 }
 
@@ -6448,9 +7386,26 @@ AIO::start(
 	ulint		n_writers,
 	ulint		n_slots_sync)
 {
+#ifdef LINUX_IO_URING
+	/* Check if io_uring is supported on this system and tmpfs */
+	if (srv_use_io_uring && !is_io_uring_supported()) {
+
+		ib::warn() << "io_uring disabled.";
+
+		srv_use_io_uring = false;
+
+# ifndef LINUX_NATIVE_AIO
+		/* libaio is not available either. */
+		srv_use_native_aio = FALSE;
+# endif /* !LINUX_NATIVE_AIO */
+	}
+#endif /* LINUX_IO_URING */
+
 #if defined(LINUX_NATIVE_AIO)
 	/* Check if native aio is supported on this system and tmpfs */
-	if (srv_use_native_aio && !is_linux_native_aio_supported()) {
+	if (srv_use_native_aio
+	    && !srv_use_io_uring
+	    && !is_linux_native_aio_supported()) {
 
 		ib::warn() << "Linux Native AIO disabled.";
 
@@ -6750,12 +7705,12 @@ os_aio_wake_all_threads_at_shutdown()
 
 	AIO::wake_at_shutdown();
 
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
 
 	/* When using native AIO interface the io helper threads
-	wait on io_getevents with a timeout value of 500ms. At
-	each wake up these threads check the server status.
-	No need to do anything to wake them up. */
+	wait on io_getevents or io_uring_enter with a timeout value
+	of 500ms. At each wake up these threads check the server
+	status. No need to do anything to wake them up. */
 
 	if (srv_use_native_aio) {
 		return;
@@ -6782,6 +7737,94 @@ os_aio_wait_until_no_pending_writes()
 	AIO::wait_until_no_pending_writes();
 }
 
+/** Registers memory areas that hold the buffers of page i/o with the
+asynchronous i/o system, replacing any earlier registration. With io_uring
+they become the fixed buffers of the rings of the read and write arrays.
+Does nothing with the other AIO implementations.
+@param[in]	areas	the memory areas, or empty to drop the
+			registration */
+void
+os_aio_register_buffers(const os_aio_buffers_t& areas)
+{
+#ifdef LINUX_IO_URING
+	if (!srv_use_io_uring) {
+		return;
+	}
+
+	std::vector<struct iovec>	iov;
+
+	for (os_aio_buffers_t::const_iterator it = areas.begin();
+	     it != areas.end();
+	     ++it) {
+
+		/* Split the areas into buffers that io_uring accepts. */
+		for (ulint offset = 0; offset < it->second;
+		     offset += OS_AIO_URING_MAX_FIXED_BUF) {
+
+			struct iovec	buf;
+
+			buf.iov_base = it->first + offset;
+			buf.iov_len = ut_min(it->second - offset,
+					     OS_AIO_URING_MAX_FIXED_BUF);
+
+			iov.push_back(buf);
+		}
+	}
+
+	if (iov.size() > OS_AIO_URING_MAX_FIXED_BUFS) {
+		ib::warn()
+			<< "Not registering the buffer pool with io_uring:"
+			" it would need " << iov.size() << " fixed buffers,"
+			" and at most " << OS_AIO_URING_MAX_FIXED_BUFS
+			<< " are supported.";
+
+		iov.clear();
+	}
+
+	std::sort(iov.begin(), iov.end(),
+		  [](const struct iovec& a, const struct iovec& b) {
+			  return(a.iov_base < b.iov_base);
+		  });
+
+	int	ret = AIO::uring_register_buffers(iov);
+
+	if (ret != 0) {
+		/* Most likely RLIMIT_MEMLOCK is too small. The i/o works
+		all the same, only without the fixed buffers. */
+		ib::warn()
+			<< "Registering the buffer pool with io_uring failed: "
+			<< strerror(-ret) << ". Page i/o will not use fixed"
+			" buffers.";
+	}
+#endif /* LINUX_IO_URING */
+}
+
+/** Takes a completed asynchronous write without waiting, so that the
+caller can complete it instead of an i/o handler thread. This is only
+possible with io_uring; with the other AIO implementations no write is
+ever returned.
+@param[out]	m1		the messages passed with the AIO request,
+@param[out]	m2		NULL if no write has completed
+@param[out]	request		OS_FILE_WRITE
+@return DB_SUCCESS or error code */
+dberr_t
+os_aio_reap_write(
+	fil_node_t**	m1,
+	void**		m2,
+	IORequest*	request)
+{
+#ifdef LINUX_IO_URING
+	if (srv_use_io_uring) {
+		return(AIO::uring_reap_write(m1, m2, request));
+	}
+#endif /* LINUX_IO_URING */
+
+	*m1 = NULL;
+	*m2 = NULL;
+
+	return(DB_SUCCESS);
+}
+
 /** Calculates segment number for a slot.
 @param[in]	array		AIO wait array
 @param[in]	slot		slot in this array
@@ -6875,9 +7918,11 @@ AIO::reserve_slot(
 
 		release();
 
-		if (!srv_use_native_aio) {
+		if (!srv_use_native_aio || srv_use_io_uring) {
 			/* If the handler threads are suspended,
-			wake them so that we get more slots */
+			wake them so that we get more slots. With
+			io_uring, submit the requests that are
+			still queued. */
 
 			os_aio_simulated_wake_handler_threads();
 		}
@@ -7042,7 +8087,7 @@ AIO::reserve_slot(
 #elif defined(LINUX_NATIVE_AIO)
 
 	/* If we are not using native AIO skip this part. */
-	if (srv_use_native_aio) {
+	if (srv_use_native_aio && !srv_use_io_uring) {
 
 		off_t		aio_offset;
 
@@ -7071,6 +8116,16 @@ AIO::reserve_slot(
 	}
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_IO_URING
+	if (srv_use_io_uring) {
+
+		slot->n_bytes = 0;
+		slot->uring_ret = 0;
+
+		uring_prepare(slot);
+	}
+#endif /* LINUX_IO_URING */
+
 	release();
 
 	return(slot);
@@ -7135,6 +8190,15 @@ os_aio_simulated_wake_handler_threads()
 	if (srv_use_native_aio) {
 		/* We do not use simulated aio: do nothing */
 
+#ifdef LINUX_IO_URING
+		if (srv_use_io_uring) {
+			/* Submit the requests that were queued without
+			waking, one batch per segment */
+
+			AIO::uring_submit_all();
+		}
+#endif /* LINUX_IO_URING */
+
 		return;
 	}
 
@@ -7182,10 +8246,10 @@ AIO::select_slot_array(IORequest& type, bool read_only, ulint mode)
 	case OS_AIO_SYNC:
 
 		array = AIO::s_sync;
-#if defined(LINUX_NATIVE_AIO)
+#if defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
 		/* In Linux native AIO we don't use sync IO array. */
 		ut_a(!srv_use_native_aio);
-#endif /* LINUX_NATIVE_AIO */
+#endif /* LINUX_NATIVE_AIO || LINUX_IO_URING */
 		break;
 
 	default:
@@ -7456,8 +8520,8 @@ try_again:
 			ret = ReadFile(
 				file.m_file, slot->ptr, slot->len,
 				&slot->n_bytes, &slot->control);
-#elif defined(LINUX_NATIVE_AIO)
-			if (!array->linux_dispatch(slot)) {
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
+			if (!array->native_dispatch(slot)) {
 				goto err_exit;
 			}
 #endif /* WIN_ASYNC_IO */
@@ -7474,8 +8538,8 @@ try_again:
 			ret = WriteFile(
 				file.m_file, slot->ptr, slot->len,
 				&slot->n_bytes, &slot->control);
-#elif defined(LINUX_NATIVE_AIO)
-			if (!array->linux_dispatch(slot)) {
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
+			if (!array->native_dispatch(slot)) {
 				goto err_exit;
 			}
 #endif /* WIN_ASYNC_IO */
@@ -7520,9 +8584,10 @@ try_again:
 	/* AIO request was queued successfully! */
 	return(DB_SUCCESS);
 
-#if defined LINUX_NATIVE_AIO || defined WIN_ASYNC_IO
+#if defined LINUX_NATIVE_AIO || defined LINUX_IO_URING \
+	|| defined WIN_ASYNC_IO
 err_exit:
-#endif /* LINUX_NATIVE_AIO || WIN_ASYNC_IO */
+#endif /* LINUX_NATIVE_AIO || LINUX_IO_URING || WIN_ASYNC_IO */
 
 	array->release_with_mutex(slot);
 
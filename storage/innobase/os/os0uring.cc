@@ -0,0 +1,331 @@
+/*****************************************************************************
+
+Copyright (c) 2017, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file os/os0uring.cc
+The interface to the Linux io_uring asynchronous i/o system calls
+*******************************************************/
+
+#include "os0uring.h"
+
+#ifdef LINUX_IO_URING
+
+#include <algorithm>
+
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/** Constructor */
+IoUring::IoUring()
+	:
+	m_fd(-1),
+	m_sq_ring(MAP_FAILED),
+	m_sq_ring_size(),
+	m_cq_ring(MAP_FAILED),
+	m_cq_ring_size(),
+	m_sqes(static_cast<struct io_uring_sqe*>(MAP_FAILED)),
+	m_sqes_size(),
+	m_sq_entries(),
+	m_sq_head(),
+	m_sq_tail(),
+	m_sq_mask(),
+	m_sq_array(),
+	m_cq_head(),
+	m_cq_tail(),
+	m_cq_mask(),
+	m_cqes()
+{
+}
+
+/** Create the rings.
+@param[in]	entries		size of the submission queue; the completion
+				queue is twice as large
+@return 0 or -errno; -EOPNOTSUPP if the kernel cannot wait for
+completions with a timeout */
+int
+IoUring::open(ulint entries)
+{
+	ut_ad(!is_open());
+
+	struct io_uring_params	params;
+
+	memset(&params, 0x0, sizeof(params));
+
+	/* There is never more than one request per AIO slot in flight,
+	so a completion queue of twice the size cannot overflow. */
+	params.flags = IORING_SETUP_CQSIZE;
+	params.cq_entries = static_cast<unsigned>(2 * entries);
+
+	int	fd = static_cast<int>(syscall(
+		__NR_io_uring_setup, static_cast<unsigned>(entries), &params));
+
+	if (fd < 0) {
+		return(-errno);
+	}
+
+	m_fd = fd;
+
+	if (!(params.features & IORING_FEAT_EXT_ARG)) {
+		close();
+		return(-EOPNOTSUPP);
+	}
+
+	m_sq_ring_size = params.sq_off.array
+		+ params.sq_entries * sizeof(unsigned);
+	m_cq_ring_size = params.cq_off.cqes
+		+ params.cq_entries * sizeof(struct io_uring_cqe);
+
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		m_sq_ring_size = m_cq_ring_size
+			= std::max(m_sq_ring_size, m_cq_ring_size);
+	}
+
+	m_sq_ring = mmap(NULL, m_sq_ring_size, PROT_READ | PROT_WRITE,
+			 MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+
+	if (m_sq_ring == MAP_FAILED) {
+		int	err = errno;
+		close();
+		return(-err);
+	}
+
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		m_cq_ring = m_sq_ring;
+	} else {
+		m_cq_ring = mmap(NULL, m_cq_ring_size, PROT_READ | PROT_WRITE,
+				 MAP_SHARED | MAP_POPULATE, m_fd,
+				 IORING_OFF_CQ_RING);
+
+		if (m_cq_ring == MAP_FAILED) {
+			int	err = errno;
+			close();
+			return(-err);
+		}
+	}
+
+	m_sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+	m_sqes = static_cast<struct io_uring_sqe*>(
+		mmap(NULL, m_sqes_size, PROT_READ | PROT_WRITE,
+		     MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES));
+
+	if (m_sqes == MAP_FAILED) {
+		int	err = errno;
+		close();
+		return(-err);
+	}
+
+	byte*	sq = static_cast<byte*>(m_sq_ring);
+	byte*	cq = static_cast<byte*>(m_cq_ring);
+
+	m_sq_entries = params.sq_entries;
+	m_sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+	m_sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+	m_sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+	m_sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+	m_cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+	m_cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+	m_cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+	m_cqes = reinterpret_cast<struct io_uring_cqe*>(
+		cq + params.cq_off.cqes);
+
+	return(0);
+}
+
+/** Destroy the rings. */
+void
+IoUring::close()
+{
+	if (m_sqes != MAP_FAILED) {
+		munmap(m_sqes, m_sqes_size);
+		m_sqes = static_cast<struct io_uring_sqe*>(MAP_FAILED);
+	}
+
+	if (m_cq_ring != MAP_FAILED && m_cq_ring != m_sq_ring) {
+		munmap(m_cq_ring, m_cq_ring_size);
+	}
+
+	m_cq_ring = MAP_FAILED;
+
+	if (m_sq_ring != MAP_FAILED) {
+		munmap(m_sq_ring, m_sq_ring_size);
+		m_sq_ring = MAP_FAILED;
+	}
+
+	if (m_fd >= 0) {
+		::close(m_fd);
+		m_fd = -1;
+	}
+}
+
+/** Register fixed buffers, replacing any earlier registration.
+@param[in]	iov	buffers, each of at most 1GiB
+@param[in]	n	number of buffers, 0 to drop the registration
+@return 0 or -errno */
+int
+IoUring::register_buffers(const struct iovec* iov, ulint n)
+{
+	ut_ad(is_open());
+
+	/* Fails with ENXIO if nothing was registered. */
+	syscall(__NR_io_uring_register, m_fd,
+		IORING_UNREGISTER_BUFFERS, NULL, 0);
+
+	if (n == 0) {
+		return(0);
+	}
+
+	long	ret = syscall(__NR_io_uring_register, m_fd,
+			      IORING_REGISTER_BUFFERS, iov,
+			      static_cast<unsigned>(n));
+
+	return(ret < 0 ? -errno : 0);
+}
+
+/** Queue a read or a write in the submission queue.  The kernel will not
+see it before the next submit() or wait().
+@param[in]	read		true for a read, false for a write
+@param[in]	fd		file descriptor
+@param[in]	buf		buffer
+@param[in]	len		number of bytes to transfer
+@param[in]	offset		file offset
+@param[in]	data		returned with the completion
+@param[in]	buf_index	index of the fixed buffer that holds buf, or -1
+				if it is not in one
+@return false if the submission queue is full */
+bool
+IoUring::prepare(
+	bool		read,
+	int		fd,
+	void*		buf,
+	ulint		len,
+	uint64_t	offset,
+	void*		data,
+	int		buf_index)
+{
+	ut_ad(is_open());
+
+	/* We are the only writer of the tail. */
+	unsigned	tail = *m_sq_tail;
+
+	if (tail - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE)
+	    >= m_sq_entries) {
+
+		return(false);
+	}
+
+	unsigned		index = tail & m_sq_mask;
+	struct io_uring_sqe*	sqe = &m_sqes[index];
+
+	memset(sqe, 0x0, sizeof(*sqe));
+
+	if (buf_index < 0) {
+		sqe->opcode = read ? IORING_OP_READ : IORING_OP_WRITE;
+	} else {
+		sqe->opcode = read
+			? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+		sqe->buf_index = static_cast<uint16_t>(buf_index);
+	}
+
+	sqe->fd = fd;
+	sqe->addr = reinterpret_cast<uintptr_t>(buf);
+	sqe->len = static_cast<uint32_t>(len);
+	sqe->off = offset;
+	sqe->user_data = reinterpret_cast<uintptr_t>(data);
+
+	m_sq_array[index] = index;
+
+	/* Publish the entry to the kernel. */
+	__atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+	return(true);
+}
+
+/** Take a completion from the completion queue.
+@param[out]	data	the data passed to prepare()
+@param[out]	res	number of bytes transferred or -errno
+@return false if the completion queue is empty */
+bool
+IoUring::reap(void** data, int* res)
+{
+	ut_ad(is_open());
+
+	/* We are the only writer of the head. */
+	unsigned	head = *m_cq_head;
+
+	if (head == __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE)) {
+		return(false);
+	}
+
+	const struct io_uring_cqe*	cqe = &m_cqes[head & m_cq_mask];
+
+	*data = reinterpret_cast<void*>(static_cast<uintptr_t>(
+		cqe->user_data));
+	*res = cqe->res;
+
+	/* Give the entry back to the kernel. */
+	__atomic_store_n(m_cq_head, head + 1, __ATOMIC_RELEASE);
+
+	return(true);
+}
+
+/** Call io_uring_enter().
+@param[in]	to_submit	number of requests to submit
+@param[in]	min_complete	number of completions to wait for
+@param[in]	timeout_ns	maximum time to wait, in nanoseconds
+@return number of requests submitted, or -errno */
+int
+IoUring::enter(ulint to_submit, ulint min_complete, uint64_t timeout_ns)
+{
+	ut_ad(is_open());
+
+	if (to_submit == 0 && min_complete == 0) {
+		return(0);
+	}
+
+	unsigned			flags = 0;
+	struct __kernel_timespec	ts;
+	struct io_uring_getevents_arg	arg;
+
+	memset(&arg, 0x0, sizeof(arg));
+
+	if (min_complete > 0) {
+		ts.tv_sec = timeout_ns / 1000000000;
+		ts.tv_nsec = timeout_ns % 1000000000;
+
+		arg.sigmask_sz = _NSIG / 8;
+		arg.ts = reinterpret_cast<uintptr_t>(&ts);
+
+		flags = IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+	}
+
+	long	ret = syscall(__NR_io_uring_enter, m_fd,
+			      static_cast<unsigned>(to_submit),
+			      static_cast<unsigned>(min_complete), flags,
+			      min_complete > 0 ? &arg : NULL,
+			      min_complete > 0 ? sizeof(arg) : 0);
+
+	return(ret < 0 ? -errno : static_cast<int>(ret));
+}
+
+#endif /* LINUX_IO_URING */
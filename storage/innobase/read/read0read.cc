@@ -23,8 +23,11 @@ Cursor read
 Created 2/16/1997 Heikki Tuuri
 *******************************************************/
 
+#include <atomic>
+
 #include "read0read.h"
 
+#include "srv0mon.h"
 #include "srv0srv.h"
 #include "trx0sys.h"
 
@@ -325,7 +328,8 @@ ReadView::ReadView()
 	m_up_limit_id(),
 	m_creator_trx_id(),
 	m_ids(),
-	m_low_limit_no()
+	m_low_limit_no(),
+	m_rw_trx_ids_version()
 {
 	ut_d(::memset(&m_view_list, 0x0, sizeof(m_view_list)));
 }
@@ -450,6 +454,8 @@ ReadView::prepare(trx_id_t id)
 
 	m_low_limit_no = m_low_limit_id = trx_sys->max_trx_id;
 
+	m_rw_trx_ids_version = trx_sys->rw_trx_ids_version;
+
 	if (!trx_sys->rw_trx_ids.empty()) {
 		copy_trx_ids(trx_sys->rw_trx_ids);
 	} else {
@@ -557,19 +563,33 @@ MVCC::view_open(ReadView*& view, trx_t* trx)
 
 		ut_ad(view->m_closed);
 
-		/* NOTE: This can be optimised further, for now we only
-		resuse the view iff there are no active RW transactions.
+		/* The snapshot is still current if no RW transaction
+		has been started (max_trx_id is unchanged) and none has
+		been removed from trx_sys->rw_trx_ids since the view was
+		created. It does not matter whether the snapshot contains
+		active transactions or not, the view is then identical to
+		the one that we would create under the trx_sys->mutex.
 
 		There is an inherent race here between purge and this
 		thread. Purge will skip views that are marked as closed.
-		Therefore we must set the low limit id after we reset the
-		closed status after the check. */
+		Therefore we must reset the closed status before we check
+		that the snapshot is still current, and the store must be
+		visible before the loads. */
 
-		if (trx_is_autocommit_non_locking(trx) && view->empty()) {
+		if (trx_is_autocommit_non_locking(trx)) {
+
+			ut_ad(view->m_creator_trx_id == 0);
 
 			view->m_closed = false;
 
-			if (view->m_low_limit_id == trx_sys_get_max_trx_id()) {
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			if (view->m_low_limit_id == trx_sys_get_max_trx_id()
+			    && view->m_rw_trx_ids_version
+			    == trx_sys_get_rw_trx_ids_version()) {
+
+				MONITOR_INC(MONITOR_TRX_VIEW_REUSED);
+
 				return;
 			} else {
 				view->m_closed = true;
@@ -649,6 +669,8 @@ ReadView::copy_prepare(const ReadView& other)
 	m_low_limit_id = other.m_low_limit_id;
 
 	m_creator_trx_id = other.m_creator_trx_id;
+
+	m_rw_trx_ids_version = other.m_rw_trx_ids_version;
 }
 
 /**
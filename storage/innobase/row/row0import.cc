@@ -2088,6 +2088,9 @@ PageConverter::update_page(
 	case FIL_PAGE_SDI_BLOB:
 	case FIL_PAGE_SDI_ZBLOB:
 	case FIL_PAGE_TYPE_RSEG_ARRAY:
+	case FIL_PAGE_TYPE_LOB_FIRST:
+	case FIL_PAGE_TYPE_LOB_INDEX:
+	case FIL_PAGE_TYPE_LOB_DATA:
 
 		/* Work directly on the uncompressed page headers. */
 		/* This is on every page in the tablespace. */
@@ -33,6 +33,7 @@ Created 4/20/1996 Heikki Tuuri
 #include "dict0boot.h"
 #include "dict0dd.h"
 #include "dict0dict.h"
+#include "dict0stats.h"
 #include "eval0eval.h"
 #include "fts0fts.h"
 #include "fts0types.h"
@@ -3810,6 +3811,10 @@ row_ins_index_entry_step(
 
 	err = row_ins_index_entry(node->index, node->entry, thr);
 
+	if (err == DB_SUCCESS) {
+		dict_stats_index_modified(node->index);
+	}
+
 	DEBUG_SYNC_C_IF_THD(thr_get_trx(thr)->mysql_thd,
 			    "after_row_ins_index_entry_step");
 
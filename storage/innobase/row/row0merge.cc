@@ -27,6 +27,9 @@ Completed by Sunny Bains and Marko Makela
 #include <fcntl.h>
 #include <math.h>
 #include <sys/types.h>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 #include "btr0bulk.h"
 #include "dict0crea.h"
@@ -39,6 +42,7 @@ Completed by Sunny Bains and Marko Makela
 #include "my_dbug.h"
 #include "my_inttypes.h"
 #include "my_psi_config.h"
+#include "os0thread-create.h"
 #include "pars0pars.h"
 #include "row0ext.h"
 #include "row0ftsort.h"
@@ -46,6 +50,7 @@ Completed by Sunny Bains and Marko Makela
 #include "row0ins.h"
 #include "row0log.h"
 #include "row0merge.h"
+#include "row0pread.h"
 #include "row0sel.h"
 #include "trx0purge.h"
 #include "ut0new.h"
@@ -60,6 +65,10 @@ Completed by Sunny Bains and Marko Makela
 /* Whether to disable file system cache */
 bool	srv_disable_sort_file_cache;
 
+#ifdef UNIV_PFS_THREAD
+mysql_pfs_key_t	row_merge_thread_key;
+#endif /* UNIV_PFS_THREAD */
+
 /** Class that caches index row tuples made from a single cluster
 index page scan, and then insert into corresponding index tree */
 class index_tuple_info_t {
@@ -2687,6 +2696,438 @@ wait_again:
 	DBUG_RETURN(err);
 }
 
+/** Decide how many threads to read the clustered index with when
+creating secondary indexes. Only plain secondary indexes on a table that
+is not being rebuilt are built from a parallel scan; a table rebuild,
+FULLTEXT, SPATIAL and virtual column indexes need the state of the
+serial scan (sequences, tokenizer threads, spatial tuple caches).
+@param[in]	trx		transaction
+@param[in]	old_table	table where rows are read from
+@param[in]	new_table	table where indexes are created
+@param[in]	online		true if creating indexes online
+@param[in]	indexes		indexes to be created
+@param[in]	n_indexes	size of indexes[]
+@param[in]	add_v		new virtual columns added along with indexes
+@return number of threads, 1 if the serial scan must be used */
+static
+size_t
+row_merge_parallel_scan_threads(
+	trx_t*			trx,
+	const dict_table_t*	old_table,
+	const dict_table_t*	new_table,
+	bool			online,
+	dict_index_t**		indexes,
+	ulint			n_indexes,
+	const dict_add_v_col_t*	add_v)
+{
+	if (old_table != new_table
+	    || old_table->is_temporary()
+	    || add_v != NULL
+	    || trx->mysql_thd == NULL) {
+		return(1);
+	}
+
+	DBUG_EXECUTE_IF("ib_purge_on_create_index_page_switch",
+			return(1););
+
+	for (ulint i = 0; i < n_indexes; i++) {
+		if ((indexes[i]->type & DICT_FTS)
+		    || dict_index_is_spatial(indexes[i])
+		    || dict_index_has_virtual(indexes[i])) {
+			return(1);
+		}
+	}
+
+	/* The parallel reader reads the versions visible to the read
+	view when there is one. A locking ALTER TABLE reads the latest
+	committed versions instead. */
+	if (!online && MVCC::is_view_active(trx->read_view)) {
+		return(1);
+	}
+
+	const size_t	n_threads = thd_parallel_read_threads(trx->mysql_thd);
+
+	if (n_threads <= 1) {
+		return(1);
+	}
+
+	/* The serial scan inserts the entries of a table that fits in
+	one sort buffer without using temporary files at all. */
+	dict_index_t*	clust_index
+		= const_cast<dict_table_t*>(old_table)->first_index();
+	mtr_t		mtr;
+
+	mtr.start();
+	mtr_s_lock(dict_index_get_lock(clust_index), &mtr);
+	const ulint	n_pages = btr_get_size(
+		clust_index, BTR_N_LEAF_PAGES, &mtr);
+	mtr.commit();
+
+	if (n_pages == ULINT_UNDEFINED
+	    || n_pages * UNIV_PAGE_SIZE <= srv_sort_buf_size) {
+		return(1);
+	}
+
+	return(n_threads);
+}
+
+/** Sort a full buffer of a parallel clustered index scan and write it
+as one run to the merge file.
+@param[in,out]	buf		sort buffer
+@param[in,out]	file		merge file
+@param[in,out]	block		buffer of srv_sort_buf_size bytes
+@param[in,out]	n_blocks	number of blocks written to file
+@param[in,out]	table		MySQL table, for reporting the duplicate key
+@param[in,out]	dup_reported	whether a duplicate was reported in table
+@return DB_SUCCESS or error code */
+static MY_ATTRIBUTE((warn_unused_result))
+dberr_t
+row_merge_buf_sort_and_write(
+	row_merge_buf_t*	buf,
+	merge_file_t*		file,
+	row_merge_block_t*	block,
+	std::atomic<ulint>*	n_blocks,
+	struct TABLE*		table,
+	std::atomic<bool>*	dup_reported)
+{
+	if (dict_index_is_unique(buf->index)) {
+		/* Several threads may find duplicates at the same time,
+		but only one of them may copy the key to table->record[0].
+		Starting n_dup at 1 makes row_merge_dup_report() only count
+		the duplicates. */
+		row_merge_dup_t	dup = {buf->index, table, NULL, 1};
+
+		row_merge_buf_sort(buf, &dup);
+
+		if (dup.n_dup > 1) {
+			bool	reported = false;
+
+			if (dup_reported->compare_exchange_strong(
+				    reported, true)) {
+				row_merge_dup_t	report = {
+					buf->index, table, NULL, 0};
+
+				row_merge_buf_sort(buf, &report);
+				ut_ad(report.n_dup > 0);
+			}
+
+			return(DB_DUPLICATE_KEY);
+		}
+	} else {
+		row_merge_buf_sort(buf, NULL);
+	}
+
+	row_merge_buf_write(buf, file, block);
+
+	if (!row_merge_write(file->fd, n_blocks->fetch_add(1), block)) {
+		return(DB_TEMP_FILE_WRITE_FAIL);
+	}
+
+	UNIV_MEM_INVALID(&block[0], srv_sort_buf_size);
+
+	return(DB_SUCCESS);
+}
+
+/** Read the clustered index of the table with several threads and create
+the temporary files containing the secondary index entries for merge
+sort. Each thread fills its own sort buffers and writes every full buffer
+as a run to the merge file of the index; the runs of all threads are
+merged by row_merge_sort() afterwards.
+@param[in]	trx		transaction
+@param[in,out]	table		MySQL table object, for reporting erroneous
+				records
+@param[in]	old_table	table where rows are read from
+@param[in]	online		true if creating indexes online
+@param[in]	index		indexes to be created
+@param[in,out]	files		temporary files
+@param[in]	key_numbers	MySQL key numbers to create
+@param[in]	n_index		number of indexes to create
+@param[in]	n_threads	number of threads to read with
+@param[in,out]	tmpfd		temporary file handle
+@param[in,out]	stage		performance schema accounting object, used by
+ALTER TABLE. stage->n_pk_recs_inc() and stage->inc() will be called for the
+records and pages read.
+@return DB_SUCCESS or error code */
+static MY_ATTRIBUTE((warn_unused_result))
+dberr_t
+row_merge_read_clustered_index_parallel(
+	trx_t*			trx,
+	struct TABLE*		table,
+	const dict_table_t*	old_table,
+	bool			online,
+	dict_index_t**		index,
+	merge_file_t*		files,
+	const ulint*		key_numbers,
+	ulint			n_index,
+	size_t			n_threads,
+	int*			tmpfd,
+	ut_stage_alter_t*	stage)
+{
+	/** State of a scan thread */
+	struct thread_ctx_t {
+		/** Sort buffers, one for each index */
+		std::vector<row_merge_buf_t*>	bufs;
+
+		/** Number of records added for each index */
+		std::vector<ulint>		n_recs;
+
+		/** Buffer for writing runs */
+		row_merge_block_t*		block;
+
+		/** Memory for the block */
+		ut_new_pfx_t			block_pfx;
+
+		/** Heap for building the rows */
+		mem_heap_t*			row_heap;
+
+		/** Page of the last record read */
+		const buf_block_t*		last_block;
+
+		/** Number of records read since the last call of
+		stage->n_pk_recs_inc() */
+		ulint				n_pk_recs;
+	};
+
+	dict_index_t*	clust_index
+		= const_cast<dict_table_t*>(old_table)->first_index();
+	dberr_t		err = DB_SUCCESS;
+	DBUG_ENTER("row_merge_read_clustered_index_parallel");
+
+	ut_ad(n_threads > 1);
+
+	trx->op_info = "reading clustered index";
+
+	const char*	path = thd_innodb_tmpdir(trx->mysql_thd);
+
+	for (ulint i = 0; i < n_index; i++) {
+		if (row_merge_file_create_if_needed(
+			    &files[i], tmpfd, 0, path) < 0) {
+			trx->error_key_num = i;
+			trx->op_info = "";
+			DBUG_RETURN(DB_OUT_OF_MEMORY);
+		}
+	}
+
+	Parallel_reader	reader(trx, clust_index, n_threads);
+
+	ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
+	std::vector<thread_ctx_t>	ctxs(reader.n_threads());
+
+	for (auto& ctx : ctxs) {
+		ctx.block = alloc.allocate_large(
+			srv_sort_buf_size, &ctx.block_pfx);
+
+		if (ctx.block == NULL) {
+			err = DB_OUT_OF_MEMORY;
+		}
+
+		for (ulint i = 0; i < n_index; i++) {
+			ctx.bufs.push_back(row_merge_buf_create(index[i]));
+		}
+
+		ctx.n_recs.resize(n_index);
+		ctx.row_heap = mem_heap_create(sizeof(mrec_buf_t));
+		ctx.last_block = NULL;
+		ctx.n_pk_recs = 0;
+	}
+
+	std::vector<std::atomic<ulint> >	n_blocks(n_index);
+	std::atomic<bool>			dup_reported(false);
+	std::atomic<ulint>			err_index(ULINT_UNDEFINED);
+	std::atomic<dberr_t>			first_err(DB_SUCCESS);
+
+	/* Remember the first error of any thread, and the index for
+	which it happened. */
+	auto	set_err = [&](ulint i, dberr_t e) {
+		ulint	none = ULINT_UNDEFINED;
+
+		if (err_index.compare_exchange_strong(none, i)) {
+			first_err.store(e);
+		}
+	};
+
+	/* Sort and write the buffer of index i of a thread. */
+	auto	write_buf = [&](thread_ctx_t& ctx, ulint i) -> dberr_t {
+		dberr_t	e = row_merge_buf_sort_and_write(
+			ctx.bufs[i], &files[i], ctx.block, &n_blocks[i],
+			table, &dup_reported);
+
+		if (e != DB_SUCCESS) {
+			set_err(i, e);
+		}
+
+		ctx.bufs[i] = row_merge_buf_empty(ctx.bufs[i]);
+
+		return(e);
+	};
+
+	if (err == DB_SUCCESS) {
+		err = reader.run([&](const Parallel_reader::Ctx& rctx)
+		{
+			thread_ctx_t&	ctx = ctxs[rctx.m_thread_id];
+
+			if (rctx.m_block != ctx.last_block) {
+				if (ctx.last_block != NULL) {
+					stage->n_pk_recs_inc(ctx.n_pk_recs);
+					stage->inc();
+					ctx.n_pk_recs = 0;
+				}
+
+				ctx.last_block = rctx.m_block;
+
+				if (trx_is_interrupted(trx)) {
+					set_err(0, DB_INTERRUPTED);
+					return(DB_INTERRUPTED);
+				}
+			}
+
+			++ctx.n_pk_recs;
+
+			mem_heap_empty(ctx.row_heap);
+
+			row_ext_t*	ext = NULL;
+			const dtuple_t*	row = row_build_w_add_vcol(
+				ROW_COPY_POINTERS, clust_index, rctx.m_rec,
+				rctx.m_offsets, old_table, NULL, NULL, NULL,
+				&ext, ctx.row_heap);
+
+			for (ulint i = 0; i < n_index; i++) {
+				doc_id_t	doc_id = 0;
+				dberr_t		e = DB_SUCCESS;
+				ulint		n_added = row_merge_buf_add(
+					ctx.bufs[i], NULL, old_table,
+					old_table, NULL, row, ext, &doc_id,
+					NULL, &e, NULL, NULL, trx);
+
+				if (n_added == 0) {
+					/* The buffer is full. Write it
+					out and try again. */
+					e = write_buf(ctx, i);
+
+					if (e != DB_SUCCESS) {
+						return(e);
+					}
+
+					n_added = row_merge_buf_add(
+						ctx.bufs[i], NULL, old_table,
+						old_table, NULL, row, ext,
+						&doc_id, NULL, &e, NULL, NULL,
+						trx);
+
+					/* An empty buffer should have
+					enough room for at least one
+					record. */
+					ut_a(n_added > 0);
+				}
+
+				ut_ad(e == DB_SUCCESS);
+				ctx.n_recs[i] += n_added;
+			}
+
+			return(DB_SUCCESS);
+		});
+	}
+
+	/* Write the last, partially filled buffers of each thread, with
+	the threads that the reader reserved. */
+	auto	finish = [&](size_t thread_id) {
+		thread_ctx_t&	ctx = ctxs[thread_id];
+
+		stage->n_pk_recs_inc(ctx.n_pk_recs);
+
+		for (ulint i = 0; i < n_index; i++) {
+			if (ctx.bufs[i]->n_tuples > 0
+			    && write_buf(ctx, i) != DB_SUCCESS) {
+				break;
+			}
+		}
+	};
+
+	if (err == DB_SUCCESS) {
+#ifdef UNIV_PFS_THREAD
+		Runnable	runnable(row_merge_thread_key);
+#else
+		Runnable	runnable(0);
+#endif /* UNIV_PFS_THREAD */
+
+		std::vector<std::thread>	threads;
+
+		for (size_t t = 1; t < ctxs.size(); ++t) {
+			threads.push_back(std::thread(runnable, finish, t));
+		}
+
+		finish(0);
+
+		for (auto& thread : threads) {
+			thread.join();
+		}
+
+		if (err_index.load() != ULINT_UNDEFINED) {
+			err = first_err.load();
+		}
+	}
+
+	if (err != DB_SUCCESS) {
+		ulint	i = err_index.load();
+
+		if (i == ULINT_UNDEFINED || err == DB_INTERRUPTED) {
+			i = 0;
+		}
+
+		trx->error_key_num = err == DB_DUPLICATE_KEY
+			? key_numbers[i] : i;
+	}
+
+	for (ulint i = 0; i < n_index; i++) {
+		files[i].offset = n_blocks[i].load();
+		files[i].n_rec = 0;
+
+		for (const auto& ctx : ctxs) {
+			files[i].n_rec += ctx.n_recs[i];
+		}
+
+		if (err == DB_SUCCESS && files[i].offset == 0) {
+			/* No records: there is nothing to sort. */
+			row_merge_file_destroy(&files[i]);
+		}
+
+		if (err != DB_SUCCESS || !online) {
+			continue;
+		}
+
+		/* Note the newest transaction that modified this index
+		when the scan was completed. We prevent older readers
+		from accessing this index, to ensure read consistency. */
+		rw_lock_x_lock(dict_index_get_lock(index[i]));
+		ut_a(dict_index_get_online_status(index[i])
+		     == ONLINE_INDEX_CREATION);
+
+		const trx_id_t	max_trx_id = row_log_get_max_trx(index[i]);
+
+		if (max_trx_id > index[i]->trx_id) {
+			index[i]->trx_id = max_trx_id;
+		}
+
+		rw_lock_x_unlock(dict_index_get_lock(index[i]));
+	}
+
+	for (auto& ctx : ctxs) {
+		for (auto buf : ctx.bufs) {
+			row_merge_buf_free(buf);
+		}
+
+		mem_heap_free(ctx.row_heap);
+
+		if (ctx.block != NULL) {
+			alloc.deallocate_large(ctx.block, &ctx.block_pfx);
+		}
+	}
+
+	trx->op_info = "";
+
+	DBUG_RETURN(err);
+}
+
 /** Write a record via buffer 2 and read the next record to buffer N.
 @param N number of the buffer (0 or 1)
 @param INDEX record descriptor
@@ -4355,6 +4796,175 @@ row_merge_write_redo(
 	mtr.commit();
 }
 
+/** Sort the merge files of several indexes and insert the sorted entries
+into the indexes, with one thread per index. The entries of all indexes
+are sorted before the first index is loaded, so that the stage of the
+ALTER TABLE moves from sort to insert only once. Duplicates of UNIQUE
+indexes are reported in the MySQL table, so those indexes are always
+sorted by the calling thread.
+@param[in]	trx		transaction
+@param[in]	old_table	table where rows are read from
+@param[in]	indexes		indexes to be created
+@param[in,out]	files		merge files of the indexes
+@param[in]	n_indexes	size of indexes[]
+@param[in,out]	table		MySQL table, for reporting erroneous key value
+@param[in]	observer	flush observer for the bulk loads
+@param[in,out]	block		3 buffers for the calling thread
+@param[in,out]	tmpfd		temporary file handle of the calling thread
+@param[in,out]	stage		performance schema accounting object
+@param[in]	n_threads	number of threads requested, including the
+				calling thread
+@param[out]	errors		DB_SUCCESS or error code for each index */
+static
+void
+row_merge_sort_and_insert_parallel(
+	trx_t*			trx,
+	const dict_table_t*	old_table,
+	dict_index_t**		indexes,
+	merge_file_t*		files,
+	ulint			n_indexes,
+	struct TABLE*		table,
+	FlushObserver*		observer,
+	row_merge_block_t*	block,
+	int*			tmpfd,
+	ut_stage_alter_t*	stage,
+	size_t			n_threads,
+	dberr_t*		errors)
+{
+	std::vector<ulint>	unique;
+	std::vector<ulint>	others;
+	ulint			max_runs = 0;
+
+	for (ulint i = 0; i < n_indexes; i++) {
+		errors[i] = DB_SUCCESS;
+
+		if (files[i].fd < 0) {
+			continue;
+		}
+
+		ut_ad(!dict_index_is_spatial(indexes[i]));
+		ut_ad(!(indexes[i]->type & DICT_FTS));
+
+		if (dict_index_is_unique(indexes[i])) {
+			unique.push_back(i);
+		} else {
+			others.push_back(i);
+		}
+
+		max_runs = std::max(max_runs, files[i].offset);
+	}
+
+	const size_t	n_tasks = unique.size() + others.size();
+
+	if (n_tasks == 0) {
+		return;
+	}
+
+	const size_t	n_workers = Parallel_reader::reserve_threads(
+		std::min(n_threads, n_tasks) - 1);
+
+	ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
+	std::vector<row_merge_block_t*>	blocks(n_workers + 1);
+	std::vector<ut_new_pfx_t>	block_pfx(n_workers + 1);
+	std::vector<int>		tmpfds(n_workers + 1, -1);
+	size_t				n_blocks = 1;
+
+	blocks[0] = block;
+
+	for (; n_blocks <= n_workers; ++n_blocks) {
+		blocks[n_blocks] = alloc.allocate_large(
+			3 * srv_sort_buf_size, &block_pfx[n_blocks]);
+
+		if (blocks[n_blocks] == NULL) {
+			break;
+		}
+	}
+
+	std::atomic<size_t>	next;
+
+	/* Run f(thread_id, i) for the indexes in tasks, with the calling
+	thread first running it for the indexes in own_tasks. */
+	auto	run = [&](
+		const std::vector<ulint>&	own_tasks,
+		const std::vector<ulint>&	tasks,
+		std::function<void(size_t, ulint)>	f)
+	{
+		auto	worker = [&](size_t thread_id) {
+			size_t	k;
+
+			while ((k = next.fetch_add(1)) < tasks.size()) {
+				f(thread_id, tasks[k]);
+			}
+		};
+
+		next = 0;
+
+#ifdef UNIV_PFS_THREAD
+		Runnable	runnable(row_merge_thread_key);
+#else
+		Runnable	runnable(0);
+#endif /* UNIV_PFS_THREAD */
+
+		std::vector<std::thread>	threads;
+
+		for (size_t t = 1; t < n_blocks; ++t) {
+			threads.push_back(std::thread(runnable, worker, t));
+		}
+
+		for (auto i : own_tasks) {
+			f(0, i);
+		}
+
+		worker(0);
+
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	};
+
+	stage->begin_phase_sort(log2(max_runs));
+
+	run(unique, others, [&](size_t thread_id, ulint i) {
+		row_merge_dup_t	dup = {
+			indexes[i], thread_id == 0 ? table : NULL, NULL, 0};
+
+		errors[i] = row_merge_sort(
+			trx, &dup, &files[i], blocks[thread_id],
+			thread_id == 0 ? tmpfd : &tmpfds[thread_id], stage);
+	});
+
+	for (size_t t = 1; t < n_blocks; ++t) {
+		row_merge_file_destroy_low(tmpfds[t]);
+	}
+
+	std::vector<ulint>	sorted;
+
+	for (ulint i = 0; i < n_indexes; i++) {
+		if (files[i].fd >= 0 && errors[i] == DB_SUCCESS) {
+			sorted.push_back(i);
+		}
+	}
+
+	stage->begin_phase_insert();
+
+	run(std::vector<ulint>(), sorted, [&](size_t thread_id, ulint i) {
+		BtrBulk	btr_bulk(indexes[i], trx->id, observer);
+		btr_bulk.init();
+
+		dberr_t	err = row_merge_insert_index_tuples(
+			trx->id, indexes[i], old_table, files[i].fd,
+			blocks[thread_id], NULL, &btr_bulk, stage);
+
+		errors[i] = btr_bulk.finish(err);
+	});
+
+	for (size_t t = 1; t < n_blocks; ++t) {
+		alloc.deallocate_large(blocks[t], &block_pfx[t]);
+	}
+
+	Parallel_reader::release_threads(n_workers);
+}
+
 /** Build indexes on a table by reading a clustered index, creating a temporary
 file containing index entries, merge sorting these index entries and inserting
 sorted index entries to indexes.
@@ -4414,6 +5024,7 @@ row_merge_build_indexes(
 	fts_psort_t*		merge_info = NULL;
 	int64_t			sig_count = 0;
 	bool			fts_psort_initiated = false;
+	dberr_t*		parallel_errors = NULL;
 	DBUG_ENTER("row_merge_build_indexes");
 
 	ut_ad(!srv_read_only_mode);
@@ -4509,13 +5120,23 @@ row_merge_build_indexes(
 	duplicate keys. */
 	innobase_rec_reset(table);
 
+	const size_t	n_threads = row_merge_parallel_scan_threads(
+		trx, old_table, new_table, online, indexes, n_indexes, add_v);
+
 	/* Read clustered index of the table and create files for
 	secondary index entries for merge sort */
-	error = row_merge_read_clustered_index(
-		trx, table, old_table, new_table, online, indexes,
-		fts_sort_idx, psort_info, merge_files, key_numbers,
-		n_indexes, add_cols, add_v, col_map, add_autoinc,
-		sequence, block, skip_pk_sort, &tmpfd, stage, eval_table);
+	if (n_threads > 1) {
+		error = row_merge_read_clustered_index_parallel(
+			trx, table, old_table, online, indexes, merge_files,
+			key_numbers, n_indexes, n_threads, &tmpfd, stage);
+	} else {
+		error = row_merge_read_clustered_index(
+			trx, table, old_table, new_table, online, indexes,
+			fts_sort_idx, psort_info, merge_files, key_numbers,
+			n_indexes, add_cols, add_v, col_map, add_autoinc,
+			sequence, block, skip_pk_sort, &tmpfd, stage,
+			eval_table);
+	}
 
 	stage->end_phase_read_pk();
 
@@ -4526,6 +5147,18 @@ row_merge_build_indexes(
 
 	DEBUG_SYNC_C("row_merge_after_scan");
 
+	if (n_threads > 1) {
+		/* Sort and load the indexes concurrently; the online
+		logs are still applied one index at a time below. */
+		parallel_errors = static_cast<dberr_t*>(
+			ut_malloc_nokey(n_indexes * sizeof *parallel_errors));
+
+		row_merge_sort_and_insert_parallel(
+			trx, old_table, indexes, merge_files, n_indexes,
+			table, flush_observer, block, &tmpfd, stage,
+			n_threads, parallel_errors);
+	}
+
 	/* Now we have files containing index entries ready for
 	sorting and inserting. */
 
@@ -4601,6 +5234,8 @@ wait_again:
 #ifdef FTS_INTERNAL_DIAG_PRINT
 			DEBUG_FTS_SORT_PRINT("FTS_SORT: Complete Insert\n");
 #endif
+		} else if (parallel_errors != NULL) {
+			error = parallel_errors[i];
 		} else if (merge_files[i].fd >= 0) {
 			row_merge_dup_t	dup = {
 				sort_idx, table, col_map, 0};
@@ -4680,6 +5315,7 @@ func_exit:
 	}
 
 	ut_free(merge_files);
+	ut_free(parallel_errors);
 
 	alloc.deallocate_large(block, &block_pfx);
 
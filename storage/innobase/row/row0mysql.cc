@@ -63,6 +63,7 @@ Created 9/17/2000 Heikki Tuuri
 #include "row0ins.h"
 #include "row0merge.h"
 #include "row0mysql.h"
+#include "row0pread.h"
 #include "row0row.h"
 #include "row0sel.h"
 #include "row0upd.h"
@@ -162,6 +163,41 @@ row_mysql_prebuilt_free_blob_heap(
 	DBUG_VOID_RETURN;
 }
 
+/** Frees the prefetch cache in prebuilt, checking the magic numbers
+around the cached rows.
+@param[in,out]	prebuilt	prebuilt struct of a ha_innobase table handle */
+void
+row_mysql_prebuilt_free_fetch_cache(
+	row_prebuilt_t*	prebuilt)
+{
+	if (prebuilt->fetch_cache_size == 0) {
+		return;
+	}
+
+	byte*	base = prebuilt->fetch_cache[0] - 4;
+	byte*	ptr = base;
+
+	for (ulint i = 0; i < prebuilt->fetch_cache_size; i++) {
+		ulint	magic1 = mach_read_from_4(ptr);
+		ut_a(magic1 == ROW_PREBUILT_FETCH_MAGIC_N);
+		ptr += 4;
+
+		byte*	row = ptr;
+		ut_a(row == prebuilt->fetch_cache[i]);
+		ptr += prebuilt->mysql_row_len;
+
+		ulint	magic2 = mach_read_from_4(ptr);
+		ut_a(magic2 == ROW_PREBUILT_FETCH_MAGIC_N);
+		ptr += 4;
+
+		prebuilt->fetch_cache[i] = NULL;
+	}
+
+	ut_free(base);
+
+	prebuilt->fetch_cache_size = 0;
+}
+
 /*******************************************************************//**
 Stores a >= 5.0.3 format true VARCHAR length to dest, in the MySQL row
 format.
@@ -919,6 +955,8 @@ row_create_prebuilt(
 	prebuilt->magic_n = ROW_PREBUILT_ALLOCATED;
 	prebuilt->magic_n2 = ROW_PREBUILT_ALLOCATED;
 
+	prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
+
 	prebuilt->table = table;
 
 	prebuilt->sql_stat_start = TRUE;
@@ -1026,26 +1064,7 @@ row_prebuilt_free(
 		mem_heap_free(prebuilt->old_vers_heap);
 	}
 
-	if (prebuilt->fetch_cache[0] != NULL) {
-		byte*	base = prebuilt->fetch_cache[0] - 4;
-		byte*	ptr = base;
-
-		for (ulint i = 0; i < MYSQL_FETCH_CACHE_SIZE; i++) {
-			ulint	magic1 = mach_read_from_4(ptr);
-			ut_a(magic1 == ROW_PREBUILT_FETCH_MAGIC_N);
-			ptr += 4;
-
-			byte*	row = ptr;
-			ut_a(row == prebuilt->fetch_cache[i]);
-			ptr += prebuilt->mysql_row_len;
-
-			ulint	magic2 = mach_read_from_4(ptr);
-			ut_a(magic2 == ROW_PREBUILT_FETCH_MAGIC_N);
-			ptr += 4;
-		}
-
-		ut_free(base);
-	}
+	row_mysql_prebuilt_free_fetch_cache(prebuilt);
 
 	if (prebuilt->rtr_info) {
 		rtr_clean_rtr_info(prebuilt->rtr_info, true);
@@ -5849,6 +5868,144 @@ funct_exit:
 	return(err);
 }
 
+/** Scan the clustered index for either COUNT(*) or CHECK TABLE with
+several threads, see row_scan_index_for_mysql(). Each thread checks the
+order of the records within the key ranges it reads.
+@param[in]	prebuilt	prebuilt struct in MySQL handle
+@param[in]	index		clustered index
+@param[in]	check_keys	true=check for mis-ordered or duplicate
+				records, false=count the rows only
+@param[in]	n_threads	number of threads to use
+@param[out]	n_rows		number of entries seen in the consistent
+				read
+@return DB_SUCCESS or other error */
+static
+dberr_t
+row_scan_index_parallel(
+	row_prebuilt_t*	prebuilt,
+	dict_index_t*	index,
+	bool		check_keys,
+	ulint		n_threads,
+	ulint*		n_rows)
+{
+	/** State of one thread of the scan */
+	struct scan_state_t {
+		/** Number of records seen by the thread */
+		ulint		m_n_rows;
+
+		/** Previous record in the current key range */
+		dtuple_t*	m_prev_entry;
+
+		/** Heap for m_prev_entry */
+		mem_heap_t*	m_heap;
+	};
+
+	trx_t*		trx = prebuilt->trx;
+
+	ut_ad(index->is_clustered());
+	ut_ad(prebuilt->select_lock_type == LOCK_NONE);
+
+	trx_start_if_not_started(trx, false);
+
+	if (trx->isolation_level > TRX_ISO_READ_UNCOMMITTED
+	    && !MVCC::is_view_active(trx->read_view)) {
+
+		trx_assign_read_view(trx);
+	}
+
+	Parallel_reader	reader(trx, index, n_threads);
+
+	std::vector<scan_state_t, ut_allocator<scan_state_t> >	states(
+		reader.n_threads());
+
+	for (auto& state : states) {
+		state.m_n_rows = 0;
+		state.m_prev_entry = NULL;
+		state.m_heap = check_keys ? mem_heap_create(100) : NULL;
+	}
+
+	const ulint	n_user_fields =
+		dict_index_get_n_ordering_defined_by_user(index);
+
+	dberr_t	ret = reader.run(
+		[&](const Parallel_reader::Ctx& ctx) -> dberr_t
+		{
+			scan_state_t&	state = states[ctx.m_thread_id];
+
+			++state.m_n_rows;
+
+			if (!check_keys) {
+				return(DB_SUCCESS);
+			}
+
+			if (ctx.m_first) {
+				/* Records are only ordered within a range
+				read by one thread. */
+				state.m_prev_entry = NULL;
+			}
+
+			if (state.m_prev_entry != NULL) {
+				ulint	matched_fields = 0;
+				int	cmp = cmp_dtuple_rec_with_match(
+					state.m_prev_entry, ctx.m_rec, index,
+					ctx.m_offsets, &matched_fields);
+
+				/* The clustered index is unique and
+				does not contain SQL NULLs. */
+				if (cmp > 0 || matched_fields >= n_user_fields) {
+					ib::error()
+						<< (cmp > 0
+						    ? "index records in a wrong"
+						    " order in "
+						    : "duplicate key in ")
+						<< index->name
+						<< " of table "
+						<< index->table->name
+						<< ": " << *state.m_prev_entry
+						<< ", "
+						<< rec_offsets_print(
+							ctx.m_rec,
+							ctx.m_offsets);
+					/* Continue reading */
+				}
+			}
+
+			ulint	n_ext;
+
+			mem_heap_empty(state.m_heap);
+
+			state.m_prev_entry = row_rec_to_index_entry(
+				ctx.m_rec, index, ctx.m_offsets, &n_ext,
+				state.m_heap);
+
+			return(DB_SUCCESS);
+		});
+
+	*n_rows = 0;
+
+	for (auto& state : states) {
+		*n_rows += state.m_n_rows;
+
+		if (state.m_heap != NULL) {
+			mem_heap_free(state.m_heap);
+		}
+	}
+
+	switch (ret) {
+	case DB_SUCCESS:
+	case DB_INTERRUPTED:
+		break;
+	default:
+		ib::warn() << (check_keys ? "CHECK TABLE" : "COUNT(*)")
+			<< " on index " << index->name << " of table "
+			<< index->table->name << " returned " << ret;
+		/* this error is ignored by CHECK TABLE */
+		ret = DB_SUCCESS;
+	}
+
+	return(ret);
+}
+
 /*********************************************************************//**
 Scans an index for either COUNT(*) or CHECK TABLE.
 If CHECK TABLE; Checks that the index contains entries in an ascending order,
@@ -5903,6 +6060,21 @@ row_scan_index_for_mysql(
 		return(DB_SUCCESS);
 	}
 
+	if (index->is_clustered()
+	    && prebuilt->select_lock_type == LOCK_NONE
+	    && !index->table->is_temporary()
+	    && prebuilt->trx->mysql_thd != NULL) {
+
+		ulint	n_threads = thd_parallel_read_threads(
+			prebuilt->trx->mysql_thd);
+
+		if (n_threads > 1) {
+			return(row_scan_index_parallel(
+				prebuilt, const_cast<dict_index_t*>(index),
+				check_keys, n_threads, n_rows));
+		}
+	}
+
 	ulint bufsize = ut_max(UNIV_PAGE_SIZE, prebuilt->mysql_row_len);
 	buf = static_cast<byte*>(ut_malloc_nokey(bufsize));
 	heap = mem_heap_create(100);
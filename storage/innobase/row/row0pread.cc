@@ -0,0 +1,474 @@
+/*****************************************************************************
+
+Copyright (c) 2017, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file row/row0pread.cc
+Parallel read of a clustered index
+
+Created 2017-Nov-02
+*******************************************************/
+
+#include <thread>
+
+#include "btr0btr.h"
+#include "btr0pcur.h"
+#include "dict0dict.h"
+#include "os0thread-create.h"
+#include "page0cur.h"
+#include "read0types.h"
+#include "rem0cmp.h"
+#include "row0pread.h"
+#include "row0row.h"
+#include "row0vers.h"
+#include "srv0srv.h"
+#include "trx0trx.h"
+
+#ifdef UNIV_PFS_THREAD
+mysql_pfs_key_t	parallel_read_thread_key;
+#endif /* UNIV_PFS_THREAD */
+
+/** Number of worker threads of all parallel reads */
+std::atomic<size_t>	Parallel_reader::s_active_threads;
+
+/** Reserve worker threads from the global limit MAX_THREADS.
+@param[in]	n	number of worker threads wanted
+@return number of worker threads reserved, can be 0 */
+size_t
+Parallel_reader::reserve_threads(size_t n)
+{
+	size_t	active = s_active_threads.load();
+
+	for (;;) {
+		size_t	n_reserve = std::min(n, MAX_THREADS - active);
+
+		if (n_reserve == 0
+		    || s_active_threads.compare_exchange_weak(
+			    active, active + n_reserve)) {
+
+			return(n_reserve);
+		}
+	}
+}
+
+/** Give back worker threads that were reserved.
+@param[in]	n	number of worker threads to release */
+void
+Parallel_reader::release_threads(size_t n)
+{
+	ut_ad(s_active_threads.load() >= n);
+
+	s_active_threads.fetch_sub(n);
+}
+
+/** Constructor.
+@param[in]	trx		transaction whose read view to use
+@param[in]	index		clustered index to read
+@param[in]	n_threads	number of threads requested, including
+				the calling thread */
+Parallel_reader::Parallel_reader(
+	trx_t*		trx,
+	dict_index_t*	index,
+	size_t		n_threads)
+	:
+	m_trx(trx),
+	m_index(index),
+	m_n_threads(),
+	m_heap(mem_heap_create(1024)),
+	m_next_range(),
+	m_err(DB_SUCCESS)
+{
+	ut_ad(index->is_clustered());
+	ut_ad(n_threads > 0);
+
+	m_n_threads = 1 + reserve_threads(n_threads - 1);
+}
+
+/** Destructor. Releases the reserved threads. */
+Parallel_reader::~Parallel_reader()
+{
+	release_threads(m_n_threads - 1);
+
+	mem_heap_free(m_heap);
+}
+
+/** Remember the first error that was encountered.
+@param[in]	err	error code */
+void
+Parallel_reader::set_error(dberr_t err)
+{
+	dberr_t	expected = DB_SUCCESS;
+
+	ut_ad(err != DB_SUCCESS);
+
+	m_err.compare_exchange_strong(expected, err);
+}
+
+/** Split the index into key ranges. Starting from the root, look for
+the highest level that has at least RANGES_PER_THREAD node pointers per
+thread, and make each node pointer on that level the start of a range.
+@return DB_SUCCESS or error code */
+dberr_t
+Parallel_reader::split()
+{
+	mtr_t		mtr;
+	const ulint	n_fields = dict_index_get_n_unique_in_tree_nonleaf(
+		m_index);
+	const size_t	target = m_n_threads * RANGES_PER_THREAD;
+	const page_size_t	page_size(dict_table_page_size(m_index->table));
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets = offsets_;
+	mem_heap_t*	heap = NULL;
+	std::vector<const dtuple_t*, ut_allocator<const dtuple_t*> >	keys;
+
+	rec_offs_init(offsets_);
+
+	mtr_start(&mtr);
+
+	/* Prevent changes to the non-leaf levels while we look at them. */
+	mtr_s_lock(dict_index_get_lock(m_index), &mtr);
+
+	buf_block_t*	block = btr_root_block_get(
+		m_index, RW_S_LATCH, &mtr);
+
+	ulint		level = btr_page_get_level(
+		buf_block_get_frame(block), &mtr);
+
+	/* Start with the whole index as one range. */
+	keys.push_back(NULL);
+
+	while (level > 0 && keys.size() < target) {
+
+		buf_block_t*	first = block;
+		page_no_t	child_page_no = FIL_NULL;
+
+		keys.clear();
+
+		/* Collect the node pointers of all pages on this level. */
+		for (;;) {
+			page_cur_t	cur;
+
+			page_cur_set_before_first(block, &cur);
+			page_cur_move_to_next(&cur);
+
+			for (; !page_cur_is_after_last(&cur);
+			     page_cur_move_to_next(&cur)) {
+
+				rec_t*	rec = page_cur_get_rec(&cur);
+
+				if (rec_get_info_bits(
+					    rec, dict_table_is_comp(
+						    m_index->table))
+				    & REC_INFO_MIN_REC_FLAG) {
+
+					ut_ad(keys.empty());
+
+					offsets = rec_get_offsets(
+						rec, m_index, offsets,
+						ULINT_UNDEFINED, &heap);
+
+					child_page_no =
+						btr_node_ptr_get_child_page_no(
+							rec, offsets);
+
+					keys.push_back(NULL);
+					continue;
+				}
+
+				keys.push_back(dict_index_build_data_tuple(
+					m_index, rec, n_fields, m_heap));
+			}
+
+			page_no_t	next = btr_page_get_next(
+				buf_block_get_frame(block), &mtr);
+
+			if (next == FIL_NULL) {
+				break;
+			}
+
+			block = btr_block_get(
+				page_id_t(block->page.id.space(), next),
+				page_size, RW_S_LATCH, m_index, &mtr);
+		}
+
+		if (keys.size() >= target || level == 1) {
+			break;
+		}
+
+		/* Too few node pointers on this level: go one level down,
+		starting from the leftmost child of the leftmost page. */
+		ut_a(child_page_no != FIL_NULL);
+
+		block = btr_block_get(
+			page_id_t(first->page.id.space(), child_page_no),
+			page_size, RW_S_LATCH, m_index, &mtr);
+
+		--level;
+
+		mem_heap_empty(m_heap);
+	}
+
+	mtr_commit(&mtr);
+
+	if (heap != NULL) {
+		mem_heap_free(heap);
+	}
+
+	ut_a(!keys.empty());
+	ut_ad(keys.front() == NULL);
+
+	for (size_t i = 0; i < keys.size(); ++i) {
+		range_t	range;
+
+		range.m_start = keys[i];
+		range.m_end = i + 1 < keys.size() ? keys[i + 1] : NULL;
+
+		m_ranges.push_back(range);
+	}
+
+	return(DB_SUCCESS);
+}
+
+/** Read the records of a key range.
+@param[in]	thread_id	id of the thread
+@param[in]	range_id	key range to read
+@param[in,out]	heap		memory heap for old versions
+@return DB_SUCCESS or error code */
+dberr_t
+Parallel_reader::read_range(
+	size_t		thread_id,
+	size_t		range_id,
+	mem_heap_t*	heap)
+{
+	mtr_t		mtr;
+	btr_pcur_t	pcur;
+	const range_t&	range = m_ranges[range_id];
+	ReadView*	view = MVCC::is_view_active(m_trx->read_view)
+		? m_trx->read_view : NULL;
+	const bool	comp = dict_table_is_comp(m_index->table);
+	dberr_t		err = DB_SUCCESS;
+	Ctx		ctx;
+
+	ctx.m_thread_id = thread_id;
+	ctx.m_range_id = range_id;
+	ctx.m_first = true;
+
+	mtr_start(&mtr);
+
+	if (range.m_start == NULL) {
+		btr_pcur_open_at_index_side(
+			true, m_index, BTR_SEARCH_LEAF, &pcur, true, 0, &mtr);
+	} else {
+		/* Position on the last record before the range, so that
+		the first move to the next record enters it. */
+		btr_pcur_open(m_index, range.m_start, PAGE_CUR_L,
+			      BTR_SEARCH_LEAF, &pcur, &mtr);
+	}
+
+	ulint	n_pages = 0;
+
+	for (;;) {
+		page_cur_t*	cur = btr_pcur_get_page_cur(&pcur);
+
+		mem_heap_empty(heap);
+
+		page_cur_move_to_next(cur);
+
+		if (page_cur_is_after_last(cur)) {
+
+			if (trx_is_interrupted(m_trx)) {
+				err = DB_INTERRUPTED;
+				break;
+			}
+
+			if (is_error_set()) {
+				break;
+			}
+
+			if (++n_pages % 64 == 0
+			    || rw_lock_get_waiters(
+				    dict_index_get_lock(m_index))) {
+
+				/* Let purge and page splits proceed: store
+				the position on the last user record of the
+				page, release the latch and restore it. */
+				btr_pcur_move_to_prev_on_page(&pcur);
+				btr_pcur_store_position(&pcur, &mtr);
+				mtr_commit(&mtr);
+
+				mtr_start(&mtr);
+				btr_pcur_restore_position(
+					BTR_SEARCH_LEAF, &pcur, &mtr);
+
+				if (!btr_pcur_move_to_next_user_rec(
+					    &pcur, &mtr)) {
+					break;
+				}
+			} else {
+				page_no_t	next_page_no = btr_page_get_next(
+					page_cur_get_page(cur), &mtr);
+
+				if (next_page_no == FIL_NULL) {
+					break;
+				}
+
+				buf_block_t*	block = page_cur_get_block(cur);
+
+				block = btr_block_get(
+					page_id_t(block->page.id.space(),
+						  next_page_no),
+					block->page.size, BTR_SEARCH_LEAF,
+					m_index, &mtr);
+
+				btr_leaf_page_release(
+					page_cur_get_block(cur),
+					BTR_SEARCH_LEAF, &mtr);
+
+				page_cur_set_before_first(block, cur);
+				page_cur_move_to_next(cur);
+
+				if (page_cur_is_after_last(cur)) {
+					/* Only the root page can be empty. */
+					break;
+				}
+			}
+		}
+
+		const rec_t*	rec = page_cur_get_rec(cur);
+		ulint*		offsets = rec_get_offsets(
+			rec, m_index, NULL, ULINT_UNDEFINED, &heap);
+
+		if (range.m_end != NULL
+		    && cmp_dtuple_rec(range.m_end, rec, m_index, offsets)
+		    <= 0) {
+
+			/* Reached the start of the next range. */
+			break;
+		}
+
+		if (view != NULL
+		    && !view->changes_visible(
+			    row_get_rec_trx_id(rec, m_index, offsets),
+			    m_index->table->name)) {
+
+			rec_t*	old_vers;
+
+			err = row_vers_build_for_consistent_read(
+				rec, &mtr, m_index, &offsets, view,
+				&heap, heap, &old_vers, NULL);
+
+			if (err != DB_SUCCESS) {
+				break;
+			}
+
+			rec = old_vers;
+
+			if (rec == NULL) {
+				/* Inserted after the read view was
+				created. */
+				continue;
+			}
+		}
+
+		if (rec_get_deleted_flag(rec, comp)) {
+			continue;
+		}
+
+		ctx.m_rec = rec;
+		ctx.m_offsets = offsets;
+		ctx.m_block = page_cur_get_block(cur);
+
+		err = m_f(ctx);
+
+		if (err != DB_SUCCESS) {
+			break;
+		}
+
+		ctx.m_first = false;
+	}
+
+	mtr_commit(&mtr);
+
+	btr_pcur_close(&pcur);
+
+	return(err);
+}
+
+/** Read key ranges until there are no more of them.
+@param[in]	thread_id	id of the thread */
+void
+Parallel_reader::worker(size_t thread_id)
+{
+	mem_heap_t*	heap = mem_heap_create(UNIV_PAGE_SIZE);
+
+	for (;;) {
+		size_t	range_id = m_next_range.fetch_add(1);
+
+		if (range_id >= m_ranges.size() || is_error_set()) {
+			break;
+		}
+
+		dberr_t	err = read_range(thread_id, range_id, heap);
+
+		if (err != DB_SUCCESS) {
+			set_error(err);
+			break;
+		}
+	}
+
+	mem_heap_free(heap);
+}
+
+/** Split the index into ranges and read them. The calling thread reads
+ranges as thread 0, while the reserved worker threads read the others.
+@param[in]	f	callback for each visible record
+@return DB_SUCCESS or the first error encountered */
+dberr_t
+Parallel_reader::run(F f)
+{
+	dberr_t	err = split();
+
+	if (err != DB_SUCCESS) {
+		return(err);
+	}
+
+	m_f = f;
+
+	/* No point in starting more threads than there are ranges. */
+	size_t	n_workers = std::min(m_n_threads, m_ranges.size()) - 1;
+
+#ifdef UNIV_PFS_THREAD
+	Runnable	runnable(parallel_read_thread_key);
+#else
+	Runnable	runnable(0);
+#endif /* UNIV_PFS_THREAD */
+
+	std::vector<std::thread>	threads;
+
+	for (size_t i = 1; i <= n_workers; ++i) {
+		threads.push_back(std::thread(
+			runnable, &Parallel_reader::worker, this, i));
+	}
+
+	worker(0);
+
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	return(m_err.load());
+}
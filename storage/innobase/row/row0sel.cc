@@ -3187,7 +3187,6 @@ be needed in the query.
 					clustered index format and it
 					is used only for end range comparison
 @return TRUE on success, FALSE if not all columns could be retrieved */
-static MY_ATTRIBUTE((warn_unused_result))
 ibool
 row_sel_store_mysql_rec(
 	byte*		mysql_rec,
@@ -3884,7 +3883,8 @@ row_sel_dequeue_cached_row_for_mysql(
 }
 
 /********************************************************************//**
-Initialise the prefetch cache. */
+Initialise the prefetch cache with room for prebuilt->fetch_cache_limit
+rows. */
 UNIV_INLINE
 void
 row_sel_prefetch_cache_init(
@@ -3898,12 +3898,14 @@ row_sel_prefetch_cache_init(
 	/* We use our own prefetch cache only if the server didn't
 	provide one. */
 	ut_ad(row_sel_get_record_buffer(prebuilt) == nullptr);
+	ut_ad(prebuilt->fetch_cache_size == 0);
+	ut_ad(prebuilt->fetch_cache_limit <= UT_ARR_SIZE(prebuilt->fetch_cache));
 
 	/* Reserve space for the magic number. */
-	sz = UT_ARR_SIZE(prebuilt->fetch_cache) * (prebuilt->mysql_row_len + 8);
+	sz = prebuilt->fetch_cache_limit * (prebuilt->mysql_row_len + 8);
 	ptr = static_cast<byte*>(ut_malloc_nokey(sz));
 
-	for (i = 0; i < UT_ARR_SIZE(prebuilt->fetch_cache); i++) {
+	for (i = 0; i < prebuilt->fetch_cache_limit; i++) {
 
 		/* A user has reported memory corruption in these
 		buffers in Linux. Put magic numbers there to help
@@ -3918,6 +3920,28 @@ row_sel_prefetch_cache_init(
 		mach_write_to_4(ptr, ROW_PREBUILT_FETCH_MAGIC_N);
 		ptr += 4;
 	}
+
+	prebuilt->fetch_cache_size = prebuilt->fetch_cache_limit;
+}
+
+/********************************************************************//**
+Let the prefetch cache hold more rows the next time it is filled in the
+current scan, so that a long scan restores the cursor and latches the
+index pages less often while a short scan keeps a small cache. */
+UNIV_INLINE
+void
+row_sel_prefetch_cache_grow(
+/*========================*/
+	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
+{
+	ulint	limit = 2 * prebuilt->fetch_cache_limit;
+
+	if (limit <= MYSQL_FETCH_CACHE_MAX_SIZE
+	    && limit * (prebuilt->mysql_row_len + 8)
+	    <= MYSQL_FETCH_CACHE_MAX_BYTES) {
+
+		prebuilt->fetch_cache_limit = limit;
+	}
 }
 
 /********************************************************************//**
@@ -3933,17 +3957,21 @@ row_sel_fetch_last_buf(
 
 	ut_ad(!prebuilt->templ_contains_blob);
 	if (record_buffer == nullptr) {
-		ut_ad(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+		ut_ad(prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit);
 	} else {
 		ut_ad(prebuilt->mysql_prefix_len <=
 		      record_buffer->record_size());
 		ut_ad(record_buffer->records() == prebuilt->n_fetch_cached);
 	}
 
-	if (record_buffer == nullptr && prebuilt->fetch_cache[0] == nullptr) {
-		/* Allocate memory for the fetch cache */
+	if (record_buffer == nullptr
+	    && prebuilt->fetch_cache_size < prebuilt->fetch_cache_limit) {
+		/* Allocate memory for the fetch cache, or reallocate it
+		for more rows.  The cache is empty when it starts to be
+		filled, so that no cached rows are lost. */
 		ut_ad(prebuilt->n_fetch_cached == 0);
 
+		row_mysql_prebuilt_free_fetch_cache(prebuilt);
 		row_sel_prefetch_cache_init(prebuilt);
 	}
 
@@ -4550,6 +4578,107 @@ row_sel_fill_vrow(
 	}
 }
 
+/** Number of leaf pages that a scan must move to before the logical
+read-ahead starts, so that short range scans do not read ahead */
+static const ulint	ROW_SEL_LRA_THRESHOLD = 2;
+
+/** Check whether a forward scan that is about to move to the next leaf
+page should read ahead the leaf pages that follow.  The read-ahead is
+throttled per scan: it is repeated when the scan has consumed half of
+the pages that were read ahead last time.
+@param[in,out]	prebuilt	prebuilt struct of the scan
+@param[in]	pcur		cursor of the scan, on a latched leaf page
+@return true if the read-ahead is due */
+static
+bool
+row_sel_read_ahead_logical_due(
+	row_prebuilt_t*		prebuilt,
+	const btr_pcur_t*	pcur)
+{
+	const ulint	n_pages = srv_logical_read_ahead_pages;
+
+	/* In read-only mode the index tree is not latched, and the node
+	pointer pages cannot be searched with BTR_SEARCH_TREE. */
+	if (n_pages == 0 || srv_read_only_mode
+	    || !btr_pcur_is_after_last_on_page(pcur)) {
+		return(false);
+	}
+
+	if (++prebuilt->m_lra_n_pages_scanned < ROW_SEL_LRA_THRESHOLD) {
+		return(false);
+	}
+
+	if (prebuilt->m_lra_n_pages_ahead == ULINT_UNDEFINED) {
+		/* All the remaining leaf pages were read ahead. */
+		return(false);
+	}
+
+	if (prebuilt->m_lra_n_pages_ahead > n_pages / 2) {
+		--prebuilt->m_lra_n_pages_ahead;
+		return(false);
+	}
+
+	return(true);
+}
+
+/** Read ahead the leaf pages that follow the stored position of a scan,
+up to the end of the range of the scan.
+@param[in,out]	prebuilt	prebuilt struct of the scan
+@param[in]	pcur		cursor of the scan, whose position has been
+stored and which holds no latches
+@param[in]	match_mode	0 or ROW_SEL_EXACT or ROW_SEL_EXACT_PREFIX */
+static
+void
+row_sel_read_ahead_logical(
+	row_prebuilt_t*		prebuilt,
+	const btr_pcur_t*	pcur,
+	ulint			match_mode)
+{
+	const ulint	n_pages = srv_logical_read_ahead_pages;
+
+	if (n_pages == 0) {
+		return;
+	}
+
+	const ha_innobase*	handler = prebuilt->m_mysql_handler;
+	const dtuple_t*		end_tuple = NULL;
+	mem_heap_t*		heap = NULL;
+
+	if (match_mode == ROW_SEL_EXACT) {
+		/* The scan ends at the last record that starts with
+		the search tuple. */
+		end_tuple = prebuilt->search_tuple;
+	} else if (handler != NULL && handler->end_range != NULL) {
+		dict_index_t*	index = prebuilt->index;
+		const ulint	n_fields = dict_index_get_n_fields(index);
+
+		heap = mem_heap_create(
+			n_fields * sizeof(dfield_t) + sizeof(dtuple_t));
+
+		dtuple_t*	tuple = dtuple_create(heap, n_fields);
+
+		dict_index_copy_types(tuple, index, n_fields);
+
+		/* srch_key_val2 is only used by records_in_range(),
+		which is not called while a scan is in progress. */
+		row_sel_convert_mysql_key_to_innobase(
+			tuple, prebuilt->srch_key_val2,
+			prebuilt->srch_key_val_len, index,
+			handler->end_range->key, handler->end_range->length,
+			prebuilt->trx);
+
+		end_tuple = tuple;
+	}
+
+	ulint	n = btr_pcur_read_ahead_logical(pcur, n_pages, end_tuple);
+
+	prebuilt->m_lra_n_pages_ahead = n < n_pages ? ULINT_UNDEFINED : n;
+
+	if (heap != NULL) {
+		mem_heap_free(heap);
+	}
+}
+
 /** Searches for rows in the database using cursor.
 Function is mainly used for tables that are shared accorss connection and
 so it employs technique that can help re-construct the rows that
@@ -4613,6 +4742,7 @@ row_search_mvcc(
 	ibool		table_lock_waited		= FALSE;
 	byte*		next_buf			= 0;
 	bool		spatial_search			= false;
+	bool		read_ahead			= false;
 	ulint		end_loop			= 0;
 
 	rec_offs_init(offsets_);
@@ -4678,6 +4808,9 @@ row_search_mvcc(
 		prebuilt->n_rows_fetched = 0;
 		prebuilt->n_fetch_cached = 0;
 		prebuilt->fetch_cache_first = 0;
+		prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
+		prebuilt->m_lra_n_pages_scanned = 0;
+		prebuilt->m_lra_n_pages_ahead = 0;
 		if (record_buffer != nullptr) {
 			record_buffer->reset();
 		}
@@ -5828,7 +5961,8 @@ requires_clust_rec:
 		cursor. */
 
 		const auto max_rows_to_cache = record_buffer ?
-			record_buffer->max_records() : MYSQL_FETCH_CACHE_SIZE;
+			record_buffer->max_records()
+			: prebuilt->fetch_cache_limit;
 		ut_a(prebuilt->n_fetch_cached < max_rows_to_cache);
 
 		/* We only convert from InnoDB row format to MySQL row
@@ -5902,6 +6036,10 @@ requires_clust_rec:
 			goto next_rec;
 		}
 
+		if (record_buffer == nullptr) {
+			row_sel_prefetch_cache_grow(prebuilt);
+		}
+
 	} else {
 		/* We cannot use a record buffer for this scan, so assert that
 		we don't have one. If we have a record buffer here,
@@ -6041,12 +6179,18 @@ next_rec:
 	For R-tree spatial search, we also commit the mini-transaction
 	each time  */
 
-	if (mtr_has_extra_clust_latch || spatial_search) {
+	read_ahead = moves_up && !spatial_search
+		&& row_sel_read_ahead_logical_due(prebuilt, pcur);
+
+	if (mtr_has_extra_clust_latch || spatial_search || read_ahead) {
 		/* If we have extra cluster latch, we must commit
 		mtr if we are moving to the next non-clustered
 		index record, because we could break the latching
 		order if we would access a different clustered
-		index page right away without releasing the previous. */
+		index page right away without releasing the previous.
+		The logical read-ahead latches the index tree from
+		the root, so it must not hold the leaf page latch
+		either. */
 
 		/* No need to do store restore for R-tree */
 		if (!spatial_search) {
@@ -6056,6 +6200,11 @@ next_rec:
 		mtr_commit(&mtr);
 		mtr_has_extra_clust_latch = FALSE;
 
+		if (read_ahead) {
+			row_sel_read_ahead_logical(
+				prebuilt, pcur, match_mode);
+		}
+
 		mtr_start(&mtr);
 
 		if (!spatial_search
@@ -26,6 +26,7 @@ Created 12/27/1996 Heikki Tuuri
 #include <sys/types.h>
 
 #include "dict0dict.h"
+#include "dict0stats.h"
 #include "ha_prototypes.h"
 #include "my_compiler.h"
 #include "my_dbug.h"
@@ -2358,7 +2359,13 @@ row_upd_sec_step(
 	if (node->state == UPD_NODE_UPDATE_ALL_SEC
 	    || row_upd_changes_ord_field_binary(node->index, node->update,
 						thr, node->row, node->ext)) {
-		return(row_upd_sec_index_entry(node, thr));
+		dberr_t	err = row_upd_sec_index_entry(node, thr);
+
+		if (err == DB_SUCCESS) {
+			dict_stats_index_modified(node->index);
+		}
+
+		return(err);
 	}
 
 	return(DB_SUCCESS);
@@ -3089,6 +3096,10 @@ row_upd_clust_step(
 	node->index = index->next();
 
 exit_func:
+	if (err == DB_SUCCESS) {
+		dict_stats_index_modified(index);
+	}
+
 	if (heap) {
 		mem_heap_free(heap);
 	}
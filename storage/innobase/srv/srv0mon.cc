@@ -104,6 +104,18 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_DEFAULT_ON,
 	 MONITOR_DEFAULT_START, MONITOR_TIMEOUT},
 
+	{"lock_deadlock_scans", "lock",
+	 "Number of wait-for graph snapshots searched by the deadlock"
+	 " detector thread",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_DEADLOCK_SCAN},
+
+	{"lock_deadlock_stale_cycles", "lock",
+	 "Number of cycles found by the deadlock detector thread that no"
+	 " longer existed when it tried to resolve them",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_DEADLOCK_STALE},
+
 	{"lock_rec_lock_waits", "lock",
 	 "Number of times enqueued into record lock wait queue",
 	 MONITOR_NONE,
@@ -231,6 +243,22 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_EXISTING | MONITOR_DEFAULT_ON),
 	 MONITOR_DEFAULT_START, MONITOR_OVLD_BUF_POOL_READ_AHEAD_EVICTED},
 
+	{"buffer_read_ahead_logical_requests", "buffer",
+	 "Number of logical read-ahead requests of index range scans",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_READ_AHEAD_LOGICAL_REQUESTS},
+
+	{"buffer_read_ahead_logical_hits", "buffer",
+	 "Leaf pages to be read ahead by logical read-ahead that were"
+	 " already in the buffer pool",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_READ_AHEAD_LOGICAL_HITS},
+
+	{"buffer_read_ahead_logical_misses", "buffer",
+	 "Leaf pages that were read asynchronously by logical read-ahead",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_READ_AHEAD_LOGICAL_MISSES},
+
 	{"buffer_pool_pages_total", "buffer",
 	 "Total buffer pool size in pages (innodb_buffer_pool_pages_total)",
 	 static_cast<monitor_type_t>(
@@ -443,6 +471,28 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_FLUSH_PCT_FOR_LSN},
 
+	{"buffer_flush_oldest_modification_age", "buffer",
+	 "Redo generated since the oldest modification in the buffer pool",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FLUSH_OLDEST_AGE},
+
+	{"buffer_flush_target_age", "buffer",
+	 "Age of the oldest modification that adaptive flushing aims for",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FLUSH_TARGET_AGE},
+
+	{"buffer_flush_lsn_target_rate", "buffer",
+	 "Progress of the oldest modification LSN per second that adaptive"
+	 " flushing aims for",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FLUSH_LSN_TARGET_RATE},
+
+	{"buffer_flush_n_to_flush_max_instance", "buffer",
+	 "Largest number of pages requested from one buffer pool instance"
+	 " by adaptive flushing",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FLUSH_N_TO_FLUSH_MAX_INSTANCE},
+
 	{"buffer_flush_sync_waits", "buffer",
 	 "Number of times a wait happens due to sync flushing",
 	 MONITOR_NONE,
@@ -605,6 +655,22 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_SET_MEMBER, MONITOR_LRU_UNZIP_SEARCH_SCANNED,
 	 MONITOR_LRU_UNZIP_SEARCH_SCANNED_PER_CALL},
 
+	/* Cumulative counter for buffered LRU accesses */
+	{"buffer_LRU_access_batch_pages", "buffer",
+	 "Total page accesses applied to the LRU list in batches",
+	 MONITOR_SET_OWNER, MONITOR_LRU_ACCESS_BATCH_NUM_CALL,
+	 MONITOR_LRU_ACCESS_BATCH_PAGES},
+
+	{"buffer_LRU_access_batch_num_flush", "buffer",
+	 "Number of times a thread applied its buffered LRU accesses",
+	 MONITOR_SET_MEMBER, MONITOR_LRU_ACCESS_BATCH_PAGES,
+	 MONITOR_LRU_ACCESS_BATCH_NUM_CALL},
+
+	{"buffer_LRU_access_batch_pages_per_flush", "buffer",
+	 "Page accesses applied per batch",
+	 MONITOR_SET_MEMBER, MONITOR_LRU_ACCESS_BATCH_PAGES,
+	 MONITOR_LRU_ACCESS_BATCH_PAGES_PER_CALL},
+
 	/* ========== Counters for Buffer Page I/O ========== */
 	{"module_buffer_page", "buffer_page_io", "Buffer Page I/O Module",
 	 static_cast<monitor_type_t>(
@@ -803,6 +869,10 @@ static monitor_info_t	innodb_counter_info[] =
 	 "Number of non-locking auto-commit read-only transactions committed",
 	 MONITOR_NONE, MONITOR_DEFAULT_START, MONITOR_TRX_NL_RO_COMMIT},
 
+	{"trx_read_views_reused", "transaction",
+	 "Number of read views reopened without acquiring trx_sys->mutex",
+	 MONITOR_NONE, MONITOR_DEFAULT_START, MONITOR_TRX_VIEW_REUSED},
+
 	{"trx_commits_insert_update", "transaction",
 	 "Number of transactions committed with inserts and updates",
 	 MONITOR_NONE,
@@ -875,6 +945,11 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_PURGE_N_PAGE_HANDLED},
 
+	{"purge_batch_size", "purge",
+	 "Number of undo log pages the last purge batch was sized for",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_PURGE_BATCH_SIZE},
+
 	{"purge_dml_delay_usec", "purge",
 	 "Microseconds DML to be delayed due to purge lagging",
 	 MONITOR_DISPLAY_CURRENT,
@@ -973,6 +1048,22 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_EXISTING | MONITOR_DEFAULT_ON),
 	 MONITOR_DEFAULT_START, MONITOR_OVLD_LOG_PADDED},
 
+	{"log_on_write_waits", "recovery",
+	 "Number of times a thread waited for the log writer thread",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_ON_WRITE_WAITS},
+
+	{"log_on_flush_waits", "recovery",
+	 "Number of times a thread waited for the log flusher thread",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_ON_FLUSH_WAITS},
+
+	{"log_lsn_wait_time", "recovery",
+	 "Time (in microseconds) spent by threads waiting for the log"
+	 " writer and log flusher threads",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOG_LSN_WAIT_TIME},
+
 	/* ========== Counters for Page Compression ========== */
 	{"module_compress", "compression", "Page Compression Info",
 	 MONITOR_MODULE,
@@ -1030,6 +1121,17 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_INDEX_DISCARD},
 
+	{"index_lob_pages_written", "index",
+	 "Number of indexed LOB data pages written",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOB_PAGES_WRITTEN},
+
+	{"index_lob_pages_shared", "index",
+	 "Number of indexed LOB data pages that an update shared with the"
+	 " previous version instead of writing them",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOB_PAGES_SHARED},
+
 	/* ========== Counters for Adaptive Hash Index ========== */
 	{"module_adaptive_hash", "adaptive_hash_index", "Adpative Hash Index",
 	 MONITOR_MODULE,
@@ -1079,6 +1181,24 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_ADAPTIVE_HASH_ROW_UPDATED},
 
+	{"adaptive_hash_index_turned_off", "adaptive_hash_index",
+	 "Number of times the Adaptive Hash Index of an index was turned off"
+	 " because it did not pay off (innodb_adaptive_hash_index_auto)",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_ADAPTIVE_HASH_INDEX_OFF},
+
+	{"adaptive_hash_index_turned_on", "adaptive_hash_index",
+	 "Number of times the Adaptive Hash Index of an index was turned back"
+	 " on (innodb_adaptive_hash_index_auto)",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_ADAPTIVE_HASH_INDEX_ON},
+
+	{"adaptive_hash_pages_queued", "adaptive_hash_index",
+	 "Number of index pages queued for the Adaptive Hash Index build"
+	 " thread",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_ADAPTIVE_HASH_PAGE_QUEUED},
+
 	/* ========== Counters for tablespace ========== */
 	{"module_file", "file_system", "Tablespace and File System Manager",
 	 MONITOR_MODULE,
@@ -1090,6 +1210,27 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT | MONITOR_DEFAULT_ON),
 	 MONITOR_DEFAULT_START, MONITOR_OVLD_N_FILE_OPENED},
 
+	{"file_extend_stalls", "file_system",
+	 "Number of times a thread extended a tablespace file itself",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FIL_EXTEND_STALLS},
+
+	{"file_extend_stall_time", "file_system",
+	 "Time (in microseconds) threads spent extending tablespace files",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FIL_EXTEND_STALL_TIME},
+
+	{"file_extend_ahead", "file_system",
+	 "Number of tablespace files extended ahead of demand in the"
+	 " background",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FIL_EXTEND_AHEAD},
+
+	{"file_extend_ahead_pages", "file_system",
+	 "Number of pages allocated ahead of demand in the background",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FIL_EXTEND_AHEAD_PAGES},
+
 	/* ========== Counters for Change Buffer ========== */
 	{"module_ibuf_system", "change_buffer", "InnoDB Change Buffer",
 	 MONITOR_MODULE,
@@ -1363,6 +1504,32 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_ICP_MATCH},
 
+	/* ========== Counters for Full Text Search Module ========== */
+	{"module_fts", "fts", "Full text search",
+	 MONITOR_MODULE,
+	 MONITOR_DEFAULT_START, MONITOR_MODULE_FTS},
+
+	{"fts_optimize_words", "fts",
+	 "Number of words rewritten by OPTIMIZE TABLE on FULLTEXT indexes",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FTS_OPTIMIZE_WORDS},
+
+	{"fts_optimize_parallel_tasks", "fts",
+	 "Number of auxiliary index tables optimized by parallel"
+	 " optimize threads",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FTS_OPTIMIZE_PARALLEL_TASKS},
+
+	{"fts_sync_nodes_written", "fts",
+	 "Number of word nodes written by FULLTEXT cache syncs",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FTS_SYNC_NODES},
+
+	{"fts_sync_batches", "fts",
+	 "Number of batches of word nodes written by FULLTEXT cache syncs",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FTS_SYNC_BATCHES},
+
 	/* ========== Mutex monitoring on/off ========== */
 	{"latch_status", "Latch counters",
 	 "Collect latch counters to display via SHOW ENGING INNODB MUTEX",
@@ -152,6 +152,10 @@ bool	srv_read_only_mode;
 dictionary tables are in the system tablespace 0 */
 bool	srv_file_per_table;
 
+/** Store new uncompressed LOBs in the indexed format, which supports
+random access and partial updates */
+bool	srv_indexed_lob	= FALSE;
+
 /** Sort buffer size in index creation */
 ulong	srv_sort_buf_size = 1048576;
 /** Maximum modification log file size for online index creation */
@@ -169,6 +173,9 @@ bool	srv_use_native_aio = TRUE; /* enabled by default on Windows */
 #else
 bool	srv_use_native_aio;
 #endif
+/** If this flag is true and native aio is used, then we use io_uring
+instead of libaio on Linux (provided we compiled Innobase with it in) */
+bool	srv_use_io_uring = false;
 bool	srv_numa_interleave = FALSE;
 
 #ifdef UNIV_DEBUG
@@ -210,6 +217,8 @@ uint		srv_flush_log_at_timeout = 1;
 ulong		srv_page_size = UNIV_PAGE_SIZE_DEF;
 ulong		srv_page_size_shift = UNIV_PAGE_SIZE_SHIFT_DEF;
 ulong		srv_log_write_ahead_size = 0;
+bool		srv_log_writer_threads = true;
+ulong		srv_log_wait_for_flush_spin_rounds = 0;
 
 page_size_t	univ_page_size(0, 0, false);
 
@@ -247,6 +256,9 @@ const ulong	srv_buf_pool_instances_default = 0;
 ulong	srv_n_page_hash_locks = 16;
 /** Scan depth for LRU flush batch i.e.: number of blocks scanned*/
 ulong	srv_LRU_scan_depth	= 1024;
+/** Number of page accesses that a thread buffers before moving the
+pages to the start of the LRU list; 1 moves them immediately */
+ulong	srv_LRU_access_batch	= 32;
 /** Whether or not to flush neighbors of a block */
 ulong	srv_flush_neighbors	= 1;
 /** Previously requested size. Accesses protected by memory barriers. */
@@ -265,17 +277,31 @@ instead. */
 ulong	srv_n_read_io_threads;
 ulong	srv_n_write_io_threads;
 
+/** Number of threads that apply redo log records to pages during
+crash recovery */
+ulong	srv_n_recv_apply_threads;
+
 /* Switch to enable random read ahead. */
 bool	srv_random_read_ahead	= FALSE;
 /* User settable value of the number of pages that must be present
 in the buffer cache and accessed sequentially for InnoDB to trigger a
 readahead request. */
 ulong	srv_read_ahead_threshold	= 56;
+/** Maximum number of leaf pages that an index range scan reads ahead
+from the node pointers of the level above the leaves; 0 disables */
+ulong	srv_logical_read_ahead_pages	= 0;
+/** Maximum size in megabytes that the background tablespace extender
+keeps allocated ahead of demand in each growing tablespace; 0 disables */
+ulong	srv_extend_ahead_max_size	= 64;
 
 /** Maximum on-disk size of change buffer in terms of percentage
 of the buffer pool. */
 uint	srv_change_buffer_max_size = CHANGE_BUFFER_DEFAULT_SIZE;
 
+/** Number of change buffer merge threads, 0 if the master thread merges
+the change buffer */
+ulong	srv_n_ibuf_merge_threads;
+
 #ifndef _WIN32
 enum srv_unix_flush_t	srv_unix_file_flush_method = SRV_UNIX_FSYNC;
 #else
@@ -368,6 +394,9 @@ bool		srv_stats_persistent = TRUE;
 bool		srv_stats_include_delete_marked = FALSE;
 unsigned long long	srv_stats_persistent_sample_pages = 20;
 bool		srv_stats_auto_recalc = TRUE;
+/** Maximum number of leaf pages that the background recalculation of
+persistent statistics samples from one table in one pass, 0 if unlimited */
+unsigned long long	srv_stats_auto_recalc_page_budget = 0;
 
 ibool	srv_use_doublewrite_buf	= TRUE;
 
@@ -377,6 +406,12 @@ batch flushing i.e.: LRU flushing and flush_list flushing. The rest
 of the pages are used for single page flushing. */
 ulong	srv_doublewrite_batch_size	= 120;
 
+/** Number of doublewrite files. Batch flushes of each buffer pool
+instance go to their own file, one for LRU and one for flush_list
+flushing, unless fewer files are configured. 0 means two files per
+buffer pool instance. */
+ulong	srv_doublewrite_files		= 0;
+
 ulong	srv_replication_delay		= 0;
 
 /*-------------------------------------------*/
@@ -590,6 +625,9 @@ and/or load it during startup. */
 bool	srv_buffer_pool_dump_at_shutdown = true;
 bool	srv_buffer_pool_load_at_startup = true;
 
+/** Number of threads that read pages during a buffer pool load */
+ulong	srv_buf_load_threads = 4;
+
 /** Slot index in the srv_sys->sys_threads array for the purge thread. */
 static const ulint	SRV_PURGE_SLOT	= 1;
 
@@ -1536,7 +1574,7 @@ loop:
 		if (srv_print_innodb_monitor) {
 			/* Reset mutex_skipped counter everytime
 			srv_print_innodb_monitor changes. This is to
-			ensure we will not be blocked by lock_sys->mutex
+			ensure we will not be blocked by lock_sys->latch
 			for short duration information printing,
 			such as requested by sync_array_print_long_waits() */
 			if (!last_srv_print_monitor) {
@@ -1713,6 +1751,8 @@ srv_any_background_threads_are_active()
 		thread_active = "srv_error_monitor_thread";
 	} else if (lock_sys->timeout_thread_active) {
 		thread_active = "srv_lock_timeout thread";
+	} else if (lock_sys->deadlock_thread_active) {
+		thread_active = "srv_lock_deadlock thread";
 	} else if (srv_monitor_active) {
 		thread_active = "srv_monitor_thread";
 	} else if (srv_buf_dump_thread_active) {
@@ -1721,10 +1761,17 @@ srv_any_background_threads_are_active()
 		thread_active = "buf_resize_thread";
 	}
 
+	if (const char* log_thread = log_writer_threads_active()) {
+		if (thread_active == NULL) {
+			thread_active = log_thread;
+		}
+	}
+
 	os_event_set(srv_error_event);
 	os_event_set(srv_monitor_event);
 	os_event_set(srv_buf_dump_event);
 	os_event_set(lock_sys->timeout_event);
+	os_event_set(lock_sys->deadlock_event);
 	os_event_set(srv_buf_resize_event);
 
 	return(thread_active);
@@ -2029,12 +2076,15 @@ srv_master_do_active_tasks(void)
 	srv_main_thread_op_info = "checking free log space";
 	log_free_check();
 
-	/* Do an ibuf merge */
-	srv_main_thread_op_info = "doing insert buffer merge";
-	counter_time = ut_time_us(NULL);
-	ibuf_merge_in_background(false);
-	MONITOR_INC_TIME_IN_MICRO_SECS(
-		MONITOR_SRV_IBUF_MERGE_MICROSECOND, counter_time);
+	/* Do an ibuf merge, unless the change buffer merge threads
+	do it */
+	if (ibuf_merge_threads_active() == 0) {
+		srv_main_thread_op_info = "doing insert buffer merge";
+		counter_time = ut_time_us(NULL);
+		ibuf_merge_in_background(false);
+		MONITOR_INC_TIME_IN_MICRO_SECS(
+			MONITOR_SRV_IBUF_MERGE_MICROSECOND, counter_time);
+	}
 
 	/* Flush logs if needed */
 	srv_main_thread_op_info = "flushing log";
@@ -2118,12 +2168,17 @@ srv_master_do_idle_tasks(void)
 	srv_main_thread_op_info = "checking free log space";
 	log_free_check();
 
-	/* Do an ibuf merge */
-	counter_time = ut_time_us(NULL);
-	srv_main_thread_op_info = "doing insert buffer merge";
-	ibuf_merge_in_background(true);
-	MONITOR_INC_TIME_IN_MICRO_SECS(
-		MONITOR_SRV_IBUF_MERGE_MICROSECOND, counter_time);
+	/* Do an ibuf merge, unless the change buffer merge threads
+	do it */
+	if (ibuf_merge_threads_active() == 0) {
+		counter_time = ut_time_us(NULL);
+		srv_main_thread_op_info = "doing insert buffer merge";
+		ibuf_merge_in_background(true);
+		MONITOR_INC_TIME_IN_MICRO_SECS(
+			MONITOR_SRV_IBUF_MERGE_MICROSECOND, counter_time);
+	} else {
+		ibuf_merge_threads_wakeup();
+	}
 
 	if (srv_shutdown_state > 0) {
 		return;
@@ -2619,6 +2674,35 @@ srv_worker_thread()
 	my_thread_end();
 }
 
+/** Get the size of the next purge batch. While the history list is
+long, the batches grow up to PURGE_BATCH_SCALE_MAX times
+innodb_purge_batch_size, aiming to work off the history in about
+PURGE_BATCH_HISTORY_DIVISOR batches. Larger batches contain more tables
+to spread over the purge threads and are planned less often.
+@param[in]	history_len	length of the history list
+@return number of undo log pages to purge in the next batch */
+static
+ulint
+srv_purge_get_batch_size(
+	ulint	history_len)
+{
+	/** Maximum factor by which a batch grows */
+	static const ulint	PURGE_BATCH_SCALE_MAX = 8;
+
+	/** Number of batches to work off the history in */
+	static const ulint	PURGE_BATCH_HISTORY_DIVISOR = 100;
+
+	ulint	batch_size = history_len / PURGE_BATCH_HISTORY_DIVISOR;
+
+	batch_size = std::min(batch_size,
+			      srv_purge_batch_size * PURGE_BATCH_SCALE_MAX);
+
+	/* Stay within the maximum of innodb_purge_batch_size. */
+	batch_size = std::min<ulint>(batch_size, MAX_PURGE_BATCH_SIZE);
+
+	return(std::max<ulint>(batch_size, srv_purge_batch_size));
+}
+
 /*********************************************************************//**
 Do the actual purge operation.
 @return length of history list before the last purge batch. */
@@ -2690,8 +2774,13 @@ srv_do_purge(
 			static_cast<ulint>(srv_purge_rseg_truncate_frequency),
 			undo_trunc_freq);
 
+		ulint	batch_size = srv_purge_get_batch_size(
+			rseg_history_len);
+
+		MONITOR_SET(MONITOR_PURGE_BATCH_SIZE, batch_size);
+
 		n_pages_purged = trx_purge(
-			n_use_threads, srv_purge_batch_size,
+			n_use_threads, batch_size,
 			(++count % rseg_truncate_frequency) == 0);
 
 		*n_total_purged += n_pages_purged;
@@ -45,6 +45,7 @@ Created 2/16/1996 Heikki Tuuri
 
 #include "btr0btr.h"
 #include "btr0cur.h"
+#include "btr0sea.h"
 #include "buf0buf.h"
 #include "buf0dump.h"
 #include "data0data.h"
@@ -177,18 +178,26 @@ static char*	srv_monitor_file_name;
 
 /* Keys to register InnoDB threads with performance schema */
 #ifdef UNIV_PFS_THREAD
+mysql_pfs_key_t	btr_search_build_thread_key;
 mysql_pfs_key_t	buf_dump_thread_key;
+mysql_pfs_key_t	buf_load_thread_key;
 mysql_pfs_key_t	buf_resize_thread_key;
 mysql_pfs_key_t	dict_stats_thread_key;
+mysql_pfs_key_t	fil_extend_ahead_thread_key;
 mysql_pfs_key_t	fts_optimize_thread_key;
 mysql_pfs_key_t	fts_parallel_merge_thread_key;
+mysql_pfs_key_t	fts_parallel_optimize_thread_key;
 mysql_pfs_key_t	fts_parallel_tokenization_thread_key;
+mysql_pfs_key_t	ibuf_merge_thread_key;
 mysql_pfs_key_t	io_handler_thread_key;
 mysql_pfs_key_t	io_ibuf_thread_key;
 mysql_pfs_key_t	io_log_thread_key;
 mysql_pfs_key_t	io_read_thread_key;
 mysql_pfs_key_t	io_write_thread_key;
+mysql_pfs_key_t	log_flusher_thread_key;
+mysql_pfs_key_t	log_writer_thread_key;
 mysql_pfs_key_t	srv_error_monitor_thread_key;
+mysql_pfs_key_t	srv_lock_deadlock_thread_key;
 mysql_pfs_key_t	srv_lock_timeout_thread_key;
 mysql_pfs_key_t	srv_master_thread_key;
 mysql_pfs_key_t	srv_monitor_thread_key;
@@ -1575,8 +1584,10 @@ srv_shutdown_all_bg_threads()
 		if (!srv_read_only_mode) {
 
 			if (srv_start_state_is_set(SRV_START_STATE_LOCK_SYS)) {
-				/* a. Let the lock timeout thread exit */
+				/* a. Let the lock timeout and deadlock
+				detector threads exit */
 				os_event_set(lock_sys->timeout_event);
+				os_event_set(lock_sys->deadlock_event);
 			}
 
 			/* b. srv error monitor thread exits automatically,
@@ -1900,7 +1911,8 @@ srv_start(bool create_new_db, const char* scan_directories)
 	srv_boot();
 
 	ib::info() << (ut_crc32_cpu_enabled ? "Using" : "Not using")
-		<< " CPU crc32 instructions";
+		<< " CPU crc32 instructions (" << ut_crc32_implementation
+		<< ")";
 
 	if (!create_new_db
 	    && scan_directories != nullptr
@@ -2368,7 +2380,7 @@ files_checked:
 
 		err = recv_recovery_from_checkpoint_start(flushed_lsn);
 
-		recv_sys->dblwr.pages.clear();
+		buf_dblwr_free_recovery_pages();
 
 		if (err == DB_SUCCESS) {
 			/* Initialize the change buffer. */
@@ -2624,6 +2636,14 @@ files_checked:
 			srv_lock_timeout_thread_key,
 			lock_wait_timeout_thread);
 
+		/* Create the thread which searches for deadlocks when
+		innodb_deadlock_detect_async is set */
+		lock_deadlock_detector_thread_starting();
+
+		os_thread_create(
+			srv_lock_deadlock_thread_key,
+			lock_deadlock_detector_thread);
+
 		/* Create the thread which warns of long semaphore waits */
 		os_thread_create(
 			srv_error_monitor_thread_key,
@@ -2868,6 +2888,13 @@ srv_start_threads(
 		return;
 	}
 
+	/* Create the log writer and log flusher threads */
+	log_writer_threads_starting();
+
+	os_thread_create(log_writer_thread_key, log_writer_thread);
+
+	os_thread_create(log_flusher_thread_key, log_flusher_thread);
+
 	if (!bootstrap && srv_force_recovery < SRV_FORCE_NO_TRX_UNDO
 	    && trx_sys_need_rollback()) {
 		/* Rollback all recovered transactions that are
@@ -2902,6 +2929,26 @@ srv_start_threads(
 		ibuf_update_max_tablespace_id();
 	}
 
+	if (srv_force_recovery < SRV_FORCE_NO_IBUF_MERGE) {
+		/* Create the change buffer merge threads */
+		ibuf_merge_threads_starting(srv_n_ibuf_merge_threads);
+
+		for (ulint i = 0; i < srv_n_ibuf_merge_threads; ++i) {
+			os_thread_create(
+				ibuf_merge_thread_key, ibuf_merge_thread, i);
+		}
+	}
+
+	/* Create the adaptive hash index build thread */
+	btr_search_build_thread_starting();
+
+	os_thread_create(btr_search_build_thread_key, btr_search_build_thread);
+
+	/* Create the background tablespace extender */
+	fil_extend_ahead_thread_starting();
+
+	os_thread_create(fil_extend_ahead_thread_key, fil_extend_ahead_thread);
+
 	/* Create the buffer pool dump/load thread */
 	os_thread_create(buf_dump_thread_key, buf_dump_thread);
 
@@ -3012,6 +3059,39 @@ srv_pre_dd_shutdown()
 			}
 		}
 
+		if (ibuf_merge_threads_active() > 0) {
+			wait = true;
+
+			ibuf_merge_threads_wakeup();
+
+			if (srv_print_verbose_log && ((count % 600) == 0)) {
+				ib::info() << "Waiting for change buffer merge"
+					" threads to exit";
+			}
+		}
+
+		if (btr_search_build_thread_active()) {
+			wait = true;
+
+			btr_search_build_thread_wakeup();
+
+			if (srv_print_verbose_log && ((count % 600) == 0)) {
+				ib::info() << "Waiting for the adaptive hash"
+					" index build thread to exit";
+			}
+		}
+
+		if (fil_extend_ahead_thread_active()) {
+			wait = true;
+
+			fil_extend_ahead_thread_wakeup();
+
+			if (srv_print_verbose_log && ((count % 600) == 0)) {
+				ib::info() << "Waiting for the background"
+					" tablespace extender to exit";
+			}
+		}
+
 		if (srv_dict_stats_thread_active) {
 			wait = true;
 
@@ -471,6 +471,8 @@ LatchDebug::LatchDebug()
 	LEVEL_MAP_INSERT(RW_LOCK_NOT_LOCKED);
 	LEVEL_MAP_INSERT(SYNC_LOCK_FREE_HASH);
 	LEVEL_MAP_INSERT(SYNC_MONITOR_MUTEX);
+	LEVEL_MAP_INSERT(SYNC_FIL_SHARD);
+	LEVEL_MAP_INSERT(SYNC_AHI_BUILD_QUEUE);
 	LEVEL_MAP_INSERT(SYNC_ANY_LATCH);
 	LEVEL_MAP_INSERT(SYNC_DOUBLEWRITE);
 	LEVEL_MAP_INSERT(SYNC_BUF_FLUSH_LIST);
@@ -500,6 +502,7 @@ LatchDebug::LatchDebug()
 	LEVEL_MAP_INSERT(SYNC_THREADS);
 	LEVEL_MAP_INSERT(SYNC_TRX);
 	LEVEL_MAP_INSERT(SYNC_TRX_SYS);
+	LEVEL_MAP_INSERT(SYNC_LOCK_SYS_SHARDED);
 	LEVEL_MAP_INSERT(SYNC_LOCK_SYS);
 	LEVEL_MAP_INSERT(SYNC_LOCK_WAIT_SYS);
 	LEVEL_MAP_INSERT(SYNC_INDEX_ONLINE_LOG);
@@ -762,6 +765,7 @@ LatchDebug::check_order(
 	case SYNC_TRX_SYS_HEADER:
 	case SYNC_LOCK_FREE_HASH:
 	case SYNC_MONITOR_MUTEX:
+	case SYNC_FIL_SHARD:
 	case SYNC_RECV:
 	case SYNC_FTS_BG_THREADS:
 	case SYNC_WORK_QUEUE:
@@ -777,6 +781,7 @@ LatchDebug::check_order(
 	case SYNC_SEARCH_SYS:
 	case SYNC_THREADS:
 	case SYNC_LOCK_SYS:
+	case SYNC_LOCK_SYS_SHARDED:
 	case SYNC_LOCK_WAIT_SYS:
 	case SYNC_TRX_SYS:
 	case SYNC_IBUF_BITMAP_MUTEX:
@@ -829,7 +834,7 @@ LatchDebug::check_order(
 
 	case SYNC_TRX:
 
-		/* Either the thread must own the lock_sys->mutex, or
+		/* Either the thread must own the lock_sys->latch, or
 		it is allowed to own only ONE trx_t::mutex. */
 
 		if (less(latches, level) != NULL) {
@@ -851,6 +856,14 @@ LatchDebug::check_order(
 		basic_check(latches, level, level - 1);
 		break;
 
+	case SYNC_AHI_BUILD_QUEUE:
+
+		/* The hash index build thread holds all the queue
+		mutexes while it stops accepting requests. */
+
+		basic_check(latches, level, level - 1);
+		break;
+
 	case SYNC_BUF_PAGE_HASH:
 		/* Fall through */
 	case SYNC_BUF_BLOCK:
@@ -1361,6 +1374,9 @@ sync_latch_meta_init()
 
 	LATCH_ADD_MUTEX(AUTOINC, SYNC_DICT_AUTOINC_MUTEX, autoinc_mutex_key);
 
+	LATCH_ADD_MUTEX(AHI_BUILD_QUEUE, SYNC_AHI_BUILD_QUEUE,
+			ahi_build_queue_mutex_key);
+
 #ifdef PFS_SKIP_BUFFER_MUTEX_RWLOCK
 	LATCH_ADD_MUTEX(BUF_BLOCK_MUTEX, SYNC_BUF_BLOCK, PFS_NOT_INSTRUMENTED);
 #else
@@ -1405,6 +1421,8 @@ sync_latch_meta_init()
 
 	LATCH_ADD_MUTEX(FIL_SYSTEM, SYNC_ANY_LATCH, fil_system_mutex_key);
 
+	LATCH_ADD_MUTEX(FIL_SHARD, SYNC_FIL_SHARD, fil_shard_mutex_key);
+
 	LATCH_ADD_MUTEX(FLUSH_LIST, SYNC_BUF_FLUSH_LIST, flush_list_mutex_key);
 
 	LATCH_ADD_MUTEX(FTS_BG_THREADS, SYNC_FTS_BG_THREADS,
@@ -1444,6 +1462,9 @@ sync_latch_meta_init()
 	LATCH_ADD_MUTEX(PURGE_SYS_PQ, SYNC_PURGE_QUEUE,
 			purge_sys_pq_mutex_key);
 
+	LATCH_ADD_MUTEX(PURGE_TABLE_STATS, SYNC_NO_ORDER_CHECK,
+			purge_table_stats_mutex_key);
+
 	LATCH_ADD_MUTEX(RECALC_POOL, SYNC_STATS_AUTO_RECALC,
 			recalc_pool_mutex_key);
 
@@ -1513,7 +1534,10 @@ sync_latch_meta_init()
 
 	LATCH_ADD_MUTEX(TRX, SYNC_TRX, trx_mutex_key);
 
-	LATCH_ADD_MUTEX(LOCK_SYS, SYNC_LOCK_SYS, lock_mutex_key);
+	LATCH_ADD_RWLOCK(LOCK_SYS, SYNC_LOCK_SYS, lock_sys_latch_key);
+
+	LATCH_ADD_MUTEX(LOCK_SYS_PAGE, SYNC_LOCK_SYS_SHARDED,
+			lock_sys_page_mutex_key);
 
 	LATCH_ADD_MUTEX(LOCK_SYS_WAIT, SYNC_LOCK_WAIT_SYS,
 			lock_wait_mutex_key);
@@ -1562,6 +1586,9 @@ sync_latch_meta_init()
 	LATCH_ADD_MUTEX(ROW_DROP_LIST, SYNC_NO_ORDER_CHECK,
 			row_drop_list_mutex_key);
 
+	LATCH_ADD_MUTEX(ALTER_STAGE, SYNC_NO_ORDER_CHECK,
+			alter_stage_mutex_key);
+
 	LATCH_ADD_RWLOCK(INDEX_ONLINE_LOG, SYNC_INDEX_ONLINE_LOG,
 			 index_online_log_key);
 
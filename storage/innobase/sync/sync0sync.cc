@@ -41,6 +41,7 @@ unsigned int mysql_pfs_key_t::s_count;
 /* Key to register autoinc_mutex with performance schema */
 mysql_pfs_key_t	autoinc_mutex_key;
 mysql_pfs_key_t	autoinc_persisted_mutex_key;
+mysql_pfs_key_t	ahi_build_queue_mutex_key;
 #  ifndef PFS_SKIP_BUFFER_MUTEX_RWLOCK
 mysql_pfs_key_t	buffer_block_mutex_key;
 #  endif /* !PFS_SKIP_BUFFER_MUTEX_RWLOCK */
@@ -55,6 +56,7 @@ mysql_pfs_key_t	dict_foreign_err_mutex_key;
 mysql_pfs_key_t	dict_persist_dirty_tables_mutex_key;
 mysql_pfs_key_t	dict_sys_mutex_key;
 mysql_pfs_key_t	fil_system_mutex_key;
+mysql_pfs_key_t	fil_shard_mutex_key;
 mysql_pfs_key_t	flush_list_mutex_key;
 mysql_pfs_key_t	fts_bg_threads_mutex_key;
 mysql_pfs_key_t	fts_delete_mutex_key;
@@ -74,6 +76,7 @@ mysql_pfs_key_t	mutex_list_mutex_key;
 mysql_pfs_key_t	recalc_pool_mutex_key;
 mysql_pfs_key_t	page_cleaner_mutex_key;
 mysql_pfs_key_t	purge_sys_pq_mutex_key;
+mysql_pfs_key_t	purge_table_stats_mutex_key;
 mysql_pfs_key_t	recv_sys_mutex_key;
 mysql_pfs_key_t	recv_writer_mutex_key;
 mysql_pfs_key_t	temp_space_rseg_mutex_key;
@@ -101,7 +104,7 @@ mysql_pfs_key_t	trx_undo_mutex_key;
 mysql_pfs_key_t	trx_mutex_key;
 mysql_pfs_key_t	trx_pool_mutex_key;
 mysql_pfs_key_t	trx_pool_manager_mutex_key;
-mysql_pfs_key_t	lock_mutex_key;
+mysql_pfs_key_t	lock_sys_page_mutex_key;
 mysql_pfs_key_t	lock_wait_mutex_key;
 mysql_pfs_key_t	trx_sys_mutex_key;
 mysql_pfs_key_t	srv_sys_mutex_key;
@@ -114,6 +117,7 @@ mysql_pfs_key_t	sync_array_mutex_key;
 mysql_pfs_key_t	thread_mutex_key;
 mysql_pfs_key_t zip_pad_mutex_key;
 mysql_pfs_key_t row_drop_list_mutex_key;
+mysql_pfs_key_t	alter_stage_mutex_key;
 mysql_pfs_key_t file_open_mutex_key;
 mysql_pfs_key_t	master_key_id_mutex_key;
 
@@ -141,6 +145,7 @@ mysql_pfs_key_t	fts_cache_rw_lock_key;
 mysql_pfs_key_t	fts_cache_init_rw_lock_key;
 mysql_pfs_key_t trx_i_s_cache_lock_key;
 mysql_pfs_key_t	trx_purge_latch_key;
+mysql_pfs_key_t	lock_sys_latch_key;
 #endif /* UNIV_PFS_RWLOCK */
 
 /* There are mutexes/rwlocks that we want to exclude from instrumentation
@@ -24,6 +24,7 @@ Created 3/26/1996 Heikki Tuuri
 *******************************************************/
 
 #include <sys/types.h>
+#include <algorithm>
 #include <new>
 
 #include "fsp0fsp.h"
@@ -238,6 +239,11 @@ trx_purge_sys_create(
 
 	mutex_create(LATCH_ID_PURGE_SYS_PQ, &purge_sys->pq_mutex);
 
+	mutex_create(LATCH_ID_PURGE_TABLE_STATS,
+		     &purge_sys->table_stats_mutex);
+
+	purge_sys->table_stats = UT_NEW_NOKEY(purge_table_stats_map_t());
+
 	ut_a(n_purge_threads > 0);
 
 	purge_sys->sess = sess_open();
@@ -292,6 +298,11 @@ trx_purge_sys_close(void)
 	rw_lock_free(&purge_sys->latch);
 	mutex_free(&purge_sys->pq_mutex);
 
+	UT_DELETE(purge_sys->table_stats);
+	purge_sys->table_stats = nullptr;
+
+	mutex_free(&purge_sys->table_stats_mutex);
+
 	if (purge_sys->purge_queue != NULL) {
 		UT_DELETE(purge_sys->purge_queue);
 		purge_sys->purge_queue = NULL;
@@ -1766,6 +1777,75 @@ trx_purge_fetch_next_rec(
 	return(trx_purge_get_next_rec(n_pages_handled, heap));
 }
 
+/** Maximum number of tables that purge keeps statistics for */
+static const ulint	PURGE_TABLE_STATS_MAX = 1024;
+
+/** Get the purge statistics of a table, creating them if needed. If
+there are too many tables, the statistics of the table that was purged
+longest ago are dropped.
+@param[in,out]	purge_sys	purge instance
+@param[in]	table_id	table id
+@return statistics of the table */
+static
+purge_table_stats_t&
+trx_purge_get_table_stats_low(
+	trx_purge_t*	purge_sys,
+	table_id_t	table_id)
+{
+	purge_table_stats_map_t*	stats = purge_sys->table_stats;
+
+	ut_ad(mutex_own(&purge_sys->table_stats_mutex));
+
+	auto	it = stats->find(table_id);
+
+	if (it != stats->end()) {
+		return(it->second);
+	}
+
+	if (stats->size() >= PURGE_TABLE_STATS_MAX) {
+		auto	oldest = stats->begin();
+
+		for (auto i = stats->begin(); i != stats->end(); ++i) {
+			if (i->second.last_trx_no
+			    < oldest->second.last_trx_no) {
+				oldest = i;
+			}
+		}
+
+		stats->erase(oldest);
+	}
+
+	purge_table_stats_t&	table_stats = (*stats)[table_id];
+
+	memset(&table_stats, 0x0, sizeof(table_stats));
+	table_stats.table_id = table_id;
+
+	return(table_stats);
+}
+
+/** Get a copy of the purge statistics of the tables.
+@param[out]	stats	statistics of the tables that purge has seen */
+void
+trx_purge_get_table_stats(
+	purge_table_stats_list_t&	stats)
+{
+	stats.clear();
+
+	if (purge_sys == nullptr) {
+		return;
+	}
+
+	mutex_enter(&purge_sys->table_stats_mutex);
+
+	stats.reserve(purge_sys->table_stats->size());
+
+	for (const auto& table_stats : *purge_sys->table_stats) {
+		stats.push_back(table_stats.second);
+	}
+
+	mutex_exit(&purge_sys->table_stats_mutex);
+}
+
 /** This function runs a purge batch.
 @param[in]	n_purge_threads	number of purge threads
 @param[in,out]	purge_sys	purge instance
@@ -1820,11 +1900,19 @@ trx_purge_attach_undo_recs(
 
 	mem_heap_empty(heap);
 
+	/** Undo records of one table in the batch */
+	struct Group {
+		/** The undo records */
+		purge_node_t::Recs*	recs;
+
+		/** Number of the transaction of the first record */
+		trx_id_t		trx_no;
+	};
+
 	using GroupBy = std::map<
-		table_id_t, purge_node_t::Recs*,
+		table_id_t, Group,
 		std::less<table_id_t>,
-		mem_heap_allocator<
-			std::pair<const table_id_t, purge_node_t::Recs*>>>;
+		mem_heap_allocator<std::pair<const table_id_t, Group>>>;
 
 	GroupBy		group_by{
 		GroupBy::key_compare{},
@@ -1863,7 +1951,7 @@ trx_purge_attach_undo_recs(
 		if (lb != group_by.end()
 		    && !(group_by.key_comp()(table_id, lb->first))) {
 
-			lb->second->push_back(rec);
+			lb->second.recs->push_back(rec);
 
 		} else {
 			using value_type = GroupBy::value_type;
@@ -1879,35 +1967,92 @@ trx_purge_attach_undo_recs(
 
 			recs->push_back(rec);
 
-			group_by.insert(lb, value_type(table_id, recs));
+			Group	group{recs, purge_sys->iter.trx_no};
+
+			group_by.insert(lb, value_type(table_id, group));
+		}
+	}
+
+	/* Update the statistics of the tables in the batch, before
+	the records of several tables are appended to each other. */
+	if (!group_by.empty()) {
+		trx_id_t	max_trx_id = trx_sys_get_max_trx_id();
+
+		mutex_enter(&purge_sys->table_stats_mutex);
+
+		for (const auto& group : group_by) {
+			purge_table_stats_t&	stats
+				= trx_purge_get_table_stats_low(
+					purge_sys, group.first);
+
+			const ulint	n = group.second.recs->size();
+
+			stats.n_recs += n;
+			++stats.n_batches;
+			stats.last_batch_recs = n;
+			stats.last_trx_no = group.second.trx_no;
+			stats.lag = max_trx_id > group.second.trx_no
+				? max_trx_id - group.second.trx_no : 0;
 		}
+
+		mutex_exit(&purge_sys->table_stats_mutex);
 	}
 
 	/* Objective is to ensure that all the table entries in one
 	batch are handled by the same thread. Ths is to avoid contention
-	on the dict_index_t::lock */
+	on the dict_index_t::lock. The tables are handed out largest
+	first, each to the thread with the fewest records so far, so
+	that a table with many records does not leave the other threads
+	idle at the end of the batch. */
 
-	GroupBy::const_iterator	end = group_by.cend();
+	using Groups = std::vector<
+		const GroupBy::value_type*,
+		mem_heap_allocator<const GroupBy::value_type*>>;
 
-	for (GroupBy::const_iterator it = group_by.cbegin(); it != end; ) {
+	Groups	groups{mem_heap_allocator<const GroupBy::value_type*>{heap}};
 
-		for (ulint i = 0; i < n_purge_threads && it != end; ++i, ++it) {
+	groups.reserve(group_by.size());
 
-			purge_node_t*	node;
+	for (const auto& group : group_by) {
+		groups.push_back(&group);
+	}
 
-			node = static_cast<purge_node_t*>(run_thrs[i]->child);
+	std::stable_sort(
+		groups.begin(), groups.end(),
+		[](const GroupBy::value_type* lhs,
+		   const GroupBy::value_type* rhs)
+		{
+			return(lhs->second.recs->size()
+			       > rhs->second.recs->size());
+		});
 
-			ut_a(que_node_get_type(node) == QUE_NODE_PURGE);
+	ulint	n_recs[MAX_PURGE_THREADS];
 
-			if (node->recs == nullptr) {
-				node->recs = it->second;
-			} else {
-				node->recs->insert(
-					std::end(*node->recs),
-					std::begin(*it->second),
-					std::end(*it->second));
-			}
+	std::fill_n(n_recs, n_purge_threads, 0);
+
+	for (const auto group : groups) {
+
+		ulint	i = std::min_element(
+			n_recs, n_recs + n_purge_threads) - n_recs;
+
+		purge_node_t*	node;
+
+		node = static_cast<purge_node_t*>(run_thrs[i]->child);
+
+		ut_a(que_node_get_type(node) == QUE_NODE_PURGE);
+
+		const purge_node_t::Recs*	recs = group->second.recs;
+
+		if (node->recs == nullptr) {
+			node->recs = group->second.recs;
+		} else {
+			node->recs->insert(
+				std::end(*node->recs),
+				std::begin(*recs),
+				std::end(*recs));
 		}
+
+		n_recs[i] += recs->size();
 	}
 
 	ut_ad(trx_purge_check_limit());
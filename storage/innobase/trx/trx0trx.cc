@@ -29,6 +29,7 @@ Created 3/26/1996 Heikki Tuuri
 #include <set>
 
 #include "btr0sea.h"
+#include "buf0lru.h"
 #include "dict0dd.h"
 #include "fsp0sysspace.h"
 #include "ha_prototypes.h"
@@ -1881,6 +1882,8 @@ trx_erase_lists(
 	ut_ad(*it == trx->id);
 	trx_sys->rw_trx_ids.erase(it);
 
+	++trx_sys->rw_trx_ids_version;
+
 	if (trx->read_only || trx->rsegs.m_redo.rseg == NULL) {
 
 		ut_ad(!trx->in_rw_trx_list);
@@ -2427,6 +2430,11 @@ trx_commit_for_mysql(
 
 		MONITOR_DEC(MONITOR_TRX_ACTIVE);
 		trx->op_info = "";
+
+		/* Do not keep the page accesses of the transaction
+		buffered until the connection runs another one. */
+		buf_LRU_access_flush();
+
 		return(DB_SUCCESS);
 	case TRX_STATE_COMMITTED_IN_MEMORY:
 		break;
@@ -2616,7 +2624,7 @@ state_ok:
 
 /**********************************************************************//**
 Prints info about a transaction.
-The caller must hold lock_sys->mutex and trx_sys->mutex.
+The caller must hold lock_sys->latch in X mode and trx_sys->mutex.
 When possible, use trx_print() instead. */
 void
 trx_print_latched(
@@ -2637,7 +2645,7 @@ trx_print_latched(
 
 /**********************************************************************//**
 Prints info about a transaction.
-Acquires and releases lock_sys->mutex and trx_sys->mutex. */
+Acquires and releases lock_sys->latch and trx_sys->mutex. */
 void
 trx_print(
 /*======*/
@@ -2683,7 +2691,8 @@ trx_assert_started(
 	/* trx->state can change from or to NOT_STARTED while we are holding
 	trx_sys->mutex for non-locking autocommit selects but not for other
 	types of transactions. It may change from ACTIVE to PREPARED. Unless
-	we are holding lock_sys->mutex, it may also change to COMMITTED. */
+	we are holding lock_sys->latch in X mode, it may also change to
+	COMMITTED. */
 
 	switch (trx->state) {
 	case TRX_STATE_PREPARED:
@@ -2965,7 +2974,7 @@ This function is used to find one X/Open XA distributed transaction
 which is in the prepared state
 @return trx on match, the trx->xid will be invalidated;
 note that the trx may have been committed, unless the caller is
-holding lock_sys->mutex */
+holding lock_sys->latch in X mode */
 static MY_ATTRIBUTE((warn_unused_result))
 trx_t*
 trx_get_trx_by_xid_low(
@@ -3007,7 +3016,7 @@ This function is used to find one X/Open XA distributed transaction
 which is in the prepared state
 @return trx or NULL; on match, the trx->xid will be invalidated;
 note that the trx may have been committed, unless the caller is
-holding lock_sys->mutex */
+holding lock_sys->latch in X mode */
 trx_t*
 trx_get_trx_by_xid(
 /*===============*/
@@ -90,6 +90,11 @@ external tools. */
 #include <intrin.h>
 #endif
 
+#if defined(__GNUC__) && defined(__aarch64__) && defined(__linux__)
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#endif
+
 #include "univ.i"
 #include "ut0crc32.h"
 
@@ -104,6 +109,13 @@ ut_crc32_func_t	ut_crc32_legacy_big_endian;
 but very slow). */
 ut_crc32_func_t	ut_crc32_byte_by_byte;
 
+/** Pointer to the software CRC32 calculation function, which does not use
+CPU instructions. */
+ut_crc32_func_t	ut_crc32_sw_func;
+
+/** Name of the implementation that ut_crc32() uses. */
+const char*	ut_crc32_implementation;
+
 /** Swap the byte order of an 8 byte integer.
 @param[in]	i	8-byte integer
 @return 8-byte integer */
@@ -132,9 +144,48 @@ bool	ut_crc32_cpu_enabled = false;
 #define gnuc64
 #endif
 
-#if defined(gnuc64) || defined(_WIN32)
+#if defined(__GNUC__) && defined(__aarch64__) && defined(__linux__)
+#define gnuc_aarch64
+#endif
+
+#if defined(gnuc64) || defined(_WIN32) || defined(gnuc_aarch64)
+#define UT_CRC32_HW
+#endif
+
+#ifdef gnuc_aarch64
+/* The CRC32 instructions are optional in ARMv8.0. Compile the functions
+that use them for a CPU that has them and only call them if the CPU
+reports HWCAP_CRC32. */
+# ifdef __clang__
+#  define UT_CRC32_TARGET	__attribute__((target("crc")))
+# else
+#  define UT_CRC32_TARGET	__attribute__((target("+crc")))
+# endif
+
+# ifndef HWCAP_CRC32
+#  define HWCAP_CRC32	(1 << 7)
+# endif
+#else
+# define UT_CRC32_TARGET
+#endif /* gnuc_aarch64 */
+
+#ifdef UT_CRC32_HW
+/** Number of bytes in each of the three blocks that ut_crc32_hw()
+checksums in parallel in its main loop. Must be a power of 2. */
+static const ulint	UT_CRC32_LONG = 1024;
+
+/** Number of bytes in each of the three blocks that ut_crc32_hw()
+checksums in parallel before its tail loop. Must be a power of 2. */
+static const ulint	UT_CRC32_SHORT = 256;
+
+/** Tables for appending UT_CRC32_LONG zero bytes to a CRC32 */
+static uint32_t	ut_crc32_long_table[4][256];
+
+/** Tables for appending UT_CRC32_SHORT zero bytes to a CRC32 */
+static uint32_t	ut_crc32_short_table[4][256];
+
 /** Checks whether the CPU has the CRC32 instructions (part of the SSE4.2
-instruction set).
+instruction set on x86_64, an optional extension of ARMv8.0).
 @return true if CRC32 is available */
 static
 bool
@@ -160,6 +211,9 @@ ut_crc32_check_cpu()
 	return false;
 #else
 
+#if defined(gnuc_aarch64)
+	return(getauxval(AT_HWCAP) & HWCAP_CRC32);
+#else
 	uint32_t	features_ecx;
 
 #if defined(gnuc64)
@@ -180,6 +234,7 @@ ut_crc32_check_cpu()
 #endif
 
 	return features_ecx & (1 << 20);  // SSE4.2
+#endif /* gnuc_aarch64 */
 #endif /* UNIV_DEBUG_VALGRIND */
 }
 
@@ -189,6 +244,7 @@ when the function ends it will contain the new checksum
 @param[in,out]	data	data to be checksummed, the pointer will be advanced
 with 1 byte
 @param[in,out]	len	remaining bytes, it will be decremented with 1 */
+UT_CRC32_TARGET
 inline
 void
 ut_crc32_8_hw(
@@ -202,6 +258,8 @@ ut_crc32_8_hw(
 	    : "+r" (*crc)
 	    /* input operands */
 	    : "rm" ((*data)[0]));
+#elif defined(gnuc_aarch64)
+	*crc = __crc32cb(static_cast<uint32_t>(*crc), (*data)[0]);
 #elif defined(_WIN32)
 	*crc = _mm_crc32_u8(static_cast<unsigned>(*crc), (*data)[0]);
 #else
@@ -216,6 +274,7 @@ ut_crc32_8_hw(
 @param[in]	crc	crc32 checksum so far
 @param[in]	data	data to be checksummed
 @return resulting checksum of crc + crc(data) */
+UT_CRC32_TARGET
 inline
 uint64_t
 ut_crc32_64_low_hw(
@@ -230,6 +289,8 @@ ut_crc32_64_low_hw(
 	    : "+r" (crc_64bit)
 	    /* input operands */
 	    : "rm" (data));
+#elif defined(gnuc_aarch64)
+	crc_64bit = __crc32cd(static_cast<uint32_t>(crc_64bit), data);
 #elif defined(_WIN32)
 	crc_64bit = _mm_crc32_u64(crc_64bit, data);
 #else
@@ -245,6 +306,7 @@ when the function ends it will contain the new checksum
 @param[in,out]	data	data to be checksummed, the pointer will be advanced
 with 8 bytes
 @param[in,out]	len	remaining bytes, it will be decremented with 8 */
+UT_CRC32_TARGET
 inline
 void
 ut_crc32_64_hw(
@@ -255,9 +317,9 @@ ut_crc32_64_hw(
 	uint64_t	data_int = *reinterpret_cast<const uint64_t*>(*data);
 
 #ifdef WORDS_BIGENDIAN
-	/* Currently we only support x86_64 (little endian) CPUs. In case
-	some big endian CPU supports a CRC32 instruction, then maybe we will
-	need a byte order swap here. */
+	/* Currently we only support little endian CPUs. In case some big
+	endian CPU supports a CRC32 instruction, then maybe we will need a
+	byte order swap here. */
 #error Dont know how to handle big endian CPUs
 	/*
 	data_int = ut_crc32_swap_byteorder(data_int);
@@ -277,6 +339,7 @@ when the function ends it will contain the new checksum
 @param[in,out]	data	data to be checksummed, the pointer will be advanced
 with 8 bytes
 @param[in,out]	len	remaining bytes, it will be decremented with 8 */
+UT_CRC32_TARGET
 inline
 void
 ut_crc32_64_legacy_big_endian_hw(
@@ -289,9 +352,9 @@ ut_crc32_64_legacy_big_endian_hw(
 #ifndef WORDS_BIGENDIAN
 	data_int = ut_crc32_swap_byteorder(data_int);
 #else
-	/* Currently we only support x86_64 (little endian) CPUs. In case
-	some big endian CPU supports a CRC32 instruction, then maybe we will
-	NOT need a byte order swap here. */
+	/* Currently we only support little endian CPUs. In case some big
+	endian CPU supports a CRC32 instruction, then maybe we will NOT
+	need a byte order swap here. */
 #error Dont know how to handle big endian CPUs
 #endif /* WORDS_BIGENDIAN */
 
@@ -301,10 +364,168 @@ ut_crc32_64_legacy_big_endian_hw(
 	*len -= 8;
 }
 
+/** Multiply a 32-bit vector by a 32x32 matrix over GF(2).
+@param[in]	mat	matrix, one column per element
+@param[in]	vec	vector
+@return mat * vec */
+static
+uint32_t
+ut_crc32_gf2_matrix_times(
+	const uint32_t*	mat,
+	uint32_t	vec)
+{
+	uint32_t	sum = 0;
+
+	for (; vec != 0; vec >>= 1, mat++) {
+		if (vec & 1) {
+			sum ^= *mat;
+		}
+	}
+
+	return(sum);
+}
+
+/** Square a 32x32 matrix over GF(2).
+@param[out]	square	mat * mat
+@param[in]	mat	matrix */
+static
+void
+ut_crc32_gf2_matrix_square(
+	uint32_t*	square,
+	const uint32_t*	mat)
+{
+	for (ulint n = 0; n < 32; n++) {
+		square[n] = ut_crc32_gf2_matrix_times(mat, mat[n]);
+	}
+}
+
+/** Initialize the tables for appending len zero bytes to a CRC32. Shifting
+a CRC32 this way lets the CRC32s of adjacent blocks that were computed
+independently be combined into the CRC32 of the concatenation.
+@param[out]	table	tables for shifting each byte of a CRC32
+@param[in]	len	number of zero bytes, must be a power of 2 */
+static
+void
+ut_crc32_zeros_table_init(
+	uint32_t	table[4][256],
+	ulint		len)
+{
+	uint32_t	even[32];
+	uint32_t	odd[32];
+	uint32_t	row = 1;
+
+	ut_ad((len & (len - 1)) == 0);
+
+	/* Operator for one zero bit: bit-reversed poly 0x1EDC6F41. */
+	odd[0] = 0x82f63b78;
+
+	for (ulint n = 1; n < 32; n++) {
+		odd[n] = row;
+		row <<= 1;
+	}
+
+	/* Operators for two and four zero bits. */
+	ut_crc32_gf2_matrix_square(even, odd);
+	ut_crc32_gf2_matrix_square(odd, even);
+
+	/* Square until the operator is for 8 * len zero bits. */
+	const uint32_t*	op;
+
+	for (;;) {
+		ut_crc32_gf2_matrix_square(even, odd);
+		len >>= 1;
+		if (len == 0) {
+			op = even;
+			break;
+		}
+
+		ut_crc32_gf2_matrix_square(odd, even);
+		len >>= 1;
+		if (len == 0) {
+			op = odd;
+			break;
+		}
+	}
+
+	for (uint32_t n = 0; n < 256; n++) {
+		table[0][n] = ut_crc32_gf2_matrix_times(op, n);
+		table[1][n] = ut_crc32_gf2_matrix_times(op, n << 8);
+		table[2][n] = ut_crc32_gf2_matrix_times(op, n << 16);
+		table[3][n] = ut_crc32_gf2_matrix_times(op, n << 24);
+	}
+}
+
+/** Append zero bytes to a CRC32.
+@param[in]	table	tables from ut_crc32_zeros_table_init()
+@param[in]	crc	crc32 checksum so far
+@return crc32 checksum after the zero bytes */
+inline
+uint64_t
+ut_crc32_shift(
+	const uint32_t	table[4][256],
+	uint64_t	crc)
+{
+	return(table[0][crc & 0xFF]
+	       ^ table[1][(crc >> 8) & 0xFF]
+	       ^ table[2][(crc >> 16) & 0xFF]
+	       ^ table[3][(crc >> 24) & 0xFF]);
+}
+
+/** Calculate CRC32 over groups of three adjacent blocks using
+hardware/CPU instructions. The three blocks of a group are checksummed in
+parallel: the crc32 instruction has a latency of several cycles but a new
+one can start every cycle, so three independent dependency chains keep
+the unit busy. The CRC32s of the blocks are then combined by shifting.
+@param[in,out]	crc		crc32 checksum so far when this function
+is called, when the function ends it will contain the new checksum
+@param[in,out]	data		data to be checksummed, the pointer will
+be advanced past the groups that were processed
+@param[in,out]	len		remaining bytes, it will be decremented
+with the number of bytes processed
+@param[in]	block_len	length of a block, a multiple of 8
+@param[in]	table		tables for appending block_len zero bytes */
+UT_CRC32_TARGET
+inline
+void
+ut_crc32_3way_hw(
+	uint64_t*	crc,
+	const byte**	data,
+	ulint*		len,
+	ulint		block_len,
+	const uint32_t	table[4][256])
+{
+	while (*len >= 3 * block_len) {
+		const byte*	p = *data;
+		const byte*	end = p + block_len;
+		uint64_t	crc0 = *crc;
+		uint64_t	crc1 = 0;
+		uint64_t	crc2 = 0;
+
+		do {
+			crc0 = ut_crc32_64_low_hw(
+				crc0, *reinterpret_cast<const uint64_t*>(p));
+			crc1 = ut_crc32_64_low_hw(
+				crc1, *reinterpret_cast<const uint64_t*>(
+					p + block_len));
+			crc2 = ut_crc32_64_low_hw(
+				crc2, *reinterpret_cast<const uint64_t*>(
+					p + 2 * block_len));
+			p += 8;
+		} while (p < end);
+
+		crc0 = ut_crc32_shift(table, crc0) ^ crc1;
+		*crc = ut_crc32_shift(table, crc0) ^ crc2;
+
+		*data += 3 * block_len;
+		*len -= 3 * block_len;
+	}
+}
+
 /** Calculates CRC32 using hardware/CPU instructions.
 @param[in]	buf	data over which to calculate CRC32
 @param[in]	len	data length
 @return CRC-32C (polynomial 0x11EDC6F41) */
+UT_CRC32_TARGET
 static
 uint32_t
 ut_crc32_hw(
@@ -321,6 +542,12 @@ ut_crc32_hw(
 		ut_crc32_8_hw(&crc, &buf, &len);
 	}
 
+	/* Checksum most of the data with three independent streams. What
+	is left is less than 3 * UT_CRC32_SHORT bytes. */
+	ut_crc32_3way_hw(&crc, &buf, &len, UT_CRC32_LONG, ut_crc32_long_table);
+	ut_crc32_3way_hw(&crc, &buf, &len, UT_CRC32_SHORT,
+			 ut_crc32_short_table);
+
 	/* Perf testing
 	./unittest/gunit/innodb/merge_innodb_tests-t --gtest_filter=ut0crc32.perf
 	on CPU "Intel(R) Core(TM) i7-4770 CPU @ 3.40GHz"
@@ -397,6 +624,7 @@ integers.
 @param[in]	buf	data over which to calculate CRC32
 @param[in]	len	data length
 @return CRC-32C (polynomial 0x11EDC6F41) */
+UT_CRC32_TARGET
 static
 uint32_t
 ut_crc32_legacy_big_endian_hw(
@@ -450,6 +678,7 @@ not depend on the byte order of the machine.
 @param[in]	buf	data over which to calculate CRC32
 @param[in]	len	data length
 @return CRC-32C (polynomial 0x11EDC6F41) */
+UT_CRC32_TARGET
 static
 uint32_t
 ut_crc32_byte_by_byte_hw(
@@ -466,7 +695,7 @@ ut_crc32_byte_by_byte_hw(
 
 	return(~static_cast<uint32_t>(crc));
 }
-#endif /* defined(gnuc64) || defined(_WIN32) */
+#endif /* UT_CRC32_HW */
 
 /* CRC32 software implementation. */
 
@@ -738,20 +967,34 @@ void
 ut_crc32_init()
 /*===========*/
 {
-#if defined(gnuc64) || defined(_WIN32)
+	ut_crc32_slice8_table_init();
+	ut_crc32_sw_func = ut_crc32_sw;
+
+#ifdef UT_CRC32_HW
 	ut_crc32_cpu_enabled = ut_crc32_check_cpu();
 
 	if (ut_crc32_cpu_enabled) {
+		ut_crc32_zeros_table_init(ut_crc32_long_table, UT_CRC32_LONG);
+		ut_crc32_zeros_table_init(
+			ut_crc32_short_table, UT_CRC32_SHORT);
+
 		ut_crc32 = ut_crc32_hw;
 		ut_crc32_legacy_big_endian = ut_crc32_legacy_big_endian_hw;
 		ut_crc32_byte_by_byte = ut_crc32_byte_by_byte_hw;
+#ifdef gnuc_aarch64
+		ut_crc32_implementation = "ARMv8 crc32c instructions,"
+			" 3-way interleaved";
+#else
+		ut_crc32_implementation = "SSE4.2 crc32 instructions,"
+			" 3-way interleaved";
+#endif /* gnuc_aarch64 */
 	}
-#endif /* defined(gnuc64) || defined(_WIN32) */
+#endif /* UT_CRC32_HW */
 
 	if (!ut_crc32_cpu_enabled) {
-		ut_crc32_slice8_table_init();
 		ut_crc32 = ut_crc32_sw;
 		ut_crc32_legacy_big_endian = ut_crc32_legacy_big_endian_sw;
 		ut_crc32_byte_by_byte = ut_crc32_byte_by_byte_sw;
+		ut_crc32_implementation = "software slice-by-8";
 	}
 }
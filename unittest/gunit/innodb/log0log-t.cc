@@ -0,0 +1,159 @@
+/* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <string.h>
+
+#include <gtest/gtest.h>
+
+#include "univ.i"
+
+#include "log0log.h"
+
+namespace innodb_log0log_unittest {
+
+/** Size of the log buffer used by the tests */
+static const ulint	BUF_SIZE = 4 * 1024 * 1024;
+
+/** Start lsn of the log buffer used by the tests */
+static const lsn_t	START_LSN = 8 * OS_FILE_LOG_BLOCK_SIZE;
+
+/** Log buffer used by the test */
+class LogBuf {
+public:
+	LogBuf()
+		:
+		m_buf(new byte[BUF_SIZE]),
+		m_free(),
+		m_lsn()
+	{
+		reset();
+	}
+
+	~LogBuf()
+	{
+		delete[] m_buf;
+	}
+
+	/** Start again from the first block of the buffer, as if the
+	buffer had been written out and switched. */
+	void reset()
+	{
+		memset(m_buf, 0, BUF_SIZE);
+		m_lsn = START_LSN;
+		log_block_init(m_buf, m_lsn);
+		m_free = LOG_BLOCK_HDR_SIZE;
+		m_lsn += LOG_BLOCK_HDR_SIZE;
+	}
+
+	/** Make room for a record group, resetting the buffer if needed. */
+	void make_room(ulint len)
+	{
+		if (m_free + 2 * len + 2 * OS_FILE_LOG_BLOCK_SIZE > BUF_SIZE) {
+			reset();
+		}
+	}
+
+	byte*	m_buf;
+	ulint	m_free;
+	lsn_t	m_lsn;
+};
+
+/** Check that a log buffer area contains the given data, framed
+in log blocks with valid headers. */
+static
+void
+check_framing(
+	const byte*	buf,
+	ulint		offset,
+	lsn_t		lsn,
+	const byte*	str,
+	ulint		len)
+{
+	while (len > 0) {
+		const byte*	block = buf + ut_calc_align_down(
+			offset, OS_FILE_LOG_BLOCK_SIZE);
+		ulint		in_block = offset % OS_FILE_LOG_BLOCK_SIZE;
+		ulint		part_len = std::min<ulint>(
+			len,
+			OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE - in_block);
+
+		EXPECT_EQ(log_block_convert_lsn_to_no(lsn),
+			  log_block_get_hdr_no(block));
+		EXPECT_EQ(0, memcmp(buf + offset, str, part_len));
+
+		str += part_len;
+		len -= part_len;
+		offset += part_len;
+		lsn += part_len;
+
+		if (in_block + part_len
+		    == OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
+			EXPECT_EQ(static_cast<ulint>(OS_FILE_LOG_BLOCK_SIZE),
+				  log_block_get_data_len(block));
+			offset += LOG_BLOCK_TRL_SIZE + LOG_BLOCK_HDR_SIZE;
+			lsn += LOG_BLOCK_TRL_SIZE + LOG_BLOCK_HDR_SIZE;
+		} else {
+			EXPECT_EQ(in_block + part_len,
+				  log_block_get_data_len(block));
+		}
+	}
+}
+
+/* Framing a record group and copying it in, possibly in several pieces,
+must produce a correctly formatted log buffer area. */
+TEST(log0log, frame_and_copy)
+{
+	LogBuf		log;
+	const ulint	max_len = 5 * OS_FILE_LOG_BLOCK_SIZE;
+	byte		str[max_len];
+
+	for (ulint i = 0; i < max_len; i++) {
+		str[i] = static_cast<byte>(i * 7 + 1);
+	}
+
+	for (ulint len = 1; len <= max_len; len += 13) {
+		log.make_room(len);
+
+		const ulint	offset = log.m_free;
+		const lsn_t	lsn = log.m_lsn;
+
+		ulint	framed = log_buffer_frame(
+			log.m_buf, offset, lsn, len, 1);
+
+		/* Copy in two pieces, like an mtr_buf_t with two blocks. */
+		ulint	end = log_buffer_copy(
+			log.m_buf, offset, str, len / 3);
+
+		end = log_buffer_copy(
+			log.m_buf, end, str + len / 3, len - len / 3);
+
+		EXPECT_EQ(offset + framed, end);
+
+		check_framing(log.m_buf, offset, lsn, str, len);
+
+		log.m_free += framed;
+		log.m_lsn += framed;
+
+		EXPECT_EQ(log.m_lsn % OS_FILE_LOG_BLOCK_SIZE,
+			  log.m_free % OS_FILE_LOG_BLOCK_SIZE);
+	}
+}
+
+}  // namespace innodb_log0log_unittest
@@ -0,0 +1,446 @@
+/* Copyright (c) 2017, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <gtest/gtest.h>
+
+#include "univ.i"
+
+#ifdef LINUX_IO_URING
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <iostream>
+#include <string>
+
+#ifdef LINUX_NATIVE_AIO
+#include <libaio.h>
+#endif /* LINUX_NATIVE_AIO */
+
+#include "benchmark.h"
+#include "os0uring.h"
+
+namespace innodb_os0uring_unittest {
+
+/** Skip the current test or benchmark because the kernel does not provide
+the interface that it measures.  googletest 1.8, which the build downloads,
+has no GTEST_SKIP(), so there the reason is recorded as a property of the
+test, which appears in the XML report, and printed in the style of the
+googletest output. */
+#ifdef GTEST_SKIP
+#define OS0URING_SKIP(reason)	GTEST_SKIP() << (reason)
+#else
+#define OS0URING_SKIP(reason)						\
+	do {								\
+		::testing::Test::RecordProperty("skipped", (reason));	\
+		std::cout << "[  SKIPPED ] " << (reason) << std::endl;	\
+		return;							\
+	} while (0)
+#endif /* GTEST_SKIP */
+
+/** Name of the file used by the tests, in the current directory */
+static const char	FILE_NAME[] = "os0uring-t.dat";
+
+/** Size of the file used by the tests */
+static const ulint	FILE_SIZE = 64 * 1024 * 1024;
+
+/** Size of each read or write, as for a default InnoDB page */
+static const ulint	REQ_SIZE = 16 * 1024;
+
+/** Number of requests kept in flight by the benchmarks */
+static const ulint	QUEUE_DEPTH = 32;
+
+/** Timeout of a wait for completions, in nanoseconds */
+static const uint64_t	WAIT_TIMEOUT = 10ULL * 1000 * 1000 * 1000;
+
+/** A file of FILE_SIZE bytes and QUEUE_DEPTH aligned buffers of REQ_SIZE
+bytes.  The file is opened with O_DIRECT if the file system allows it,
+so that the benchmarks measure the device and not the page cache. */
+class TestFile {
+public:
+	TestFile()
+		:
+		m_fd(-1),
+		m_buf()
+	{
+		int	ret = posix_memalign(
+			reinterpret_cast<void**>(&m_buf), REQ_SIZE,
+			QUEUE_DEPTH * REQ_SIZE);
+
+		if (ret != 0) {
+			m_buf = NULL;
+			return;
+		}
+
+		m_fd = ::open(FILE_NAME, O_RDWR | O_CREAT | O_TRUNC | O_DIRECT,
+			      0600);
+
+		if (m_fd < 0) {
+			m_fd = ::open(FILE_NAME, O_RDWR | O_CREAT | O_TRUNC,
+				      0600);
+		}
+
+		if (m_fd < 0) {
+			return;
+		}
+
+		/* Fill the file with a pattern that identifies each
+		block, so that reads can be verified. */
+		for (ulint offset = 0; offset < FILE_SIZE;
+		     offset += REQ_SIZE) {
+
+			fill(m_buf, offset);
+
+			if (pwrite(m_fd, m_buf, REQ_SIZE, offset)
+			    != static_cast<ssize_t>(REQ_SIZE)) {
+
+				::close(m_fd);
+				m_fd = -1;
+				break;
+			}
+		}
+	}
+
+	~TestFile()
+	{
+		if (m_fd >= 0) {
+			::close(m_fd);
+			unlink(FILE_NAME);
+		}
+
+		free(m_buf);
+	}
+
+	/** @return true if the file and the buffers could be created */
+	bool is_ok() const
+	{
+		return(m_fd >= 0);
+	}
+
+	/** Fill a buffer with the pattern of a block.
+	@param[out]	buf	buffer of REQ_SIZE bytes
+	@param[in]	offset	file offset of the block */
+	static void fill(byte* buf, ulint offset)
+	{
+		memset(buf, static_cast<int>((offset / REQ_SIZE) % 251 + 1),
+		       REQ_SIZE);
+	}
+
+	/** @return whether a buffer holds the pattern of a block
+	@param[in]	buf	buffer of REQ_SIZE bytes
+	@param[in]	offset	file offset of the block */
+	static bool check(const byte* buf, ulint offset)
+	{
+		byte	expected = static_cast<byte>(
+			(offset / REQ_SIZE) % 251 + 1);
+
+		for (ulint i = 0; i < REQ_SIZE; i++) {
+			if (buf[i] != expected) {
+				return(false);
+			}
+		}
+
+		return(true);
+	}
+
+	/** @return buffer of a request
+	@param[in]	i	request number, less than QUEUE_DEPTH */
+	byte* buf(ulint i) const
+	{
+		return(m_buf + i * REQ_SIZE);
+	}
+
+	/** File descriptor */
+	int	m_fd;
+
+	/** QUEUE_DEPTH buffers of REQ_SIZE bytes */
+	byte*	m_buf;
+};
+
+/** Pick a random block of the file.
+@param[in,out]	state	state of the generator, non-zero
+@return file offset of the block */
+static
+ulint
+random_offset(uint64_t* state)
+{
+	/* xorshift64 */
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+
+	return((*state % (FILE_SIZE / REQ_SIZE)) * REQ_SIZE);
+}
+
+/** Write blocks through a ring, then read them back both with pread()
+and through the ring, with and without fixed buffers. */
+TEST(os0uring, write_and_read)
+{
+	TestFile	file;
+
+	ASSERT_TRUE(file.is_ok());
+
+	IoUring		ring;
+	int		err = ring.open(QUEUE_DEPTH);
+
+	if (err != 0) {
+		OS0URING_SKIP(std::string("io_uring is not available: ")
+			      + strerror(-err));
+	}
+
+	const ulint	base = FILE_SIZE / 2;
+
+	/* Overwrite QUEUE_DEPTH blocks with the pattern of the blocks
+	at the start of the file. */
+	for (ulint i = 0; i < QUEUE_DEPTH; i++) {
+		TestFile::fill(file.buf(i), i * REQ_SIZE);
+
+		ASSERT_TRUE(ring.prepare(
+			false, file.m_fd, file.buf(i), REQ_SIZE,
+			base + i * REQ_SIZE, file.buf(i), -1));
+	}
+
+	/* The submission queue is full. */
+	EXPECT_FALSE(ring.prepare(false, file.m_fd, file.buf(0), REQ_SIZE,
+				  base, file.buf(0), -1));
+	EXPECT_EQ(QUEUE_DEPTH, ring.n_queued());
+
+	for (ulint n = 0; n < QUEUE_DEPTH; ) {
+		void*	data;
+		int	res;
+
+		if (!ring.reap(&data, &res)) {
+			err = ring.wait(WAIT_TIMEOUT);
+			ASSERT_TRUE(err >= 0 || err == -EINTR);
+			continue;
+		}
+
+		EXPECT_EQ(static_cast<int>(REQ_SIZE), res);
+		++n;
+	}
+
+	EXPECT_EQ(0U, ring.n_queued());
+
+	for (ulint i = 0; i < QUEUE_DEPTH; i++) {
+		ASSERT_EQ(static_cast<ssize_t>(REQ_SIZE),
+			  pread(file.m_fd, file.buf(i), REQ_SIZE,
+				base + i * REQ_SIZE));
+		EXPECT_TRUE(TestFile::check(file.buf(i), i * REQ_SIZE));
+	}
+
+	/* Read them back through the ring, with every other request
+	using the fixed buffer. */
+	struct iovec	iov;
+
+	iov.iov_base = file.m_buf;
+	iov.iov_len = QUEUE_DEPTH * REQ_SIZE;
+
+	bool	fixed = ring.register_buffers(&iov, 1) == 0;
+
+	memset(file.m_buf, 0x0, QUEUE_DEPTH * REQ_SIZE);
+
+	for (ulint i = 0; i < QUEUE_DEPTH; i++) {
+		ASSERT_TRUE(ring.prepare(
+			true, file.m_fd, file.buf(i), REQ_SIZE,
+			base + i * REQ_SIZE,
+			reinterpret_cast<void*>(i + 1),
+			fixed && (i & 1) ? 0 : -1));
+	}
+
+	EXPECT_GE(ring.submit(), 0);
+
+	for (ulint n = 0; n < QUEUE_DEPTH; ) {
+		void*	data;
+		int	res;
+
+		if (!ring.reap(&data, &res)) {
+			err = ring.wait(WAIT_TIMEOUT);
+			ASSERT_TRUE(err >= 0 || err == -EINTR);
+			continue;
+		}
+
+		ulint	i = reinterpret_cast<ulint>(data) - 1;
+
+		ASSERT_LT(i, QUEUE_DEPTH);
+		EXPECT_EQ(static_cast<int>(REQ_SIZE), res);
+		EXPECT_TRUE(TestFile::check(file.buf(i), i * REQ_SIZE));
+		++n;
+	}
+
+	if (fixed) {
+		EXPECT_EQ(0, ring.register_buffers(NULL, 0));
+	}
+}
+
+/** Read random blocks through io_uring, keeping QUEUE_DEPTH requests
+in flight.
+@param[in]	num_iterations	number of reads
+@param[in]	fixed		whether to use a fixed buffer */
+static
+void
+run_uring_read_benchmark(size_t num_iterations, bool fixed)
+{
+	StopBenchmarkTiming();
+
+	TestFile	file;
+	IoUring		ring;
+
+	ASSERT_TRUE(file.is_ok());
+
+	int	ret = ring.open(QUEUE_DEPTH);
+
+	if (ret != 0) {
+		OS0URING_SKIP(std::string("io_uring is not available: ")
+			      + strerror(-ret));
+	}
+
+	if (fixed) {
+		struct iovec	iov;
+
+		iov.iov_base = file.m_buf;
+		iov.iov_len = QUEUE_DEPTH * REQ_SIZE;
+
+		ASSERT_EQ(0, ring.register_buffers(&iov, 1));
+	}
+
+	uint64_t	state = 88172645463325252ULL;
+	size_t		submitted = 0;
+	size_t		completed = 0;
+
+	StartBenchmarkTiming();
+
+	while (completed < num_iterations) {
+
+		while (submitted < num_iterations
+		       && submitted - completed < QUEUE_DEPTH) {
+
+			ulint	i = submitted % QUEUE_DEPTH;
+
+			ring.prepare(true, file.m_fd, file.buf(i), REQ_SIZE,
+				     random_offset(&state), NULL,
+				     fixed ? 0 : -1);
+			++submitted;
+		}
+
+		int	err = ring.wait(WAIT_TIMEOUT);
+
+		ASSERT_TRUE(err >= 0 || err == -EINTR || err == -ETIME);
+
+		void*	data;
+		int	res;
+
+		while (ring.reap(&data, &res)) {
+			ASSERT_EQ(static_cast<int>(REQ_SIZE), res);
+			++completed;
+		}
+	}
+
+	StopBenchmarkTiming();
+
+	SetBytesProcessed(num_iterations * REQ_SIZE);
+}
+
+static void BM_URING_READ_16K(size_t num_iterations)
+{
+	run_uring_read_benchmark(num_iterations, false);
+}
+BENCHMARK(BM_URING_READ_16K);
+
+static void BM_URING_READ_FIXED_16K(size_t num_iterations)
+{
+	run_uring_read_benchmark(num_iterations, true);
+}
+BENCHMARK(BM_URING_READ_FIXED_16K);
+
+#ifdef LINUX_NATIVE_AIO
+/** Read random blocks through libaio, keeping QUEUE_DEPTH requests
+in flight, as os0file.cc does with innodb_use_native_aio.
+@param[in]	num_iterations	number of reads */
+static void BM_LIBAIO_READ_16K(size_t num_iterations)
+{
+	StopBenchmarkTiming();
+
+	TestFile	file;
+	io_context_t	ctx;
+
+	ASSERT_TRUE(file.is_ok());
+
+	memset(&ctx, 0x0, sizeof(ctx));
+
+	int	err = io_setup(QUEUE_DEPTH, &ctx);
+
+	if (err != 0) {
+		OS0URING_SKIP(std::string("libaio is not available: ")
+			      + strerror(-err));
+	}
+
+	struct iocb	iocbs[QUEUE_DEPTH];
+	struct io_event	events[QUEUE_DEPTH];
+	uint64_t	state = 88172645463325252ULL;
+	size_t		submitted = 0;
+	size_t		completed = 0;
+
+	StartBenchmarkTiming();
+
+	while (completed < num_iterations) {
+
+		while (submitted < num_iterations
+		       && submitted - completed < QUEUE_DEPTH) {
+
+			ulint		i = submitted % QUEUE_DEPTH;
+			struct iocb*	iocb = &iocbs[i];
+
+			io_prep_pread(iocb, file.m_fd, file.buf(i), REQ_SIZE,
+				      random_offset(&state));
+
+			ASSERT_EQ(1, io_submit(ctx, 1, &iocb));
+			++submitted;
+		}
+
+		struct timespec	timeout;
+
+		timeout.tv_sec = WAIT_TIMEOUT / 1000000000;
+		timeout.tv_nsec = 0;
+
+		int	n = io_getevents(
+			ctx, 1, QUEUE_DEPTH, events, &timeout);
+
+		ASSERT_TRUE(n >= 0 || n == -EINTR);
+
+		for (int i = 0; i < n; i++) {
+			ASSERT_EQ(REQ_SIZE, events[i].res);
+			++completed;
+		}
+	}
+
+	StopBenchmarkTiming();
+
+	io_destroy(ctx);
+
+	SetBytesProcessed(num_iterations * REQ_SIZE);
+}
+BENCHMARK(BM_LIBAIO_READ_16K);
+#endif /* LINUX_NATIVE_AIO */
+
+}  // namespace innodb_os0uring_unittest
+
+#endif /* LINUX_IO_URING */
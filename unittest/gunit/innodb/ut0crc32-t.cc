@@ -2090,9 +2090,7 @@ init()
 	ut_crc32_init();
 
 	fprintf(stderr, "Using %s, CPU is %s-endian\n",
-		ut_crc32_cpu_enabled
-		? "hardware CPU crc32 instructions"
-		: "software crc32 implementation",
+		ut_crc32_implementation,
 #ifdef WORDS_BIGENDIAN
 		"big"
 #else /* WORDS_BIGENDIAN */
@@ -2165,6 +2163,103 @@ TEST(ut0crc32, basic)
 	delete[] buf;
 }
 
+/* ut_crc32() must agree with the software implementation for all lengths
+and alignments, including the ones that use the interleaved streams. */
+TEST(ut0crc32, matches_software)
+{
+	init();
+
+	const ulint	max_len = 4 * UNIV_PAGE_SIZE_DEF + 64;
+	byte*		buf = new byte[max_len + 8];
+
+	for (ulint i = 0; i < max_len + 8; i++) {
+		buf[i] = static_cast<byte>(i * 131 + (i >> 8));
+	}
+
+	for (ulint offset = 0; offset < 8; offset++) {
+		for (ulint len = 0; len <= max_len; len += 1 + len / 7) {
+			const byte*	p = buf + offset;
+
+			EXPECT_EQ(ut_crc32_sw_func(p, len), ut_crc32(p, len));
+			EXPECT_EQ(ut_crc32_byte_by_byte(p, len),
+				  ut_crc32(p, len));
+		}
+	}
+
+	delete[] buf;
+}
+
+/** Run a checksum benchmark over a buffer of a page size.
+@param[in]	num_iterations	number of checksums to compute
+@param[in]	func		checksum function pointer, set by init()
+@param[in]	len		page size */
+static
+void
+run_crc32_benchmark(
+	size_t			num_iterations,
+	const ut_crc32_func_t*	func,
+	ulint			len)
+{
+	StopBenchmarkTiming();
+	init();
+
+	byte*	buf = new byte[len];
+
+	for (ulint i = 0; i < len; i++) {
+		buf[i] = page[i % page_size];
+	}
+
+	ut_crc32_func_t	f = *func;
+
+	StartBenchmarkTiming();
+	size_t sum = 0;
+	for (size_t n = 0; n < num_iterations; n++) {
+		sum += f(buf, len);
+	}
+	StopBenchmarkTiming();
+
+	EXPECT_NE(0U, sum);  // To keep the compiler from optimizing it away.
+	SetBytesProcessed(num_iterations * len);
+
+	delete[] buf;
+}
+
+static void BM_CRC32_4K(size_t num_iterations)
+{
+	run_crc32_benchmark(num_iterations, &ut_crc32, 4096);
+}
+BENCHMARK(BM_CRC32_4K);
+
+static void BM_CRC32_16K(size_t num_iterations)
+{
+	run_crc32_benchmark(num_iterations, &ut_crc32, 16384);
+}
+BENCHMARK(BM_CRC32_16K);
+
+static void BM_CRC32_64K(size_t num_iterations)
+{
+	run_crc32_benchmark(num_iterations, &ut_crc32, 65536);
+}
+BENCHMARK(BM_CRC32_64K);
+
+static void BM_SoftwareCRC32_4K(size_t num_iterations)
+{
+	run_crc32_benchmark(num_iterations, &ut_crc32_sw_func, 4096);
+}
+BENCHMARK(BM_SoftwareCRC32_4K);
+
+static void BM_SoftwareCRC32_16K(size_t num_iterations)
+{
+	run_crc32_benchmark(num_iterations, &ut_crc32_sw_func, 16384);
+}
+BENCHMARK(BM_SoftwareCRC32_16K);
+
+static void BM_SoftwareCRC32_64K(size_t num_iterations)
+{
+	run_crc32_benchmark(num_iterations, &ut_crc32_sw_func, 65536);
+}
+BENCHMARK(BM_SoftwareCRC32_64K);
+
 static void BM_CRC32(size_t num_iterations)
 {
 	StopBenchmarkTiming();